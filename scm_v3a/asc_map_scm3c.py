@@ -0,0 +1,134 @@
+"""Analog scan chain field map for scm3c.
+
+Generated by scripts/gen_asc_map.py from asc_map_scm3c.json. Do not edit.
+
+The helpers work on a list of bits indexed by ASC position before
+any scan chain inversion is applied.
+"""
+
+ASC_LENGTH = 1216
+
+# Field name: (positions from MSB to LSB, inverted bits mask).
+FIELDS = {
+    'counter_analog_cfg_select': ([2, 3, 4, 5, 6, 7, 8], 0x0),
+    'chip_clk_divider_passthrough': ([41], 0x0),
+    'rftimer_divider': ([49, 48, 47, 46, 45, 44, 43, 42], 0xFF),
+    'gpo_row1_select': ([248, 247, 246, 245], 0x0),
+    'gpo_row2_select': ([252, 251, 250, 249], 0x0),
+    'gpo_row3_select': ([256, 255, 254, 253], 0x0),
+    'gpo_row4_select': ([260, 259, 258, 257], 0x0),
+    'gpi_row1_select': ([262, 261], 0x0),
+    'gpi_row2_select': ([264, 263], 0x0),
+    'gpi_row3_select': ([266, 265], 0x0),
+    'gpi_row4_select': ([268, 267], 0x0),
+    'zcc_demod_threshold': (
+        [122, 121, 120, 119, 118, 117, 116, 115, 114, 113, 112, 111, 110, 109,
+         108, 107],
+        0x0),
+    'zcc_clk_div': ([131, 130, 129, 128, 127, 126, 125, 124], 0x0),
+    'zcc_early_decision_margin': (
+        [224, 223, 222, 221, 220, 219, 218, 217, 216, 215, 214, 213, 212, 211,
+         210, 209],
+        0x0),
+    'adc_reset_source': ([242], 0x0),
+    'adc_convert_source': ([243], 0x0),
+    'adc_pga_amplify_source': ([244], 0x0),
+    'if_q_gain': ([272, 273, 274, 275, 276, 277], 0x0),
+    'if_mixer_disable': ([298, 307], 0x0),
+    'if_q_comparator_ptrim': ([335, 336, 337, 338, 339], 0x0),
+    'if_q_comparator_ntrim': ([340, 341, 342, 343, 344], 0x0),
+    'if_rc_coarse': ([427, 428, 429, 430, 431], 0x0),
+    'if_rc_fine': ([433, 434, 435, 436, 437], 0x0),
+    'if_i_comparator_ntrim': ([456, 455, 454, 453, 452], 0x0),
+    'if_i_comparator_ptrim': ([461, 460, 459, 458, 457], 0x0),
+    'if_i_gain': ([490, 489, 488, 487, 486, 485], 0x0),
+    'if_ldo_rdac': ([498, 497, 496, 495, 494, 493, 492], 0x0),
+    'scan_pon_if': ([501], 0x0),
+    'scan_pon_lo': ([502], 0x0),
+    'scan_pon_pa': ([503], 0x0),
+    'gpio_pon_en_if': ([504], 0x0),
+    'fsm_pon_en_if': ([505], 0x0),
+    'gpio_pon_en_lo': ([506], 0x0),
+    'fsm_pon_en_lo': ([507], 0x0),
+    'gpio_pon_en_pa': ([508], 0x0),
+    'fsm_pon_en_pa': ([509], 0x0),
+    'master_ldo_en_if': ([510], 0x0),
+    'master_ldo_en_lo': ([511], 0x0),
+    'master_ldo_en_pa': ([512], 0x0),
+    'scan_pon_div': ([513], 0x0),
+    'gpio_pon_en_div': ([514], 0x0),
+    'fsm_pon_en_div': ([515], 0x0),
+    'master_ldo_en_div': ([516], 0x0),
+    'lf_clock_disable': ([553], 0x0),
+    'always_on_ldo': ([557, 924, 925, 926, 927, 928, 929], 0x60),
+    'osc_32k_enable': ([623], 0x0),
+    'if_rc_high_speed_mode': ([726], 0x0),
+    'adc_const_gm_tuning_code': (
+        [765, 764, 763, 762, 761, 760, 759, 758],
+        0x0),
+    'adc_pga_gain': ([766, 767, 768, 769, 770, 771, 800, 773], 0x0),
+    'adc_bandgap_reference_tuning_code': (
+        [778, 784, 783, 782, 781, 780, 779],
+        0x0),
+    'vddd_ldo': ([791, 792, 793, 794, 795, 796, 797], 0x60),
+    'adc_vbat_div_4_enable': ([798], 0x0),
+    'adc_ldo_enable': ([801], 0x0),
+    'adc_settling_time': ([816, 817, 818, 819, 820, 821, 822, 823], 0x0),
+    'hf_clock_fine': ([874, 873, 872, 871, 870], 0x10),
+    'hf_clock_coarse': ([877, 876, 875, 861, 860], 0x1C),
+    'aux_ldo_control_select': ([914], 0x0),
+    'adc_input_mux_select': ([915, 1087], 0x0),
+    'aux_ldo_disable': ([916], 0x0),
+    'aux_ldo': ([923, 922, 921, 920, 919, 918, 917], 0x60),
+    'polyphase_enable': ([971], 0x0),
+    'pa_ldo_rdac': ([972, 973, 974, 975, 976, 977, 978], 0x7F),
+    'lo_ldo_rdac': ([980, 981, 982, 983, 984, 985, 986], 0x7F),
+    'lo_current': ([988, 989, 990, 991, 992, 993, 994, 995], 0x0),
+    'mod_15_4_tune': ([1002, 1001, 1000], 0x0),
+    'divider_sel_1mhz_2mhz': ([1012], 0x0),
+    'adc_pga_bypass': ([1088], 0x0),
+    'rc_2m_coarse1': ([1093, 1092, 1091, 1090, 1089], 0x0),
+    'rc_2m_coarse2': ([1098, 1097, 1096, 1095, 1094], 0x0),
+    'rc_2m_coarse3': ([1103, 1102, 1101, 1100, 1099], 0x0),
+    'rc_2m_fine': ([1108, 1107, 1106, 1105, 1104], 0x0),
+    'rc_2m_superfine': ([1113, 1112, 1111, 1110, 1109], 0x0),
+    'rc_2m_enable': ([1114], 0x0),
+    'gpo_enable': (
+        [1130, 1128, 1126, 1124, 1121, 1119, 1117, 1115, 1146, 1144, 1142,
+         1140, 1137, 1135, 1133, 1131],
+        0xFFFF),
+    'gpi_enable': (
+        [1129, 1127, 1125, 1123, 1122, 1120, 1118, 1116, 1145, 1143, 1141,
+         1139, 1138, 1136, 1134, 1132],
+        0x0),
+    'hclk_source_hf_clock': ([1147], 0x0),
+    'rftimer_source_hf_clock': ([1151], 0x0),
+    'chip_clk_source_rc_2m': ([1156], 0x0),
+}
+
+
+def set_field(asc, name, value):
+    """Write the value into the field of the ASC bit list."""
+    bits, inverted = FIELDS[name]
+    if value >> len(bits):
+        raise ValueError('{} does not fit into {}'.format(value, name))
+    value ^= inverted
+    for index, position in enumerate(bits):
+        asc[position] = (value >> (len(bits) - 1 - index)) & 0x1
+
+
+def get_field(asc, name):
+    """Read the field from the ASC bit list."""
+    bits, inverted = FIELDS[name]
+    value = 0
+    for position in bits:
+        value = (value << 1) | (asc[position] & 0x1)
+    return value ^ inverted
+
+
+def build(**values):
+    """Return an ASC bit list with the given fields set."""
+    asc = [0] * ASC_LENGTH
+    for name, value in values.items():
+        set_field(asc, name, value)
+    return asc
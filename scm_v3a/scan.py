@@ -8,6 +8,8 @@ import time
 import struct
 import difflib
 
+import asc_map_scm3c
+
 # SCM 3 analog scan chain programming script
 
 ## Variables for operation to match the matlab scan function
@@ -416,7 +418,7 @@ ASC.extend(IF_scan + power_control);
 # DB section A
 ##----------------------------
 ASC.extend([0]*429)
-ASC[623] = 1; #32 kHz oscillator enable
+asc_map_scm3c.set_field(ASC, "osc_32k_enable", 1); #32 kHz oscillator enable
 # TO BE COMPLETED AT A LATER DATE
 
 ## ASC 946:1088 -- LC tuning and transmitter
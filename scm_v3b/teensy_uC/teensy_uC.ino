@@ -1363,35 +1363,26 @@ byte LUT_4B5B(byte in) {
 }
 
 
-// Reverses (reflects) bits in a 32-bit word.
-unsigned reverse(unsigned x) {
-   x = ((x & 0x55555555) <<  1) | ((x >>  1) & 0x55555555);
-   x = ((x & 0x33333333) <<  2) | ((x >>  2) & 0x33333333);
-   x = ((x & 0x0F0F0F0F) <<  4) | ((x >>  4) & 0x0F0F0F0F);
-   x = (x << 24) | ((x & 0xFF00) << 8) |
-       ((x >> 8) & 0xFF00) | (x >> 24);
-   return x;
-}
-
-// Same C function used for calculating CRC on SCM
+// CRC of every nibble value for the reflected CRC-32 polynomial 0xEDB88320
+const unsigned int crc32_table[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+  0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+  0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+// Same CRC as calculated on SCM (see crc32.c in scm_v3c)
+// Reflected form with a 16-entry table, so no bit reversal is needed
 unsigned int crc32c(unsigned int length) {
-  int i, j;
-  unsigned int byte, crc;
-
-  i = 0;
-   crc = 0xFFFFFFFF;
-   while (i < length) {
-      byte = ram[i];            // Get next byte.
-      byte = reverse(byte);         // 32-bit reversal.
-      for (j = 0; j <= 7; j++) {    // Do eight times.
-         if ((int)(crc ^ byte) < 0)
-              crc = (crc << 1) ^ 0x04C11DB7;
-         else crc = crc << 1;
-         byte = byte << 1;          // Ready next msg bit.
-        }
-      i = i + 1;
-   }
-   return reverse(~crc);
+  unsigned int i, crc;
+
+  crc = 0xFFFFFFFF;
+  for (i = 0; i < length; i++) {
+    crc ^= ram[i];
+    crc = (crc >> 4) ^ crc32_table[crc & 0xF];
+    crc = (crc >> 4) ^ crc32_table[crc & 0xF];
+  }
+  return ~crc;
 }
 
 // First use transfer_sram() to copy 64kB payload into Teensy SRAM variable ram[]
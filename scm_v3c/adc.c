@@ -1,172 +1,189 @@
 #include "adc.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "asc_map.h"
+#include "isr_profiler.h"
 #include "memory_map.h"
+#include "rftimer.h"
 #include "scm3c_hw_interface.h"
 
-// ADC analog scan chain bit enum.
-typedef enum {
-    ADC_INVALD_ASC_BIT = -1,
-    ADC_RESET_SOURCE_ASC_BIT = 242,
-    ADC_CONVERT_SOURCE_ASC_BIT = 243,
-    ADC_PGA_AMPLIFY_SOURCE_ASC_BIT = 244,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_0_ASC_BIT = 765,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_1_ASC_BIT = 764,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_2_ASC_BIT = 763,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_3_ASC_BIT = 762,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_4_ASC_BIT = 761,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_5_ASC_BIT = 760,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_6_ASC_BIT = 759,
-    ADC_CONST_GM_DEVICE_TUNING_CODE_7_ASC_BIT = 758,
-    ADC_PGA_GAIN_0_ASC_BIT = 766,
-    ADC_PGA_GAIN_1_ASC_BIT = 767,
-    ADC_PGA_GAIN_2_ASC_BIT = 768,
-    ADC_PGA_GAIN_3_ASC_BIT = 769,
-    ADC_PGA_GAIN_4_ASC_BIT = 770,
-    ADC_PGA_GAIN_5_ASC_BIT = 771,
-    ADC_PGA_GAIN_6_ASC_BIT = 800,
-    ADC_PGA_GAIN_7_ASC_BIT = 773,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_0_ASC_BIT = 778,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_1_ASC_BIT = 784,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_2_ASC_BIT = 783,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_3_ASC_BIT = 782,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_4_ASC_BIT = 781,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_5_ASC_BIT = 780,
-    ADC_BANDGAP_REFERENCE_TUNING_CODE_6_ASC_BIT = 779,
-    ADC_VBAT_DIV_4_ENABLED_ASC_BIT = 798,
-    ADC_LDO_ENABLED_ASC_BIT = 801,
-    ADC_SETTLING_TIME_0_ASC_BIT = 816,
-    ADC_SETTLING_TIME_1_ASC_BIT = 817,
-    ADC_SETTLING_TIME_2_ASC_BIT = 818,
-    ADC_SETTLING_TIME_3_ASC_BIT = 819,
-    ADC_SETTLING_TIME_4_ASC_BIT = 820,
-    ADC_SETTLING_TIME_5_ASC_BIT = 821,
-    ADC_SETTLING_TIME_6_ASC_BIT = 822,
-    ADC_SETTLING_TIME_7_ASC_BIT = 823,
-    ADC_INPUT_MUX_SELECT_0_ASC_BIT = 915,
-    ADC_INPUT_MUX_SELECT_1_ASC_BIT = 1087,
-    ADC_PGA_BYPASS_ASC_BIT = 1088,
-} adc_asc_bit_t;
-
 // ADC output.
 adc_output_t g_adc_output;
 
-// Set the ASC bit to the specified value.
-static void adc_set_asc_bit(const adc_asc_bit_t asc_bit, const uint8_t value) {
-    if ((value & 0x1) == 1) {
-        set_asc_bit((unsigned int)asc_bit);
-    } else {
-        clear_asc_bit((unsigned int)asc_bit);
+// CIC decimator state. The integrators run at the conversion rate, and the
+// combs run at the output rate. The integrators and combs wrap around, which
+// the CIC decimator tolerates as long as its output fits into 32 bits.
+typedef struct {
+    uint32_t integrators[ADC_STREAM_MAX_CIC_ORDER];
+    uint32_t combs[ADC_STREAM_MAX_CIC_ORDER];
+
+    // Number of conversions until the next output.
+    uint32_t num_conversions_to_output;
+
+    // Number of outputs to discard until the combs are filled.
+    uint8_t num_outputs_to_discard;
+} adc_stream_cic_t;
+
+// ADC stream configuration.
+static adc_stream_config_t g_adc_stream_config;
+
+// Whether the stream is running.
+static volatile bool g_adc_stream_running = false;
+
+// Compare value of the next conversion and of the pending conversion.
+static uint32_t g_adc_stream_next_compare = 0;
+static uint32_t g_adc_stream_conversion_compare = 0;
+
+// Last conversion result, which the decimator repeats for missed conversions.
+static uint16_t g_adc_stream_last_data = 0;
+
+// CIC decimator.
+static adc_stream_cic_t g_adc_stream_cic;
+
+// Ring buffer of samples. The ADC interrupt pushes at the head, and the main
+// loop pops at the tail.
+static adc_stream_sample_t g_adc_stream_buffer[ADC_STREAM_BUFFER_SIZE];
+static volatile uint32_t g_adc_stream_head = 0;
+static volatile uint32_t g_adc_stream_tail = 0;
+
+// Number of missed conversions and dropped samples.
+static volatile uint32_t g_adc_stream_num_dropped = 0;
+
+// Sequence number of the next stream packet.
+static uint8_t g_adc_stream_packet_sequence = 0;
+
+// Push a sample into the ring buffer.
+static void adc_stream_push(const uint32_t timestamp, const uint16_t data) {
+    adc_stream_sample_t* sample = NULL;
+
+    if (g_adc_stream_head - g_adc_stream_tail >= ADC_STREAM_BUFFER_SIZE) {
+        ++g_adc_stream_num_dropped;
+        return;
     }
-}
 
-// Set the ASC bits for the PGA gain.
-static void adc_set_pga_gain_asc_bits(const uint8_t pga_gain) {
-    adc_set_asc_bit(ADC_PGA_GAIN_0_ASC_BIT, (pga_gain >> 7) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_1_ASC_BIT, (pga_gain >> 6) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_2_ASC_BIT, (pga_gain >> 5) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_3_ASC_BIT, (pga_gain >> 4) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_4_ASC_BIT, (pga_gain >> 3) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_5_ASC_BIT, (pga_gain >> 2) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_6_ASC_BIT, (pga_gain >> 1) & 0x1);
-    adc_set_asc_bit(ADC_PGA_GAIN_7_ASC_BIT, pga_gain & 0x1);
+    sample =
+        &g_adc_stream_buffer[g_adc_stream_head & (ADC_STREAM_BUFFER_SIZE - 1)];
+    sample->timestamp = timestamp;
+    sample->data = data;
+    ++g_adc_stream_head;
 }
 
-// Set the ASC bits for the ADC settling time.
-static void adc_set_settling_time_asc_bits(const uint8_t settling_time) {
-    adc_set_asc_bit(ADC_SETTLING_TIME_0_ASC_BIT, (settling_time >> 7) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_1_ASC_BIT, (settling_time >> 6) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_2_ASC_BIT, (settling_time >> 5) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_3_ASC_BIT, (settling_time >> 4) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_4_ASC_BIT, (settling_time >> 3) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_5_ASC_BIT, (settling_time >> 2) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_6_ASC_BIT, (settling_time >> 1) & 0x1);
-    adc_set_asc_bit(ADC_SETTLING_TIME_7_ASC_BIT, settling_time & 0x1);
+// Feed a conversion result into the decimator and push the decimator output
+// into the ring buffer.
+static void adc_stream_decimate(const uint32_t timestamp, const uint16_t data) {
+    const uint8_t order = g_adc_stream_config.cic_order;
+    adc_stream_cic_t* const cic = &g_adc_stream_cic;
+    uint32_t value = data;
+    uint32_t previous_value = 0;
+    uint8_t i = 0;
+
+    if (order == 0) {
+        adc_stream_push(timestamp, data);
+        return;
+    }
+
+    for (i = 0; i < order; ++i) {
+        cic->integrators[i] += value;
+        value = cic->integrators[i];
+    }
+
+    if (--cic->num_conversions_to_output != 0) {
+        return;
+    }
+    cic->num_conversions_to_output = 1
+                                     << g_adc_stream_config.decimation_log2;
+
+    for (i = 0; i < order; ++i) {
+        previous_value = cic->combs[i];
+        cic->combs[i] = value;
+        value -= previous_value;
+    }
+
+    if (cic->num_outputs_to_discard != 0) {
+        --cic->num_outputs_to_discard;
+        return;
+    }
+
+    // Divide by the CIC gain to get a 10-bit output.
+    adc_stream_push(timestamp,
+                    value >> (order * g_adc_stream_config.decimation_log2));
 }
 
-// Set the ASC bits for the bandgap reference.
-static void adc_set_bandgap_refernce_tuning_code_asc_bits(
-    const uint8_t bandgap_reference_tuning_code) {
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_0_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 6) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_1_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 5) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_2_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 4) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_3_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 3) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_4_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 2) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_5_ASC_BIT,
-                    (bandgap_reference_tuning_code >> 1) & 0x1);
-    adc_set_asc_bit(ADC_BANDGAP_REFERENCE_TUNING_CODE_6_ASC_BIT,
-                    bandgap_reference_tuning_code & 0x1);
+// Called by the RF timer at every conversion period.
+static void adc_stream_compare(void) {
+    if (!g_adc_stream_running) {
+        return;
+    }
+
+    // Schedule the next conversion one period after this compare value. If
+    // the interrupt was delayed by more than a period, skip the missed
+    // conversions, but keep the decimator on the conversion grid by repeating
+    // the last conversion result for them.
+    g_adc_stream_conversion_compare = g_adc_stream_next_compare;
+    g_adc_stream_next_compare += g_adc_stream_config.period;
+    while ((int32_t)(g_adc_stream_next_compare - RFTIMER_REG__COUNTER) <= 0) {
+        ++g_adc_stream_num_dropped;
+        if (g_adc_stream_config.cic_order != 0) {
+            adc_stream_decimate(g_adc_stream_conversion_compare,
+                                g_adc_stream_last_data);
+        }
+        g_adc_stream_conversion_compare = g_adc_stream_next_compare;
+        g_adc_stream_next_compare += g_adc_stream_config.period;
+    }
+    rftimer_setCompareIn_by_id(g_adc_stream_next_compare,
+                               g_adc_stream_config.rftimer_id);
+
+    ADC_REG__START = 0x1;
 }
 
-// Set the ASC bits to tune the gm.
-static void adc_set_const_gm_tuning_code_asc_bits(
-    const uint8_t const_gm_tuning_code) {
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_0_ASC_BIT,
-                    (const_gm_tuning_code >> 7) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_1_ASC_BIT,
-                    (const_gm_tuning_code >> 6) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_2_ASC_BIT,
-                    (const_gm_tuning_code >> 5) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_3_ASC_BIT,
-                    (const_gm_tuning_code >> 4) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_4_ASC_BIT,
-                    (const_gm_tuning_code >> 3) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_5_ASC_BIT,
-                    (const_gm_tuning_code >> 2) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_6_ASC_BIT,
-                    (const_gm_tuning_code >> 1) & 0x1);
-    adc_set_asc_bit(ADC_CONST_GM_DEVICE_TUNING_CODE_7_ASC_BIT,
-                    const_gm_tuning_code & 0x1);
+// Store a 16-bit value LSB-first.
+static inline void adc_stream_put_int16(uint8_t* buffer, const uint16_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
 }
 
 void adc_config(const adc_config_t* adc_config) {
+    uint32_t* asc = scm3c_hw_interface_get_asc();
+
     // Set the ASC bit for the ADC reset signal source.
-    adc_set_asc_bit(ADC_RESET_SOURCE_ASC_BIT,
-                    (uint8_t)adc_config->reset_source);
+    asc_map_set_adc_reset_source(asc, (uint8_t)adc_config->reset_source);
 
     // Set the ASC bit for the ADC convert signal source.
-    adc_set_asc_bit(ADC_CONVERT_SOURCE_ASC_BIT,
-                    (uint8_t)adc_config->convert_source);
+    asc_map_set_adc_convert_source(asc, (uint8_t)adc_config->convert_source);
 
     // Set the ASC bit for the PGA amplify signal source.
-    adc_set_asc_bit(ADC_PGA_AMPLIFY_SOURCE_ASC_BIT,
-                    (uint8_t)adc_config->pga_amplify_source);
+    asc_map_set_adc_pga_amplify_source(
+        asc, (uint8_t)adc_config->pga_amplify_source);
 
     // Set the ASC bits for the PGA gain.
-    adc_set_pga_gain_asc_bits(adc_config->pga_gain);
+    asc_map_set_adc_pga_gain(asc, adc_config->pga_gain);
 
     // Set the ASC bits for the ADC settling time.
-    adc_set_settling_time_asc_bits(adc_config->settling_time);
+    asc_map_set_adc_settling_time(asc, adc_config->settling_time);
 
     // Set the ASC bits for the bandgap reference tuning code.
-    adc_set_bandgap_refernce_tuning_code_asc_bits(
-        adc_config->bandgap_reference_tuning_code);
+    asc_map_set_adc_bandgap_reference_tuning_code(
+        asc, adc_config->bandgap_reference_tuning_code);
 
     // Set the ASC bits for the const gm device tuning code.
-    adc_set_const_gm_tuning_code_asc_bits(adc_config->const_gm_tuning_code);
+    asc_map_set_adc_const_gm_tuning_code(asc,
+                                         adc_config->const_gm_tuning_code);
 
     // Set the ASC bit for enabling the VBAT / 4 input.
-    adc_set_asc_bit(ADC_VBAT_DIV_4_ENABLED_ASC_BIT,
-                    adc_config->vbat_div_4_enabled);
+    asc_map_set_adc_vbat_div_4_enable(asc, adc_config->vbat_div_4_enabled);
 
     // Set the ASC bit for enabling the on-chip LDO.
-    adc_set_asc_bit(ADC_LDO_ENABLED_ASC_BIT, adc_config->ldo_enabled);
+    asc_map_set_adc_ldo_enable(asc, adc_config->ldo_enabled);
 
     // Set the ASC bits for the ADC input mux select.
-    adc_set_asc_bit(ADC_INPUT_MUX_SELECT_0_ASC_BIT,
-                    (adc_config->input_mux_select >> 1) & 0x1);
-    adc_set_asc_bit(ADC_INPUT_MUX_SELECT_1_ASC_BIT,
-                    adc_config->input_mux_select & 0x1);
+    asc_map_set_adc_input_mux_select(asc, adc_config->input_mux_select);
 
     // Set the ASC bit for bypassing the PGA.
-    adc_set_asc_bit(ADC_PGA_BYPASS_ASC_BIT, adc_config->pga_bypass);
+    asc_map_set_adc_pga_bypass(asc, adc_config->pga_bypass);
 }
 
 void adc_trigger(void) {
@@ -185,7 +202,110 @@ void adc_disable_interrupt(void) {
 }
 
 void adc_isr(void) {
-    printf("ADC conversion complete.\n");
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_ADC);
+
     g_adc_output.data = ADC_REG__DATA;
     g_adc_output.valid = true;
+
+    if (g_adc_stream_running) {
+        g_adc_stream_last_data = g_adc_output.data;
+        adc_stream_decimate(g_adc_stream_conversion_compare,
+                            g_adc_stream_last_data);
+    }
+
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_ADC);
+}
+
+bool adc_stream_start(const adc_stream_config_t* stream_config) {
+    if (g_adc_stream_running || stream_config->period == 0 ||
+        stream_config->period > ADC_STREAM_MAX_PERIOD ||
+        stream_config->cic_order > ADC_STREAM_MAX_CIC_ORDER ||
+        stream_config->decimation_log2 > ADC_STREAM_MAX_DECIMATION_LOG2) {
+        return false;
+    }
+
+    g_adc_stream_config = *stream_config;
+    memset(&g_adc_stream_cic, 0, sizeof(g_adc_stream_cic));
+    g_adc_stream_cic.num_conversions_to_output =
+        1 << stream_config->decimation_log2;
+    // The comb outputs are only valid once all combs have been filled.
+    if (stream_config->cic_order > 1) {
+        g_adc_stream_cic.num_outputs_to_discard = stream_config->cic_order - 1;
+    }
+    g_adc_stream_last_data = 0;
+    g_adc_stream_head = 0;
+    g_adc_stream_tail = 0;
+    g_adc_stream_num_dropped = 0;
+    g_adc_stream_running = true;
+
+    rftimer_set_callback_by_id(adc_stream_compare, stream_config->rftimer_id);
+    g_adc_stream_next_compare = RFTIMER_REG__COUNTER + stream_config->period;
+    rftimer_setCompareIn_by_id(g_adc_stream_next_compare,
+                               stream_config->rftimer_id);
+    return true;
+}
+
+void adc_stream_stop(void) {
+    if (!g_adc_stream_running) {
+        return;
+    }
+    g_adc_stream_running = false;
+    rftimer_disable_interrupts_by_id(g_adc_stream_config.rftimer_id);
+}
+
+uint32_t adc_stream_num_samples(void) {
+    return g_adc_stream_head - g_adc_stream_tail;
+}
+
+bool adc_stream_pop(adc_stream_sample_t* sample) {
+    if (g_adc_stream_head == g_adc_stream_tail) {
+        return false;
+    }
+    *sample =
+        g_adc_stream_buffer[g_adc_stream_tail & (ADC_STREAM_BUFFER_SIZE - 1)];
+    ++g_adc_stream_tail;
+    return true;
+}
+
+uint32_t adc_stream_get_num_dropped(void) { return g_adc_stream_num_dropped; }
+
+uint8_t adc_stream_build_packet(uint8_t* packet,
+                                const uint8_t max_num_samples) {
+    const adc_stream_sample_t* sample = NULL;
+    const uint32_t sample_period =
+        g_adc_stream_config.cic_order != 0
+            ? g_adc_stream_config.period << g_adc_stream_config.decimation_log2
+            : g_adc_stream_config.period;
+    uint32_t first_timestamp = 0;
+    uint8_t num_samples = 0;
+
+    while (num_samples < max_num_samples &&
+           num_samples < ADC_STREAM_MAX_NUM_PACKET_SAMPLES &&
+           g_adc_stream_head != g_adc_stream_tail) {
+        sample = &g_adc_stream_buffer[g_adc_stream_tail &
+                                      (ADC_STREAM_BUFFER_SIZE - 1)];
+        if (num_samples == 0) {
+            first_timestamp = sample->timestamp;
+        } else if (sample->timestamp - first_timestamp !=
+                   num_samples * sample_period) {
+            break;
+        }
+
+        adc_stream_put_int16(
+            &packet[ADC_STREAM_PACKET_HEADER_LENGTH + 2 * num_samples],
+            sample->data);
+        ++g_adc_stream_tail;
+        ++num_samples;
+    }
+
+    if (num_samples == 0) {
+        return 0;
+    }
+
+    packet[0] = ADC_STREAM_PACKET_CODE;
+    packet[1] = g_adc_stream_packet_sequence++;
+    packet[2] = num_samples;
+    adc_stream_put_int16(&packet[3], first_timestamp & 0xFFFF);
+    adc_stream_put_int16(&packet[5], first_timestamp >> 16);
+    return ADC_STREAM_PACKET_HEADER_LENGTH + 2 * num_samples;
 }
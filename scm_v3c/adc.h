@@ -1,9 +1,46 @@
+// Besides one-shot conversions, the ADC can stream conversions that are
+// triggered by an RF timer compare channel at a fixed period, so the sample
+// rate does not depend on the main loop. The ADC interrupt feeds the samples
+// through an optional CIC decimator into a ring buffer, from which the main
+// loop pops the samples or packs several of them into one packet. The RF timer
+// must be initialized with rftimer_init() and the ADC interrupt must be
+// enabled before starting the stream.
+
 #ifndef __ADC_H
 #define __ADC_H
 
 #include <stdbool.h>
 #include <stdint.h>
 
+// Number of samples in the stream ring buffer. Must be a power of 2.
+#define ADC_STREAM_BUFFER_SIZE 128
+
+// Maximum CIC decimator order.
+#define ADC_STREAM_MAX_CIC_ORDER 3
+
+// Maximum base 2 logarithm of the CIC decimation ratio. The CIC gain of
+// 2^(order * decimation_log2) times the 10-bit input must fit into 32 bits.
+#define ADC_STREAM_MAX_DECIMATION_LOG2 7
+
+// Maximum conversion period in RF timer ticks. The RF timer treats compare
+// values that are further in the future as being in the past.
+#define ADC_STREAM_MAX_PERIOD 0xFFFE
+
+// First byte of a stream packet.
+#define ADC_STREAM_PACKET_CODE 107
+
+// Length of the stream packet header: code, sequence number, number of
+// samples, and the 4-byte timestamp of the first sample.
+#define ADC_STREAM_PACKET_HEADER_LENGTH 7
+
+// Maximum number of samples in a stream packet, which fits into a 125-byte
+// payload.
+#define ADC_STREAM_MAX_NUM_PACKET_SAMPLES 59
+
+// Maximum length of a stream packet.
+#define ADC_STREAM_MAX_PACKET_LENGTH \
+    (ADC_STREAM_PACKET_HEADER_LENGTH + 2 * ADC_STREAM_MAX_NUM_PACKET_SAMPLES)
+
 // ADC reset signal source enum.
 typedef enum {
     ADC_RESET_SOURCE_INVALID = -1,
@@ -88,6 +125,32 @@ typedef struct __attribute__((packed)) {
     bool valid;
 } adc_output_t;
 
+// ADC stream configuration.
+typedef struct {
+    // Conversion period in RF timer ticks, at most ADC_STREAM_MAX_PERIOD.
+    uint32_t period;
+
+    // RF timer compare channel that triggers the conversions.
+    uint8_t rftimer_id;
+
+    // CIC decimator order. 0 disables the decimator, and 1 averages
+    // non-overlapping blocks of samples like a boxcar filter.
+    uint8_t cic_order;
+
+    // Base 2 logarithm of the decimation ratio, i.e., the decimator outputs a
+    // sample every 2^decimation_log2 conversions.
+    uint8_t decimation_log2;
+} adc_stream_config_t;
+
+// Timestamped ADC stream sample.
+typedef struct {
+    // RF timer compare value of the last conversion of the sample.
+    uint32_t timestamp;
+
+    // 10-bit ADC output or decimator output.
+    uint16_t data;
+} adc_stream_sample_t;
+
 // ADC output.
 extern adc_output_t g_adc_output;
 
@@ -103,4 +166,28 @@ void adc_enable_interrupt(void);
 // Disable the ADC interrupt.
 void adc_disable_interrupt(void);
 
+// Start streaming conversions. Return false if the stream is already running
+// or the configuration is invalid.
+bool adc_stream_start(const adc_stream_config_t* stream_config);
+
+// Stop streaming conversions. The buffered samples can still be popped.
+void adc_stream_stop(void);
+
+// Return the number of buffered samples.
+uint32_t adc_stream_num_samples(void);
+
+// Pop the oldest sample. Return whether a sample was popped.
+bool adc_stream_pop(adc_stream_sample_t* sample);
+
+// Return the number of samples that were dropped because the ring buffer was
+// full or a compare was missed.
+uint32_t adc_stream_get_num_dropped(void);
+
+// Pop up to max_num_samples consecutive samples, but at most
+// ADC_STREAM_MAX_NUM_PACKET_SAMPLES, into a stream packet. The samples are
+// stored LSB-first after the header and are one sample period apart, so a
+// dropped sample starts a new packet. Return the packet length or 0 if there
+// is no sample.
+uint8_t adc_stream_build_packet(uint8_t* packet, uint8_t max_num_samples);
+
 #endif  // __ADC_H
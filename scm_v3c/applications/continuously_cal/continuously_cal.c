@@ -18,6 +18,7 @@ This calibration only applies on on signel channel, e.g. channel 11.
 
 #include "freq_setting_selection.h"
 #include "gpio.h"
+#include "health_monitor.h"
 #include "memory_map.h"
 #include "optical.h"
 #include "radio.h"
@@ -143,6 +144,7 @@ void delay_lc_setup(void);
 
 int main(void) {
     uint32_t calc_crc;
+    health_monitor_config_t health_monitor_config;
 
     uint8_t i;
     uint8_t j;
@@ -206,6 +208,12 @@ int main(void) {
 
     printf("Cal complete\r\n");
 
+    // Monitor the battery to back off the probe frames when the supply sags.
+    health_monitor_get_default_config(&health_monitor_config);
+    if (!health_monitor_init(&health_monitor_config)) {
+        printf("Health monitor failed\r\n");
+    }
+
     app_vars.target_count_2m = TARGET_2M_COUNT;
 
     app_vars.state = SWEEP_RX;
@@ -508,6 +516,17 @@ void getFrequencyTx(uint16_t setting_start, uint16_t setting_end) {
 
         radio_rfOff();
 
+        // stretch the sending interval with the radio off when the supply is
+        // low. The ack window is timed by the RF timer compare, so the extra
+        // time is waited here to keep the compare within its range.
+        health_monitor_update();
+        backoff = health_monitor_scale_interval(SENDING_INTERVAL) -
+                  SENDING_INTERVAL;
+        backoff_start = rftimer_readCounter();
+        while (rftimer_readCounter() - backoff_start < backoff) {
+            health_monitor_update();
+        }
+
         app_vars.tx_done = 0;
 
         pkt[0] = 'C';
@@ -571,6 +590,9 @@ void contiuously_calibration_start(void) {
     uint16_t tx_setting_target;
     uint16_t rx_setting_target;
 
+    uint32_t backoff;
+    uint32_t backoff_start;
+
     while (app_vars.state != SWEEP_TX_DONE)
         ;
 
@@ -585,6 +607,17 @@ void contiuously_calibration_start(void) {
 
         radio_rfOff();
 
+        // stretch the sending interval with the radio off when the supply is
+        // low. The ack window is timed by the RF timer compare, so the extra
+        // time is waited here to keep the compare within its range.
+        health_monitor_update();
+        backoff = health_monitor_scale_interval(SENDING_INTERVAL) -
+                  SENDING_INTERVAL;
+        backoff_start = rftimer_readCounter();
+        while (rftimer_readCounter() - backoff_start < backoff) {
+            health_monitor_update();
+        }
+
         app_vars.tx_done = 0;
 
         pkt[0] = 'C';
@@ -1,6 +1,7 @@
 #include <string.h>
 
 #include "optical.h"
+#include "prbs.h"
 #include "radio.h"
 #include "scm3c_hw_interface.h"
 
@@ -8,6 +9,14 @@
 
 #define RX_PACKET_LEN 125 + 2  // 2 for CRC
 
+// Set to 1 to receive PRBS packets for BER tests (see prbs.h) at the fixed
+// tuning code while freq_sweep_tx_simple sweeps with BER_MODE. The BER and PER
+// per transmitter tuning code are reported by scripts/ber_report.py.
+#define BER_MODE 0
+
+#define BER_PACKET_LEN 64 + 2  // 2 for CRC
+#define BER_POLYNOMIAL PRBS_PN9
+
 //=========================== variables =======================================
 
 typedef struct {
@@ -18,6 +27,8 @@ app_vars_t app_vars;
 
 //=========================== prototypes ======================================
 void radio_rx_cb(uint8_t* packet, uint8_t packet_len);
+void ber_rx_cb(uint8_t* packet, uint8_t packet_len);
+void ber_rx_crc_error_cb(uint8_t* packet, uint8_t packet_len);
 
 //=========================== main ============================================
 
@@ -46,6 +57,14 @@ int main(void) {
     repeat_params.fixed_lc_mid = 21;
     repeat_params.fixed_lc_fine = 3;
 
+#if BER_MODE == 1
+    prbs_ber_init(BER_POLYNOMIAL);
+    radio_setRxCb(ber_rx_cb);
+    radio_setRxCrcErrorCb(ber_rx_crc_error_cb);
+    repeat_params.pkt_len = BER_PACKET_LEN;
+    repeat_params.repeat_mode = FIXED;
+#endif
+
     repeat_rx_tx(repeat_params);
 }
 
@@ -61,3 +80,11 @@ void radio_rx_cb(uint8_t* packet, uint8_t packet_len) {
     }
     printf("\n");
 }
+
+void ber_rx_cb(uint8_t* packet, uint8_t packet_len) {
+    prbs_ber_check_packet(packet, packet_len, true);
+}
+
+void ber_rx_crc_error_cb(uint8_t* packet, uint8_t packet_len) {
+    prbs_ber_check_packet(packet, packet_len, false);
+}
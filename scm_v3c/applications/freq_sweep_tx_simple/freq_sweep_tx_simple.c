@@ -1,18 +1,46 @@
+#include <stdio.h>
 #include <string.h>
 
+#include "asc_profiles.h"
 #include "optical.h"
+#include "prbs.h"
 #include "radio.h"
 #include "scm3c_hw_interface.h"
+#include "shell.h"
+#include "tuning.h"
 
 //=========================== defines =========================================
 
 #define TX_PACKET_LEN 8 + 2  // 2 for CRC
 
+// Set to 1 to transmit PRBS packets for BER tests (see prbs.h) instead of the
+// tuning codes. The receiver should run freq_sweep_rx_simple with BER_MODE.
+#define BER_MODE 0
+
+#define BER_PACKET_LEN 64 + 2  // 2 for CRC
+#define BER_POLYNOMIAL PRBS_PN9
+#define BER_PACKETS_PER_CODE 20
+
 //=========================== variables =======================================
 
 typedef struct {
     uint8_t dummy;
     uint8_t index;
+
+    // BER sweep configuration, which can be changed over the shell.
+    tuning_sweep_config_t sweep_config;
+
+    // Current tuning code of the BER sweep.
+    tuning_code_t tuning_code;
+
+    // Number of PRBS packets at each tuning code.
+    uint8_t ber_packets_per_code;
+
+    // Number of PRBS packets sent at the current tuning code.
+    uint8_t ber_packet_index;
+
+    // Whether the sweep should restart at the start code.
+    bool ber_restart;
 } app_vars_t;
 
 app_vars_t app_vars;
@@ -20,6 +48,29 @@ app_vars_t app_vars;
 //=========================== prototypes ======================================
 void fill_tx_packet(uint8_t* packet, uint8_t packet_len,
                     repeat_rx_tx_state_t state);
+void ber_tx(void);
+bool ber_restart_action(uint8_t argc, const char* argv[]);
+void ber_print_status(void);
+bool ber_sweep_config_set_cb(void);
+
+// Shell parameters of the BER sweep.
+static const shell_param_t g_ber_shell_params[] = {
+    {"coarse_start", SHELL_PARAM_TYPE_UINT8,
+     &app_vars.sweep_config.coarse.start, TUNING_MIN_CODE, TUNING_MAX_CODE,
+     ber_sweep_config_set_cb},
+    {"coarse_end", SHELL_PARAM_TYPE_UINT8, &app_vars.sweep_config.coarse.end,
+     TUNING_MIN_CODE, TUNING_MAX_CODE, ber_sweep_config_set_cb},
+    {"mid_start", SHELL_PARAM_TYPE_UINT8, &app_vars.sweep_config.mid.start,
+     TUNING_MIN_CODE, TUNING_MAX_CODE, ber_sweep_config_set_cb},
+    {"mid_end", SHELL_PARAM_TYPE_UINT8, &app_vars.sweep_config.mid.end,
+     TUNING_MIN_CODE, TUNING_MAX_CODE, ber_sweep_config_set_cb},
+    {"fine_start", SHELL_PARAM_TYPE_UINT8, &app_vars.sweep_config.fine.start,
+     TUNING_MIN_CODE, TUNING_MAX_CODE, ber_sweep_config_set_cb},
+    {"fine_end", SHELL_PARAM_TYPE_UINT8, &app_vars.sweep_config.fine.end,
+     TUNING_MIN_CODE, TUNING_MAX_CODE, ber_sweep_config_set_cb},
+    {"packets_per_code", SHELL_PARAM_TYPE_UINT8,
+     &app_vars.ber_packets_per_code, 1, UINT8_MAX, NULL},
+};
 
 //=========================== main ============================================
 
@@ -48,7 +99,18 @@ int main(void) {
     repeat_params.fixed_lc_mid = 30;
     repeat_params.fixed_lc_fine = 22;
 
+#if BER_MODE == 1
+    app_vars.sweep_config.coarse.start = repeat_params.sweep_lc_coarse_start;
+    app_vars.sweep_config.coarse.end = repeat_params.sweep_lc_coarse_end;
+    app_vars.sweep_config.mid.start = repeat_params.sweep_lc_mid_start;
+    app_vars.sweep_config.mid.end = repeat_params.sweep_lc_mid_end;
+    app_vars.sweep_config.fine.start = repeat_params.sweep_lc_fine_start;
+    app_vars.sweep_config.fine.end = repeat_params.sweep_lc_fine_end;
+    app_vars.ber_packets_per_code = BER_PACKETS_PER_CODE;
+    ber_tx();
+#else
     repeat_rx_tx(repeat_params);
+#endif
 }
 
 //=========================== private =========================================
@@ -57,3 +119,75 @@ void fill_tx_packet(uint8_t* packet, uint8_t packet_len,
     sprintf(packet, "%d %d %d", state.cfg_coarse, state.cfg_mid,
             state.cfg_fine);
 }
+
+// Repeatedly sweep the tuning codes and send ber_packets_per_code PRBS packets
+// at each tuning code. The sweep can be reconfigured over the UART shell
+// between packets.
+void ber_tx(void) {
+    static const shell_action_t restart_action = {"restart", "restart",
+                                                  ber_restart_action};
+    uint8_t ber_packet[BER_PACKET_LEN];
+    size_t i;
+
+    shell_init();
+    for (i = 0; i < sizeof(g_ber_shell_params) / sizeof(shell_param_t); i++) {
+        shell_register_param(&g_ber_shell_params[i]);
+    }
+    shell_register_action(&restart_action);
+    shell_set_status_callback(ber_print_status);
+
+    prbs_ber_init(BER_POLYNOMIAL);
+    tuning_init_for_sweep(&app_vars.tuning_code, &app_vars.sweep_config);
+
+    while (1) {
+        printf("coarse=%d, middle=%d, fine=%d\r\n",
+               app_vars.tuning_code.coarse, app_vars.tuning_code.mid,
+               app_vars.tuning_code.fine);
+        tuning_tune_radio(&app_vars.tuning_code);
+
+        for (app_vars.ber_packet_index = 0;
+             app_vars.ber_packet_index < app_vars.ber_packets_per_code &&
+             !app_vars.ber_restart;
+             app_vars.ber_packet_index++) {
+            prbs_ber_fill_packet(ber_packet, BER_PACKET_LEN,
+                                 &app_vars.tuning_code,
+                                 app_vars.ber_packet_index,
+                                 app_vars.ber_packets_per_code);
+            send_packet(ber_packet, BER_PACKET_LEN);
+            shell_process();
+        }
+
+        if (app_vars.ber_restart ||
+            tuning_end_of_sweep(&app_vars.tuning_code,
+                                &app_vars.sweep_config)) {
+            app_vars.ber_restart = false;
+            tuning_init_for_sweep(&app_vars.tuning_code,
+                                  &app_vars.sweep_config);
+        } else {
+            tuning_increment_code_for_sweep(&app_vars.tuning_code,
+                                            &app_vars.sweep_config);
+        }
+    }
+}
+
+// Restart the sweep if the new sweep configuration is valid.
+bool ber_sweep_config_set_cb(void) {
+    if (!tuning_validate_sweep_config(&app_vars.sweep_config)) {
+        return false;
+    }
+    return ber_restart_action(0, NULL);
+}
+
+// Restart the sweep at the start code after the current packet.
+bool ber_restart_action(uint8_t argc, const char* argv[]) {
+    app_vars.ber_restart = true;
+    return true;
+}
+
+void ber_print_status(void) {
+    printf("coarse=%d, middle=%d, fine=%d, packet=%d/%d\r\n",
+           app_vars.tuning_code.coarse, app_vars.tuning_code.mid,
+           app_vars.tuning_code.fine, app_vars.ber_packet_index,
+           app_vars.ber_packets_per_code);
+    asc_profiles_print_switch_stats();
+}
@@ -11,7 +11,9 @@
 #include "Int_Handlers.h"
 #include "Memory_map.h"
 #include "bucket_o_functions.h"
+#include "imu_sampler.h"
 #include "lighthouse.h"
+#include "optical.h"
 #include "rf_global_vars.h"
 #include "scm3C_hardware_interface.h"
 #include "scm3_hardware_interface.h"
@@ -28,6 +30,14 @@ extern unsigned int ASC[38];
 #define crc_value (*((unsigned int*)0x0000FFFC))
 #define code_length (*((unsigned int*)0x0000FFF8))
 
+// IMU sample rate. The sampler splits sample periods longer than the RF timer
+// compare range into several compares.
+#define IMU_SAMPLE_RATE_HZ 200
+// number of IMU samples sent per packet
+#define IMU_SAMPLES_PER_PACKET IMU_SAMPLER_MAX_NUM_PACKET_SAMPLES
+// RF timer compare channel of the IMU sampler
+#define IMU_SAMPLER_RFTIMER_ID 2
+
 // Target radio LO freq = 2.4025G
 // Divide ratio is currently 480*2
 // Calibration counts for 100ms
@@ -167,12 +177,42 @@ void test_LC_sweep_tx(void) {
     }
 }
 
+// sends the buffered IMU samples in one packet
+void send_imu_sample_packet(void) {
+    int i;
+    uint8_t len;
+
+    len = imu_sampler_build_packet((uint8_t*)send_packet,
+                                   IMU_SAMPLES_PER_PACKET);
+    if (len == 0) {
+        return;
+    }
+
+    // enable radio
+    radio_txEnable();
+
+    // load packet
+    radio_loadPacket(len);
+
+    // set lo frequency
+    LC_FREQCHANGE(23 & 0x1F, 20 & 0x1F, 0 & 0x1F);
+
+    // wait for 1000 loop cycles
+    for (i = 0; i < 1000; i++) {
+    }
+
+    // send packet
+    radio_txNow();
+}
+
 //////////////////////////////////////////////////////////////////
 // Main Function
 //////////////////////////////////////////////////////////////////
 
 int main(void) {
     unsigned int calc_crc;
+    unsigned int hf_clock_ticks_in_100ms;
+    imu_sampler_config_t imu_sampler_config;
     int i;
 
     printf("Initializing...");
@@ -227,6 +267,13 @@ int main(void) {
     ICER = 0xFFFF;
     printf("Cal complete\n");
 
+    // Scale the pulse classifier to the calibrated HF_CLOCK
+    hf_clock_ticks_in_100ms = optical_getHFClockTicksIn100ms();
+    if (hf_clock_ticks_in_100ms == 0) {
+        hf_clock_ticks_in_100ms = LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT;
+    }
+    lh_calibrate_pulse_classifier(hf_clock_ticks_in_100ms);
+
     // run frequency cal sweep
 
     // test_LC_sweep_tx();
@@ -265,27 +312,27 @@ int main(void) {
     for (i = 0; i < 50000; i++)
         ;
 
+    // trigger the IMU reads at a fixed rate from the RF timer interrupt
+    imu_sampler_config.trigger = IMU_SAMPLER_TRIGGER_RFTIMER;
+    imu_sampler_config.period =
+        hf_clock_ticks_in_100ms * 10 / IMU_SAMPLE_RATE_HZ;
+    imu_sampler_config.rftimer_id = IMU_SAMPLER_RFTIMER_ID;
+    imu_sampler_start(&imu_sampler_config);
+
     // start localization loop
     while (1) {
-        // poll imu
-
-        // store measurement
-        imu_data_t imu_measurement;
-
-        // test_imu_life();
-        // GPIO_REG__OUTPUT = ~GPIO_REG__OUTPUT;
+        // read the triggered IMU samples over SPI outside of the interrupt
+        imu_sampler_process();
 
-        imu_measurement.acc_x.value = read_acc_x();
-        imu_measurement.acc_y.value = read_acc_y();
-        imu_measurement.acc_z.value = read_acc_z();
-        imu_measurement.gyro_x.value = read_gyro_x();
-        imu_measurement.gyro_y.value = read_gyro_y();
-        imu_measurement.gyro_z.value = read_gyro_z();
+        // decode the photodiode edges while the samples are buffered, and send
+        // the finished pose sets
+        lh_process_edges();
+        send_lh_pose_packet();
 
-        // send measurement
-        for (i = 0; i < 25000; i++) {
+        // send the samples in batches
+        if (imu_sampler_num_samples() >= IMU_SAMPLES_PER_PACKET) {
+            send_imu_sample_packet();
         }
-        send_imu_packet(imu_measurement);
 
         // use interrupts intesad of polling
         /*
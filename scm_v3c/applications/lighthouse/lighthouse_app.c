@@ -12,6 +12,7 @@
 #include "Memory_map.h"
 #include "bucket_o_functions.h"
 #include "lighthouse.h"
+#include "optical.h"
 #include "rf_global_vars.h"
 #include "scm3C_hardware_interface.h"
 #include "scm3_hardware_interface.h"
@@ -27,6 +28,15 @@ extern unsigned int ASC[38];
 #define crc_value (*((unsigned int*)0x0000FFFC))
 #define code_length (*((unsigned int*)0x0000FFF8))
 
+// number of photodiodes. The first photodiode is on GPIO 8 and captured by the
+// GPIO 8 and 9 interrupts, and the others are on GPIs 10, 11, and 13, which
+// are sampled by lh_sample_gpio in the decoding loop
+#define LH_APP_NUM_SENSORS 1
+
+// GPI bits of the photodiodes
+static const unsigned short lh_sensor_gpio_masks[] = {0x0100, 0x0400, 0x0800,
+                                                      0x2000};
+
 // Target radio LO freq = 2.4025G
 // Divide ratio is currently 480*2
 // Calibration counts for 100ms
@@ -219,6 +229,12 @@ int main(void) {
     ICER = 0xFFFF;
     printf("Cal complete\n");
 
+    // Scale the pulse classifier to the calibrated HF_CLOCK
+    lh_calibrate_pulse_classifier(optical_getHFClockTicksIn100ms());
+
+    // Set up the pulse pipelines of all photodiodes
+    lh_init_sensors(lh_sensor_gpio_masks, LH_APP_NUM_SENSORS);
+
     // run frequency cal sweep
     // test_LC_sweep_tx();
 
@@ -255,8 +271,12 @@ int main(void) {
         imu_measurement.gyro_y.value = -1234;
         imu_measurement.gyro_z.value = 1111;
 
-        // send measurement
+        // send measurement, sampling and decoding the photodiode edges and
+        // sending the finished pose sets while waiting
         for (i = 0; i < 500000; i++) {
+            lh_sample_gpio();
+            lh_process_edges();
+            send_lh_pose_packet();
         }
         send_imu_packet(imu_measurement);
 
@@ -0,0 +1,232 @@
+//-----------------------------------------------------------------------------
+// u-robot Digital Controller Firmware
+//-----------------------------------------------------------------------------
+
+// Fuses the IMU samples and the lighthouse angles of the first photodiode on
+// chip with the pose filter and only transmits the fused state at
+// fused_output_rate_hz instead of one packet per IMU sample and per cycle.
+
+#include <math.h>
+#include <rt_misc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Int_Handlers.h"
+#include "Memory_map.h"
+#include "bucket_o_functions.h"
+#include "lighthouse.h"
+#include "optical.h"
+#include "pose_filter.h"
+#include "rf_global_vars.h"
+#include "scm3C_hardware_interface.h"
+#include "scm3_hardware_interface.h"
+#include "scum_radio_bsp.h"
+#include "spi.h"
+
+extern unsigned int current_lfsr;
+
+extern char send_packet[127];
+extern unsigned int ASC[38];
+
+// Bootloader will insert length and pre-calculated CRC at these memory
+// addresses
+#define crc_value (*((unsigned int*)0x0000FFFC))
+#define code_length (*((unsigned int*)0x0000FFF8))
+
+// code that tells code that its a fused state packet
+#define FUSED_CODE 102
+// length of a fused state packet: code, sequence number, valid angle mask,
+// roll, pitch, yaw, and the lighthouse angles
+#define FUSED_PACKET_LENGTH (3 + 2 * 3 + 2 * POSE_FILTER_NUM_ANGLES)
+
+// Target radio LO freq = 2.4025G
+// Divide ratio is currently 480*2
+// Calibration counts for 100ms
+unsigned int LC_target = 250187;
+unsigned int LC_code = 680;
+
+// HF_CLOCK tuning settings
+unsigned int HF_CLOCK_fine = 17;
+unsigned int HF_CLOCK_coarse = 3;
+
+// RC 2MHz tuning settings
+// This the transmitter chip clock
+unsigned int RC2M_coarse = 21;
+unsigned int RC2M_fine = 15;
+unsigned int RC2M_superfine = 15;
+
+// Receiver clock settings
+// The receiver chip clock is derived from this clock
+unsigned int IF_clk_target = 1600000;
+unsigned int IF_coarse = 22;
+unsigned int IF_fine = 18;
+
+unsigned int cal_iteration = 0;
+unsigned int run_test_flag = 0;
+unsigned int num_packets_to_test = 1;
+
+unsigned short optical_cal_iteration = 0, optical_cal_finished = 0;
+
+unsigned short doing_initial_packet_search;
+unsigned short current_RF_channel;
+unsigned short do_debug_print = 0;
+
+// Variables for lighthouse RX
+unsigned short current_gpio = 0, last_gpio = 0, state = 0, nextstate = 0,
+               pulse_type = 0;
+unsigned int timestamp_rise, timestamp_fall, pulse_width;
+
+// number of fused state packets per second
+unsigned int fused_output_rate_hz = 20;
+
+// sequence number of the next fused state packet
+unsigned char fused_sequence = 0;
+
+// passes the angles of the first photodiode to the pose filter
+void fused_angle_cb(uint8_t sensor, uint8_t index, unsigned short angle,
+                    unsigned int timestamp) {
+    if (sensor == 0) {
+        pose_filter_update_angle(index, angle, timestamp);
+    }
+}
+
+// sends the fused state, LSB first
+void send_fused_packet(const pose_filter_state_t* fused_state) {
+    int i;
+    // enable radio
+    radio_txEnable();
+
+    send_packet[0] = FUSED_CODE;
+    send_packet[1] = fused_sequence++;
+    send_packet[2] = fused_state->valid;
+    send_packet[3] = fused_state->roll & 0xFF;
+    send_packet[4] = (fused_state->roll >> 8) & 0xFF;
+    send_packet[5] = fused_state->pitch & 0xFF;
+    send_packet[6] = (fused_state->pitch >> 8) & 0xFF;
+    send_packet[7] = fused_state->yaw & 0xFF;
+    send_packet[8] = (fused_state->yaw >> 8) & 0xFF;
+    for (i = 0; i < POSE_FILTER_NUM_ANGLES; i++) {
+        send_packet[9 + 2 * i] = fused_state->angles[i] & 0xFF;
+        send_packet[10 + 2 * i] = (fused_state->angles[i] >> 8) & 0xFF;
+    }
+
+    // load packet
+    radio_loadPacket(FUSED_PACKET_LENGTH);
+
+    // set lo frequency
+    LC_FREQCHANGE(23 & 0x1F, 20 & 0x1F, 0 & 0x1F);
+
+    // wait for 1000 loop cycles
+    for (i = 0; i < 1000; i++) {
+    }
+
+    // send packet
+    radio_txNow();
+}
+
+//////////////////////////////////////////////////////////////////
+// Main Function
+//////////////////////////////////////////////////////////////////
+
+int main(void) {
+    unsigned int calc_crc;
+    unsigned int hf_clock_ticks_in_100ms;
+    unsigned int output_period;
+    unsigned int next_output;
+    unsigned int timestamp;
+    pose_filter_config_t pose_filter_config;
+    pose_filter_state_t fused_state;
+    imu_data_t imu_measurement;
+
+    printf("Initializing...");
+
+    // Set up mote configuration
+    // This function handles all the analog scan chain setup
+    // Do not call any other scm3C or scm3 hardware interface functions, they
+    // will mess up the analog scanchain functions This should be independent
+    // of all the random global variable settings
+    initialize_mote_lighthouse();
+
+    // Check CRC to ensure there were no errors during optical programming
+    printf("\n-------------------\n");
+    printf("Validating program integrity...");
+
+    calc_crc = crc32c(0x0000, code_length);
+
+    if (calc_crc == crc_value) {
+        printf("CRC OK\n");
+    } else {
+        printf(
+            "\nProgramming Error - CRC DOES NOT MATCH - Halting Execution\n");
+        while (1) {
+        }
+    }
+
+    // After bootloading the next thing that happens is frequency calibration
+    // using optical
+    printf("Calibrating frequencies...\n");
+
+    // Turn on LO, DIV, PA
+    ANALOG_CFG_REG__10 = 0x78;
+
+    // Turn off polyphase and disable mixer
+    ANALOG_CFG_REG__16 = 0x6;
+
+    // Enable optical SFD interrupt for optical calibration
+    ISER = 0x0800;
+
+    // Wait for optical cal to finish
+    while (optical_cal_finished == 0)
+        ;
+    optical_cal_finished = 0;
+
+    ICER = 0xFFFF;
+    printf("Cal complete\n");
+
+    // Scale the pulse classifier and the filter to the calibrated HF_CLOCK
+    hf_clock_ticks_in_100ms = optical_getHFClockTicksIn100ms();
+    if (hf_clock_ticks_in_100ms == 0) {
+        hf_clock_ticks_in_100ms = LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT;
+    }
+    lh_calibrate_pulse_classifier(hf_clock_ticks_in_100ms);
+    pose_filter_get_default_config(hf_clock_ticks_in_100ms,
+                                   &pose_filter_config);
+    pose_filter_init(&pose_filter_config);
+
+    // Pass the angles to the pose filter instead of sending pose packets
+    lh_set_angle_callback(fused_angle_cb);
+
+    // enable gpio 8 and gpio 9 interrupts (interrupts 1 and 2)
+    ISER = GPIO9_LOW_INT | GPIO8_HIGH_INT;
+
+    // Reset RF Timer count register
+    RFTIMER_REG__COUNTER = 0x0;
+
+    test_imu_life();
+    initialize_imu();
+
+    output_period = hf_clock_ticks_in_100ms * 10 / fused_output_rate_hz;
+    next_output = RFTIMER_REG__COUNTER + output_period;
+
+    // start localization loop
+    while (1) {
+        // predict the state at the IMU rate
+        timestamp = RFTIMER_REG__COUNTER;
+        read_all_imu_data(&imu_measurement);
+        pose_filter_update_imu(&imu_measurement, timestamp);
+
+        // correct the state with the sweeps received in the meantime. Only the
+        // photodiode on the GPIO 8 and 9 interrupts is decoded, since the IMU
+        // reads block for longer than a laser sweep, so lh_sample_gpio would
+        // miss the edges of photodiodes on other GPIs
+        lh_process_edges();
+
+        // send the fused state at the output rate
+        if ((int)(RFTIMER_REG__COUNTER - next_output) >= 0) {
+            pose_filter_get_state(&fused_state);
+            send_fused_packet(&fused_state);
+            next_output += output_period;
+        }
+    }
+}
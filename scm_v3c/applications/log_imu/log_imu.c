@@ -1,7 +1,10 @@
+#include <stdio.h>
 #include <string.h>
 
+#include "imu_sampler.h"
 #include "memory_map.h"
 #include "optical.h"
+#include "rftimer.h"
 #include "scm3c_hw_interface.h"
 #include "spi.h"
 
@@ -10,20 +13,40 @@
 #define CRC_VALUE (*((unsigned int*)0x0000FFFC))
 #define CODE_LENGTH (*((unsigned int*)0x0000FFF8))
 
+// Sample period in RF timer ticks (500 kHz), i.e., 10 Hz.
+#define IMU_SAMPLE_PERIOD 50000
+
+// RF timer compare channel of the IMU sampler.
+#define IMU_SAMPLER_RFTIMER_ID 2
+
+// Number of IMU reads to time for each read method.
+#define IMU_BENCHMARK_NUM_READS 100
+
+// IMU clock, data out, and data in pins, which must match spi.c.
+#define IMU_CLK_PIN 14
+#define IMU_DATA_PIN 12
+#define IMU_DIN_PIN 13
+
 //=========================== variables =======================================
 
 typedef struct {
-    imu_data_t imu_measurement;
+    imu_sampler_sample_t sample;
 } app_vars_t;
 
 app_vars_t app_vars;
 
 //=========================== prototypes ======================================
 
+static void baseline_spi_write(unsigned char write_byte);
+static unsigned char baseline_spi_read(void);
+static unsigned char baseline_read_imu_register(unsigned char reg);
+static unsigned int baseline_read_imu_value(unsigned char reg);
+static void benchmark_imu_reads(void);
+
 //=========================== main ============================================
 
 int main(void) {
-    uint32_t i;
+    imu_sampler_config_t imu_sampler_config;
 
     memset(&app_vars, 0, sizeof(app_vars_t));
 
@@ -46,16 +69,135 @@ int main(void) {
 
     initialize_imu();
     test_imu_life();
+    benchmark_imu_reads();
 
-    while (1) {
-        read_all_imu_data(&app_vars.imu_measurement);
-        log_imu_data(&app_vars.imu_measurement);
+    // Trigger the IMU reads at a fixed rate from the RF timer interrupt.
+    imu_sampler_config.trigger = IMU_SAMPLER_TRIGGER_RFTIMER;
+    imu_sampler_config.period = IMU_SAMPLE_PERIOD;
+    imu_sampler_config.rftimer_id = IMU_SAMPLER_RFTIMER_ID;
+    imu_sampler_start(&imu_sampler_config);
 
-        for (i = 0; i < 100000; i++)
-            ;
+    while (1) {
+        imu_sampler_process();
+        if (imu_sampler_pop(&app_vars.sample)) {
+            printf("%u (+%u): ", app_vars.sample.timestamp,
+                   app_vars.sample.timestamp -
+                       app_vars.sample.trigger_timestamp);
+            log_imu_data(&app_vars.sample.imu_measurement);
+        }
     }
 }
 
 //=========================== public ==========================================
 
 //=========================== private =========================================
+
+// Write a byte with the original bit-banging loop, which reads and modifies
+// the GPIO outputs for every clock edge. This is the baseline of the
+// benchmark.
+static void baseline_spi_write(unsigned char write_byte) {
+    int j;
+
+    for (j = 7; j >= 0; j--) {
+        if ((write_byte & (0x01 << j)) != 0) {
+            GPIO_REG__OUTPUT &= ~(1 << IMU_CLK_PIN);  // clock low
+            GPIO_REG__OUTPUT |= 1 << IMU_DATA_PIN;    // write a 1
+            GPIO_REG__OUTPUT |= 1 << IMU_CLK_PIN;     // clock high
+        } else {
+            GPIO_REG__OUTPUT &= ~(1 << IMU_CLK_PIN);   // clock low
+            GPIO_REG__OUTPUT &= ~(1 << IMU_DATA_PIN);  // write a 0
+            GPIO_REG__OUTPUT |= (1 << IMU_CLK_PIN);    // clock high
+        }
+    }
+
+    GPIO_REG__OUTPUT &= ~(1 << IMU_DATA_PIN);  // set data out to 0
+}
+
+// Read a byte with the original bit-banging loop.
+static unsigned char baseline_spi_read(void) {
+    unsigned char read_byte = 0;
+    int j;
+
+    GPIO_REG__OUTPUT &= ~(1 << IMU_CLK_PIN);  // clock low
+
+    for (j = 7; j >= 0; j--) {
+        GPIO_REG__OUTPUT |= (1 << IMU_CLK_PIN);  // clock high
+        read_byte |= ((GPIO_REG__INPUT & (1 << IMU_DIN_PIN)) >> IMU_DIN_PIN)
+                     << j;
+        GPIO_REG__OUTPUT &= ~(1 << IMU_CLK_PIN);  // clock low
+    }
+
+    // The bit-banged driver expects the clock to idle high.
+    GPIO_REG__OUTPUT |= (1 << IMU_CLK_PIN);
+
+    return read_byte;
+}
+
+// Read a register with the original bit-banging loops.
+static unsigned char baseline_read_imu_register(unsigned char reg) {
+    unsigned char read_byte;
+
+    spi_chip_select();
+    baseline_spi_write((reg & 0x7F) | 0x80);
+    read_byte = baseline_spi_read();
+    spi_chip_deselect();
+
+    return read_byte;
+}
+
+// Read a 16-bit measurement from its MSB and LSB registers with the original
+// bit-banging loops, like read_acc_x().
+static unsigned int baseline_read_imu_value(unsigned char reg) {
+    unsigned int value;
+
+    value = baseline_read_imu_register(reg) << 8;
+    value |= baseline_read_imu_register(reg + 1);
+
+    return value;
+}
+
+// Time reading the IMU one register at a time with the original
+// bit-banging loops, one register at a time with spi_write() and spi_read()
+// on the bit-banged driver, and in one burst transfer.
+static void benchmark_imu_reads(void) {
+    imu_data_t imu_measurement;
+    uint32_t start;
+    uint32_t baseline_ticks;
+    uint32_t register_ticks;
+    uint32_t burst_ticks;
+    uint8_t i;
+
+    start = rftimer_readCounter();
+    for (i = 0; i < IMU_BENCHMARK_NUM_READS; ++i) {
+        imu_measurement.acc_x.value = baseline_read_imu_value(0x2D);
+        imu_measurement.acc_y.value = baseline_read_imu_value(0x2F);
+        imu_measurement.acc_z.value = baseline_read_imu_value(0x31);
+        imu_measurement.gyro_x.value = baseline_read_imu_value(0x33);
+        imu_measurement.gyro_y.value = baseline_read_imu_value(0x35);
+        imu_measurement.gyro_z.value = baseline_read_imu_value(0x37);
+    }
+    baseline_ticks = rftimer_readCounter() - start;
+
+    start = rftimer_readCounter();
+    for (i = 0; i < IMU_BENCHMARK_NUM_READS; ++i) {
+        imu_measurement.acc_x.value = read_acc_x();
+        imu_measurement.acc_y.value = read_acc_y();
+        imu_measurement.acc_z.value = read_acc_z();
+        imu_measurement.gyro_x.value = read_gyro_x();
+        imu_measurement.gyro_y.value = read_gyro_y();
+        imu_measurement.gyro_z.value = read_gyro_z();
+    }
+    register_ticks = rftimer_readCounter() - start;
+
+    start = rftimer_readCounter();
+    for (i = 0; i < IMU_BENCHMARK_NUM_READS; ++i) {
+        read_all_imu_data(&imu_measurement);
+    }
+    burst_ticks = rftimer_readCounter() - start;
+
+    printf("IMU read: %u ticks per baseline register read, ",
+           baseline_ticks / IMU_BENCHMARK_NUM_READS);
+    printf("%u ticks per register read, %u ticks per burst read.\n",
+           register_ticks / IMU_BENCHMARK_NUM_READS,
+           burst_ticks / IMU_BENCHMARK_NUM_READS);
+}
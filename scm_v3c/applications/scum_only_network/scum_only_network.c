@@ -1,5 +1,6 @@
 #include <string.h>
 
+#include "counters.h"
 #include "gpio.h"
 #include "memory_map.h"
 #include "optical.h"
@@ -102,7 +103,7 @@ int main(void) {
 //=========================== private =========================================
 
 void timer_cb(void) {
-    uint32_t rdata_lsb, rdata_msb;
+    counters_snapshot_t counters;
     uint32_t count_LC, count_32k, count_2M, count_HFclock, count_IF;
 
     uint32_t RC2M_coarse;
@@ -115,8 +116,12 @@ void timer_cb(void) {
     rftimer_setCompareIn_by_id(rftimer_readCounter() + RFTIMER_CAL_DURATION,
                                1);  // reset timer
 
-    // Disable all counters
-    ANALOG_CFG_REG__0 = 0x007F;
+    // Read all counters and restart them for the next calibration period
+    counters_read(&counters);
+    count_HFclock = counters.counts[COUNTERS_HF_CLOCK];
+    count_2M = counters.counts[COUNTERS_2M];
+    count_LC = counters.counts[COUNTERS_LC];
+    count_IF = counters.counts[COUNTERS_IF];
 
     RC2M_coarse = scm3c_hw_interface_get_RC2M_coarse();
     RC2M_fine = scm3c_hw_interface_get_RC2M_fine();
@@ -125,35 +130,12 @@ void timer_cb(void) {
     IF_coarse = scm3c_hw_interface_get_IF_coarse();
     IF_fine = scm3c_hw_interface_get_IF_fine();
 
-    // Read HF_CLOCK counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x100000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x140000);
-    count_HFclock = rdata_lsb + (rdata_msb << 16);
-
-    // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    count_2M = rdata_lsb + (rdata_msb << 16);
-
-    // Read LC_div counter (via counter4)
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x280000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x2C0000);
-    count_LC = rdata_lsb + (rdata_msb << 16);
-
-    // Read IF ADC_CLK counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x300000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x340000);
-    count_IF = rdata_lsb + (rdata_msb << 16);
-
-    // Reset all counters
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // Enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
-
     cal_vars.cal_iteration++;
 
     if (cal_vars.cal_iteration > 2) {
+        // Batch all tuning updates into a single scan chain write
+        asc_begin();
+
         // execute calibration on 2M clock
 
         // TOO FAST:
@@ -199,8 +181,7 @@ void timer_cb(void) {
         scm3c_hw_interface_set_IF_coarse(IF_coarse);
         scm3c_hw_interface_set_IF_fine(IF_fine);
 
-        analog_scan_chain_write();
-        analog_scan_chain_load();
+        asc_commit();
 
         // print debug outputs:
         printf("HF=%d   2M=%d-%d,%d,%d   LC=%d   IF=%d-%d\r\n", count_HFclock,
@@ -214,6 +195,6 @@ void timer_cb(void) {
         cal_vars.cal_finished = 1;
 
         // halt all counters:
-        ANALOG_CFG_REG__0 = 0x0000;
+        counters_reset();
     }
 }
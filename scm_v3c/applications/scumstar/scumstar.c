@@ -5,7 +5,8 @@
 #include <string.h>
 
 #include "Memory_Map.h"
-#include "gpio.h"
+#include "counters.h"
+#include "debug_trace.h"
 #include "memory_map.h"
 #include "optical.h"
 #include "radio.h"
@@ -27,6 +28,14 @@
 #define JOINED \
     2  // SENT A JOIN REQ. AND RECEIVED A VALID ACK WITH SCHEDULE INFO!
 
+// === DEBUG TRACE STATES === //
+// state codes on the debug trace state bus, see debug_trace.h
+#define SCUMSTAR_TRACE_IDLE 0       // radio off
+#define SCUMSTAR_TRACE_LISTEN 1     // listening for packets
+#define SCUMSTAR_TRACE_TX 2         // transmitting
+#define SCUMSTAR_TRACE_RX_FRAME 3   // receiving a frame
+#define SCUMSTAR_TRACE_LISTEN_EB 4  // listening in the expected EB window
+
 // === TIME VARIABLES === //
 #define RX_EB_BACKOFF 1000
 // #define RX_EB_BACKOFF					1400
@@ -501,7 +510,7 @@ int main(void) {
     // begin to listen
     radio_rxEnable();
     radio_rxNow();
-    gpio_12_set();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN);
 
     // set timeout/reset timer
     rftimer_setCompareIn_by_id(rftimer_readCounter() + 6000,
@@ -530,14 +539,11 @@ int main(void) {
 void radio_startframe_cb(uint32_t timestamp) {
     // start+enable the IF ADC counter
 
-    // reset all counters:
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
+    // reset and enable all counters:
+    counters_start();
 
     // raise GPIO flag
-    gpio_14_set();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_RX_FRAME);
 }
 
 void radio_rx_cb(uint32_t timestamp) {
@@ -546,8 +552,8 @@ void radio_rx_cb(uint32_t timestamp) {
     uint32_t temp_storage_2;
 
     // stop+disable counters:
-    ANALOG_CFG_REG__0 = 0x007F;
-    gpio_14_clr();
+    counters_stop();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
 
     radio_getReceivedFrame(&(app_vars.packet[0]), &app_vars.packet_len,
                            sizeof(app_vars.packet), &app_vars.rxpk_rssi,
@@ -568,10 +574,7 @@ void radio_rx_cb(uint32_t timestamp) {
             // store IF counter result:
             app_vars.ADC_counter = read_IF_ADC_counter();
 
-            gpio_15_clr();
-            gpio_14_clr();
-            gpio_13_clr();
-            gpio_12_clr();
+            DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
             app_vars.IF_estimate = radio_getIFestimate();
             scumpong_vars.last_EB_received = 1;
 
@@ -582,8 +585,7 @@ void radio_rx_cb(uint32_t timestamp) {
                 tune_fine_codes(app_vars.IF_estimate);
             } else {
                 radio_rfOff();
-                gpio_13_clr();
-                gpio_12_clr();
+                DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
             }
 
             // extract timing information for next EB from packet:
@@ -730,10 +732,7 @@ void radio_rx_cb(uint32_t timestamp) {
                    PACKET_FOR_ME) {  // indicates a packet unicast to me
             if ((scumpong_vars.sync_state == SYNCHED) ||
                 (scumpong_vars.sync_state == JOINED)) {  //
-                gpio_15_clr();
-                gpio_14_clr();
-                gpio_13_clr();
-                gpio_12_clr();
+                DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
             }
             if (((app_vars.packet[4] == 0x00) &&
                  (app_vars.packet[5] ==
@@ -763,8 +762,7 @@ void radio_rx_cb(uint32_t timestamp) {
                     // printf("tx EB at: %d\r\n",
                     // time_sync_vars.tx_EB_timer_from_parent);
                     radio_rfOff();  // turn radio off immediately
-                    gpio_13_clr();
-                    gpio_12_clr();
+                    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
                     printf("JOINED, tx EB at: %d, ded. slot at %d \r\n",
                            time_sync_vars.tx_EB_timer_from_parent,
                            time_sync_vars.tx_dedicated_slot_from_parent);
@@ -791,8 +789,7 @@ void radio_rx_cb(uint32_t timestamp) {
         if (scumpong_vars.sync_state ==
             SYNCHED) {      // if synched - send a join request
             radio_rfOff();  // do not listen forever
-            gpio_13_clr();
-            gpio_12_clr();
+            DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
             if ((ONLY_LISTEN == 0) &&
                 (EB_ONLY == 0)) {  // debug mode - do not send join requests
                 rftimer_setCompareIn_by_id(
@@ -814,8 +811,7 @@ void radio_rx_cb(uint32_t timestamp) {
                               // network, send in my dedicated slot and wait for
                               // response
             radio_rfOff();    // do not listen forever
-            gpio_13_clr();
-            gpio_12_clr();
+            DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
             scumpong_vars.desync_risk = 0;
             if (scumpong_vars.ack_join_request == 1) {
                 rftimer_setCompareIn_by_id(
@@ -852,7 +848,7 @@ void radio_rx_cb(uint32_t timestamp) {
             // keep listening
             radio_rxEnable();
             radio_rxNow();
-            gpio_12_set();
+            DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN);
         }
 
         // debug print: TODO move debug prints into main...
@@ -905,7 +901,7 @@ analog_scan_chain_load();*/
         // CRC miss or packet not for me :)
         radio_rxEnable();
         radio_rxNow();
-        gpio_12_set();
+        DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN);
     }
     memset(app_vars.packet, 0, sizeof(app_vars.packet));
 }
@@ -921,7 +917,6 @@ void test_rf_timer_callback(void) {
         app_vars.IF_on_early = 0;
     } else {
         time_sync_vars.rx_EB_start_reception_time = rftimer_readCounter();
-        gpio_15_set();
 
         if ((scumpong_vars.sync_state == SYNCHED) ||
             (scumpong_vars.sync_state == JOINED)) {
@@ -937,7 +932,7 @@ void test_rf_timer_callback(void) {
         }
         radio_rxEnable();
         radio_rxNow();
-        gpio_12_set();
+        DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN_EB);
     }
 }
 
@@ -1048,7 +1043,7 @@ void transmit_EB_timer_callback(void) {
 
 void transmit_delay_callback(void) {
     radio_txNow();
-    gpio_13_set();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_TX);
 }
 
 void receive_delay_callback(void) {
@@ -1058,7 +1053,7 @@ void receive_delay_callback(void) {
     radio_rxNow();
     rftimer_setCompareIn_by_id(rftimer_readCounter() + 20000,
                                TIMER_CB_RX_TIMEOUT);
-    gpio_12_set();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN);
 
     if (scumpong_vars.future_listen_in_EB == 1) {
         rftimer_setCompareIn_by_id(
@@ -1073,8 +1068,7 @@ void receive_delay_callback(void) {
 
 void rx_timeout_callback(void) {
     radio_rfOff();
-    gpio_13_clr();
-    gpio_12_clr();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
     if (scumpong_vars.in_case_of_EB_miss == 1) {
         scumpong_vars.in_case_of_EB_miss = 0;
     } else if ((scumpong_vars.last_EB_received == 0) &&
@@ -1132,8 +1126,7 @@ void rx_timeout_callback(void) {
 
 void tx_endframe_callback(uint32_t timestamp) {
     radio_rfOff();
-    gpio_13_clr();
-    gpio_12_clr();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
     LC_FREQCHANGE(channel_vars.rx_coarse, channel_vars.rx_mid,
                   channel_vars.rx_fine);
 
@@ -1150,14 +1143,13 @@ void tx_endframe_callback(uint32_t timestamp) {
 void rx_startframe_timeout_callback(void) {
     uint16_t i;
     radio_rfOff();
-    gpio_13_clr();
-    gpio_12_clr();
+    DEBUG_TRACE_STATE(SCUMSTAR_TRACE_IDLE);
     for (i = 0; i < 0xFF; i++)
         ;
     if (scumpong_vars.sync_state == DESYNCHED) {
         radio_rxEnable();
         radio_rxNow();
-        gpio_12_set();
+        DEBUG_TRACE_STATE(SCUMSTAR_TRACE_LISTEN);
     }
     rftimer_setCompareIn_by_id(rftimer_readCounter() + 100000,
                                TIMER_CB_SF_TIMEOUT);
@@ -1210,16 +1202,12 @@ void tune_fine_rx_sync_code(uint32_t IF_estimate) {
 
 uint32_t read_IF_ADC_counter() {
     uint32_t count_IF;
-    uint16_t rdata_lsb;
-    uint16_t rdata_msb;
 
     // Read IF ADC_CLK counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x300000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x340000);
-    count_IF = rdata_lsb + (rdata_msb << 16);
+    count_IF = counters_read_counter(COUNTERS_IF);
 
     // reset counters
-    ANALOG_CFG_REG__0 = 0x0000;
+    counters_reset();
 
     // enable counter
     // ANALOG_CFG_REG__0 = 0x3FFF;
@@ -1229,13 +1217,9 @@ uint32_t read_IF_ADC_counter() {
 }
 uint32_t read_2M_counter() {
     uint32_t count_2M;
-    uint16_t rdata_lsb;
-    uint16_t rdata_msb;
 
     // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    count_2M = rdata_lsb + (rdata_msb << 16);
+    count_2M = counters_read_counter(COUNTERS_2M);
 
     // reset counter
     ANALOG_CFG_REG__0 = 0x0008;
@@ -6,8 +6,23 @@
 #include "adc.h"
 #include "memory_map.h"
 #include "optical.h"
+#include "optical_data.h"
 #include "scm3c_hw_interface.h"
 
+// Conversion period in RF timer ticks. The RF timer runs at 500 kHz, so the
+// ADC converts at 1 kHz.
+#define SENSOR_ADC_CONVERSION_PERIOD 500
+
+// RF timer compare channel that triggers the conversions.
+#define SENSOR_ADC_RFTIMER_ID 1
+
+// The second-order CIC decimator averages 16 conversions into one sample.
+#define SENSOR_ADC_CIC_ORDER 2
+#define SENSOR_ADC_DECIMATION_LOG2 4
+
+// Number of samples to print per line.
+#define SENSOR_ADC_NUM_BATCH_SAMPLES 16
+
 // ADC configuration.
 static const adc_config_t g_adc_config = {
     .reset_source = ADC_RESET_SOURCE_FSM,
@@ -23,6 +38,17 @@ static const adc_config_t g_adc_config = {
     .pga_bypass = true,
 };
 
+// ADC stream configuration.
+static const adc_stream_config_t g_adc_stream_config = {
+    .period = SENSOR_ADC_CONVERSION_PERIOD,
+    .rftimer_id = SENSOR_ADC_RFTIMER_ID,
+    .cic_order = SENSOR_ADC_CIC_ORDER,
+    .decimation_log2 = SENSOR_ADC_DECIMATION_LOG2,
+};
+
+// Batch of samples to print.
+static adc_stream_sample_t g_samples[SENSOR_ADC_NUM_BATCH_SAMPLES];
+
 int main(void) {
     initialize_mote();
 
@@ -37,19 +63,33 @@ int main(void) {
     crc_check();
     perform_calibration();
 
+    // Receive calibration and patch updates over the optical data channel.
+    optical_data_init();
+
+    // Stream the ADC conversions from the RF timer interrupt.
+    printf("Starting the ADC stream.\n");
+    if (!adc_stream_start(&g_adc_stream_config)) {
+        printf("Failed to start the ADC stream.\n");
+        return -1;
+    }
+
     while (true) {
-        // Trigger an ADC read.
-        printf("Triggering ADC.\n");
-        adc_trigger();
-        while (!g_adc_output.valid) {
+        optical_data_process();
+
+        // Print the samples in batches, so that the UART does not limit the
+        // sample rate.
+        if (adc_stream_num_samples() < SENSOR_ADC_NUM_BATCH_SAMPLES) {
+            continue;
         }
-        if (!g_adc_output.valid) {
-            printf("ADC output should be valid.\n");
+        for (size_t i = 0; i < SENSOR_ADC_NUM_BATCH_SAMPLES; ++i) {
+            adc_stream_pop(&g_samples[i]);
         }
-        printf("ADC output: %u\n", g_adc_output.data);
 
-        // Wait a bit.
-        for (uint32_t i = 0; i < 1000000; ++i) {
+        printf("%u (%u dropped):", g_samples[0].timestamp,
+               adc_stream_get_num_dropped());
+        for (size_t i = 0; i < SENSOR_ADC_NUM_BATCH_SAMPLES; ++i) {
+            printf(" %u", g_samples[i].data);
         }
+        printf("\n");
     }
 }
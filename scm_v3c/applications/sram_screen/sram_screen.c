@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "memory_map.h"
+#include "scm3c_hw_interface.h"
+#include "sram_march.h"
+
+//=========================== defines =========================================
+
+//=========================== variables =======================================
+
+typedef struct {
+    // Free data memory range to test.
+    sram_march_range_t range;
+
+    // Result of each march algorithm.
+    sram_march_result_t results[SRAM_MARCH_NUM_ALGORITHMS];
+
+    // Whether all march algorithms passed.
+    bool passed;
+} app_vars_t;
+
+app_vars_t app_vars;
+
+//=========================== prototypes ======================================
+
+void run_screen(void);
+
+//=========================== main ============================================
+
+int main(void) {
+    memset(&app_vars, 0, sizeof(app_vars_t));
+
+    printf("Initializing...");
+
+    initialize_mote();
+    crc_check();
+
+    run_screen();
+
+    while (1)
+        ;
+}
+
+//=========================== public ==========================================
+
+//=========================== private =========================================
+
+void run_screen(void) {
+    sram_march_algorithm_e algorithm;
+
+    sram_march_get_free_range(&app_vars.range);
+    printf("Testing SRAM from 0x%08X to 0x%08X\n",
+           (uint32_t)app_vars.range.start, (uint32_t)app_vars.range.end);
+
+    app_vars.passed = true;
+    for (algorithm = SRAM_MARCH_C_MINUS; algorithm < SRAM_MARCH_NUM_ALGORITHMS;
+         ++algorithm) {
+        if (!sram_march_run(algorithm, &app_vars.range, 1,
+                            SRAM_MARCH_NUM_BACKGROUNDS,
+                            &app_vars.results[algorithm])) {
+            app_vars.passed = false;
+        }
+        sram_march_print_result(algorithm, &app_vars.results[algorithm]);
+    }
+
+    printf("SRAM screen %s\n", app_vars.passed ? "PASSED" : "FAILED");
+}
@@ -0,0 +1,136 @@
+// This application keeps the LC, 2 MHz RC, and IF clock codes compensated
+// over temperature after performing calibration. The temperature
+// compensation table is taught by repeating the optical calibration at
+// different temperatures over the UART shell. The temperature is measured by
+// the health monitor, and the updates back off when the supply sags.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "health_monitor.h"
+#include "memory_map.h"
+#include "optical.h"
+#include "optical_data.h"
+#include "scm3c_hw_interface.h"
+#include "shell.h"
+#include "temp_comp.h"
+
+// Period of the temperature compensation updates in RF timer ticks. The RF
+// timer runs at 500 kHz, so the codes are updated every second. The period is
+// stretched by the health monitor when the supply is low.
+#define TEMP_COMP_CAL_UPDATE_PERIOD 500000
+
+// Number of LC codes in the LC table.
+#define TEMP_COMP_CAL_LC_TABLE_NUM_CODES 512
+
+// The LC table spans the coarse codes around the RX LO frequency of channel
+// 11, so that the LC codes are linear in frequency for the temperature
+// compensation.
+static const tuning_sweep_config_t g_lc_table_sweep_config = {
+    .coarse = {.start = 22, .end = 24},
+    .mid = {.start = TUNING_MIN_CODE, .end = TUNING_MAX_CODE},
+    .fine = {.start = TUNING_MIN_CODE, .end = TUNING_MAX_CODE},
+};
+
+// RF timer count of the next temperature compensation update.
+static uint32_t g_next_update = 0;
+
+// Get the currently applied codes.
+static void temp_comp_cal_get_codes(temp_comp_codes_t* codes) {
+    codes->codes[TEMP_COMP_CODE_LC] = optical_getLCCode();
+    codes->codes[TEMP_COMP_CODE_RC2M_FINE] =
+        scm3c_hw_interface_get_RC2M_fine();
+    codes->codes[TEMP_COMP_CODE_IF_FINE] = scm3c_hw_interface_get_IF_fine();
+}
+
+// Repeat the optical calibration and learn the calibrated codes at the current
+// temperature.
+static bool temp_comp_cal_recalibrate(const uint8_t argc, const char* argv[]) {
+    // Measure the temperature before the calibration, which changes the codes
+    // that the temperature estimate depends on.
+    const uint32_t temperature = temp_comp_measure_temperature();
+    temp_comp_codes_t codes;
+
+    perform_calibration();
+    temp_comp_cal_get_codes(&codes);
+    temp_comp_learn(temperature, &codes);
+    return true;
+}
+
+// Print the temperature compensation table.
+static bool temp_comp_cal_print(const uint8_t argc, const char* argv[]) {
+    temp_comp_print_table();
+    return true;
+}
+
+// Print the temperature estimate, the applied codes, and the supply.
+static void temp_comp_cal_print_status(void) {
+    const temp_comp_codes_t* codes = temp_comp_get_applied_codes();
+
+    printf("T=%u LC=%d RC2M=%d IF=%d\n", temp_comp_measure_temperature(),
+           codes->codes[TEMP_COMP_CODE_LC],
+           codes->codes[TEMP_COMP_CODE_RC2M_FINE],
+           codes->codes[TEMP_COMP_CODE_IF_FINE]);
+    printf("VBAT=%d mV supply=%d\n", health_monitor_get_battery_voltage(),
+           health_monitor_get_supply_state());
+    optical_data_print_stats();
+}
+
+// Shell actions.
+static const shell_action_t g_recalibrate_action = {
+    "recal", "recal", temp_comp_cal_recalibrate};
+static const shell_action_t g_print_action = {"table", "table",
+                                              temp_comp_cal_print};
+
+int main(void) {
+    health_monitor_config_t health_monitor_config;
+    temp_comp_codes_t reference;
+
+    initialize_mote();
+    crc_check();
+    optical_set_lc_table_sweep(&g_lc_table_sweep_config,
+                               TEMP_COMP_CAL_LC_TABLE_NUM_CODES);
+    perform_calibration();
+
+    // Measure the temperature with the health monitor, which is not affected
+    // by the 2 MHz RC code. If the ADC fails, fall back to the 2 MHz RC and
+    // 32 kHz counter ratio.
+    health_monitor_get_default_config(&health_monitor_config);
+    if (health_monitor_init(&health_monitor_config)) {
+        temp_comp_set_temperature_source(
+            health_monitor_get_temperature_millikelvin);
+    } else {
+        printf("Health monitor failed.\n");
+    }
+
+    // The calibrated codes are the reference codes at the current temperature.
+    temp_comp_cal_get_codes(&reference);
+    temp_comp_init(&reference);
+
+    // Receive calibration and patch updates over the optical data channel.
+    optical_data_init();
+
+    shell_init();
+    shell_register_action(&g_recalibrate_action);
+    shell_register_action(&g_print_action);
+    shell_set_status_callback(temp_comp_cal_print_status);
+
+    printf("Starting the temperature compensation.\n");
+    g_next_update = RFTIMER_REG__COUNTER + TEMP_COMP_CAL_UPDATE_PERIOD;
+    while (true) {
+        shell_process();
+        optical_data_process();
+        health_monitor_update();
+
+        if ((int32_t)(RFTIMER_REG__COUNTER - g_next_update) < 0) {
+            continue;
+        }
+        g_next_update +=
+            health_monitor_scale_interval(TEMP_COMP_CAL_UPDATE_PERIOD);
+        if (temp_comp_update()) {
+            temp_comp_cal_print_status();
+        }
+    }
+}
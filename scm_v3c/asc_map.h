@@ -0,0 +1,1447 @@
+// Analog scan chain field map for scm3c.
+//
+// Generated by scripts/gen_asc_map.py from asc_map_scm3c.json. Do not edit.
+//
+// Each field has a setter and a getter operating on the ASC image,
+// e.g., asc_map_set_if_rc_coarse(asc, 22). Bits that are stored
+// inverted on-chip are inverted by the accessors.
+
+#ifndef __ASC_MAP_H
+#define __ASC_MAP_H
+
+#include <stdint.h>
+
+// Number of bits in the analog scan chain.
+#define ASC_MAP_LENGTH 1216
+
+// Counter reset and enable source select, 1 = analog_cfg control.
+// ASC<2:8> (MSB first).
+#define ASC_MAP_COUNTER_ANALOG_CFG_SELECT_WIDTH 7
+
+static inline void asc_map_set_counter_analog_cfg_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[0] = (asc[0] & ~0x3F800000u) | ((v & 0x7Fu) << 23);
+}
+
+static inline uint32_t asc_map_get_counter_analog_cfg_select(
+    const uint32_t* asc) {
+    return ((asc[0] & 0x3F800000u) >> 23);
+}
+
+// Chip clock divider passthrough, 1 = passthrough.
+// ASC<41> (MSB first).
+#define ASC_MAP_CHIP_CLK_DIVIDER_PASSTHROUGH_WIDTH 1
+
+static inline void asc_map_set_chip_clk_divider_passthrough(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[1] = (asc[1] & ~0x00400000u) | ((v & 0x1u) << 22);
+}
+
+static inline uint32_t asc_map_get_chip_clk_divider_passthrough(
+    const uint32_t* asc) {
+    return ((asc[1] & 0x400000u) >> 22);
+}
+
+// RF timer clock divide value.
+// ASC<49:42> (MSB first), inverted.
+#define ASC_MAP_RFTIMER_DIVIDER_WIDTH 8
+
+static inline void asc_map_set_rftimer_divider(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0xFFu;
+    asc[1] = (asc[1] & ~0x003FC000u) |
+             ((v & 0x80u) << 7) |
+             ((v & 0x40u) << 9) |
+             ((v & 0x20u) << 11) |
+             ((v & 0x10u) << 13) |
+             ((v & 0x8u) << 15) |
+             ((v & 0x4u) << 17) |
+             ((v & 0x2u) << 19) |
+             ((v & 0x1u) << 21);
+}
+
+static inline uint32_t asc_map_get_rftimer_divider(const uint32_t* asc) {
+    return (((asc[1] & 0x4000u) >> 7) |
+            ((asc[1] & 0x8000u) >> 9) |
+            ((asc[1] & 0x10000u) >> 11) |
+            ((asc[1] & 0x20000u) >> 13) |
+            ((asc[1] & 0x40000u) >> 15) |
+            ((asc[1] & 0x80000u) >> 17) |
+            ((asc[1] & 0x100000u) >> 19) |
+            ((asc[1] & 0x200000u) >> 21)) ^ 0xFFu;
+}
+
+// GPO row 1 bank select.
+// ASC<248:245> (MSB first).
+#define ASC_MAP_GPO_ROW1_SELECT_WIDTH 4
+
+static inline void asc_map_set_gpo_row1_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00000780u) |
+             ((v & 0x8u) << 4) |
+             ((v & 0x4u) << 6) |
+             ((v & 0x2u) << 8) |
+             ((v & 0x1u) << 10);
+}
+
+static inline uint32_t asc_map_get_gpo_row1_select(const uint32_t* asc) {
+    return ((asc[7] & 0x80u) >> 4) |
+           ((asc[7] & 0x100u) >> 6) |
+           ((asc[7] & 0x200u) >> 8) |
+           ((asc[7] & 0x400u) >> 10);
+}
+
+// GPO row 2 bank select.
+// ASC<252:249> (MSB first).
+#define ASC_MAP_GPO_ROW2_SELECT_WIDTH 4
+
+static inline void asc_map_set_gpo_row2_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00000078u) |
+             (v & 0x8u) |
+             ((v & 0x4u) << 2) |
+             ((v & 0x2u) << 4) |
+             ((v & 0x1u) << 6);
+}
+
+static inline uint32_t asc_map_get_gpo_row2_select(const uint32_t* asc) {
+    return (asc[7] & 0x8u) |
+           ((asc[7] & 0x10u) >> 2) |
+           ((asc[7] & 0x20u) >> 4) |
+           ((asc[7] & 0x40u) >> 6);
+}
+
+// GPO row 3 bank select.
+// ASC<256:253> (MSB first).
+#define ASC_MAP_GPO_ROW3_SELECT_WIDTH 4
+
+static inline void asc_map_set_gpo_row3_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00000007u) |
+             ((v & 0x4u) >> 2) |
+             (v & 0x2u) |
+             ((v & 0x1u) << 2);
+    asc[8] = (asc[8] & ~0x80000000u) | ((v & 0x8u) << 28);
+}
+
+static inline uint32_t asc_map_get_gpo_row3_select(const uint32_t* asc) {
+    return ((asc[7] & 0x1u) << 2) |
+           (asc[7] & 0x2u) |
+           ((asc[7] & 0x4u) >> 2) |
+           ((asc[8] & 0x80000000u) >> 28);
+}
+
+// GPO row 4 bank select.
+// ASC<260:257> (MSB first).
+#define ASC_MAP_GPO_ROW4_SELECT_WIDTH 4
+
+static inline void asc_map_set_gpo_row4_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x78000000u) |
+             ((v & 0x8u) << 24) |
+             ((v & 0x4u) << 26) |
+             ((v & 0x2u) << 28) |
+             ((v & 0x1u) << 30);
+}
+
+static inline uint32_t asc_map_get_gpo_row4_select(const uint32_t* asc) {
+    return ((asc[8] & 0x8000000u) >> 24) |
+           ((asc[8] & 0x10000000u) >> 26) |
+           ((asc[8] & 0x20000000u) >> 28) |
+           ((asc[8] & 0x40000000u) >> 30);
+}
+
+// GPI row 1 bank select.
+// ASC<262:261> (MSB first).
+#define ASC_MAP_GPI_ROW1_SELECT_WIDTH 2
+
+static inline void asc_map_set_gpi_row1_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x06000000u) | ((v & 0x2u) << 24) | ((v & 0x1u) << 26);
+}
+
+static inline uint32_t asc_map_get_gpi_row1_select(const uint32_t* asc) {
+    return ((asc[8] & 0x2000000u) >> 24) | ((asc[8] & 0x4000000u) >> 26);
+}
+
+// GPI row 2 bank select.
+// ASC<264:263> (MSB first).
+#define ASC_MAP_GPI_ROW2_SELECT_WIDTH 2
+
+static inline void asc_map_set_gpi_row2_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x01800000u) | ((v & 0x2u) << 22) | ((v & 0x1u) << 24);
+}
+
+static inline uint32_t asc_map_get_gpi_row2_select(const uint32_t* asc) {
+    return ((asc[8] & 0x800000u) >> 22) | ((asc[8] & 0x1000000u) >> 24);
+}
+
+// GPI row 3 bank select.
+// ASC<266:265> (MSB first).
+#define ASC_MAP_GPI_ROW3_SELECT_WIDTH 2
+
+static inline void asc_map_set_gpi_row3_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x00600000u) | ((v & 0x2u) << 20) | ((v & 0x1u) << 22);
+}
+
+static inline uint32_t asc_map_get_gpi_row3_select(const uint32_t* asc) {
+    return ((asc[8] & 0x200000u) >> 20) | ((asc[8] & 0x400000u) >> 22);
+}
+
+// GPI row 4 bank select.
+// ASC<268:267> (MSB first).
+#define ASC_MAP_GPI_ROW4_SELECT_WIDTH 2
+
+static inline void asc_map_set_gpi_row4_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x00180000u) | ((v & 0x2u) << 18) | ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_gpi_row4_select(const uint32_t* asc) {
+    return ((asc[8] & 0x80000u) >> 18) | ((asc[8] & 0x100000u) >> 20);
+}
+
+// ZCC demodulator counter threshold.
+// ASC<122:107> (MSB first).
+#define ASC_MAP_ZCC_DEMOD_THRESHOLD_WIDTH 16
+
+static inline void asc_map_set_zcc_demod_threshold(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[3] = (asc[3] & ~0x001FFFE0u) |
+             ((v & 0x8000u) >> 10) |
+             ((v & 0x4000u) >> 8) |
+             ((v & 0x2000u) >> 6) |
+             ((v & 0x1000u) >> 4) |
+             ((v & 0x800u) >> 2) |
+             (v & 0x400u) |
+             ((v & 0x200u) << 2) |
+             ((v & 0x100u) << 4) |
+             ((v & 0x80u) << 6) |
+             ((v & 0x40u) << 8) |
+             ((v & 0x20u) << 10) |
+             ((v & 0x10u) << 12) |
+             ((v & 0x8u) << 14) |
+             ((v & 0x4u) << 16) |
+             ((v & 0x2u) << 18) |
+             ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_zcc_demod_threshold(const uint32_t* asc) {
+    return ((asc[3] & 0x20u) << 10) |
+           ((asc[3] & 0x40u) << 8) |
+           ((asc[3] & 0x80u) << 6) |
+           ((asc[3] & 0x100u) << 4) |
+           ((asc[3] & 0x200u) << 2) |
+           (asc[3] & 0x400u) |
+           ((asc[3] & 0x800u) >> 2) |
+           ((asc[3] & 0x1000u) >> 4) |
+           ((asc[3] & 0x2000u) >> 6) |
+           ((asc[3] & 0x4000u) >> 8) |
+           ((asc[3] & 0x8000u) >> 10) |
+           ((asc[3] & 0x10000u) >> 12) |
+           ((asc[3] & 0x20000u) >> 14) |
+           ((asc[3] & 0x40000u) >> 16) |
+           ((asc[3] & 0x80000u) >> 18) |
+           ((asc[3] & 0x100000u) >> 20);
+}
+
+// ZCC demodulator clock divider, IF clock rate / 2 MHz.
+// ASC<131:124> (MSB first).
+#define ASC_MAP_ZCC_CLK_DIV_WIDTH 8
+
+static inline void asc_map_set_zcc_clk_div(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[3] = (asc[3] & ~0x0000000Fu) |
+             ((v & 0x8u) >> 3) |
+             ((v & 0x4u) >> 1) |
+             ((v & 0x2u) << 1) |
+             ((v & 0x1u) << 3);
+    asc[4] = (asc[4] & ~0xF0000000u) |
+             ((v & 0x80u) << 21) |
+             ((v & 0x40u) << 23) |
+             ((v & 0x20u) << 25) |
+             ((v & 0x10u) << 27);
+}
+
+static inline uint32_t asc_map_get_zcc_clk_div(const uint32_t* asc) {
+    return ((asc[3] & 0x1u) << 3) |
+           ((asc[3] & 0x2u) << 1) |
+           ((asc[3] & 0x4u) >> 1) |
+           ((asc[3] & 0x8u) >> 3) |
+           ((asc[4] & 0x10000000u) >> 21) |
+           ((asc[4] & 0x20000000u) >> 23) |
+           ((asc[4] & 0x40000000u) >> 25) |
+           ((asc[4] & 0x80000000u) >> 27);
+}
+
+// ZCC demodulator early decision margin.
+// ASC<224:209> (MSB first).
+#define ASC_MAP_ZCC_EARLY_DECISION_MARGIN_WIDTH 16
+
+static inline void asc_map_set_zcc_early_decision_margin(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[6] = (asc[6] & ~0x00007FFFu) |
+             ((v & 0x4000u) >> 14) |
+             ((v & 0x2000u) >> 12) |
+             ((v & 0x1000u) >> 10) |
+             ((v & 0x800u) >> 8) |
+             ((v & 0x400u) >> 6) |
+             ((v & 0x200u) >> 4) |
+             ((v & 0x100u) >> 2) |
+             (v & 0x80u) |
+             ((v & 0x40u) << 2) |
+             ((v & 0x20u) << 4) |
+             ((v & 0x10u) << 6) |
+             ((v & 0x8u) << 8) |
+             ((v & 0x4u) << 10) |
+             ((v & 0x2u) << 12) |
+             ((v & 0x1u) << 14);
+    asc[7] = (asc[7] & ~0x80000000u) | ((v & 0x8000u) << 16);
+}
+
+static inline uint32_t asc_map_get_zcc_early_decision_margin(
+    const uint32_t* asc) {
+    return ((asc[6] & 0x1u) << 14) |
+           ((asc[6] & 0x2u) << 12) |
+           ((asc[6] & 0x4u) << 10) |
+           ((asc[6] & 0x8u) << 8) |
+           ((asc[6] & 0x10u) << 6) |
+           ((asc[6] & 0x20u) << 4) |
+           ((asc[6] & 0x40u) << 2) |
+           (asc[6] & 0x80u) |
+           ((asc[6] & 0x100u) >> 2) |
+           ((asc[6] & 0x200u) >> 4) |
+           ((asc[6] & 0x400u) >> 6) |
+           ((asc[6] & 0x800u) >> 8) |
+           ((asc[6] & 0x1000u) >> 10) |
+           ((asc[6] & 0x2000u) >> 12) |
+           ((asc[6] & 0x4000u) >> 14) |
+           ((asc[7] & 0x80000000u) >> 16);
+}
+
+// ADC reset signal source, 0 = FSM, 1 = GPI.
+// ASC<242> (MSB first).
+#define ASC_MAP_ADC_RESET_SOURCE_WIDTH 1
+
+static inline void asc_map_set_adc_reset_source(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00002000u) | ((v & 0x1u) << 13);
+}
+
+static inline uint32_t asc_map_get_adc_reset_source(const uint32_t* asc) {
+    return ((asc[7] & 0x2000u) >> 13);
+}
+
+// ADC convert signal source, 0 = FSM, 1 = GPI.
+// ASC<243> (MSB first).
+#define ASC_MAP_ADC_CONVERT_SOURCE_WIDTH 1
+
+static inline void asc_map_set_adc_convert_source(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00001000u) | ((v & 0x1u) << 12);
+}
+
+static inline uint32_t asc_map_get_adc_convert_source(const uint32_t* asc) {
+    return ((asc[7] & 0x1000u) >> 12);
+}
+
+// PGA amplify signal source, 0 = FSM, 1 = GPI.
+// ASC<244> (MSB first).
+#define ASC_MAP_ADC_PGA_AMPLIFY_SOURCE_WIDTH 1
+
+static inline void asc_map_set_adc_pga_amplify_source(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[7] = (asc[7] & ~0x00000800u) | ((v & 0x1u) << 11);
+}
+
+static inline uint32_t asc_map_get_adc_pga_amplify_source(const uint32_t* asc) {
+    return ((asc[7] & 0x800u) >> 11);
+}
+
+// IF Q channel gain code, binary weighted.
+// ASC<272:277> (MSB first).
+#define ASC_MAP_IF_Q_GAIN_WIDTH 6
+
+static inline void asc_map_set_if_q_gain(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[8] = (asc[8] & ~0x0000FC00u) | ((v & 0x3Fu) << 10);
+}
+
+static inline uint32_t asc_map_get_if_q_gain(const uint32_t* asc) {
+    return ((asc[8] & 0xFC00u) >> 10);
+}
+
+// IF mixer wells, 1 = hi-Z for TX, 0 = enabled.
+// ASC<298, 307> (MSB first).
+#define ASC_MAP_IF_MIXER_DISABLE_WIDTH 2
+
+static inline void asc_map_set_if_mixer_disable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[9] = (asc[9] & ~0x00201000u) | ((v & 0x1u) << 12) | ((v & 0x2u) << 20);
+}
+
+static inline uint32_t asc_map_get_if_mixer_disable(const uint32_t* asc) {
+    return ((asc[9] & 0x1000u) >> 12) | ((asc[9] & 0x200000u) >> 20);
+}
+
+// IF Q channel comparator P side offset trim.
+// ASC<335:339> (MSB first).
+#define ASC_MAP_IF_Q_COMPARATOR_PTRIM_WIDTH 5
+
+static inline void asc_map_set_if_q_comparator_ptrim(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[10] = (asc[10] & ~0x0001F000u) | ((v & 0x1Fu) << 12);
+}
+
+static inline uint32_t asc_map_get_if_q_comparator_ptrim(const uint32_t* asc) {
+    return ((asc[10] & 0x1F000u) >> 12);
+}
+
+// IF Q channel comparator N side offset trim.
+// ASC<340:344> (MSB first).
+#define ASC_MAP_IF_Q_COMPARATOR_NTRIM_WIDTH 5
+
+static inline void asc_map_set_if_q_comparator_ntrim(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[10] = (asc[10] & ~0x00000F80u) | ((v & 0x1Fu) << 7);
+}
+
+static inline uint32_t asc_map_get_if_q_comparator_ntrim(const uint32_t* asc) {
+    return ((asc[10] & 0xF80u) >> 7);
+}
+
+// IF RC oscillator coarse tuning, binary weighted.
+// ASC<427:431> (MSB first).
+#define ASC_MAP_IF_RC_COARSE_WIDTH 5
+
+static inline void asc_map_set_if_rc_coarse(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[13] = (asc[13] & ~0x001F0000u) | ((v & 0x1Fu) << 16);
+}
+
+static inline uint32_t asc_map_get_if_rc_coarse(const uint32_t* asc) {
+    return ((asc[13] & 0x1F0000u) >> 16);
+}
+
+// IF RC oscillator fine tuning, binary weighted.
+// ASC<433:437> (MSB first).
+#define ASC_MAP_IF_RC_FINE_WIDTH 5
+
+static inline void asc_map_set_if_rc_fine(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[13] = (asc[13] & ~0x00007C00u) | ((v & 0x1Fu) << 10);
+}
+
+static inline uint32_t asc_map_get_if_rc_fine(const uint32_t* asc) {
+    return ((asc[13] & 0x7C00u) >> 10);
+}
+
+// IF I channel comparator N side offset trim.
+// ASC<456:452> (MSB first).
+#define ASC_MAP_IF_I_COMPARATOR_NTRIM_WIDTH 5
+
+static inline void asc_map_set_if_i_comparator_ntrim(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[14] = (asc[14] & ~0x0F800000u) |
+              ((v & 0x10u) << 19) |
+              ((v & 0x8u) << 21) |
+              ((v & 0x4u) << 23) |
+              ((v & 0x2u) << 25) |
+              ((v & 0x1u) << 27);
+}
+
+static inline uint32_t asc_map_get_if_i_comparator_ntrim(const uint32_t* asc) {
+    return ((asc[14] & 0x800000u) >> 19) |
+           ((asc[14] & 0x1000000u) >> 21) |
+           ((asc[14] & 0x2000000u) >> 23) |
+           ((asc[14] & 0x4000000u) >> 25) |
+           ((asc[14] & 0x8000000u) >> 27);
+}
+
+// IF I channel comparator P side offset trim.
+// ASC<461:457> (MSB first).
+#define ASC_MAP_IF_I_COMPARATOR_PTRIM_WIDTH 5
+
+static inline void asc_map_set_if_i_comparator_ptrim(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[14] = (asc[14] & ~0x007C0000u) |
+              ((v & 0x10u) << 14) |
+              ((v & 0x8u) << 16) |
+              ((v & 0x4u) << 18) |
+              ((v & 0x2u) << 20) |
+              ((v & 0x1u) << 22);
+}
+
+static inline uint32_t asc_map_get_if_i_comparator_ptrim(const uint32_t* asc) {
+    return ((asc[14] & 0x40000u) >> 14) |
+           ((asc[14] & 0x80000u) >> 16) |
+           ((asc[14] & 0x100000u) >> 18) |
+           ((asc[14] & 0x200000u) >> 20) |
+           ((asc[14] & 0x400000u) >> 22);
+}
+
+// IF I channel gain code, binary weighted.
+// ASC<490:485> (MSB first).
+#define ASC_MAP_IF_I_GAIN_WIDTH 6
+
+static inline void asc_map_set_if_i_gain(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x07E00000u) |
+              ((v & 0x20u) << 16) |
+              ((v & 0x10u) << 18) |
+              ((v & 0x8u) << 20) |
+              ((v & 0x4u) << 22) |
+              ((v & 0x2u) << 24) |
+              ((v & 0x1u) << 26);
+}
+
+static inline uint32_t asc_map_get_if_i_gain(const uint32_t* asc) {
+    return ((asc[15] & 0x200000u) >> 16) |
+           ((asc[15] & 0x400000u) >> 18) |
+           ((asc[15] & 0x800000u) >> 20) |
+           ((asc[15] & 0x1000000u) >> 22) |
+           ((asc[15] & 0x2000000u) >> 24) |
+           ((asc[15] & 0x4000000u) >> 26);
+}
+
+// IF LDO reference voltage.
+// ASC<498:492> (MSB first).
+#define ASC_MAP_IF_LDO_RDAC_WIDTH 7
+
+static inline void asc_map_set_if_ldo_rdac(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x000FE000u) |
+              ((v & 0x40u) << 7) |
+              ((v & 0x20u) << 9) |
+              ((v & 0x10u) << 11) |
+              ((v & 0x8u) << 13) |
+              ((v & 0x4u) << 15) |
+              ((v & 0x2u) << 17) |
+              ((v & 0x1u) << 19);
+}
+
+static inline uint32_t asc_map_get_if_ldo_rdac(const uint32_t* asc) {
+    return ((asc[15] & 0x2000u) >> 7) |
+           ((asc[15] & 0x4000u) >> 9) |
+           ((asc[15] & 0x8000u) >> 11) |
+           ((asc[15] & 0x10000u) >> 13) |
+           ((asc[15] & 0x20000u) >> 15) |
+           ((asc[15] & 0x40000u) >> 17) |
+           ((asc[15] & 0x80000u) >> 19);
+}
+
+// Turn on the IF LDO via the scan chain.
+// ASC<501> (MSB first).
+#define ASC_MAP_SCAN_PON_IF_WIDTH 1
+
+static inline void asc_map_set_scan_pon_if(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000400u) | ((v & 0x1u) << 10);
+}
+
+static inline uint32_t asc_map_get_scan_pon_if(const uint32_t* asc) {
+    return ((asc[15] & 0x400u) >> 10);
+}
+
+// Turn on the LO LDO via the scan chain.
+// ASC<502> (MSB first).
+#define ASC_MAP_SCAN_PON_LO_WIDTH 1
+
+static inline void asc_map_set_scan_pon_lo(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000200u) | ((v & 0x1u) << 9);
+}
+
+static inline uint32_t asc_map_get_scan_pon_lo(const uint32_t* asc) {
+    return ((asc[15] & 0x200u) >> 9);
+}
+
+// Turn on the PA LDO via the scan chain.
+// ASC<503> (MSB first).
+#define ASC_MAP_SCAN_PON_PA_WIDTH 1
+
+static inline void asc_map_set_scan_pon_pa(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000100u) | ((v & 0x1u) << 8);
+}
+
+static inline uint32_t asc_map_get_scan_pon_pa(const uint32_t* asc) {
+    return ((asc[15] & 0x100u) >> 8);
+}
+
+// Allow the GPIO bank to turn on the IF LDO.
+// ASC<504> (MSB first).
+#define ASC_MAP_GPIO_PON_EN_IF_WIDTH 1
+
+static inline void asc_map_set_gpio_pon_en_if(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000080u) | ((v & 0x1u) << 7);
+}
+
+static inline uint32_t asc_map_get_gpio_pon_en_if(const uint32_t* asc) {
+    return ((asc[15] & 0x80u) >> 7);
+}
+
+// Allow the radio FSM to turn on the IF LDO.
+// ASC<505> (MSB first).
+#define ASC_MAP_FSM_PON_EN_IF_WIDTH 1
+
+static inline void asc_map_set_fsm_pon_en_if(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000040u) | ((v & 0x1u) << 6);
+}
+
+static inline uint32_t asc_map_get_fsm_pon_en_if(const uint32_t* asc) {
+    return ((asc[15] & 0x40u) >> 6);
+}
+
+// Allow the GPIO bank to turn on the LO LDO.
+// ASC<506> (MSB first).
+#define ASC_MAP_GPIO_PON_EN_LO_WIDTH 1
+
+static inline void asc_map_set_gpio_pon_en_lo(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000020u) | ((v & 0x1u) << 5);
+}
+
+static inline uint32_t asc_map_get_gpio_pon_en_lo(const uint32_t* asc) {
+    return ((asc[15] & 0x20u) >> 5);
+}
+
+// Allow the radio FSM to turn on the LO LDO.
+// ASC<507> (MSB first).
+#define ASC_MAP_FSM_PON_EN_LO_WIDTH 1
+
+static inline void asc_map_set_fsm_pon_en_lo(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000010u) | ((v & 0x1u) << 4);
+}
+
+static inline uint32_t asc_map_get_fsm_pon_en_lo(const uint32_t* asc) {
+    return ((asc[15] & 0x10u) >> 4);
+}
+
+// Allow the GPIO bank to turn on the PA LDO.
+// ASC<508> (MSB first).
+#define ASC_MAP_GPIO_PON_EN_PA_WIDTH 1
+
+static inline void asc_map_set_gpio_pon_en_pa(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000008u) | ((v & 0x1u) << 3);
+}
+
+static inline uint32_t asc_map_get_gpio_pon_en_pa(const uint32_t* asc) {
+    return ((asc[15] & 0x8u) >> 3);
+}
+
+// Allow the radio FSM to turn on the PA LDO.
+// ASC<509> (MSB first).
+#define ASC_MAP_FSM_PON_EN_PA_WIDTH 1
+
+static inline void asc_map_set_fsm_pon_en_pa(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000004u) | ((v & 0x1u) << 2);
+}
+
+static inline uint32_t asc_map_get_fsm_pon_en_pa(const uint32_t* asc) {
+    return ((asc[15] & 0x4u) >> 2);
+}
+
+// Allow the IF LDO to turn on, 0 = forced off.
+// ASC<510> (MSB first).
+#define ASC_MAP_MASTER_LDO_EN_IF_WIDTH 1
+
+static inline void asc_map_set_master_ldo_en_if(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000002u) | ((v & 0x1u) << 1);
+}
+
+static inline uint32_t asc_map_get_master_ldo_en_if(const uint32_t* asc) {
+    return ((asc[15] & 0x2u) >> 1);
+}
+
+// Allow the LO LDO to turn on, 0 = forced off.
+// ASC<511> (MSB first).
+#define ASC_MAP_MASTER_LDO_EN_LO_WIDTH 1
+
+static inline void asc_map_set_master_ldo_en_lo(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[15] = (asc[15] & ~0x00000001u) | (v & 0x1u);
+}
+
+static inline uint32_t asc_map_get_master_ldo_en_lo(const uint32_t* asc) {
+    return (asc[15] & 0x1u);
+}
+
+// Allow the PA LDO to turn on, 0 = forced off.
+// ASC<512> (MSB first).
+#define ASC_MAP_MASTER_LDO_EN_PA_WIDTH 1
+
+static inline void asc_map_set_master_ldo_en_pa(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[16] = (asc[16] & ~0x80000000u) | ((v & 0x1u) << 31);
+}
+
+static inline uint32_t asc_map_get_master_ldo_en_pa(const uint32_t* asc) {
+    return ((asc[16] & 0x80000000u) >> 31);
+}
+
+// Turn on the DIV LDO via the scan chain.
+// ASC<513> (MSB first).
+#define ASC_MAP_SCAN_PON_DIV_WIDTH 1
+
+static inline void asc_map_set_scan_pon_div(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[16] = (asc[16] & ~0x40000000u) | ((v & 0x1u) << 30);
+}
+
+static inline uint32_t asc_map_get_scan_pon_div(const uint32_t* asc) {
+    return ((asc[16] & 0x40000000u) >> 30);
+}
+
+// Allow the GPIO bank to turn on the DIV LDO.
+// ASC<514> (MSB first).
+#define ASC_MAP_GPIO_PON_EN_DIV_WIDTH 1
+
+static inline void asc_map_set_gpio_pon_en_div(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[16] = (asc[16] & ~0x20000000u) | ((v & 0x1u) << 29);
+}
+
+static inline uint32_t asc_map_get_gpio_pon_en_div(const uint32_t* asc) {
+    return ((asc[16] & 0x20000000u) >> 29);
+}
+
+// Allow the radio FSM to turn on the DIV LDO.
+// ASC<515> (MSB first).
+#define ASC_MAP_FSM_PON_EN_DIV_WIDTH 1
+
+static inline void asc_map_set_fsm_pon_en_div(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[16] = (asc[16] & ~0x10000000u) | ((v & 0x1u) << 28);
+}
+
+static inline uint32_t asc_map_get_fsm_pon_en_div(const uint32_t* asc) {
+    return ((asc[16] & 0x10000000u) >> 28);
+}
+
+// Allow the DIV LDO to turn on, 0 = forced off.
+// ASC<516> (MSB first).
+#define ASC_MAP_MASTER_LDO_EN_DIV_WIDTH 1
+
+static inline void asc_map_set_master_ldo_en_div(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[16] = (asc[16] & ~0x08000000u) | ((v & 0x1u) << 27);
+}
+
+static inline uint32_t asc_map_get_master_ldo_en_div(const uint32_t* asc) {
+    return ((asc[16] & 0x8000000u) >> 27);
+}
+
+// LF_CLOCK disable.
+// ASC<553> (MSB first).
+#define ASC_MAP_LF_CLOCK_DISABLE_WIDTH 1
+
+static inline void asc_map_set_lf_clock_disable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[17] = (asc[17] & ~0x00400000u) | ((v & 0x1u) << 22);
+}
+
+static inline uint32_t asc_map_get_lf_clock_disable(const uint32_t* asc) {
+    return ((asc[17] & 0x400000u) >> 22);
+}
+
+// Always-on LDO reference voltage, the MSB is the panic bit.
+// ASC<557, 924, 925, 926, 927, 928, 929> (MSB first), inverted ASC<557, 924>.
+#define ASC_MAP_ALWAYS_ON_LDO_WIDTH 7
+
+static inline void asc_map_set_always_on_ldo(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x60u;
+    asc[17] = (asc[17] & ~0x00040000u) | ((v & 0x40u) << 12);
+    asc[28] = (asc[28] & ~0x0000000Fu) | ((v & 0x3Cu) >> 2);
+    asc[29] = (asc[29] & ~0xC0000000u) | ((v & 0x3u) << 30);
+}
+
+static inline uint32_t asc_map_get_always_on_ldo(const uint32_t* asc) {
+    return (((asc[17] & 0x40000u) >> 12) |
+            ((asc[28] & 0xFu) << 2) |
+            ((asc[29] & 0xC0000000u) >> 30)) ^ 0x60u;
+}
+
+// 32 kHz oscillator enable.
+// ASC<623> (MSB first).
+#define ASC_MAP_OSC_32K_ENABLE_WIDTH 1
+
+static inline void asc_map_set_osc_32k_enable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[19] = (asc[19] & ~0x00010000u) | ((v & 0x1u) << 16);
+}
+
+static inline uint32_t asc_map_get_osc_32k_enable(const uint32_t* asc) {
+    return ((asc[19] & 0x10000u) >> 16);
+}
+
+// IF RC oscillator range, 1 = high range.
+// ASC<726> (MSB first).
+#define ASC_MAP_IF_RC_HIGH_SPEED_MODE_WIDTH 1
+
+static inline void asc_map_set_if_rc_high_speed_mode(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[22] = (asc[22] & ~0x00000200u) | ((v & 0x1u) << 9);
+}
+
+static inline uint32_t asc_map_get_if_rc_high_speed_mode(const uint32_t* asc) {
+    return ((asc[22] & 0x200u) >> 9);
+}
+
+// ADC const gm device tuning code.
+// ASC<765:758> (MSB first).
+#define ASC_MAP_ADC_CONST_GM_TUNING_CODE_WIDTH 8
+
+static inline void asc_map_set_adc_const_gm_tuning_code(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[23] = (asc[23] & ~0x000003FCu) |
+              ((v & 0x80u) >> 5) |
+              ((v & 0x40u) >> 3) |
+              ((v & 0x20u) >> 1) |
+              ((v & 0x10u) << 1) |
+              ((v & 0x8u) << 3) |
+              ((v & 0x4u) << 5) |
+              ((v & 0x2u) << 7) |
+              ((v & 0x1u) << 9);
+}
+
+static inline uint32_t asc_map_get_adc_const_gm_tuning_code(
+    const uint32_t* asc) {
+    return ((asc[23] & 0x4u) << 5) |
+           ((asc[23] & 0x8u) << 3) |
+           ((asc[23] & 0x10u) << 1) |
+           ((asc[23] & 0x20u) >> 1) |
+           ((asc[23] & 0x40u) >> 3) |
+           ((asc[23] & 0x80u) >> 5) |
+           ((asc[23] & 0x100u) >> 7) |
+           ((asc[23] & 0x200u) >> 9);
+}
+
+// ADC PGA gain, the actual gain is the code + 1.
+// ASC<766, 767, 768, 769, 770, 771, 800, 773> (MSB first).
+#define ASC_MAP_ADC_PGA_GAIN_WIDTH 8
+
+static inline void asc_map_set_adc_pga_gain(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[23] = (asc[23] & ~0x00000003u) | ((v & 0xC0u) >> 6);
+    asc[24] = (asc[24] & ~0xF4000000u) | ((v & 0x3Du) << 26);
+    asc[25] = (asc[25] & ~0x80000000u) | ((v & 0x2u) << 30);
+}
+
+static inline uint32_t asc_map_get_adc_pga_gain(const uint32_t* asc) {
+    return ((asc[23] & 0x3u) << 6) |
+           ((asc[24] & 0xF4000000u) >> 26) |
+           ((asc[25] & 0x80000000u) >> 30);
+}
+
+// ADC bandgap reference tuning code, the MSB is the panic bit.
+// ASC<778, 784, 783, 782, 781, 780, 779> (MSB first).
+#define ASC_MAP_ADC_BANDGAP_REFERENCE_TUNING_CODE_WIDTH 7
+
+static inline void asc_map_set_adc_bandgap_reference_tuning_code(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[24] = (asc[24] & ~0x003F8000u) |
+              ((v & 0x20u) << 10) |
+              ((v & 0x10u) << 12) |
+              ((v & 0x8u) << 14) |
+              ((v & 0x40u) << 15) |
+              ((v & 0x4u) << 16) |
+              ((v & 0x2u) << 18) |
+              ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_adc_bandgap_reference_tuning_code(
+    const uint32_t* asc) {
+    return ((asc[24] & 0x8000u) >> 10) |
+           ((asc[24] & 0x10000u) >> 12) |
+           ((asc[24] & 0x20000u) >> 14) |
+           ((asc[24] & 0x200000u) >> 15) |
+           ((asc[24] & 0x40000u) >> 16) |
+           ((asc[24] & 0x80000u) >> 18) |
+           ((asc[24] & 0x100000u) >> 20);
+}
+
+// VDDD LDO reference voltage.
+// ASC<791:797> (MSB first), inverted ASC<791, 792>.
+#define ASC_MAP_VDDD_LDO_WIDTH 7
+
+static inline void asc_map_set_vddd_ldo(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x60u;
+    asc[24] = (asc[24] & ~0x000001FCu) | ((v & 0x7Fu) << 2);
+}
+
+static inline uint32_t asc_map_get_vddd_ldo(const uint32_t* asc) {
+    return (((asc[24] & 0x1FCu) >> 2)) ^ 0x60u;
+}
+
+// ADC VBAT / 4 input enable.
+// ASC<798> (MSB first).
+#define ASC_MAP_ADC_VBAT_DIV_4_ENABLE_WIDTH 1
+
+static inline void asc_map_set_adc_vbat_div_4_enable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[24] = (asc[24] & ~0x00000002u) | ((v & 0x1u) << 1);
+}
+
+static inline uint32_t asc_map_get_adc_vbat_div_4_enable(const uint32_t* asc) {
+    return ((asc[24] & 0x2u) >> 1);
+}
+
+// ADC on-chip LDO enable.
+// ASC<801> (MSB first).
+#define ASC_MAP_ADC_LDO_ENABLE_WIDTH 1
+
+static inline void asc_map_set_adc_ldo_enable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[25] = (asc[25] & ~0x40000000u) | ((v & 0x1u) << 30);
+}
+
+static inline uint32_t asc_map_get_adc_ldo_enable(const uint32_t* asc) {
+    return ((asc[25] & 0x40000000u) >> 30);
+}
+
+// ADC settling time.
+// ASC<816:823> (MSB first).
+#define ASC_MAP_ADC_SETTLING_TIME_WIDTH 8
+
+static inline void asc_map_set_adc_settling_time(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[25] = (asc[25] & ~0x0000FF00u) | ((v & 0xFFu) << 8);
+}
+
+static inline uint32_t asc_map_get_adc_settling_time(const uint32_t* asc) {
+    return ((asc[25] & 0xFF00u) >> 8);
+}
+
+// HF_CLOCK fine tuning.
+// ASC<874, 873, 872, 871, 870> (MSB first), inverted ASC<874>.
+#define ASC_MAP_HF_CLOCK_FINE_WIDTH 5
+
+static inline void asc_map_set_hf_clock_fine(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x10u;
+    asc[27] = (asc[27] & ~0x03E00000u) |
+              ((v & 0x10u) << 17) |
+              ((v & 0x8u) << 19) |
+              ((v & 0x4u) << 21) |
+              ((v & 0x2u) << 23) |
+              ((v & 0x1u) << 25);
+}
+
+static inline uint32_t asc_map_get_hf_clock_fine(const uint32_t* asc) {
+    return (((asc[27] & 0x200000u) >> 17) |
+            ((asc[27] & 0x400000u) >> 19) |
+            ((asc[27] & 0x800000u) >> 21) |
+            ((asc[27] & 0x1000000u) >> 23) |
+            ((asc[27] & 0x2000000u) >> 25)) ^ 0x10u;
+}
+
+// HF_CLOCK coarse tuning.
+// ASC<877, 876, 875, 861, 860> (MSB first), inverted ASC<877, 876, 875>.
+#define ASC_MAP_HF_CLOCK_COARSE_WIDTH 5
+
+static inline void asc_map_set_hf_clock_coarse(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x1Cu;
+    asc[26] = (asc[26] & ~0x0000000Cu) | ((v & 0x2u) << 1) | ((v & 0x1u) << 3);
+    asc[27] = (asc[27] & ~0x001C0000u) |
+              ((v & 0x10u) << 14) |
+              ((v & 0x8u) << 16) |
+              ((v & 0x4u) << 18);
+}
+
+static inline uint32_t asc_map_get_hf_clock_coarse(const uint32_t* asc) {
+    return (((asc[26] & 0x4u) >> 1) |
+            ((asc[26] & 0x8u) >> 3) |
+            ((asc[27] & 0x40000u) >> 14) |
+            ((asc[27] & 0x80000u) >> 16) |
+            ((asc[27] & 0x100000u) >> 18)) ^ 0x1Cu;
+}
+
+// AUX LDO control select, 0 = ASC<916>, 1 = analog_cfg<167>.
+// ASC<914> (MSB first).
+#define ASC_MAP_AUX_LDO_CONTROL_SELECT_WIDTH 1
+
+static inline void asc_map_set_aux_ldo_control_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[28] = (asc[28] & ~0x00002000u) | ((v & 0x1u) << 13);
+}
+
+static inline uint32_t asc_map_get_aux_ldo_control_select(const uint32_t* asc) {
+    return ((asc[28] & 0x2000u) >> 13);
+}
+
+// ADC input mux select.
+// ASC<915, 1087> (MSB first).
+#define ASC_MAP_ADC_INPUT_MUX_SELECT_WIDTH 2
+
+static inline void asc_map_set_adc_input_mux_select(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[28] = (asc[28] & ~0x00001000u) | ((v & 0x2u) << 11);
+    asc[33] = (asc[33] & ~0x00000001u) | (v & 0x1u);
+}
+
+static inline uint32_t asc_map_get_adc_input_mux_select(const uint32_t* asc) {
+    return ((asc[28] & 0x1000u) >> 11) | (asc[33] & 0x1u);
+}
+
+// AUX LDO disable when controlled by the scan chain.
+// ASC<916> (MSB first).
+#define ASC_MAP_AUX_LDO_DISABLE_WIDTH 1
+
+static inline void asc_map_set_aux_ldo_disable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[28] = (asc[28] & ~0x00000800u) | ((v & 0x1u) << 11);
+}
+
+static inline uint32_t asc_map_get_aux_ldo_disable(const uint32_t* asc) {
+    return ((asc[28] & 0x800u) >> 11);
+}
+
+// AUX LDO reference voltage.
+// ASC<923:917> (MSB first), inverted ASC<923, 922>.
+#define ASC_MAP_AUX_LDO_WIDTH 7
+
+static inline void asc_map_set_aux_ldo(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x60u;
+    asc[28] = (asc[28] & ~0x000007F0u) |
+              ((v & 0x40u) >> 2) |
+              (v & 0x20u) |
+              ((v & 0x10u) << 2) |
+              ((v & 0x8u) << 4) |
+              ((v & 0x4u) << 6) |
+              ((v & 0x2u) << 8) |
+              ((v & 0x1u) << 10);
+}
+
+static inline uint32_t asc_map_get_aux_ldo(const uint32_t* asc) {
+    return (((asc[28] & 0x10u) << 2) |
+            (asc[28] & 0x20u) |
+            ((asc[28] & 0x40u) >> 2) |
+            ((asc[28] & 0x80u) >> 4) |
+            ((asc[28] & 0x100u) >> 6) |
+            ((asc[28] & 0x200u) >> 8) |
+            ((asc[28] & 0x400u) >> 10)) ^ 0x60u;
+}
+
+// Polyphase filter enable.
+// ASC<971> (MSB first).
+#define ASC_MAP_POLYPHASE_ENABLE_WIDTH 1
+
+static inline void asc_map_set_polyphase_enable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[30] = (asc[30] & ~0x00100000u) | ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_polyphase_enable(const uint32_t* asc) {
+    return ((asc[30] & 0x100000u) >> 20);
+}
+
+// PA LDO reference voltage, the MSB is the panic bit.
+// ASC<972:978> (MSB first), inverted.
+#define ASC_MAP_PA_LDO_RDAC_WIDTH 7
+
+static inline void asc_map_set_pa_ldo_rdac(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x7Fu;
+    asc[30] = (asc[30] & ~0x000FE000u) | ((v & 0x7Fu) << 13);
+}
+
+static inline uint32_t asc_map_get_pa_ldo_rdac(const uint32_t* asc) {
+    return (((asc[30] & 0xFE000u) >> 13)) ^ 0x7Fu;
+}
+
+// LO LDO reference voltage, the MSB is the panic bit.
+// ASC<980:986> (MSB first), inverted.
+#define ASC_MAP_LO_LDO_RDAC_WIDTH 7
+
+static inline void asc_map_set_lo_ldo_rdac(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0x7Fu;
+    asc[30] = (asc[30] & ~0x00000FE0u) | ((v & 0x7Fu) << 5);
+}
+
+static inline uint32_t asc_map_get_lo_ldo_rdac(const uint32_t* asc) {
+    return (((asc[30] & 0xFE0u) >> 5)) ^ 0x7Fu;
+}
+
+// LC oscillator current.
+// ASC<988:995> (MSB first).
+#define ASC_MAP_LO_CURRENT_WIDTH 8
+
+static inline void asc_map_set_lo_current(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[30] = (asc[30] & ~0x0000000Fu) | ((v & 0xF0u) >> 4);
+    asc[31] = (asc[31] & ~0xF0000000u) | ((v & 0xFu) << 28);
+}
+
+static inline uint32_t asc_map_get_lo_current(const uint32_t* asc) {
+    return ((asc[30] & 0xFu) << 4) | ((asc[31] & 0xF0000000u) >> 28);
+}
+
+// 802.15.4 modulation tone spacing.
+// ASC<1002:1000> (MSB first).
+#define ASC_MAP_MOD_15_4_TUNE_WIDTH 3
+
+static inline void asc_map_set_mod_15_4_tune(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[31] = (asc[31] & ~0x00E00000u) |
+              ((v & 0x4u) << 19) |
+              ((v & 0x2u) << 21) |
+              ((v & 0x1u) << 23);
+}
+
+static inline uint32_t asc_map_get_mod_15_4_tune(const uint32_t* asc) {
+    return ((asc[31] & 0x200000u) >> 19) |
+           ((asc[31] & 0x400000u) >> 21) |
+           ((asc[31] & 0x800000u) >> 23);
+}
+
+// Divider x2 select, keep at 1 for clean divider output edges.
+// ASC<1012> (MSB first).
+#define ASC_MAP_DIVIDER_SEL_1MHZ_2MHZ_WIDTH 1
+
+static inline void asc_map_set_divider_sel_1mhz_2mhz(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[31] = (asc[31] & ~0x00000800u) | ((v & 0x1u) << 11);
+}
+
+static inline uint32_t asc_map_get_divider_sel_1mhz_2mhz(const uint32_t* asc) {
+    return ((asc[31] & 0x800u) >> 11);
+}
+
+// ADC PGA bypass.
+// ASC<1088> (MSB first).
+#define ASC_MAP_ADC_PGA_BYPASS_WIDTH 1
+
+static inline void asc_map_set_adc_pga_bypass(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x80000000u) | ((v & 0x1u) << 31);
+}
+
+static inline uint32_t asc_map_get_adc_pga_bypass(const uint32_t* asc) {
+    return ((asc[34] & 0x80000000u) >> 31);
+}
+
+// 2 MHz RC oscillator coarse 1 tuning.
+// ASC<1093:1089> (MSB first).
+#define ASC_MAP_RC_2M_COARSE1_WIDTH 5
+
+static inline void asc_map_set_rc_2m_coarse1(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x7C000000u) |
+              ((v & 0x10u) << 22) |
+              ((v & 0x8u) << 24) |
+              ((v & 0x4u) << 26) |
+              ((v & 0x2u) << 28) |
+              ((v & 0x1u) << 30);
+}
+
+static inline uint32_t asc_map_get_rc_2m_coarse1(const uint32_t* asc) {
+    return ((asc[34] & 0x4000000u) >> 22) |
+           ((asc[34] & 0x8000000u) >> 24) |
+           ((asc[34] & 0x10000000u) >> 26) |
+           ((asc[34] & 0x20000000u) >> 28) |
+           ((asc[34] & 0x40000000u) >> 30);
+}
+
+// 2 MHz RC oscillator coarse 2 tuning.
+// ASC<1098:1094> (MSB first).
+#define ASC_MAP_RC_2M_COARSE2_WIDTH 5
+
+static inline void asc_map_set_rc_2m_coarse2(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x03E00000u) |
+              ((v & 0x10u) << 17) |
+              ((v & 0x8u) << 19) |
+              ((v & 0x4u) << 21) |
+              ((v & 0x2u) << 23) |
+              ((v & 0x1u) << 25);
+}
+
+static inline uint32_t asc_map_get_rc_2m_coarse2(const uint32_t* asc) {
+    return ((asc[34] & 0x200000u) >> 17) |
+           ((asc[34] & 0x400000u) >> 19) |
+           ((asc[34] & 0x800000u) >> 21) |
+           ((asc[34] & 0x1000000u) >> 23) |
+           ((asc[34] & 0x2000000u) >> 25);
+}
+
+// 2 MHz RC oscillator coarse 3 tuning.
+// ASC<1103:1099> (MSB first).
+#define ASC_MAP_RC_2M_COARSE3_WIDTH 5
+
+static inline void asc_map_set_rc_2m_coarse3(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x001F0000u) |
+              ((v & 0x10u) << 12) |
+              ((v & 0x8u) << 14) |
+              ((v & 0x4u) << 16) |
+              ((v & 0x2u) << 18) |
+              ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_rc_2m_coarse3(const uint32_t* asc) {
+    return ((asc[34] & 0x10000u) >> 12) |
+           ((asc[34] & 0x20000u) >> 14) |
+           ((asc[34] & 0x40000u) >> 16) |
+           ((asc[34] & 0x80000u) >> 18) |
+           ((asc[34] & 0x100000u) >> 20);
+}
+
+// 2 MHz RC oscillator fine tuning.
+// ASC<1108:1104> (MSB first).
+#define ASC_MAP_RC_2M_FINE_WIDTH 5
+
+static inline void asc_map_set_rc_2m_fine(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x0000F800u) |
+              ((v & 0x10u) << 7) |
+              ((v & 0x8u) << 9) |
+              ((v & 0x4u) << 11) |
+              ((v & 0x2u) << 13) |
+              ((v & 0x1u) << 15);
+}
+
+static inline uint32_t asc_map_get_rc_2m_fine(const uint32_t* asc) {
+    return ((asc[34] & 0x800u) >> 7) |
+           ((asc[34] & 0x1000u) >> 9) |
+           ((asc[34] & 0x2000u) >> 11) |
+           ((asc[34] & 0x4000u) >> 13) |
+           ((asc[34] & 0x8000u) >> 15);
+}
+
+// 2 MHz RC oscillator superfine tuning.
+// ASC<1113:1109> (MSB first).
+#define ASC_MAP_RC_2M_SUPERFINE_WIDTH 5
+
+static inline void asc_map_set_rc_2m_superfine(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x000007C0u) |
+              ((v & 0x10u) << 2) |
+              ((v & 0x8u) << 4) |
+              ((v & 0x4u) << 6) |
+              ((v & 0x2u) << 8) |
+              ((v & 0x1u) << 10);
+}
+
+static inline uint32_t asc_map_get_rc_2m_superfine(const uint32_t* asc) {
+    return ((asc[34] & 0x40u) >> 2) |
+           ((asc[34] & 0x80u) >> 4) |
+           ((asc[34] & 0x100u) >> 6) |
+           ((asc[34] & 0x200u) >> 8) |
+           ((asc[34] & 0x400u) >> 10);
+}
+
+// 2 MHz RC oscillator enable.
+// ASC<1114> (MSB first).
+#define ASC_MAP_RC_2M_ENABLE_WIDTH 1
+
+static inline void asc_map_set_rc_2m_enable(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x00000020u) | ((v & 0x1u) << 5);
+}
+
+static inline uint32_t asc_map_get_rc_2m_enable(const uint32_t* asc) {
+    return ((asc[34] & 0x20u) >> 5);
+}
+
+// GPIO output driver enables, bit n enables GPIO n.
+// ASC<1130, 1128, 1126, 1124, 1121, 1119, 1117, 1115, 1146, 1144, 1142, 1140,
+// 1137, 1135, 1133, 1131> (MSB first), inverted.
+#define ASC_MAP_GPO_ENABLE_WIDTH 16
+
+static inline void asc_map_set_gpo_enable(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value ^ 0xFFFFu;
+    asc[34] = (asc[34] & ~0x00000015u) |
+              ((v & 0x400u) >> 10) |
+              ((v & 0x200u) >> 7) |
+              ((v & 0x100u) >> 4);
+    asc[35] = (asc[35] & ~0x4AB54AA0u) |
+              ((v & 0x80u) >> 2) |
+              ((v & 0x40u) << 1) |
+              ((v & 0x20u) << 4) |
+              ((v & 0x8000u) << 6) |
+              ((v & 0x10u) << 7) |
+              ((v & 0x4000u) << 9) |
+              ((v & 0x8u) << 11) |
+              ((v & 0x2000u) << 12) |
+              ((v & 0x4u) << 14) |
+              ((v & 0x1000u) << 15) |
+              ((v & 0x2u) << 17) |
+              ((v & 0x800u) << 19) |
+              ((v & 0x1u) << 20);
+}
+
+static inline uint32_t asc_map_get_gpo_enable(const uint32_t* asc) {
+    return (((asc[34] & 0x1u) << 10) |
+            ((asc[34] & 0x4u) << 7) |
+            ((asc[34] & 0x10u) << 4) |
+            ((asc[35] & 0x20u) << 2) |
+            ((asc[35] & 0x80u) >> 1) |
+            ((asc[35] & 0x200u) >> 4) |
+            ((asc[35] & 0x200000u) >> 6) |
+            ((asc[35] & 0x800u) >> 7) |
+            ((asc[35] & 0x800000u) >> 9) |
+            ((asc[35] & 0x4000u) >> 11) |
+            ((asc[35] & 0x2000000u) >> 12) |
+            ((asc[35] & 0x10000u) >> 14) |
+            ((asc[35] & 0x8000000u) >> 15) |
+            ((asc[35] & 0x40000u) >> 17) |
+            ((asc[35] & 0x40000000u) >> 19) |
+            ((asc[35] & 0x100000u) >> 20)) ^ 0xFFFFu;
+}
+
+// GPIO input enables, bit n enables GPIO n.
+// ASC<1129, 1127, 1125, 1123, 1122, 1120, 1118, 1116, 1145, 1143, 1141, 1139,
+// 1138, 1136, 1134, 1132> (MSB first).
+#define ASC_MAP_GPI_ENABLE_WIDTH 16
+
+static inline void asc_map_set_gpi_enable(uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[34] = (asc[34] & ~0x0000000Au) |
+              ((v & 0x200u) >> 8) |
+              ((v & 0x100u) >> 5);
+    asc[35] = (asc[35] & ~0xB54AB540u) |
+              ((v & 0x80u) >> 1) |
+              ((v & 0x40u) << 2) |
+              ((v & 0x20u) << 5) |
+              ((v & 0x8000u) << 7) |
+              ((v & 0x10u) << 8) |
+              ((v & 0x4008u) << 10) |
+              ((v & 0x2004u) << 13) |
+              ((v & 0x1002u) << 16) |
+              ((v & 0x800u) << 18) |
+              ((v & 0x1u) << 19) |
+              ((v & 0x400u) << 21);
+}
+
+static inline uint32_t asc_map_get_gpi_enable(const uint32_t* asc) {
+    return ((asc[34] & 0x2u) << 8) |
+           ((asc[34] & 0x8u) << 5) |
+           ((asc[35] & 0x40u) << 1) |
+           ((asc[35] & 0x100u) >> 2) |
+           ((asc[35] & 0x400u) >> 5) |
+           ((asc[35] & 0x400000u) >> 7) |
+           ((asc[35] & 0x1000u) >> 8) |
+           ((asc[35] & 0x1002000u) >> 10) |
+           ((asc[35] & 0x4008000u) >> 13) |
+           ((asc[35] & 0x10020000u) >> 16) |
+           ((asc[35] & 0x20000000u) >> 18) |
+           ((asc[35] & 0x80000u) >> 19) |
+           ((asc[35] & 0x80000000u) >> 21);
+}
+
+// HCLK source, 1 = HF_CLOCK.
+// ASC<1147> (MSB first).
+#define ASC_MAP_HCLK_SOURCE_HF_CLOCK_WIDTH 1
+
+static inline void asc_map_set_hclk_source_hf_clock(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[35] = (asc[35] & ~0x00000010u) | ((v & 0x1u) << 4);
+}
+
+static inline uint32_t asc_map_get_hclk_source_hf_clock(const uint32_t* asc) {
+    return ((asc[35] & 0x10u) >> 4);
+}
+
+// RF timer clock source, 1 = HF_CLOCK.
+// ASC<1151> (MSB first).
+#define ASC_MAP_RFTIMER_SOURCE_HF_CLOCK_WIDTH 1
+
+static inline void asc_map_set_rftimer_source_hf_clock(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[35] = (asc[35] & ~0x00000001u) | (v & 0x1u);
+}
+
+static inline uint32_t asc_map_get_rftimer_source_hf_clock(
+    const uint32_t* asc) {
+    return (asc[35] & 0x1u);
+}
+
+// Chip clock source, 1 = 2 MHz RC oscillator.
+// ASC<1156> (MSB first).
+#define ASC_MAP_CHIP_CLK_SOURCE_RC_2M_WIDTH 1
+
+static inline void asc_map_set_chip_clk_source_rc_2m(
+    uint32_t* asc, const uint32_t value) {
+    const uint32_t v = value;
+    asc[36] = (asc[36] & ~0x08000000u) | ((v & 0x1u) << 27);
+}
+
+static inline uint32_t asc_map_get_chip_clk_source_rc_2m(const uint32_t* asc) {
+    return ((asc[36] & 0x8000000u) >> 27);
+}
+
+#endif  // __ASC_MAP_H
@@ -0,0 +1,227 @@
+#include "asc_profiles.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "asc_map.h"
+#include "memory_map.h"
+#include "scm3c_hw_interface.h"
+
+// ASC profile names printed in the statistics, indexed by asc_profile_e.
+static const char* const g_asc_profiles_names[ASC_PROFILE_NUM_PROFILES] = {
+    "tx",
+    "rx_mf",
+    "rx_zcc",
+};
+
+// ASC profiles.
+static uint32_t g_asc_profiles[ASC_PROFILE_NUM_PROFILES]
+                              [ASC_PROFILES_NUM_WORDS];
+
+// Whether the ASC profiles have been built.
+static bool g_asc_profiles_built = false;
+
+// Profile that was last switched to.
+static asc_profile_e g_asc_profiles_current = ASC_PROFILE_INVALID;
+
+// Profile switch time statistics.
+static asc_profiles_switch_stats_t g_asc_profiles_switch_stats;
+
+// Bits that differ between the TX and the selected RX profile. Only these bits
+// are copied on a switch, and all other bits are kept from the local ASC
+// image.
+static uint32_t g_asc_profiles_mask[ASC_PROFILES_NUM_WORDS];
+
+// Bits that have been overwritten by asc_profiles_write(), which are always
+// copied on a switch.
+static uint32_t g_asc_profiles_written_mask[ASC_PROFILES_NUM_WORDS];
+
+// Profile used for reception.
+static asc_profile_e g_asc_profiles_rx = ASC_PROFILE_RX_MF;
+
+// Save the local ASC image as the given profile.
+static inline void asc_profiles_save(const asc_profile_e profile,
+                                     const uint32_t* asc) {
+    memcpy(g_asc_profiles[profile], asc, sizeof(g_asc_profiles[profile]));
+}
+
+// Configure the IF path for reception. The polyphase filter and the mixers
+// are enabled, and the radio LDOs are controlled by the FSM.
+static void asc_profiles_apply_rx(uint32_t* asc) {
+    asc_map_set_polyphase_enable(asc, 1);
+    asc_map_set_if_mixer_disable(asc, 0x0);
+    asc_map_set_gpio_pon_en_if(asc, 0);
+    asc_map_set_gpio_pon_en_lo(asc, 0);
+    asc_map_set_gpio_pon_en_pa(asc, 0);
+}
+
+// Configure the radio for transmission like radio_build_channel_table(). The
+// polyphase filter is turned off, the mixer wells are hi-Z, and the LO and PA
+// LDOs are enabled.
+static void asc_profiles_apply_tx(uint32_t* asc) {
+    asc_map_set_polyphase_enable(asc, 0);
+    asc_map_set_if_mixer_disable(asc, 0x3);
+    asc_map_set_gpio_pon_en_if(asc, 0);
+    asc_map_set_gpio_pon_en_lo(asc, 1);
+    asc_map_set_gpio_pon_en_pa(asc, 1);
+}
+
+// Compute the bits that differ between the TX and the selected RX profile.
+// The GPIO enables are left to the application, so they are never switched.
+static void asc_profiles_compute_mask(void) {
+    uint32_t gpio_mask[ASC_PROFILES_NUM_WORDS];
+    uint8_t i = 0;
+
+    memset(gpio_mask, 0, sizeof(gpio_mask));
+    asc_map_set_gpi_enable(gpio_mask, 0xFFFF);
+    // The GPO enables are inverted in the scan chain.
+    asc_map_set_gpo_enable(gpio_mask, 0x0000);
+
+    for (i = 0; i < ASC_PROFILES_NUM_WORDS; ++i) {
+        g_asc_profiles_mask[i] =
+            ((g_asc_profiles[ASC_PROFILE_TX][i] ^
+              g_asc_profiles[g_asc_profiles_rx][i]) &
+             ~gpio_mask[i]) |
+            g_asc_profiles_written_mask[i];
+    }
+}
+
+// Update the switch time statistics.
+static void asc_profiles_update_switch_stats(const uint32_t duration,
+                                             const bool updated) {
+    asc_profiles_switch_stats_t* stats = &g_asc_profiles_switch_stats;
+
+    ++stats->num_switches;
+    stats->last_duration = duration;
+    stats->total_duration += duration;
+    if (duration > stats->max_duration) {
+        stats->max_duration = duration;
+    }
+    if (updated) {
+        if (stats->num_updates == 0 || duration < stats->min_duration) {
+            stats->min_duration = duration;
+        }
+        ++stats->num_updates;
+    }
+}
+
+void asc_profiles_build(void) {
+    uint32_t* asc = scm3c_hw_interface_get_asc();
+    uint32_t current_asc[ASC_PROFILES_NUM_WORDS];
+
+    memcpy(current_asc, asc, sizeof(current_asc));
+
+    // Only the ASC image is changed, so the profiles can be built at any time
+    // without affecting the radio. The IF clock has to be set after
+    // initializing the receiver.
+    radio_init_rx_ZCC_ASC();
+    set_IF_clock_frequency(scm3c_hw_interface_get_IF_coarse(),
+                           scm3c_hw_interface_get_IF_fine(), 0);
+    asc_profiles_apply_rx(asc);
+    asc_profiles_save(ASC_PROFILE_RX_ZCC, asc);
+
+    // The TX profile is based on the matched filter profile.
+    memcpy(asc, current_asc, sizeof(current_asc));
+    radio_init_rx_MF_ASC();
+    set_IF_clock_frequency(scm3c_hw_interface_get_IF_coarse(),
+                           scm3c_hw_interface_get_IF_fine(), 0);
+    asc_profiles_apply_rx(asc);
+    asc_profiles_save(ASC_PROFILE_RX_MF, asc);
+
+    asc_profiles_apply_tx(asc);
+    asc_profiles_save(ASC_PROFILE_TX, asc);
+
+    // Restore the current ASC image.
+    memcpy(asc, current_asc, sizeof(current_asc));
+    memset(g_asc_profiles_written_mask, 0,
+           sizeof(g_asc_profiles_written_mask));
+    asc_profiles_compute_mask();
+    g_asc_profiles_built = true;
+    g_asc_profiles_current = ASC_PROFILE_INVALID;
+}
+
+bool asc_profiles_switch(const asc_profile_e profile) {
+    uint32_t* asc = NULL;
+    uint32_t start_count;
+    bool updated;
+    uint8_t i = 0;
+
+    if (!g_asc_profiles_built || profile <= ASC_PROFILE_INVALID ||
+        profile >= ASC_PROFILE_NUM_PROFILES) {
+        return false;
+    }
+
+    start_count = RFTIMER_REG__COUNTER;
+
+    // Commit within a transaction, so that switching within an outer
+    // transaction is deferred to the outer asc_commit().
+    asc_begin();
+    asc = scm3c_hw_interface_get_asc();
+    for (i = 0; i < ASC_PROFILES_NUM_WORDS; ++i) {
+        asc[i] = (asc[i] & ~g_asc_profiles_mask[i]) |
+                 (g_asc_profiles[profile][i] & g_asc_profiles_mask[i]);
+    }
+    updated = asc_commit();
+
+    // Wrap-around safe like in isr_profiler_exit().
+    asc_profiles_update_switch_stats(RFTIMER_REG__COUNTER - start_count,
+                                     updated);
+    g_asc_profiles_current = profile;
+    return updated;
+}
+
+void asc_profiles_set_rx(const asc_profile_e profile) {
+    if (profile != ASC_PROFILE_RX_MF && profile != ASC_PROFILE_RX_ZCC) {
+        return;
+    }
+    g_asc_profiles_rx = profile;
+    asc_profiles_compute_mask();
+}
+
+asc_profile_e asc_profiles_get_rx(void) { return g_asc_profiles_rx; }
+
+asc_profile_e asc_profiles_get_current(void) { return g_asc_profiles_current; }
+
+const uint32_t* asc_profiles_get(const asc_profile_e profile) {
+    return g_asc_profiles[profile];
+}
+
+bool asc_profiles_write(const asc_profile_e profile, const uint16_t offset,
+                        const uint32_t* words, const uint16_t num_words) {
+    uint16_t i = 0;
+
+    if (!g_asc_profiles_built || profile <= ASC_PROFILE_INVALID ||
+        profile >= ASC_PROFILE_NUM_PROFILES ||
+        offset + num_words > ASC_PROFILES_NUM_WORDS) {
+        return false;
+    }
+    for (i = 0; i < num_words; ++i) {
+        // The written bits are copied on a switch from now on.
+        g_asc_profiles_written_mask[offset + i] |=
+            words[i] ^ g_asc_profiles[profile][offset + i];
+        g_asc_profiles_mask[offset + i] |=
+            g_asc_profiles_written_mask[offset + i];
+        g_asc_profiles[profile][offset + i] = words[i];
+    }
+    return true;
+}
+
+const asc_profiles_switch_stats_t* asc_profiles_get_switch_stats(void) {
+    return &g_asc_profiles_switch_stats;
+}
+
+void asc_profiles_print_switch_stats(void) {
+    const asc_profiles_switch_stats_t* stats = &g_asc_profiles_switch_stats;
+
+    // Each RF timer tick is 2 us.
+    printf("ASC profile %s: n=%u updates=%u last=%u us min=%u us max=%u us "
+           "sum=%u us\n",
+           g_asc_profiles_current == ASC_PROFILE_INVALID
+               ? "none"
+               : g_asc_profiles_names[g_asc_profiles_current],
+           stats->num_switches, stats->num_updates, 2 * stats->last_duration,
+           2 * stats->min_duration, 2 * stats->max_duration,
+           2 * stats->total_duration);
+}
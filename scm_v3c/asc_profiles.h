@@ -0,0 +1,101 @@
+// The ASC profiles are complete analog scan chain images for the radio modes.
+// They are built once from the current ASC image and trims, so switching
+// between the modes only copies the bits that differ between the TX and the
+// selected RX profile into the local ASC image, followed by a single shift and
+// load of the scan chain if anything changed, instead of flipping many
+// individual bits. All other bits, e.g., the clock trims and the GPIO enables
+// of the application, are kept from the local ASC image, so the profiles do
+// not have to be rebuilt when the trims change.
+//
+// radio_txEnable() and radio_rxEnable() switch to the TX and the selected RX
+// profile, and radio_init_rx_MF() and radio_init_rx_ZCC() select the RX
+// profile. The TX profile turns off the polyphase filter, puts the mixer wells
+// into hi-Z, and enables the LO and PA LDOs in the scan chain, like
+// radio_build_channel_table(). The memory-mapped analog configuration, e.g.,
+// ANALOG_CFG_REG__10 and ANALOG_CFG_REG__16, is still set by
+// radio_txEnable() and radio_rxEnable(). The switch statistics show the time
+// spent in the switches.
+//
+// Building the profiles only changes the local ASC image and restores it
+// afterwards, so it does not touch the memory-mapped registers. However, it
+// takes a while and should not be called from an interrupt service routine.
+
+#ifndef __ASC_PROFILES_H
+#define __ASC_PROFILES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "asc_map.h"
+
+// Number of 32-bit words in an ASC profile.
+#define ASC_PROFILES_NUM_WORDS ((ASC_MAP_LENGTH + 31) / 32)
+
+// ASC profile enum.
+typedef enum {
+    ASC_PROFILE_INVALID = -1,
+    ASC_PROFILE_TX = 0,
+    ASC_PROFILE_RX_MF = 1,
+    ASC_PROFILE_RX_ZCC = 2,
+    ASC_PROFILE_NUM_PROFILES = 3,
+} asc_profile_e;
+
+// Profile switch time statistics.
+typedef struct {
+    // Number of profile switches.
+    uint32_t num_switches;
+
+    // Number of profile switches that shifted or loaded the scan chain.
+    uint32_t num_updates;
+
+    // Duration of the last switch in RF timer ticks.
+    uint32_t last_duration;
+
+    // Minimum duration of a switch that updated the scan chain in RF timer
+    // ticks.
+    uint32_t min_duration;
+
+    // Maximum duration of a switch in RF timer ticks.
+    uint32_t max_duration;
+
+    // Sum of all durations in RF timer ticks.
+    uint32_t total_duration;
+} asc_profiles_switch_stats_t;
+
+// Build all ASC profiles from the current ASC image and trims. The current
+// ASC image is restored afterwards, and the scan chain is not written.
+void asc_profiles_build(void);
+
+// Switch the analog scan chain to the given profile. Return whether the
+// analog configuration was updated.
+bool asc_profiles_switch(asc_profile_e profile);
+
+// Select the profile used for reception, ASC_PROFILE_RX_MF by default. Other
+// profiles are ignored.
+void asc_profiles_set_rx(asc_profile_e profile);
+
+// Return the profile used for reception.
+asc_profile_e asc_profiles_get_rx(void);
+
+// Return the profile that was last switched to.
+asc_profile_e asc_profiles_get_current(void);
+
+// Return the ASC image of the given profile.
+const uint32_t* asc_profiles_get(asc_profile_e profile);
+
+// Overwrite num_words words of the given profile starting at the word offset,
+// e.g., with words downloaded over the optical data channel. The words are
+// applied on the next switch to the profile and are lost when the profiles
+// are rebuilt. The changed bits are copied on every switch from then on.
+// Return whether the profiles have been built and the words fit into the
+// profile.
+bool asc_profiles_write(asc_profile_e profile, uint16_t offset,
+                        const uint32_t* words, uint16_t num_words);
+
+// Return the profile switch time statistics.
+const asc_profiles_switch_stats_t* asc_profiles_get_switch_stats(void);
+
+// Print the profile switch time statistics.
+void asc_profiles_print_switch_stats(void);
+
+#endif  // __ASC_PROFILES_H
@@ -0,0 +1,311 @@
+#include "bitbang.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memory_map.h"
+
+// I2C read and write bits.
+#define BITBANG_I2C_WRITE 0x00
+#define BITBANG_I2C_READ 0x01
+
+// Clock one SPI bit. The first write sets up the data and the clock of the
+// first phase, and the second write makes the clock edge on which the bit is
+// sampled. The other GPIO outputs are read again before every write, so that
+// pins changed by interrupts before the read are not reverted. A change
+// between the read and the write is lost.
+#define BITBANG_SPI_TRANSFER_BIT(bit)                                \
+    data = ((tx_byte >> (bit)) & 0x01) << mosi_pin;                  \
+    *gpio_output = (*gpio_output & output_mask) | first_clk | data;  \
+    *gpio_output = (*gpio_output & output_mask) | second_clk | data; \
+    rx_byte |= ((*gpio_input >> miso_pin) & 0x01) << (bit);
+
+// Clock one I2C bit out. SCL falls before SDA changes, so that SDA only
+// changes while SCL is low.
+#define BITBANG_I2C_WRITE_BIT(bit)                           \
+    data = ((byte >> (bit)) & 0x01) << context->sda_out_pin; \
+    bitbang_i2c_clear_scl(context);                          \
+    bitbang_i2c_set_lines(context, data);                    \
+    bitbang_delay(context->half_period_delay);               \
+    bitbang_i2c_set_lines(context, context->scl | data);     \
+    bitbang_delay(context->half_period_delay);
+
+// Clock one I2C bit in. The bit is sampled while SCL is high.
+#define BITBANG_I2C_READ_BIT(bit)                                            \
+    bitbang_i2c_set_lines(context, context->sda);                            \
+    bitbang_delay(context->half_period_delay);                               \
+    bitbang_i2c_set_lines(context, context->scl | context->sda);             \
+    bitbang_delay(context->half_period_delay);                               \
+    byte |= ((*context->gpio_input >> context->sda_in_pin) & 0x01) << (bit);
+
+// I2C transaction state.
+typedef struct {
+    volatile unsigned int* gpio_output;
+    volatile unsigned int* gpio_input;
+
+    // Mask of the GPIO outputs other than SCL and SDA.
+    unsigned int output_mask;
+
+    // SCL and SDA output bits.
+    unsigned int scl;
+    unsigned int sda;
+
+    uint8_t sda_out_pin;
+    uint8_t sda_in_pin;
+    uint16_t half_period_delay;
+} bitbang_i2c_context_t;
+
+// Write the SCL and SDA output bits. The other GPIO outputs are read again
+// before every write like for SPI, with the same race with interrupts.
+static inline void bitbang_i2c_set_lines(
+    const bitbang_i2c_context_t* context, const unsigned int bits) {
+    *context->gpio_output =
+        (*context->gpio_output & context->output_mask) | bits;
+}
+
+// Pull SCL low without changing SDA.
+static inline void bitbang_i2c_clear_scl(const bitbang_i2c_context_t* context) {
+    *context->gpio_output &= ~context->scl;
+}
+
+// Busy-wait for the number of loop iterations.
+static inline void bitbang_delay(const uint16_t delay) {
+    volatile uint16_t i = 0;
+
+    for (i = 0; i < delay; ++i) {
+    }
+}
+
+// Return the byte with its bits reversed.
+static inline uint8_t bitbang_reverse(uint8_t byte) {
+    byte = ((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4);
+    byte = ((byte & 0xCC) >> 2) | ((byte & 0x33) << 2);
+    return ((byte & 0xAA) >> 1) | ((byte & 0x55) << 1);
+}
+
+// Return the clock output bit while the SPI clock idles.
+static inline unsigned int bitbang_spi_idle_clk(
+    const bitbang_spi_device_t* device) {
+    return (device->mode & 0x02) ? 1 << device->clk_pin : 0;
+}
+
+void bitbang_spi_init(const bitbang_spi_device_t* device) {
+    GPIO_REG__OUTPUT = (GPIO_REG__OUTPUT & ~(1 << device->clk_pin)) |
+                       bitbang_spi_idle_clk(device) | (1 << device->cs_pin);
+}
+
+void bitbang_spi_select(const bitbang_spi_device_t* device) {
+    GPIO_REG__OUTPUT &= ~((1 << device->cs_pin) | (1 << device->mosi_pin));
+    bitbang_delay(device->select_delay);
+}
+
+void bitbang_spi_deselect(const bitbang_spi_device_t* device) {
+    GPIO_REG__OUTPUT |= 1 << device->cs_pin;
+}
+
+void bitbang_spi_transfer(const bitbang_spi_device_t* device,
+                          const uint8_t* tx, uint8_t* rx, const size_t len) {
+    volatile unsigned int* const gpio_output = &GPIO_REG__OUTPUT;
+    volatile unsigned int* const gpio_input = &GPIO_REG__INPUT;
+    const uint8_t mosi_pin = device->mosi_pin;
+    const uint8_t miso_pin = device->miso_pin;
+    const bool lsb_first = device->bit_order == BITBANG_LSB_FIRST;
+    const unsigned int idle_clk = bitbang_spi_idle_clk(device);
+    const unsigned int active_clk = idle_clk ^ (1 << device->clk_pin);
+    unsigned int first_clk = 0;
+    unsigned int second_clk = 0;
+    const unsigned int output_mask =
+        ~((1 << device->clk_pin) | (1 << mosi_pin));
+    unsigned int data = 0;
+    unsigned int tx_byte = 0;
+    unsigned int rx_byte = 0;
+    size_t i = 0;
+
+    // With clock phase 0, the data is sampled on the leading edge, i.e., when
+    // the clock leaves its idle level, and with clock phase 1 on the trailing
+    // edge.
+    if ((device->mode & 0x01) == 0) {
+        first_clk = idle_clk;
+        second_clk = active_clk;
+    } else {
+        first_clk = active_clk;
+        second_clk = idle_clk;
+    }
+
+    for (i = 0; i < len; ++i) {
+        tx_byte = tx != NULL ? tx[i] : 0;
+        if (lsb_first) {
+            tx_byte = bitbang_reverse(tx_byte);
+        }
+        rx_byte = 0;
+
+        BITBANG_SPI_TRANSFER_BIT(7)
+        BITBANG_SPI_TRANSFER_BIT(6)
+        BITBANG_SPI_TRANSFER_BIT(5)
+        BITBANG_SPI_TRANSFER_BIT(4)
+        BITBANG_SPI_TRANSFER_BIT(3)
+        BITBANG_SPI_TRANSFER_BIT(2)
+        BITBANG_SPI_TRANSFER_BIT(1)
+        BITBANG_SPI_TRANSFER_BIT(0)
+
+        if (rx != NULL) {
+            rx[i] = lsb_first ? bitbang_reverse(rx_byte) : rx_byte;
+        }
+        if (device->inter_byte_delay != 0 && i + 1 < len) {
+            bitbang_delay(device->inter_byte_delay);
+        }
+    }
+
+    // Idle the clock and set the data out to 0.
+    *gpio_output = (*gpio_output & output_mask) | idle_clk;
+}
+
+// Start an I2C transaction and set up its context.
+static void bitbang_i2c_start(const bitbang_i2c_bus_t* bus,
+                              bitbang_i2c_context_t* context) {
+    context->gpio_output = &GPIO_REG__OUTPUT;
+    context->gpio_input = &GPIO_REG__INPUT;
+    context->scl = 1 << bus->scl_pin;
+    context->sda = 1 << bus->sda_out_pin;
+    context->sda_out_pin = bus->sda_out_pin;
+    context->sda_in_pin = bus->sda_in_pin;
+    context->half_period_delay = bus->half_period_delay;
+    context->output_mask = ~(context->scl | context->sda);
+
+    // SDA falls while SCL is high.
+    bitbang_i2c_set_lines(context, context->scl | context->sda);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, 0);
+}
+
+// Repeat the start condition within a transaction.
+static void bitbang_i2c_restart(const bitbang_i2c_context_t* context) {
+    bitbang_i2c_set_lines(context, context->sda);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl | context->sda);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, 0);
+}
+
+// Stop the transaction. SDA rises while SCL is high.
+static void bitbang_i2c_stop(const bitbang_i2c_context_t* context) {
+    bitbang_i2c_set_lines(context, 0);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl | context->sda);
+}
+
+// Write a byte and return whether the slave acknowledged it.
+static bool bitbang_i2c_write_byte(const bitbang_i2c_context_t* context,
+                                   const uint8_t byte) {
+    unsigned int data = 0;
+    bool ack = false;
+
+    BITBANG_I2C_WRITE_BIT(7)
+    BITBANG_I2C_WRITE_BIT(6)
+    BITBANG_I2C_WRITE_BIT(5)
+    BITBANG_I2C_WRITE_BIT(4)
+    BITBANG_I2C_WRITE_BIT(3)
+    BITBANG_I2C_WRITE_BIT(2)
+    BITBANG_I2C_WRITE_BIT(1)
+    BITBANG_I2C_WRITE_BIT(0)
+
+    // Release SDA and sample the acknowledgment.
+    bitbang_i2c_clear_scl(context);
+    bitbang_i2c_set_lines(context, context->sda);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl | context->sda);
+    bitbang_delay(context->half_period_delay);
+    ack = ((*context->gpio_input >> context->sda_in_pin) & 0x01) == 0;
+    bitbang_i2c_set_lines(context, context->sda);
+    return ack;
+}
+
+// Read a byte and acknowledge it unless it is the last one.
+static uint8_t bitbang_i2c_read_byte(const bitbang_i2c_context_t* context,
+                                     const bool last) {
+    const unsigned int ack_data = last ? context->sda : 0;
+    unsigned int byte = 0;
+
+    BITBANG_I2C_READ_BIT(7)
+    BITBANG_I2C_READ_BIT(6)
+    BITBANG_I2C_READ_BIT(5)
+    BITBANG_I2C_READ_BIT(4)
+    BITBANG_I2C_READ_BIT(3)
+    BITBANG_I2C_READ_BIT(2)
+    BITBANG_I2C_READ_BIT(1)
+    BITBANG_I2C_READ_BIT(0)
+
+    bitbang_i2c_clear_scl(context);
+    bitbang_i2c_set_lines(context, ack_data);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, context->scl | ack_data);
+    bitbang_delay(context->half_period_delay);
+    bitbang_i2c_set_lines(context, ack_data);
+    return byte;
+}
+
+void bitbang_i2c_init(const bitbang_i2c_bus_t* bus) {
+    GPIO_REG__OUTPUT |= (1 << bus->scl_pin) | (1 << bus->sda_out_pin);
+}
+
+bool bitbang_i2c_write(const bitbang_i2c_device_t* device, const uint8_t* data,
+                       const size_t len) {
+    bitbang_i2c_context_t context;
+    bool ack = false;
+    size_t i = 0;
+
+    bitbang_i2c_start(device->bus, &context);
+    ack = bitbang_i2c_write_byte(&context,
+                                 (device->address << 1) | BITBANG_I2C_WRITE);
+    for (i = 0; ack && i < len; ++i) {
+        ack = bitbang_i2c_write_byte(&context, data[i]);
+    }
+    bitbang_i2c_stop(&context);
+    return ack;
+}
+
+bool bitbang_i2c_read(const bitbang_i2c_device_t* device, uint8_t* data,
+                      const size_t len) {
+    bitbang_i2c_context_t context;
+    bool ack = false;
+    size_t i = 0;
+
+    bitbang_i2c_start(device->bus, &context);
+    ack = bitbang_i2c_write_byte(&context,
+                                 (device->address << 1) | BITBANG_I2C_READ);
+    for (i = 0; ack && i < len; ++i) {
+        data[i] = bitbang_i2c_read_byte(&context, i + 1 == len);
+    }
+    bitbang_i2c_stop(&context);
+    return ack;
+}
+
+bool bitbang_i2c_read_registers(const bitbang_i2c_device_t* device,
+                                const uint8_t reg, uint8_t* data,
+                                const size_t len) {
+    bitbang_i2c_context_t context;
+    bool ack = false;
+    size_t i = 0;
+
+    bitbang_i2c_start(device->bus, &context);
+    ack = bitbang_i2c_write_byte(&context,
+                                 (device->address << 1) | BITBANG_I2C_WRITE) &&
+          bitbang_i2c_write_byte(&context, reg);
+    if (ack) {
+        bitbang_i2c_restart(&context);
+        ack = bitbang_i2c_write_byte(&context,
+                                     (device->address << 1) | BITBANG_I2C_READ);
+    }
+    for (i = 0; ack && i < len; ++i) {
+        data[i] = bitbang_i2c_read_byte(&context, i + 1 == len);
+    }
+    bitbang_i2c_stop(&context);
+    return ack;
+}
@@ -0,0 +1,123 @@
+// The bitbang module implements SPI and I2C masters on the GPIOs, so that
+// several sensors can share one driver instead of each copying the pin
+// handling. Each device is described by a descriptor with its pins and
+// timing, and the transfers clock the bits with unrolled loops. Every write
+// to the GPIO output register reads the register again and only replaces the
+// clock and data pins, so interrupts may change the other GPIO outputs during
+// a transfer, e.g., the debug trace pins. Since the read and the write are not
+// atomic, a change by an interrupt between them is still overwritten, so
+// interrupts that must not lose their GPIO outputs have to be disabled during
+// the transfer. The GPIOs must be enabled as inputs and outputs with
+// GPI_enables() and GPO_enables() beforehand.
+//
+// The SPI master supports all four SPI modes and both bit orders. Each bit
+// takes two writes to the GPIO output register and one read of the GPIO input
+// register.
+//
+// The I2C master supports 7-bit addresses, repeated starts, and bus speeds up
+// to what the GPIO writes allow, but no clock stretching or multiple masters.
+// Since the GPIOs cannot be switched to high impedance at run time, SCL is
+// driven push-pull, and SDA is driven through an external open-drain buffer
+// or a series resistor that the slaves can overdrive. SDA is read back on a
+// separate input pin, which may be wired to the same line.
+
+#ifndef __BITBANG_H
+#define __BITBANG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// SPI mode enum. Bit 1 is the clock polarity, and bit 0 is the clock phase.
+typedef enum {
+    // Clock idles low, data is sampled on the rising edge.
+    BITBANG_SPI_MODE_0 = 0,
+    // Clock idles low, data is sampled on the falling edge.
+    BITBANG_SPI_MODE_1 = 1,
+    // Clock idles high, data is sampled on the falling edge.
+    BITBANG_SPI_MODE_2 = 2,
+    // Clock idles high, data is sampled on the rising edge.
+    BITBANG_SPI_MODE_3 = 3,
+} bitbang_spi_mode_e;
+
+// Bit order enum.
+typedef enum {
+    BITBANG_MSB_FIRST = 0,
+    BITBANG_LSB_FIRST = 1,
+} bitbang_bit_order_e;
+
+// SPI device descriptor.
+typedef struct {
+    // GPIO pins of the chip select, clock, data out, and data in.
+    uint8_t cs_pin;
+    uint8_t clk_pin;
+    uint8_t mosi_pin;
+    uint8_t miso_pin;
+
+    // SPI mode.
+    bitbang_spi_mode_e mode;
+
+    // Bit order.
+    bitbang_bit_order_e bit_order;
+
+    // Delay after the chip select in busy-wait loop iterations.
+    uint16_t select_delay;
+
+    // Delay between bytes in busy-wait loop iterations.
+    uint16_t inter_byte_delay;
+} bitbang_spi_device_t;
+
+// I2C bus descriptor.
+typedef struct {
+    // GPIO pins of the clock, the data output, and the data input.
+    uint8_t scl_pin;
+    uint8_t sda_out_pin;
+    uint8_t sda_in_pin;
+
+    // Delay of each clock phase in busy-wait loop iterations. 0 clocks the bus
+    // as fast as possible.
+    uint16_t half_period_delay;
+} bitbang_i2c_bus_t;
+
+// I2C device descriptor.
+typedef struct {
+    // Bus of the device.
+    const bitbang_i2c_bus_t* bus;
+
+    // 7-bit address.
+    uint8_t address;
+} bitbang_i2c_device_t;
+
+// Deselect the SPI device and idle its clock.
+void bitbang_spi_init(const bitbang_spi_device_t* device);
+
+// Select the SPI device and wait for the select delay.
+void bitbang_spi_select(const bitbang_spi_device_t* device);
+
+// Deselect the SPI device.
+void bitbang_spi_deselect(const bitbang_spi_device_t* device);
+
+// Transfer len bytes full duplex while the device is selected. tx may be NULL
+// to send zeros, and rx may be NULL to discard the received bytes.
+void bitbang_spi_transfer(const bitbang_spi_device_t* device,
+                          const uint8_t* tx, uint8_t* rx, size_t len);
+
+// Idle the I2C bus.
+void bitbang_i2c_init(const bitbang_i2c_bus_t* bus);
+
+// Write len bytes to the I2C device. Return whether all bytes were
+// acknowledged.
+bool bitbang_i2c_write(const bitbang_i2c_device_t* device, const uint8_t* data,
+                       size_t len);
+
+// Read len bytes from the I2C device. Return whether the address was
+// acknowledged.
+bool bitbang_i2c_read(const bitbang_i2c_device_t* device, uint8_t* data,
+                      size_t len);
+
+// Write the register address and read len bytes from the I2C device with a
+// repeated start. Return whether all bytes were acknowledged.
+bool bitbang_i2c_read_registers(const bitbang_i2c_device_t* device,
+                                uint8_t reg, uint8_t* data, size_t len);
+
+#endif  // __BITBANG_H
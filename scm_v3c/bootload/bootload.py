@@ -1,3 +1,4 @@
+import binascii
 import serial
 import random
 import argparse
@@ -74,6 +75,12 @@ def program_cortex(teensy_port="COM15", scum_port="COM18", binary_image="./code.
         bindata[65529] = code_length // 256
         bindata[65530] = 0
         bindata[65531] = 0
+
+        # The Teensy inserts the standard CRC-32 of the code, which is the
+        # same CRC as computed by binascii
+        expected_crc = binascii.crc32(bytes(bindata[:code_length]))
+        expected_crc &= 0xFFFFFFFF
+        print("Expected CRC: 0x{:08X}".format(expected_crc))
     
     # Transfer payload to Teensy
     teensy_ser.write(b'transfersram\n')
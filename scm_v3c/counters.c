@@ -0,0 +1,180 @@
+#include "counters.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "memory_map.h"
+#include "rftimer.h"
+
+// Counter control value that resets all counters.
+#define COUNTERS_CONTROL_RESET 0x0000
+
+// Counter control value that disables all counters.
+#define COUNTERS_CONTROL_DISABLE 0x007F
+
+// Counter control value that enables all counters.
+#define COUNTERS_CONTROL_ENABLE 0x3FFF
+
+// Address offset between consecutive counter registers.
+#define COUNTERS_REGISTER_OFFSET 0x040000
+
+// Counter accumulator for the running mean and variance. The counts are
+// accumulated as deviations from the first count to keep the sums small.
+typedef struct {
+    // First count.
+    uint32_t offset;
+
+    // Sum of the deviations from the first count.
+    int64_t sum;
+
+    // Sum of the squared deviations from the first count.
+    uint64_t sum_squares;
+} counters_accumulator_t;
+
+// Measurement configuration.
+static counters_config_t g_counters_config;
+
+// Whether a measurement is running.
+static volatile bool g_counters_busy = false;
+
+// RF timer count when the counters were last started.
+static uint32_t g_counters_start_count = 0;
+
+// Counter accumulators.
+static counters_accumulator_t g_counters_accumulators[COUNTERS_NUM_COUNTERS];
+
+// Measurement statistics.
+static counters_stats_t g_counters_stats;
+
+// Update the statistics of the counter with the count.
+static void counters_update_counter_stats(const counters_counter_e counter,
+                                          const uint32_t count) {
+    counters_accumulator_t* accumulator = &g_counters_accumulators[counter];
+    counters_counter_stats_t* stats = &g_counters_stats.counters[counter];
+    const uint8_t num_windows = g_counters_stats.num_windows;
+    int32_t deviation = 0;
+
+    if (num_windows == 1) {
+        accumulator->offset = count;
+        accumulator->sum = 0;
+        accumulator->sum_squares = 0;
+        stats->min = count;
+        stats->max = count;
+    }
+
+    deviation = (int32_t)(count - accumulator->offset);
+    accumulator->sum += deviation;
+    accumulator->sum_squares += (int64_t)deviation * deviation;
+
+    if (count < stats->min) {
+        stats->min = count;
+    }
+    if (count > stats->max) {
+        stats->max = count;
+    }
+    stats->mean = accumulator->offset + accumulator->sum / num_windows;
+    if (num_windows > 1) {
+        stats->variance = (accumulator->sum_squares -
+                           accumulator->sum * accumulator->sum / num_windows) /
+                          (num_windows - 1);
+    } else {
+        stats->variance = 0;
+    }
+}
+
+// Called by the RF timer at the end of a measurement window.
+static void counters_window_elapsed(void) {
+    uint8_t i = 0;
+
+    if (!g_counters_busy) {
+        return;
+    }
+
+    // Reading the counters restarts them for the next window.
+    counters_read(&g_counters_stats.last_snapshot);
+
+    ++g_counters_stats.num_windows;
+    for (i = 0; i < COUNTERS_NUM_COUNTERS; ++i) {
+        counters_update_counter_stats(
+            (counters_counter_e)i, g_counters_stats.last_snapshot.counts[i]);
+    }
+
+    if (g_counters_stats.num_windows < g_counters_config.num_windows) {
+        rftimer_setCompareIn_by_id(
+            g_counters_start_count + g_counters_config.window_duration,
+            g_counters_config.rftimer_id);
+        return;
+    }
+
+    counters_stop();
+    rftimer_disable_interrupts_by_id(g_counters_config.rftimer_id);
+    g_counters_busy = false;
+    if (g_counters_config.callback != NULL) {
+        g_counters_config.callback(&g_counters_stats);
+    }
+}
+
+void counters_start(void) {
+    ANALOG_CFG_REG__0 = COUNTERS_CONTROL_RESET;
+    ANALOG_CFG_REG__0 = COUNTERS_CONTROL_ENABLE;
+    g_counters_start_count = RFTIMER_REG__COUNTER;
+}
+
+void counters_stop(void) { ANALOG_CFG_REG__0 = COUNTERS_CONTROL_DISABLE; }
+
+void counters_reset(void) { ANALOG_CFG_REG__0 = COUNTERS_CONTROL_RESET; }
+
+uint32_t counters_read_counter(const counters_counter_e counter) {
+    // The LSBs and MSBs of counter i are at register 2i and 2i + 1.
+    const uint32_t lsb_address =
+        APB_ANALOG_CFG_BASE + 2 * counter * COUNTERS_REGISTER_OFFSET;
+    const uint32_t rdata_lsb = *(unsigned int*)lsb_address;
+    const uint32_t rdata_msb =
+        *(unsigned int*)(lsb_address + COUNTERS_REGISTER_OFFSET);
+    return rdata_lsb + (rdata_msb << 16);
+}
+
+void counters_read(counters_snapshot_t* snapshot) {
+    uint8_t i = 0;
+
+    counters_stop();
+    snapshot->duration = RFTIMER_REG__COUNTER - g_counters_start_count;
+    for (i = 0; i < COUNTERS_NUM_COUNTERS; ++i) {
+        snapshot->counts[i] = counters_read_counter((counters_counter_e)i);
+    }
+    counters_start();
+}
+
+bool counters_measure_start(const counters_config_t* config) {
+    if (g_counters_busy || config->num_windows == 0 ||
+        config->window_duration == 0 ||
+        config->window_duration > COUNTERS_MAX_WINDOW_DURATION) {
+        return false;
+    }
+
+    g_counters_config = *config;
+    memset(&g_counters_stats, 0, sizeof(g_counters_stats));
+    memset(g_counters_accumulators, 0, sizeof(g_counters_accumulators));
+    g_counters_busy = true;
+
+    rftimer_set_callback_by_id(counters_window_elapsed, config->rftimer_id);
+    counters_start();
+    rftimer_setCompareIn_by_id(
+        g_counters_start_count + g_counters_config.window_duration,
+        g_counters_config.rftimer_id);
+    return true;
+}
+
+void counters_measure_abort(void) {
+    if (!g_counters_busy) {
+        return;
+    }
+    rftimer_disable_interrupts_by_id(g_counters_config.rftimer_id);
+    counters_stop();
+    g_counters_busy = false;
+}
+
+bool counters_measure_busy(void) { return g_counters_busy; }
+
+const counters_stats_t* counters_get_stats(void) { return &g_counters_stats; }
@@ -0,0 +1,120 @@
+// The counters module reads the on-chip clock counters, which count the edges
+// of the 32 kHz, HF_CLOCK, 2 MHz RC, divided LC, and IF ADC clocks. All
+// counters are started, stopped, and reset together through
+// ANALOG_CFG_REG__0, and each counter is read as two 16-bit halves.
+//
+// A measurement gates the counters with an RF timer compare channel for a
+// configurable window and repeats the window a configurable number of times.
+// The running mean and variance of each counter are updated after every
+// window, and the completion callback is called from the RF timer interrupt
+// once all windows have been measured. The RF timer must be initialized with
+// rftimer_init() before starting a measurement.
+
+#ifndef __COUNTERS_H
+#define __COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Maximum window duration in RF timer ticks. The RF timer treats compare values
+// that are further in the future as being in the past.
+#define COUNTERS_MAX_WINDOW_DURATION 0xFFFE
+
+// Counter enum. The enum value is the index of the counter registers.
+typedef enum {
+    COUNTERS_32K = 0,
+    COUNTERS_UNUSED_1 = 1,
+    COUNTERS_HF_CLOCK = 2,
+    COUNTERS_2M = 3,
+    // LC divider counter used by read_counters().
+    COUNTERS_LC_DIV = 4,
+    // LC divider counter used for calibration.
+    COUNTERS_LC = 5,
+    COUNTERS_IF = 6,
+    COUNTERS_NUM_COUNTERS = 7,
+} counters_counter_e;
+
+// Counter snapshot.
+typedef struct {
+    // Counts of all counters, indexed by counters_counter_e.
+    uint32_t counts[COUNTERS_NUM_COUNTERS];
+
+    // Number of RF timer ticks since the counters were started.
+    uint32_t duration;
+} counters_snapshot_t;
+
+// Statistics of a single counter over the measured windows.
+typedef struct {
+    // Mean count.
+    uint32_t mean;
+
+    // Sample variance of the count.
+    uint32_t variance;
+
+    // Minimum count.
+    uint32_t min;
+
+    // Maximum count.
+    uint32_t max;
+} counters_counter_stats_t;
+
+// Measurement statistics.
+typedef struct {
+    // Number of measured windows.
+    uint8_t num_windows;
+
+    // Statistics of all counters, indexed by counters_counter_e.
+    counters_counter_stats_t counters[COUNTERS_NUM_COUNTERS];
+
+    // Snapshot of the last window.
+    counters_snapshot_t last_snapshot;
+} counters_stats_t;
+
+// Measurement completion callback.
+typedef void (*counters_callback_t)(const counters_stats_t* stats);
+
+// Measurement configuration.
+typedef struct {
+    // Window duration in RF timer ticks, up to COUNTERS_MAX_WINDOW_DURATION.
+    uint32_t window_duration;
+
+    // Number of windows to measure.
+    uint8_t num_windows;
+
+    // RF timer compare channel used to gate the windows.
+    uint8_t rftimer_id;
+
+    // Callback called once all windows have been measured. Can be NULL.
+    counters_callback_t callback;
+} counters_config_t;
+
+// Reset and enable all counters.
+void counters_start(void);
+
+// Disable all counters. The counts are held until the counters are reset.
+void counters_stop(void);
+
+// Hold all counters in reset.
+void counters_reset(void);
+
+// Read the count of a single counter without stopping the counters.
+uint32_t counters_read_counter(counters_counter_e counter);
+
+// Stop all counters, read them into the snapshot, and restart them.
+void counters_read(counters_snapshot_t* snapshot);
+
+// Start a measurement. Return false if a measurement is already running or the
+// configuration is invalid.
+bool counters_measure_start(const counters_config_t* config);
+
+// Abort the running measurement. The completion callback is not called.
+void counters_measure_abort(void);
+
+// Return whether a measurement is running.
+bool counters_measure_busy(void);
+
+// Return the statistics of the last measurement. The statistics are updated
+// after every window of a running measurement.
+const counters_stats_t* counters_get_stats(void);
+
+#endif  // __COUNTERS_H
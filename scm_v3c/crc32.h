@@ -0,0 +1,40 @@
+// The CRC-32 is the IEEE 802.3 CRC with the polynomial 0x04C11DB7, which is
+// computed in its reflected form with an initial value of 0xFFFFFFFF and a
+// final inversion. This is the same CRC as computed by zlib and by the Teensy
+// when inserting the CRC during bootloading.
+//
+// The implementation is selected at compile time with CRC32_TABLE_BITS:
+//  - 0: bitwise without a table.
+//  - 4: nibble-wise with a 16-entry table (64 bytes).
+//  - 8: byte-wise with a 256-entry table (1 kB).
+// A larger table is faster, but it also increases the code size that needs to
+// be bootloaded.
+
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of message bits processed per table lookup.
+#ifndef CRC32_TABLE_BITS
+#define CRC32_TABLE_BITS 4
+#endif  // CRC32_TABLE_BITS
+
+// Initial value of the CRC register.
+#define CRC32_INITIAL_VALUE 0xFFFFFFFF
+
+// Update the CRC register with the message. The register should start at
+// CRC32_INITIAL_VALUE, and the CRC is the inverted register after the last
+// update.
+uint32_t crc32_update(uint32_t crc, const uint8_t* message, uint32_t length);
+
+// Compute the CRC of the message.
+uint32_t crc32(const uint8_t* message, uint32_t length);
+
+// Verify the selected implementation against the test vectors and the
+// original bitwise algorithm. Return whether all tests passed. crc_check()
+// runs the test if the CRC of the program does not match.
+bool crc32_self_test(void);
+
+#endif  // __CRC32_H
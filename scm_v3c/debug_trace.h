@@ -0,0 +1,132 @@
+// The debug trace macros mark events and states on GPIO pins for a logic
+// analyzer. Each trace point is mapped to a pin at compile time, so a trace
+// compiles to a single read-modify-write of the GPIO output register with a
+// constant mask instead of a function call, and the hot paths are timed
+// without being perturbed by the tracing. In addition, a 4-pin state bus
+// shows the state codes of a state machine, which
+// scripts/debug_trace_decode.py decodes from a logic analyzer CSV export
+// into a state timeline.
+//
+// The tracing is opt-in. Define DEBUG_TRACE in the project's preprocessor
+// symbols to enable it. Otherwise, all traces compile to nothing. The pins of
+// the trace points and of the state bus can be overridden with preprocessor
+// symbols, and a trace point mapped to DEBUG_TRACE_PIN_NONE compiles to
+// nothing. The traced pins must be enabled as outputs with GPO_enables().
+
+#ifndef __DEBUG_TRACE_H
+#define __DEBUG_TRACE_H
+
+#include "memory_map.h"
+
+// Pin of a disabled trace point.
+#define DEBUG_TRACE_PIN_NONE -1
+
+// Pin of the trace point for received and transmitted frames.
+#ifndef DEBUG_TRACE_PIN_FRAME
+#define DEBUG_TRACE_PIN_FRAME 1
+#endif
+
+// Pin of the trace point for interrupt service routines.
+#ifndef DEBUG_TRACE_PIN_ISR
+#define DEBUG_TRACE_PIN_ISR 2
+#endif
+
+// Pin of the trace point for slots.
+#ifndef DEBUG_TRACE_PIN_SLOT
+#define DEBUG_TRACE_PIN_SLOT 3
+#endif
+
+// Pin of the trace point for state machines.
+#ifndef DEBUG_TRACE_PIN_FSM
+#define DEBUG_TRACE_PIN_FSM 4
+#endif
+
+// Pin of the trace point for tasks.
+#ifndef DEBUG_TRACE_PIN_TASK
+#define DEBUG_TRACE_PIN_TASK 5
+#endif
+
+// Pin of the trace point for the radio interrupt.
+#ifndef DEBUG_TRACE_PIN_RADIO
+#define DEBUG_TRACE_PIN_RADIO 6
+#endif
+
+// Lowest pin of the state bus. The state code is output LSB-first on
+// DEBUG_TRACE_STATE_NUM_PINS consecutive pins. The default pins 12 to 15 are
+// the IMU SPI pins in spi.c, so applications that read the IMU must move the
+// state bus, e.g., to pins 8 to 11 if these are not used otherwise, or must
+// not use DEBUG_TRACE_STATE().
+#ifndef DEBUG_TRACE_STATE_PIN_BASE
+#define DEBUG_TRACE_STATE_PIN_BASE 12
+#endif
+
+// Number of pins of the state bus.
+#define DEBUG_TRACE_STATE_NUM_PINS 4
+
+// Number of state codes on the state bus.
+#define DEBUG_TRACE_NUM_STATES (1 << DEBUG_TRACE_STATE_NUM_PINS)
+
+// GPIO output mask of a trace point.
+#define DEBUG_TRACE_MASK(point)                   \
+    (DEBUG_TRACE_PIN_##point >= 0                 \
+         ? 1u << (DEBUG_TRACE_PIN_##point & 0x1F) \
+         : 0u)
+
+// GPIO output mask of the state bus.
+#define DEBUG_TRACE_STATE_MASK \
+    ((DEBUG_TRACE_NUM_STATES - 1u) << DEBUG_TRACE_STATE_PIN_BASE)
+
+#ifdef DEBUG_TRACE
+
+// Set the pin of the trace point.
+#define DEBUG_TRACE_SET(point)                           \
+    do {                                                 \
+        if (DEBUG_TRACE_MASK(point) != 0) {              \
+            GPIO_REG__OUTPUT |= DEBUG_TRACE_MASK(point); \
+        }                                                \
+    } while (0)
+
+// Clear the pin of the trace point.
+#define DEBUG_TRACE_CLR(point)                            \
+    do {                                                  \
+        if (DEBUG_TRACE_MASK(point) != 0) {               \
+            GPIO_REG__OUTPUT &= ~DEBUG_TRACE_MASK(point); \
+        }                                                 \
+    } while (0)
+
+// Toggle the pin of the trace point.
+#define DEBUG_TRACE_TOGGLE(point)                        \
+    do {                                                 \
+        if (DEBUG_TRACE_MASK(point) != 0) {              \
+            GPIO_REG__OUTPUT ^= DEBUG_TRACE_MASK(point); \
+        }                                                \
+    } while (0)
+
+// Output the state code on the state bus. All state pins change with the same
+// write, so the state bus never shows an intermediate code.
+#define DEBUG_TRACE_STATE(state)                                     \
+    do {                                                             \
+        GPIO_REG__OUTPUT =                                           \
+            (GPIO_REG__OUTPUT & ~DEBUG_TRACE_STATE_MASK) |           \
+            (((unsigned int)(state) & (DEBUG_TRACE_NUM_STATES - 1u)) \
+             << DEBUG_TRACE_STATE_PIN_BASE);                         \
+    } while (0)
+
+#else
+
+#define DEBUG_TRACE_SET(point) \
+    do {                       \
+    } while (0)
+#define DEBUG_TRACE_CLR(point) \
+    do {                       \
+    } while (0)
+#define DEBUG_TRACE_TOGGLE(point) \
+    do {                          \
+    } while (0)
+#define DEBUG_TRACE_STATE(state) \
+    do {                         \
+    } while (0)
+
+#endif  // DEBUG_TRACE
+
+#endif  // __DEBUG_TRACE_H
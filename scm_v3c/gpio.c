@@ -1,3 +1,4 @@
+#include "isr_profiler.h"
 #include "memory_map.h"
 #include "optical.h"
 
@@ -86,15 +87,23 @@ void gpio_15_toggle(void) { GPIO_REG__OUTPUT ^= 0x8000; }
 
 // ISRs for external interrupts
 void ext_gpio3_activehigh_debounced_isr() {
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_EXT_GPIO3);
     printf("External Interrupt GPIO3 triggered\r\n");
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_EXT_GPIO3);
 }
 void ext_gpio8_activehigh_isr() {
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_EXT_GPIO8);
     // Trigger the interrupt for calibration
     optical_sfd_isr();
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_EXT_GPIO8);
 }
 void ext_gpio9_activelow_isr() {
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_EXT_GPIO9);
     printf("External Interrupt GPIO9 triggered\r\n");
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_EXT_GPIO9);
 }
 void ext_gpio10_activelow_isr() {
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_EXT_GPIO10);
     printf("External Interrupt GPIO10 triggered\r\n");
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_EXT_GPIO10);
 }
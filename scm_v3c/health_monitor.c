@@ -0,0 +1,270 @@
+#include "health_monitor.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adc.h"
+#include "memory_map.h"
+#include "scm3c_hw_interface.h"
+
+// Conversion timeout in RF timer ticks. A conversion takes tens of
+// microseconds, and the timeout is generous enough not to depend on the RF
+// timer clock: 5000 ticks are 10 ms at the default 500 kHz and still 250 us
+// if the RF timer runs from the 20 MHz HF clock in lighthouse mode.
+#define HEALTH_MONITOR_CONVERSION_TIMEOUT 5000
+
+// 0 degrees Celsius in millikelvin.
+#define HEALTH_MONITOR_ZERO_CELSIUS_MILLIKELVIN 273150
+
+// Health monitor configuration.
+static health_monitor_config_t g_health_monitor_config;
+
+// Health monitor state.
+static health_monitor_state_t g_health_monitor_state;
+
+// RF timer count of the next measurement.
+static uint32_t g_health_monitor_next_measurement = 0;
+
+// Select the ADC input and write the scan chain.
+static void health_monitor_select_input(
+    const adc_input_mux_select_e input_mux_select) {
+    adc_config_t config = g_health_monitor_config.adc_config;
+
+    config.input_mux_select = input_mux_select;
+    asc_begin();
+    adc_config(&config);
+    asc_commit();
+}
+
+// Convert once and wait for the ADC output. Return false on a timeout.
+static bool health_monitor_convert(uint16_t* data) {
+    const uint32_t start = RFTIMER_REG__COUNTER;
+
+    adc_trigger();
+    while (!g_adc_output.valid) {
+        if (RFTIMER_REG__COUNTER - start > HEALTH_MONITOR_CONVERSION_TIMEOUT) {
+            return false;
+        }
+    }
+    *data = g_adc_output.data;
+    return true;
+}
+
+// Average the conversions of the ADC input with
+// HEALTH_MONITOR_RAW_FRACTIONAL_BITS fractional bits. Return false on a
+// timeout.
+static bool health_monitor_sample(const adc_input_mux_select_e input_mux_select,
+                                  uint32_t* raw) {
+    const uint8_t oversampling_log2 =
+        g_health_monitor_config.oversampling_log2;
+    uint32_t sum = 0;
+    uint16_t data = 0;
+    uint32_t i = 0;
+
+    health_monitor_select_input(input_mux_select);
+
+    // The first conversion after switching the mux may not have settled.
+    if (!health_monitor_convert(&data)) {
+        return false;
+    }
+
+    for (i = 0; i < ((uint32_t)1 << oversampling_log2); ++i) {
+        if (!health_monitor_convert(&data)) {
+            return false;
+        }
+        sum += data;
+    }
+
+    if (oversampling_log2 > HEALTH_MONITOR_RAW_FRACTIONAL_BITS) {
+        *raw = sum >> (oversampling_log2 - HEALTH_MONITOR_RAW_FRACTIONAL_BITS);
+    } else {
+        *raw = sum << (HEALTH_MONITOR_RAW_FRACTIONAL_BITS - oversampling_log2);
+    }
+    return true;
+}
+
+// Apply the calibration to an averaged ADC output.
+static inline int32_t health_monitor_calibrate(
+    const health_monitor_calibration_t* calibration, const uint32_t raw) {
+    return calibration->offset +
+           (int32_t)(((int64_t)calibration->gain * raw) >>
+                     (HEALTH_MONITOR_GAIN_FRACTIONAL_BITS +
+                      HEALTH_MONITOR_RAW_FRACTIONAL_BITS));
+}
+
+// Filter the value with an exponential moving average. The first measurement
+// initializes the filter.
+static inline int32_t health_monitor_filter(const int32_t filtered,
+                                            const int32_t value) {
+    if (g_health_monitor_state.num_measurements == 0) {
+        return value;
+    }
+    return filtered +
+           ((value - filtered) >> g_health_monitor_config.filter_shift);
+}
+
+// Update the supply state from the filtered battery voltage. The supply only
+// recovers to a better state once the battery voltage exceeds the threshold
+// by the hysteresis.
+static void health_monitor_update_supply_state(void) {
+    const int32_t voltage = g_health_monitor_state.battery_voltage;
+    const int32_t hysteresis = g_health_monitor_config.battery_hysteresis;
+    health_monitor_supply_state_e state = g_health_monitor_state.supply_state;
+
+    if (voltage < g_health_monitor_config.battery_critical_threshold) {
+        state = HEALTH_MONITOR_SUPPLY_CRITICAL;
+    } else if (voltage < g_health_monitor_config.battery_low_threshold) {
+        if (state != HEALTH_MONITOR_SUPPLY_CRITICAL ||
+            voltage >= g_health_monitor_config.battery_critical_threshold +
+                           hysteresis) {
+            state = HEALTH_MONITOR_SUPPLY_LOW;
+        }
+    } else if (voltage >=
+               g_health_monitor_config.battery_low_threshold + hysteresis) {
+        state = HEALTH_MONITOR_SUPPLY_OK;
+    } else if (state == HEALTH_MONITOR_SUPPLY_CRITICAL) {
+        state = HEALTH_MONITOR_SUPPLY_LOW;
+    }
+    g_health_monitor_state.supply_state = state;
+}
+
+void health_monitor_get_default_config(health_monitor_config_t* config) {
+    memset(config, 0, sizeof(health_monitor_config_t));
+
+    config->adc_config.reset_source = ADC_RESET_SOURCE_FSM;
+    config->adc_config.convert_source = ADC_CONVERT_SOURCE_FSM;
+    config->adc_config.pga_amplify_source = ADC_PGA_AMPLIFY_SOURCE_FSM;
+    config->adc_config.pga_gain = 0;
+    config->adc_config.settling_time = 0;
+    config->adc_config.bandgap_reference_tuning_code = 1;
+    config->adc_config.const_gm_tuning_code = 0xFF;
+    config->adc_config.vbat_div_4_enabled = true;
+    config->adc_config.ldo_enabled = true;
+    config->adc_config.input_mux_select = ADC_INPUT_MUX_SELECT_V_PTAT;
+    config->adc_config.pga_bypass = true;
+
+    // Measure every second.
+    config->period = 500000;
+    config->oversampling_log2 = 4;
+    config->filter_shift = 3;
+
+    // 1 LSB is 1.2 V / 1024, which corresponds to 0.586 K at 2 mV/K.
+    config->temperature_calibration.gain = 38400000;
+    config->temperature_calibration.offset =
+        -HEALTH_MONITOR_ZERO_CELSIUS_MILLIKELVIN;
+
+    // 1 LSB of VBAT / 4 is 4 * 1.2 V / 1024.
+    config->battery_calibration.gain = 307200;
+    config->battery_calibration.offset = 0;
+
+    config->battery_low_threshold = 2400;
+    config->battery_critical_threshold = 2100;
+    config->battery_hysteresis = 50;
+    config->low_backoff_shift = 1;
+    config->critical_backoff_shift = 3;
+}
+
+bool health_monitor_init(const health_monitor_config_t* config) {
+    if (config->period == 0 ||
+        config->oversampling_log2 > HEALTH_MONITOR_MAX_OVERSAMPLING_LOG2 ||
+        config->battery_critical_threshold > config->battery_low_threshold) {
+        return false;
+    }
+
+    g_health_monitor_config = *config;
+    memset(&g_health_monitor_state, 0, sizeof(health_monitor_state_t));
+
+    adc_enable_interrupt();
+    g_health_monitor_next_measurement = RFTIMER_REG__COUNTER + config->period;
+    return health_monitor_measure();
+}
+
+bool health_monitor_update(void) {
+    const uint32_t count = RFTIMER_REG__COUNTER;
+
+    if ((int32_t)(count - g_health_monitor_next_measurement) < 0) {
+        return false;
+    }
+    g_health_monitor_next_measurement = count + g_health_monitor_config.period;
+    return health_monitor_measure();
+}
+
+bool health_monitor_measure(void) {
+    uint32_t temperature_raw = 0;
+    uint32_t battery_raw = 0;
+
+    if (!health_monitor_sample(ADC_INPUT_MUX_SELECT_V_PTAT,
+                               &temperature_raw) ||
+        !health_monitor_sample(ADC_INPUT_MUX_SELECT_V_BAT_DIV_4,
+                               &battery_raw)) {
+        ++g_health_monitor_state.num_failures;
+        return false;
+    }
+
+    g_health_monitor_state.temperature_raw = temperature_raw;
+    g_health_monitor_state.battery_raw = battery_raw;
+    g_health_monitor_state.temperature = health_monitor_filter(
+        g_health_monitor_state.temperature,
+        health_monitor_calibrate(
+            &g_health_monitor_config.temperature_calibration,
+            temperature_raw));
+    g_health_monitor_state.battery_voltage = health_monitor_filter(
+        g_health_monitor_state.battery_voltage,
+        health_monitor_calibrate(&g_health_monitor_config.battery_calibration,
+                                 battery_raw));
+    health_monitor_update_supply_state();
+    ++g_health_monitor_state.num_measurements;
+    return true;
+}
+
+int32_t health_monitor_get_temperature(void) {
+    return g_health_monitor_state.temperature;
+}
+
+uint32_t health_monitor_get_temperature_millikelvin(void) {
+    return g_health_monitor_state.temperature +
+           HEALTH_MONITOR_ZERO_CELSIUS_MILLIKELVIN;
+}
+
+int32_t health_monitor_get_battery_voltage(void) {
+    return g_health_monitor_state.battery_voltage;
+}
+
+health_monitor_supply_state_e health_monitor_get_supply_state(void) {
+    return g_health_monitor_state.supply_state;
+}
+
+uint32_t health_monitor_scale_interval(const uint32_t interval) {
+    switch (g_health_monitor_state.supply_state) {
+        case HEALTH_MONITOR_SUPPLY_LOW:
+            return interval << g_health_monitor_config.low_backoff_shift;
+        case HEALTH_MONITOR_SUPPLY_CRITICAL:
+            return interval << g_health_monitor_config.critical_backoff_shift;
+        case HEALTH_MONITOR_SUPPLY_OK:
+        default:
+            return interval;
+    }
+}
+
+const health_monitor_state_t* health_monitor_get_state(void) {
+    return &g_health_monitor_state;
+}
+
+bool health_monitor_compute_calibration(
+    const uint32_t raw_a, const int32_t value_a, const uint32_t raw_b,
+    const int32_t value_b, health_monitor_calibration_t* calibration) {
+    if (raw_a == raw_b) {
+        return false;
+    }
+
+    calibration->gain =
+        (int32_t)(((int64_t)(value_b - value_a)
+                   << (HEALTH_MONITOR_GAIN_FRACTIONAL_BITS +
+                       HEALTH_MONITOR_RAW_FRACTIONAL_BITS)) /
+                  ((int32_t)raw_b - (int32_t)raw_a));
+    calibration->offset = 0;
+    calibration->offset =
+        value_a - health_monitor_calibrate(calibration, raw_a);
+    return true;
+}
@@ -0,0 +1,157 @@
+// The health monitor periodically measures the chip temperature from the PTAT
+// voltage and the battery voltage from VBAT / 4 with the on-chip ADC, so that
+// the frequency compensation can anticipate the temperature drift and the
+// application can back off when the supply sags.
+//
+// Each measurement switches the ADC input mux, discards the first conversion
+// after the switch, and averages 2^oversampling_log2 conversions. The average
+// is converted with a per-chip linear calibration and filtered with an
+// exponential moving average. The nominal calibrations of the default
+// configuration assume a PTAT slope of 2 mV/K and an ADC full scale of 1.2 V
+// and should be replaced by calibrations computed with
+// health_monitor_compute_calibration() from two known points.
+//
+// The monitor owns the ADC while it is running, so it must not be used
+// together with the ADC stream. The ADC interrupt is enabled by
+// health_monitor_init(), and the measurements are taken from the main loop by
+// health_monitor_update(), since switching the mux writes the scan chain.
+
+#ifndef __HEALTH_MONITOR_H
+#define __HEALTH_MONITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adc.h"
+
+// Maximum base 2 logarithm of the number of conversions per measurement.
+#define HEALTH_MONITOR_MAX_OVERSAMPLING_LOG2 8
+
+// Number of fractional bits of the averaged ADC output.
+#define HEALTH_MONITOR_RAW_FRACTIONAL_BITS 4
+
+// Number of fractional bits of the calibration gain.
+#define HEALTH_MONITOR_GAIN_FRACTIONAL_BITS 16
+
+// Supply state enum.
+typedef enum {
+    // The battery voltage is above the low threshold.
+    HEALTH_MONITOR_SUPPLY_OK = 0,
+    // The battery voltage is below the low threshold.
+    HEALTH_MONITOR_SUPPLY_LOW = 1,
+    // The battery voltage is below the critical threshold.
+    HEALTH_MONITOR_SUPPLY_CRITICAL = 2,
+} health_monitor_supply_state_e;
+
+// Linear calibration from the averaged ADC output to a physical value.
+typedef struct {
+    // Physical value per ADC LSB with HEALTH_MONITOR_GAIN_FRACTIONAL_BITS
+    // fractional bits.
+    int32_t gain;
+
+    // Physical value at an ADC output of 0.
+    int32_t offset;
+} health_monitor_calibration_t;
+
+// Health monitor configuration.
+typedef struct {
+    // ADC configuration. The input mux select is overridden for each
+    // measurement.
+    adc_config_t adc_config;
+
+    // Measurement period in RF timer ticks.
+    uint32_t period;
+
+    // Base 2 logarithm of the number of conversions per measurement.
+    uint8_t oversampling_log2;
+
+    // Base 2 logarithm of the exponential moving average time constant in
+    // measurements. 0 disables the filter.
+    uint8_t filter_shift;
+
+    // Calibration from the PTAT voltage to the temperature in millidegrees
+    // Celsius.
+    health_monitor_calibration_t temperature_calibration;
+
+    // Calibration from VBAT / 4 to the battery voltage in millivolts.
+    health_monitor_calibration_t battery_calibration;
+
+    // Battery voltage thresholds in millivolts below which the supply is low
+    // or critical.
+    int32_t battery_low_threshold;
+    int32_t battery_critical_threshold;
+
+    // Battery voltage in millivolts that the supply has to recover above a
+    // threshold to leave the corresponding state.
+    int32_t battery_hysteresis;
+
+    // Base 2 logarithm of the factor by which health_monitor_scale_interval()
+    // stretches the intervals when the supply is low or critical.
+    uint8_t low_backoff_shift;
+    uint8_t critical_backoff_shift;
+} health_monitor_config_t;
+
+// Health monitor state.
+typedef struct {
+    // Last averaged ADC outputs with HEALTH_MONITOR_RAW_FRACTIONAL_BITS
+    // fractional bits.
+    uint32_t temperature_raw;
+    uint32_t battery_raw;
+
+    // Filtered temperature in millidegrees Celsius.
+    int32_t temperature;
+
+    // Filtered battery voltage in millivolts.
+    int32_t battery_voltage;
+
+    // Supply state.
+    health_monitor_supply_state_e supply_state;
+
+    // Number of completed measurements.
+    uint32_t num_measurements;
+
+    // Number of measurements that failed because a conversion timed out.
+    uint32_t num_failures;
+} health_monitor_state_t;
+
+// Get the default configuration.
+void health_monitor_get_default_config(health_monitor_config_t* config);
+
+// Initialize the health monitor and take the first measurement. Return false
+// if the configuration is invalid or the measurement failed.
+bool health_monitor_init(const health_monitor_config_t* config);
+
+// Take a measurement if the measurement period has elapsed. Call this
+// periodically from the main loop. Return whether a measurement was taken.
+bool health_monitor_update(void);
+
+// Take a measurement now. Return whether the measurement succeeded.
+bool health_monitor_measure(void);
+
+// Return the filtered temperature in millidegrees Celsius.
+int32_t health_monitor_get_temperature(void);
+
+// Return the filtered temperature in millikelvin. This can be set as the
+// temperature source of the temperature compensation.
+uint32_t health_monitor_get_temperature_millikelvin(void);
+
+// Return the filtered battery voltage in millivolts.
+int32_t health_monitor_get_battery_voltage(void);
+
+// Return the supply state.
+health_monitor_supply_state_e health_monitor_get_supply_state(void);
+
+// Stretch the interval of a periodic activity, e.g., the packet interval,
+// according to the supply state.
+uint32_t health_monitor_scale_interval(uint32_t interval);
+
+// Return the state.
+const health_monitor_state_t* health_monitor_get_state(void);
+
+// Compute the calibration from the averaged ADC outputs at two known physical
+// values. Return false if the ADC outputs are equal.
+bool health_monitor_compute_calibration(
+    uint32_t raw_a, int32_t value_a, uint32_t raw_b, int32_t value_b,
+    health_monitor_calibration_t* calibration);
+
+#endif  // __HEALTH_MONITOR_H
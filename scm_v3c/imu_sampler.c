@@ -0,0 +1,220 @@
+#include "imu_sampler.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "memory_map.h"
+#include "rftimer.h"
+#include "spi.h"
+
+// Longest RF timer compare interval. The RF timer treats compare values that
+// are LARGEST_INTERVAL (0xFFFF) or more ticks ahead as being in the past, so
+// longer sample periods are split into several compares.
+#define IMU_SAMPLER_MAX_COMPARE_INTERVAL 0xF000
+
+// Sampler configuration.
+static imu_sampler_config_t g_imu_sampler_config;
+
+// Whether the sampler is running.
+static volatile bool g_imu_sampler_running = false;
+
+// RF timer count of the next RF timer triggered read.
+static uint32_t g_imu_sampler_next_sample = 0;
+
+// Whether a read has been triggered but not yet performed, and the RF timer
+// count at the trigger.
+static volatile bool g_imu_sampler_pending = false;
+static volatile uint32_t g_imu_sampler_pending_timestamp = 0;
+
+// Ring buffer of samples. The main loop pushes at the head in
+// imu_sampler_process() and pops at the tail.
+static imu_sampler_sample_t g_imu_sampler_buffer[IMU_SAMPLER_BUFFER_SIZE];
+static volatile uint32_t g_imu_sampler_head = 0;
+static volatile uint32_t g_imu_sampler_tail = 0;
+
+// Number of dropped samples.
+static volatile uint32_t g_imu_sampler_num_dropped = 0;
+
+// Sequence number of the next sample packet.
+static uint8_t g_imu_sampler_packet_sequence = 0;
+
+// Trigger a read, which is performed by imu_sampler_process(). Only the
+// timestamp is taken in the interrupt, so that the SPI transfer does not
+// delay the other interrupts.
+static void imu_sampler_trigger(void) {
+    if (g_imu_sampler_pending) {
+        ++g_imu_sampler_num_dropped;
+        return;
+    }
+    g_imu_sampler_pending_timestamp = RFTIMER_REG__COUNTER;
+    g_imu_sampler_pending = true;
+}
+
+// Schedule the RF timer compare towards the next read, at most
+// IMU_SAMPLER_MAX_COMPARE_INTERVAL ticks ahead.
+static void imu_sampler_schedule(void) {
+    uint32_t compare = g_imu_sampler_next_sample;
+
+    if ((int32_t)(compare - RFTIMER_REG__COUNTER) >
+        IMU_SAMPLER_MAX_COMPARE_INTERVAL) {
+        compare = RFTIMER_REG__COUNTER + IMU_SAMPLER_MAX_COMPARE_INTERVAL;
+    }
+    rftimer_setCompareIn_by_id(compare, g_imu_sampler_config.rftimer_id);
+}
+
+// Called by the RF timer at every sample period and at the intermediate
+// compares of long sample periods.
+static void imu_sampler_compare(void) {
+    if (!g_imu_sampler_running) {
+        return;
+    }
+
+    // Reschedule the intermediate compares until the read is due.
+    if ((int32_t)(g_imu_sampler_next_sample - RFTIMER_REG__COUNTER) > 0) {
+        imu_sampler_schedule();
+        return;
+    }
+    imu_sampler_trigger();
+
+    // Schedule the next read one period after this one. If the interrupt was
+    // delayed by more than a period, skip the missed reads.
+    g_imu_sampler_next_sample += g_imu_sampler_config.period;
+    while ((int32_t)(g_imu_sampler_next_sample - RFTIMER_REG__COUNTER) <= 0) {
+        g_imu_sampler_next_sample += g_imu_sampler_config.period;
+        ++g_imu_sampler_num_dropped;
+    }
+    imu_sampler_schedule();
+}
+
+// Store a 16-bit value LSB-first.
+static inline void imu_sampler_put_int16(uint8_t* buffer,
+                                         const uint16_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+}
+
+bool imu_sampler_start(const imu_sampler_config_t* config) {
+    if (g_imu_sampler_running ||
+        (config->trigger == IMU_SAMPLER_TRIGGER_RFTIMER &&
+         config->period == 0)) {
+        return false;
+    }
+
+    g_imu_sampler_config = *config;
+    g_imu_sampler_head = 0;
+    g_imu_sampler_tail = 0;
+    g_imu_sampler_num_dropped = 0;
+    g_imu_sampler_pending = false;
+    g_imu_sampler_running = true;
+
+    if (config->trigger == IMU_SAMPLER_TRIGGER_RFTIMER) {
+        rftimer_set_callback_by_id(imu_sampler_compare, config->rftimer_id);
+        g_imu_sampler_next_sample = RFTIMER_REG__COUNTER + config->period;
+        imu_sampler_schedule();
+    }
+    return true;
+}
+
+void imu_sampler_stop(void) {
+    if (!g_imu_sampler_running) {
+        return;
+    }
+    g_imu_sampler_running = false;
+    if (g_imu_sampler_config.trigger == IMU_SAMPLER_TRIGGER_RFTIMER) {
+        rftimer_disable_interrupts_by_id(g_imu_sampler_config.rftimer_id);
+    }
+}
+
+void imu_sampler_data_ready_isr(void) {
+    if (g_imu_sampler_running &&
+        g_imu_sampler_config.trigger == IMU_SAMPLER_TRIGGER_DATA_READY) {
+        imu_sampler_trigger();
+    }
+}
+
+bool imu_sampler_process(void) {
+    imu_sampler_sample_t* sample = NULL;
+
+    if (!g_imu_sampler_pending) {
+        return false;
+    }
+
+    if (g_imu_sampler_head - g_imu_sampler_tail >= IMU_SAMPLER_BUFFER_SIZE) {
+        ++g_imu_sampler_num_dropped;
+        g_imu_sampler_pending = false;
+        return false;
+    }
+
+    sample = &g_imu_sampler_buffer[g_imu_sampler_head &
+                                   (IMU_SAMPLER_BUFFER_SIZE - 1)];
+    sample->trigger_timestamp = g_imu_sampler_pending_timestamp;
+    g_imu_sampler_pending = false;
+    sample->timestamp = RFTIMER_REG__COUNTER;
+    read_all_imu_data(&sample->imu_measurement);
+    ++g_imu_sampler_head;
+    return true;
+}
+
+uint32_t imu_sampler_num_samples(void) {
+    return g_imu_sampler_head - g_imu_sampler_tail;
+}
+
+bool imu_sampler_pop(imu_sampler_sample_t* sample) {
+    if (g_imu_sampler_head == g_imu_sampler_tail) {
+        return false;
+    }
+    *sample = g_imu_sampler_buffer[g_imu_sampler_tail &
+                                   (IMU_SAMPLER_BUFFER_SIZE - 1)];
+    ++g_imu_sampler_tail;
+    return true;
+}
+
+uint32_t imu_sampler_get_num_dropped(void) { return g_imu_sampler_num_dropped; }
+
+uint8_t imu_sampler_build_packet(uint8_t* packet,
+                                 const uint8_t max_num_samples) {
+    const imu_sampler_sample_t* sample = NULL;
+    uint32_t first_timestamp = 0;
+    uint8_t num_samples = 0;
+    uint8_t* buffer = NULL;
+
+    while (num_samples < max_num_samples &&
+           num_samples < IMU_SAMPLER_MAX_NUM_PACKET_SAMPLES &&
+           g_imu_sampler_head != g_imu_sampler_tail) {
+        sample = &g_imu_sampler_buffer[g_imu_sampler_tail &
+                                       (IMU_SAMPLER_BUFFER_SIZE - 1)];
+        if (num_samples == 0) {
+            first_timestamp = sample->timestamp;
+        } else if (sample->timestamp - first_timestamp > 0xFFFF) {
+            break;
+        }
+
+        buffer = &packet[IMU_SAMPLER_PACKET_HEADER_LENGTH +
+                         num_samples * IMU_SAMPLER_PACKET_SAMPLE_LENGTH];
+        imu_sampler_put_int16(&buffer[0], sample->timestamp - first_timestamp);
+        imu_sampler_put_int16(&buffer[2], sample->imu_measurement.acc_x.value);
+        imu_sampler_put_int16(&buffer[4], sample->imu_measurement.acc_y.value);
+        imu_sampler_put_int16(&buffer[6], sample->imu_measurement.acc_z.value);
+        imu_sampler_put_int16(&buffer[8], sample->imu_measurement.gyro_x.value);
+        imu_sampler_put_int16(&buffer[10],
+                              sample->imu_measurement.gyro_y.value);
+        imu_sampler_put_int16(&buffer[12],
+                              sample->imu_measurement.gyro_z.value);
+
+        ++g_imu_sampler_tail;
+        ++num_samples;
+    }
+
+    if (num_samples == 0) {
+        return 0;
+    }
+
+    packet[0] = IMU_SAMPLER_PACKET_CODE;
+    packet[1] = g_imu_sampler_packet_sequence++;
+    packet[2] = num_samples;
+    imu_sampler_put_int16(&packet[3], first_timestamp & 0xFFFF);
+    imu_sampler_put_int16(&packet[5], first_timestamp >> 16);
+    return IMU_SAMPLER_PACKET_HEADER_LENGTH +
+           num_samples * IMU_SAMPLER_PACKET_SAMPLE_LENGTH;
+}
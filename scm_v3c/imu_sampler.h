@@ -0,0 +1,118 @@
+// The IMU sampler triggers the IMU reads at a fixed rate from an interrupt
+// instead of timing them in the main loop, so the trigger times do not depend
+// on the loop or on the radio. The interrupt only takes the trigger time, and
+// the main loop performs the SPI read in imu_sampler_process(), so the read
+// itself is delayed by whatever the loop does between the trigger and the
+// next call, e.g., sending a packet. Each sample is therefore stored with the
+// RF timer count at its read, which is when the IMU registers were sampled,
+// and with the count at its trigger in a ring buffer, from which the main
+// loop pops the samples or packs several of them into one radio packet.
+//
+// A read is triggered either by an RF timer compare channel, which is
+// rescheduled one period after its last read so that the rate does not drift,
+// or by the IMU data-ready pin, whose external interrupt handler must call
+// imu_sampler_data_ready_isr(). Periods longer than the RF timer compare range
+// are split into several compares. The RF timer must be initialized with
+// rftimer_init() before starting the sampler. Since the samples are read over
+// SPI by imu_sampler_process(), the main loop must not access the IMU
+// otherwise while the sampler is running.
+
+#ifndef __IMU_SAMPLER_H
+#define __IMU_SAMPLER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "spi.h"
+
+// Number of samples in the ring buffer. Must be a power of 2.
+#define IMU_SAMPLER_BUFFER_SIZE 32
+
+// First byte of a sample packet.
+#define IMU_SAMPLER_PACKET_CODE 106
+
+// Length of the sample packet header: code, sequence number, number of
+// samples, and the 4-byte timestamp of the first sample.
+#define IMU_SAMPLER_PACKET_HEADER_LENGTH 7
+
+// Length of a sample in a sample packet: the 2-byte timestamp offset from the
+// first sample and the 12 accelerometer and gyroscope bytes.
+#define IMU_SAMPLER_PACKET_SAMPLE_LENGTH 14
+
+// Maximum number of samples in a sample packet, which fits into a 125-byte
+// payload.
+#define IMU_SAMPLER_MAX_NUM_PACKET_SAMPLES 8
+
+// Maximum length of a sample packet.
+#define IMU_SAMPLER_MAX_PACKET_LENGTH   \
+    (IMU_SAMPLER_PACKET_HEADER_LENGTH + \
+     IMU_SAMPLER_PACKET_SAMPLE_LENGTH * IMU_SAMPLER_MAX_NUM_PACKET_SAMPLES)
+
+// Trigger enum.
+typedef enum {
+    // RF timer compare channel with a fixed period.
+    IMU_SAMPLER_TRIGGER_RFTIMER = 0,
+    // IMU data-ready pin.
+    IMU_SAMPLER_TRIGGER_DATA_READY = 1,
+} imu_sampler_trigger_e;
+
+// Sampler configuration.
+typedef struct {
+    // Trigger of the reads.
+    imu_sampler_trigger_e trigger;
+
+    // Sample period in RF timer ticks for the RF timer trigger.
+    uint32_t period;
+
+    // RF timer compare channel for the RF timer trigger.
+    uint8_t rftimer_id;
+} imu_sampler_config_t;
+
+// Timestamped IMU sample.
+typedef struct {
+    // RF timer count at the read.
+    uint32_t timestamp;
+
+    // RF timer count at the trigger of the read. The difference to the
+    // timestamp is the latency of the main loop.
+    uint32_t trigger_timestamp;
+
+    // Accelerometer and gyroscope measurement.
+    imu_data_t imu_measurement;
+} imu_sampler_sample_t;
+
+// Start sampling. Return false if the sampler is already running or the
+// configuration is invalid.
+bool imu_sampler_start(const imu_sampler_config_t* config);
+
+// Stop sampling. The buffered samples can still be popped.
+void imu_sampler_stop(void);
+
+// Trigger a read. Call this from the external interrupt handler of the IMU
+// data-ready pin.
+void imu_sampler_data_ready_isr(void);
+
+// Perform the triggered read into the ring buffer. Call this periodically
+// from the main loop, at least once per sample period. Return whether a
+// sample was read.
+bool imu_sampler_process(void);
+
+// Return the number of buffered samples.
+uint32_t imu_sampler_num_samples(void);
+
+// Pop the oldest sample. Return whether a sample was popped.
+bool imu_sampler_pop(imu_sampler_sample_t* sample);
+
+// Return the number of samples that were dropped because the ring buffer was
+// full, a compare was missed, or the previous read was still pending.
+uint32_t imu_sampler_get_num_dropped(void);
+
+// Pop up to max_num_samples samples, but at most
+// IMU_SAMPLER_MAX_NUM_PACKET_SAMPLES, into a sample packet with the timestamps
+// of their reads. The samples are
+// stored LSB-first after the header. Samples that are more than 0xFFFF ticks
+// after the first sample are left for the next packet. Return the packet
+// length or 0 if there is no sample.
+uint8_t imu_sampler_build_packet(uint8_t* packet, uint8_t max_num_samples);
+
+#endif  // __IMU_SAMPLER_H
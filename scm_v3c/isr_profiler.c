@@ -0,0 +1,108 @@
+#include "isr_profiler.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+// ISR names printed in the dump, indexed by isr_profiler_isr_e.
+static const char* const g_isr_profiler_isr_names[ISR_PROFILER_NUM_ISRS] = {
+    "radio",     "rftimer",   "optical_sfd", "adc",
+    "ext_gpio3", "ext_gpio8", "ext_gpio9",   "ext_gpio10",
+};
+
+// ISR statistics.
+static isr_profiler_stats_t g_isr_profiler_stats[ISR_PROFILER_NUM_ISRS];
+
+// Return the log2 histogram bucket of the given number of ticks.
+static inline uint8_t isr_profiler_bucket(uint32_t ticks) {
+    uint8_t bucket = 0;
+    while (ticks != 0 && bucket < ISR_PROFILER_NUM_BUCKETS - 1) {
+        ticks >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// Increment the histogram bucket, saturating at the maximum count.
+static inline void isr_profiler_increment_bucket(uint16_t* histogram,
+                                                 const uint32_t ticks) {
+    const uint8_t bucket = isr_profiler_bucket(ticks);
+    if (histogram[bucket] != UINT16_MAX) {
+        ++histogram[bucket];
+    }
+}
+
+// Print the histogram as a comma-separated list.
+static void isr_profiler_print_histogram(const uint16_t* histogram) {
+    uint8_t i = 0;
+    for (i = 0; i < ISR_PROFILER_NUM_BUCKETS; ++i) {
+        printf(i == 0 ? "%u" : ",%u", histogram[i]);
+    }
+}
+
+void isr_profiler_reset(void) {
+    memset(g_isr_profiler_stats, 0, sizeof(g_isr_profiler_stats));
+}
+
+void isr_profiler_enter(const isr_profiler_isr_e isr) {
+    g_isr_profiler_stats[isr].entry_count = RFTIMER_REG__COUNTER;
+}
+
+void isr_profiler_exit(const isr_profiler_isr_e isr) {
+    isr_profiler_stats_t* stats = &g_isr_profiler_stats[isr];
+
+    // The RF timer wraps around at RFTIMER_MAX_COUNT, so the unsigned
+    // difference is correct across an overflow.
+    const uint32_t duration = RFTIMER_REG__COUNTER - stats->entry_count;
+
+    if (stats->num_invocations == 0 || duration < stats->min_duration) {
+        stats->min_duration = duration;
+    }
+    ++stats->num_invocations;
+    stats->total_duration += duration;
+    if (duration > stats->max_duration) {
+        stats->max_duration = duration;
+    }
+    isr_profiler_increment_bucket(stats->duration_histogram, duration);
+}
+
+void isr_profiler_record_latency(const isr_profiler_isr_e isr,
+                                 const uint32_t compare_value) {
+    isr_profiler_stats_t* stats = &g_isr_profiler_stats[isr];
+    const uint32_t latency = stats->entry_count - compare_value;
+
+    ++stats->num_latencies;
+    if (latency > stats->max_latency) {
+        stats->max_latency = latency;
+    }
+    isr_profiler_increment_bucket(stats->latency_histogram, latency);
+}
+
+const isr_profiler_stats_t* isr_profiler_get_stats(
+    const isr_profiler_isr_e isr) {
+    return &g_isr_profiler_stats[isr];
+}
+
+void isr_profiler_print(void) {
+    uint8_t i = 0;
+    const isr_profiler_stats_t* stats = NULL;
+
+    for (i = 0; i < ISR_PROFILER_NUM_ISRS; ++i) {
+        stats = &g_isr_profiler_stats[i];
+        if (stats->num_invocations == 0) {
+            continue;
+        }
+
+        printf("ISRPROF %s n=%u min=%u max=%u sum=%u dur=",
+               g_isr_profiler_isr_names[i], stats->num_invocations,
+               stats->min_duration, stats->max_duration,
+               stats->total_duration);
+        isr_profiler_print_histogram(stats->duration_histogram);
+        printf(" nlat=%u maxlat=%u lat=", stats->num_latencies,
+               stats->max_latency);
+        isr_profiler_print_histogram(stats->latency_histogram);
+        printf("\n");
+    }
+}
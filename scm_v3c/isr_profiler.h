@@ -0,0 +1,111 @@
+// The ISR profiler timestamps the entry and exit of the interrupt service
+// routines with the RF timer, since the Cortex-M0 has no cycle counter. The
+// RF timer runs at 500 kHz, so each tick is 2 us. Durations and entry
+// latencies are accumulated into log2 histograms per ISR, which can be dumped
+// over UART and parsed by scripts/isr_profile_report.py.
+//
+// The profiler is opt-in. Define ISR_PROFILER in the project's preprocessor
+// symbols to enable it. Otherwise, all hooks compile to nothing.
+
+#ifndef __ISR_PROFILER_H
+#define __ISR_PROFILER_H
+
+#include <stdint.h>
+
+// Number of log2 histogram buckets. Bucket 0 counts samples of 0 ticks, and
+// bucket i counts samples in [2^(i-1), 2^i) ticks. The last bucket also
+// counts all longer samples.
+#define ISR_PROFILER_NUM_BUCKETS 16
+
+// Profiled ISR enum.
+typedef enum {
+    ISR_PROFILER_ISR_RADIO = 0,
+    ISR_PROFILER_ISR_RFTIMER = 1,
+    ISR_PROFILER_ISR_OPTICAL_SFD = 2,
+    ISR_PROFILER_ISR_ADC = 3,
+    ISR_PROFILER_ISR_EXT_GPIO3 = 4,
+    ISR_PROFILER_ISR_EXT_GPIO8 = 5,
+    ISR_PROFILER_ISR_EXT_GPIO9 = 6,
+    ISR_PROFILER_ISR_EXT_GPIO10 = 7,
+    ISR_PROFILER_NUM_ISRS = 8,
+} isr_profiler_isr_e;
+
+// ISR profiler statistics of a single ISR.
+typedef struct {
+    // RF timer count at the last entry.
+    uint32_t entry_count;
+
+    // Number of completed invocations.
+    uint32_t num_invocations;
+
+    // Minimum duration in RF timer ticks.
+    uint32_t min_duration;
+
+    // Maximum duration in RF timer ticks.
+    uint32_t max_duration;
+
+    // Sum of all durations in RF timer ticks.
+    uint32_t total_duration;
+
+    // Duration histogram.
+    uint16_t duration_histogram[ISR_PROFILER_NUM_BUCKETS];
+
+    // Number of latency samples.
+    uint32_t num_latencies;
+
+    // Maximum entry latency in RF timer ticks.
+    uint32_t max_latency;
+
+    // Entry latency histogram.
+    uint16_t latency_histogram[ISR_PROFILER_NUM_BUCKETS];
+} isr_profiler_stats_t;
+
+#ifdef ISR_PROFILER
+
+// Mark the entry of the ISR.
+#define ISR_PROFILER_ENTER(isr) isr_profiler_enter(isr)
+
+// Mark the exit of the ISR.
+#define ISR_PROFILER_EXIT(isr) isr_profiler_exit(isr)
+
+// Record the entry latency of the ISR relative to the programmed compare
+// value.
+#define ISR_PROFILER_LATENCY(isr, compare_value) \
+    isr_profiler_record_latency(isr, compare_value)
+
+#else
+
+#define ISR_PROFILER_ENTER(isr) \
+    do {                        \
+    } while (0)
+#define ISR_PROFILER_EXIT(isr) \
+    do {                       \
+    } while (0)
+#define ISR_PROFILER_LATENCY(isr, compare_value) \
+    do {                                         \
+    } while (0)
+
+#endif  // ISR_PROFILER
+
+// Reset all ISR statistics.
+void isr_profiler_reset(void);
+
+// Record the RF timer count at the entry of the ISR.
+void isr_profiler_enter(isr_profiler_isr_e isr);
+
+// Record the duration of the ISR since its last entry.
+void isr_profiler_exit(isr_profiler_isr_e isr);
+
+// Record the latency between the given compare value and the last entry of
+// the ISR.
+void isr_profiler_record_latency(isr_profiler_isr_e isr,
+                                 uint32_t compare_value);
+
+// Return the statistics of the ISR.
+const isr_profiler_stats_t* isr_profiler_get_stats(isr_profiler_isr_e isr);
+
+// Print the statistics of all ISRs that have run at least once. Each ISR is
+// printed as a single line starting with "ISRPROF".
+void isr_profiler_print(void);
+
+#endif  // __ISR_PROFILER_H
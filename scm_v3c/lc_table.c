@@ -0,0 +1,221 @@
+#include "lc_table.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "counters.h"
+#include "scm3c_hw_interface.h"
+#include "tuning.h"
+
+// LC table.
+static lc_table_t g_lc_table;
+
+// Whether the table is valid.
+static bool g_lc_table_valid = false;
+
+// Build statistics.
+static lc_table_stats_t g_lc_table_stats;
+
+// Difference between the measured count and the target count of each LC code
+// while building the table.
+static uint16_t g_lc_table_errors[LC_TABLE_MAX_NUM_CODES];
+
+// Tune to the tuning code and measure the mean LC count over the windows.
+static uint32_t lc_table_measure(const tuning_code_t* tuning_code) {
+    uint32_t count = 0;
+    uint32_t variance = 0;
+
+    tuning_tune_radio(tuning_code);
+    count = lc_table_measure_count();
+
+    variance = counters_get_stats()->counters[COUNTERS_LC].variance;
+    if (variance > g_lc_table_stats.max_variance) {
+        g_lc_table_stats.max_variance = variance;
+    }
+    return count;
+}
+
+// Return the target count of the LC code.
+static inline uint32_t lc_table_target_count(const uint16_t lc_code) {
+    const uint32_t span = g_lc_table.max_count - g_lc_table.min_count;
+    return g_lc_table.min_count +
+           (uint32_t)((uint64_t)span * lc_code / (g_lc_table.num_codes - 1));
+}
+
+// Record the tuning code for the LC code closest to the measured count.
+static void lc_table_record(const tuning_code_t* tuning_code,
+                            const uint32_t count) {
+    uint16_t lc_code = 0;
+    uint32_t target_count = 0;
+    uint32_t error = 0;
+
+    if (count < g_lc_table.min_count || count > g_lc_table.max_count) {
+        ++g_lc_table_stats.num_out_of_range;
+        return;
+    }
+
+    lc_code = lc_table_count_to_lc_code(count);
+    target_count = lc_table_target_count(lc_code);
+    error = count > target_count ? count - target_count : target_count - count;
+    if (error > UINT16_MAX) {
+        error = UINT16_MAX;
+    }
+    if (error < g_lc_table_errors[lc_code]) {
+        g_lc_table_errors[lc_code] = error;
+        g_lc_table.tuning_codes[lc_code] = *tuning_code;
+    }
+}
+
+bool lc_table_build(const tuning_sweep_config_t* sweep_config,
+                    const uint16_t num_codes) {
+    tuning_code_t tuning_code;
+    tuning_code_t last_tuning_code;
+    uint16_t i = 0;
+
+    if (!tuning_validate_sweep_config(sweep_config) || num_codes < 2 ||
+        num_codes > LC_TABLE_MAX_NUM_CODES) {
+        return false;
+    }
+
+    g_lc_table_valid = false;
+    memset(&g_lc_table, 0, sizeof(g_lc_table));
+    memset(&g_lc_table_stats, 0, sizeof(g_lc_table_stats));
+    g_lc_table.num_codes = num_codes;
+
+    // The first and last tuning codes of the sweep define the count range.
+    tuning_init_for_sweep(&tuning_code, sweep_config);
+    last_tuning_code.coarse = sweep_config->coarse.end;
+    last_tuning_code.mid = sweep_config->mid.end;
+    last_tuning_code.fine = sweep_config->fine.end;
+    g_lc_table.min_count = lc_table_measure(&tuning_code);
+    g_lc_table.max_count = lc_table_measure(&last_tuning_code);
+    if (g_lc_table.max_count <= g_lc_table.min_count) {
+        printf("LC table sweep is not increasing: %u to %u\r\n",
+               g_lc_table.min_count, g_lc_table.max_count);
+        return false;
+    }
+
+    // More LC codes than counts in the span would map several LC codes to the
+    // same count and leave the others empty.
+    if (g_lc_table.max_count - g_lc_table.min_count + 1 < num_codes) {
+        g_lc_table.num_codes = g_lc_table.max_count - g_lc_table.min_count + 1;
+        printf("LC table limited to %u codes by the count span\r\n",
+               g_lc_table.num_codes);
+    }
+
+    for (i = 0; i < g_lc_table.num_codes; ++i) {
+        g_lc_table_errors[i] = UINT16_MAX;
+    }
+    g_lc_table.tuning_codes[0] = tuning_code;
+    g_lc_table_errors[0] = 0;
+    g_lc_table.tuning_codes[g_lc_table.num_codes - 1] = last_tuning_code;
+    g_lc_table_errors[g_lc_table.num_codes - 1] = 0;
+
+    while (true) {
+        lc_table_record(&tuning_code, lc_table_measure(&tuning_code));
+        ++g_lc_table_stats.num_measured;
+        if (tuning_end_of_sweep(&tuning_code, sweep_config)) {
+            break;
+        }
+        tuning_increment_code_for_sweep(&tuning_code, sweep_config);
+    }
+
+    // Fill the LC codes without a measured tuning code with the previous
+    // tuning code to keep the table monotonic.
+    for (i = 1; i < g_lc_table.num_codes; ++i) {
+        if (g_lc_table_errors[i] == UINT16_MAX) {
+            g_lc_table.tuning_codes[i] = g_lc_table.tuning_codes[i - 1];
+            ++g_lc_table_stats.num_empty;
+        } else if (g_lc_table_errors[i] > g_lc_table_stats.max_error) {
+            g_lc_table_stats.max_error = g_lc_table_errors[i];
+        }
+    }
+
+    g_lc_table_valid = true;
+    return true;
+}
+
+uint32_t lc_table_measure_count(void) {
+    const counters_config_t config = {
+        .window_duration = LC_TABLE_WINDOW_DURATION,
+        .num_windows = LC_TABLE_NUM_WINDOWS,
+        .rftimer_id = LC_TABLE_RFTIMER_ID,
+        .callback = NULL,
+    };
+
+    if (!counters_measure_start(&config)) {
+        return 0;
+    }
+    while (counters_measure_busy()) {
+    }
+    return counters_get_stats()->counters[COUNTERS_LC].mean;
+}
+
+bool lc_table_load(const lc_table_t* table) {
+    if (table->num_codes < 2 || table->num_codes > LC_TABLE_MAX_NUM_CODES ||
+        table->max_count <= table->min_count) {
+        return false;
+    }
+    g_lc_table = *table;
+    memset(&g_lc_table_stats, 0, sizeof(g_lc_table_stats));
+    g_lc_table_valid = true;
+    return true;
+}
+
+void lc_table_invalidate(void) { g_lc_table_valid = false; }
+
+bool lc_table_is_valid(void) { return g_lc_table_valid; }
+
+const lc_table_t* lc_table_get_table(void) { return &g_lc_table; }
+
+const lc_table_stats_t* lc_table_get_stats(void) { return &g_lc_table_stats; }
+
+const tuning_code_t* lc_table_lookup(const int32_t lc_code) {
+    if (lc_code < 0) {
+        return &g_lc_table.tuning_codes[0];
+    }
+    if (lc_code >= g_lc_table.num_codes) {
+        return &g_lc_table.tuning_codes[g_lc_table.num_codes - 1];
+    }
+    return &g_lc_table.tuning_codes[lc_code];
+}
+
+uint16_t lc_table_count_to_lc_code(const uint32_t count) {
+    const uint32_t span = g_lc_table.max_count - g_lc_table.min_count;
+
+    if (count <= g_lc_table.min_count) {
+        return 0;
+    }
+    if (count >= g_lc_table.max_count) {
+        return g_lc_table.num_codes - 1;
+    }
+
+    // Round to the closest LC code.
+    return (uint16_t)(((uint64_t)(count - g_lc_table.min_count) *
+                           (g_lc_table.num_codes - 1) +
+                       span / 2) /
+                      span);
+}
+
+void lc_table_tune(const int32_t lc_code) {
+    tuning_tune_radio(lc_table_lookup(lc_code));
+}
+
+void lc_table_print(void) {
+    const tuning_code_t* tuning_code = NULL;
+    uint16_t i = 0;
+
+    printf("LC table: %u codes, counts %u to %u, %u measured, %u out of range, "
+           "%u empty, max error %u, max variance %u\r\n",
+           g_lc_table.num_codes, g_lc_table.min_count, g_lc_table.max_count,
+           g_lc_table_stats.num_measured, g_lc_table_stats.num_out_of_range,
+           g_lc_table_stats.num_empty, g_lc_table_stats.max_error,
+           g_lc_table_stats.max_variance);
+    for (i = 0; i < g_lc_table.num_codes; ++i) {
+        tuning_code = &g_lc_table.tuning_codes[i];
+        printf("%u: %u.%u.%u\r\n", i, tuning_code->coarse, tuning_code->mid,
+               tuning_code->fine);
+    }
+}
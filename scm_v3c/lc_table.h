@@ -0,0 +1,126 @@
+// The LC table maps an LC code to the coarse, mid, and fine codes of the LC
+// oscillator. It is built once per chip by sweeping the tuning codes and
+// measuring the LC frequency of each code with the LC divider counter.
+//
+// The LC codes are evenly spaced in the measured LC count between the first
+// and the last code of the sweep. The table holds at most one LC code per
+// count of the span, so it has fewer LC codes than requested if the span is
+// too narrow. Each LC code holds the tuning code whose
+// measured count is closest to its target count, so consecutive LC codes are
+// monotonic in frequency on every chip regardless of the overlap between the
+// coarse, mid, and fine steps. LC codes without a measured tuning code reuse
+// the tuning code of the previous LC code.
+//
+// Once the table is built or loaded, LC_monotonic() looks up the tuning code
+// in the table instead of using the fixed coarse and mid divisions. The table
+// is built by perform_calibration() if enabled with optical_set_lc_table_sweep()
+// and can be stored and loaded with the calibration data.
+
+#ifndef __LC_TABLE_H
+#define __LC_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tuning.h"
+
+// Maximum number of LC codes in the table.
+#ifndef LC_TABLE_MAX_NUM_CODES
+#define LC_TABLE_MAX_NUM_CODES 512
+#endif  // LC_TABLE_MAX_NUM_CODES
+
+// Duration of a counter window in RF timer ticks to measure the LC frequency
+// of each tuning code. At 500 kHz, the two windows last 100 ms like the optical
+// calibration windows, so the divided LC clock counts about 125000 edges per
+// window and one count is about 8 ppm. Measuring a sweep of 32 x 32 codes per
+// coarse code takes about 100 s per coarse code.
+#ifndef LC_TABLE_WINDOW_DURATION
+#define LC_TABLE_WINDOW_DURATION 25000
+#endif  // LC_TABLE_WINDOW_DURATION
+
+// Number of counter windows to measure the LC frequency of each tuning code.
+// The table uses the mean count over the windows.
+#ifndef LC_TABLE_NUM_WINDOWS
+#define LC_TABLE_NUM_WINDOWS 2
+#endif  // LC_TABLE_NUM_WINDOWS
+
+// RF timer compare channel used to gate the counter windows.
+#ifndef LC_TABLE_RFTIMER_ID
+#define LC_TABLE_RFTIMER_ID 6
+#endif  // LC_TABLE_RFTIMER_ID
+
+// LC table.
+typedef struct {
+    // LC count of the first LC code.
+    uint32_t min_count;
+
+    // LC count of the last LC code.
+    uint32_t max_count;
+
+    // Number of LC codes.
+    uint16_t num_codes;
+
+    // Tuning code of each LC code.
+    tuning_code_t tuning_codes[LC_TABLE_MAX_NUM_CODES];
+} lc_table_t;
+
+// LC table build statistics.
+typedef struct {
+    // Number of measured tuning codes.
+    uint32_t num_measured;
+
+    // Number of tuning codes outside of the count range of the table.
+    uint32_t num_out_of_range;
+
+    // Number of LC codes without a measured tuning code.
+    uint16_t num_empty;
+
+    // Maximum difference between the measured count of a tuning code and the
+    // target count of its LC code.
+    uint16_t max_error;
+
+    // Maximum variance of the LC count of a tuning code over the windows.
+    uint32_t max_variance;
+} lc_table_stats_t;
+
+// Build the table with up to the given number of LC codes by sweeping the
+// tuning codes. The number of LC codes is limited to one per count of the
+// measured span. The LO must be powered on, e.g., by radio_rxEnable(), and
+// this must not be called from an interrupt handler, since every tuning code is
+// measured with the RF timer interrupt. Return whether the table was built.
+bool lc_table_build(const tuning_sweep_config_t* sweep_config,
+                    uint16_t num_codes);
+
+// Measure the mean LC count of the current tuning code over the windows. This
+// must not be called from an interrupt handler.
+uint32_t lc_table_measure_count(void);
+
+// Load a previously built table. Return whether the table is valid.
+bool lc_table_load(const lc_table_t* table);
+
+// Invalidate the table, so that LC_monotonic() falls back to the fixed
+// divisions.
+void lc_table_invalidate(void);
+
+// Return whether the table has been built or loaded.
+bool lc_table_is_valid(void);
+
+// Return the table.
+const lc_table_t* lc_table_get_table(void);
+
+// Return the build statistics.
+const lc_table_stats_t* lc_table_get_stats(void);
+
+// Return the tuning code of the LC code. The LC code is clipped to the table.
+const tuning_code_t* lc_table_lookup(int32_t lc_code);
+
+// Return the LC code whose target count is closest to the LC count.
+uint16_t lc_table_count_to_lc_code(uint32_t count);
+
+// Tune the LC oscillator to the LC code.
+void lc_table_tune(int32_t lc_code);
+
+// Print the table.
+void lc_table_print(void);
+
+#endif  // __LC_TABLE_H
@@ -6,27 +6,93 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "Memory_map.h"
+#include "asc_profiles.h"
 #include "scm3C_hardware_interface.h"
 #include "scm3_hardware_interface.h"
 #include "scum_radio_bsp.h"
 
 #define QX3_FINE 0
 #define QX3_MID 20
-#define HCLOCK_ERROR 924 / 1000
 extern char send_packet[127];
 
 static bool lh_packet_ready;
 
+// pulse width boundaries in 10 MHz ticks. A pulse belongs to the pulse type of
+// the highest boundary not above its width.
+static const unsigned int nominal_pulse_boundaries[] = {
+    101 + WIDTH_BIAS,   // Laser sweep (THIS NEEDS TUNING)
+    585 + WIDTH_BIAS,   // Azimuth sync, data=0, skip = 0
+    675 + WIDTH_BIAS,   // Elevation sync, data=0, skip = 0
+    781 + WIDTH_BIAS,   // Azimuth sync, data=1, skip = 0
+    885 + WIDTH_BIAS,   // Elevation sync, data=1, skip = 0
+    989 + WIDTH_BIAS,   // Azimuth sync, data=0, skip = 1
+    1083 + WIDTH_BIAS,  // elevation sync, data=0, skip = 1
+    1200 + WIDTH_BIAS,  // Azimuth sync, data=1, skip = 1
+    1300 + WIDTH_BIAS,  // Elevation sync, data=1, skip = 1
+    1400 + WIDTH_BIAS,  // too long
+};
+
+// pulse type of the widths from each boundary up to the next one
+static const pulse_type_t pulse_types[LH_NUM_PULSE_BOUNDARIES] = {
+    INVALID, LASER,   AZ,      EL,      AZ,      EL,      AZ_SKIP, EL_SKIP,
+    AZ_SKIP, EL_SKIP, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID,
+};
+
+// pulse width boundaries in RF timer ticks, padded with the maximum width
+static unsigned int pulse_boundaries[LH_NUM_PULSE_BOUNDARIES];
+
+// RF timer ticks per rotor revolution (60 Hz) and the angle per RF timer tick
+// in 0.01 degrees as a Q16 fixed point number
+static unsigned int rotor_period;
+static unsigned int angle_scale;
+
+// sequence number of the next pose packet
+static uint8_t pose_sequence;
+
+// receives the angles instead of the pose packets if set
+static lh_angle_callback_t angle_callback = NULL;
+
+// pulse pipelines of all photodiodes
+static lh_sensor_t sensors[LH_MAX_SENSORS];
+static uint8_t num_sensors;
+
+// GPI bits of the photodiodes sampled by lh_sample_gpio, i.e., all photodiodes
+// except the first, which is captured by lh_int_cb
+static unsigned short sampled_gpio_mask;
+
+// edges of all photodiodes in order of arrival. The interrupts or the GPIO
+// sampler push at the head, and lh_process_edges pops at the tail.
+static lh_edge_t edge_queue[LH_EDGE_QUEUE_SIZE];
+static volatile unsigned int edge_queue_head;
+static volatile unsigned int edge_queue_tail;
+static unsigned int num_dropped_edges;
+
+// pose sets in order of completion. lh_record_angle pushes at the head, and
+// send_lh_pose_packet pops at the tail, so that the radio is not used while
+// the edges are decoded.
+static lh_pose_t pose_queue[LH_POSE_QUEUE_SIZE];
+static unsigned int pose_queue_head;
+static unsigned int pose_queue_tail;
+static unsigned int num_dropped_poses;
+
 // functions//
 void initialize_mote_lighthouse() {
     extern unsigned int ASC[38];  // this is a little sketchy
+    const unsigned short default_sensor_gpio_mask = 0x0100;
 
     int t;
     lh_packet_ready = false;
 
+    // classify with the nominal HF_CLOCK until it has been calibrated
+    lh_calibrate_pulse_classifier(LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT);
+
+    // single photodiode on GPIO 8, which also drives the GPIO 9 interrupt
+    lh_init_sensors(&default_sensor_gpio_mask, 1);
+
     // RF Timer rolls over at this value and starts a new cycle
     RFTIMER_REG__MAX_COUNT = 0xFFFFFFFF;
 
@@ -138,6 +204,10 @@ void initialize_mote_lighthouse() {
     // Program analog scan chain
     analog_scan_chain_write(&ASC[0]);
     analog_scan_chain_load();
+
+    // Build the ASC profiles for switching between the radio modes. The GPIO
+    // enables above are kept by the switches.
+    asc_profiles_build();
     //--------------------------------------------------------
 }
 
@@ -411,419 +481,494 @@ void send_lh_packet(unsigned int sync_time, unsigned int laser_time,
     // transmit packet (radio_txnow) (wait 50 us between tx enable and tx_now)
     radio_txNow();
 }
+// Scale the pulse width boundaries and the angle conversion to RF timer ticks,
+// which count HF_CLOCK ticks. Call this after every HF_CLOCK calibration, so
+// that neither classify_pulse nor lh_compute_angle needs to divide in the
+// interrupt.
+void lh_calibrate_pulse_classifier(unsigned int hf_clock_ticks_in_100ms) {
+    int i;
+    const int num_boundaries =
+        sizeof(nominal_pulse_boundaries) / sizeof(nominal_pulse_boundaries[0]);
+
+    if (hf_clock_ticks_in_100ms == 0) {
+        hf_clock_ticks_in_100ms = LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT;
+    }
+
+    // 10 MHz ticks are 1000000 ticks in 100 ms, round up so that a width is
+    // above a boundary exactly if its width in 10 MHz ticks is
+    for (i = 0; i < num_boundaries; i++) {
+        pulse_boundaries[i] =
+            ((uint64_t)nominal_pulse_boundaries[i] * hf_clock_ticks_in_100ms +
+             999999) /
+            1000000;
+    }
+    for (; i < LH_NUM_PULSE_BOUNDARIES; i++) {
+        pulse_boundaries[i] = 0xFFFFFFFF;
+    }
+
+    // the rotor turns 360 degrees in 1/60 s, which is 100 ms / 6
+    rotor_period = hf_clock_ticks_in_100ms / 6;
+    angle_scale = (((uint64_t)36000 * 6 << 16) + hf_clock_ticks_in_100ms / 2) /
+                  hf_clock_ticks_in_100ms;
+}
+
+// Return the rotor angle in 0.01 degrees between the sync pulse and the laser
+// sweep. The product fits into 32 bits for any delta within one revolution.
+unsigned int lh_compute_angle(unsigned int sync_time,
+                              unsigned int laser_time) {
+    return ((laser_time - sync_time) * angle_scale) >> 16;
+}
+
+// Queue the angles of the current cycle of the photodiode for
+// send_lh_pose_packet and start the next cycle.
+static void lh_queue_pose(lh_sensor_t* sensor) {
+    const unsigned int next_head =
+        (pose_queue_head + 1) & (LH_POSE_QUEUE_SIZE - 1);
+    lh_pose_t* pose = &pose_queue[pose_queue_head];
+
+    if (next_head == pose_queue_tail) {
+        num_dropped_poses++;
+        sensor->cycle_valid = 0;
+        return;
+    }
+    memcpy(pose->angles, sensor->cycle_angles, sizeof(pose->angles));
+    pose->sensor = sensor - sensors;
+    pose->valid = sensor->cycle_valid;
+    pose_queue_head = next_head;
+    sensor->cycle_valid = 0;
+}
+
+// Store the angle of a sweep. Once the azimuth and elevation of both
+// lighthouses have been stored, or an angle of the next cycle arrives before
+// the set is complete, the angles are queued for a single pose packet. If an
+// angle callback is set, the angle is passed to it instead.
+void lh_record_angle(lh_sensor_t* sensor, unsigned int sync_time,
+                     unsigned int laser_time, lh_id_t lighthouse,
+                     angle_type_t angle_type) {
+    const uint8_t index = (lighthouse << 1) | angle_type;
+
+    if (LH_SEND_RAW == 1) {
+        send_lh_packet(sync_time, laser_time, lighthouse, angle_type);
+        return;
+    }
+
+    // drop sweeps that are longer than a revolution
+    if (laser_time - sync_time >= rotor_period) {
+        return;
+    }
+
+    if (angle_callback != NULL) {
+        angle_callback(sensor - sensors, index,
+                       lh_compute_angle(sync_time, laser_time), laser_time);
+        return;
+    }
+
+    // this angle was already measured, so a sweep of the last cycle was missed
+    if (sensor->cycle_valid & (1 << index)) {
+        lh_queue_pose(sensor);
+    }
+
+    sensor->cycle_angles[index] = lh_compute_angle(sync_time, laser_time);
+    sensor->cycle_valid |= 1 << index;
+
+    if (sensor->cycle_valid == LH_ALL_ANGLES_VALID) {
+        lh_queue_pose(sensor);
+    }
+}
+
+// sends the oldest queued pose set, LSB first, with a sequence number, the
+// photodiode index in the upper and the mask of the valid angles in the lower
+// 4 bits of the third byte. Call this from the main loop, outside of
+// lh_process_edges. The photodiodes are sampled while the frequency settles,
+// so that lh_sample_gpio does not miss edges. Return whether a packet was sent.
+bool send_lh_pose_packet(void) {
+    const lh_pose_t* pose = &pose_queue[pose_queue_tail];
+    int i;
+
+    if (pose_queue_tail == pose_queue_head) {
+        return false;
+    }
+    if (USE_RADIO == 0) {
+        pose_queue_tail = (pose_queue_tail + 1) & (LH_POSE_QUEUE_SIZE - 1);
+        return false;
+    }
+    radio_txEnable();
+
+    send_packet[0] = LH_POSE_CODE;
+    send_packet[1] = pose_sequence++;
+    send_packet[2] = (pose->sensor << 4) | pose->valid;
+    for (i = 0; i < LH_NUM_ANGLES; i++) {
+        send_packet[3 + 2 * i] = pose->angles[i] & 0xFF;
+        send_packet[4 + 2 * i] = (pose->angles[i] >> 8) & 0xFF;
+    }
+    pose_queue_tail = (pose_queue_tail + 1) & (LH_POSE_QUEUE_SIZE - 1);
+
+    radio_loadPacket(LH_POSE_PACKET_LENGTH);
+
+    LC_FREQCHANGE(23 & 0x1F, QX3_MID & 0x1F, QX3_FINE & 0x1F);  // qx3
+    // wait for the frequency to settle (50 us between tx enable and tx_now)
+    for (i = 0; i < 200; i++) {
+        lh_sample_gpio();
+    }
+    radio_txNow();
+    return true;
+}
+
+unsigned int lh_get_num_dropped_poses(void) { return num_dropped_poses; }
+
 pulse_type_t classify_pulse(unsigned int timestamp_rise,
                             unsigned int timestamp_fall) {
-    pulse_type_t pulse_type;
     unsigned int pulse_width;
+    unsigned int index = 0;
+
+    pulse_width = timestamp_fall - timestamp_rise;
 
-    pulse_width = (timestamp_fall - timestamp_rise) * HCLOCK_ERROR;
-    pulse_type = INVALID;
-
-    // Identify what kind of pulse this was
-
-    if (pulse_width < 585 + WIDTH_BIAS && pulse_width > 100 + WIDTH_BIAS)
-        pulse_type = LASER;  // Laser sweep (THIS NEEDS TUNING)
-    if (pulse_width < 675 + WIDTH_BIAS && pulse_width > 585 + WIDTH_BIAS)
-        pulse_type = AZ;  // Azimuth sync, data=0, skip = 0
-    if (pulse_width >= 675 + WIDTH_BIAS && pulse_width < 781 + WIDTH_BIAS)
-        pulse_type = EL;  // Elevation sync, data=0, skip = 0
-    if (pulse_width >= 781 + WIDTH_BIAS && pulse_width < 885 + WIDTH_BIAS)
-        pulse_type = AZ;  // Azimuth sync, data=1, skip = 0
-    if (pulse_width >= 885 + WIDTH_BIAS && pulse_width < 989 + WIDTH_BIAS)
-        pulse_type = EL;  // Elevation sync, data=1, skip = 0
-    if (pulse_width >= 989 + WIDTH_BIAS && pulse_width < 1083 + WIDTH_BIAS)
-        pulse_type = AZ_SKIP;  // Azimuth sync, data=0, skip = 1
-    if (pulse_width >= 1083 + WIDTH_BIAS && pulse_width < 1200 + WIDTH_BIAS)
-        pulse_type = EL_SKIP;  // elevation sync, data=0, skip = 1
-    if (pulse_width >= 1200 + WIDTH_BIAS && pulse_width < 1300 + WIDTH_BIAS)
-        pulse_type = AZ_SKIP;  // Azimuth sync, data=1, skip = 1
-    if (pulse_width >= 1300 + WIDTH_BIAS && pulse_width < 1400 + WIDTH_BIAS)
-        pulse_type = EL_SKIP;  // Elevation sync, data=1, skip = 1
-
-    return pulse_type;
+    // Identify what kind of pulse this was with a binary search for the
+    // number of boundaries not above the pulse width. The comparisons are
+    // added instead of branched on, so every pulse takes the same time.
+    index += (pulse_width >= pulse_boundaries[index + 7]) << 3;
+    index += (pulse_width >= pulse_boundaries[index + 3]) << 2;
+    index += (pulse_width >= pulse_boundaries[index + 1]) << 1;
+    index += (pulse_width >= pulse_boundaries[index]);
+
+    return pulse_types[index];
 }
 
 // This function takes the current gpio state as input returns a debounced
 // version of of the current gpio state. It keeps track of the previous gpio
-// states in order to add hysteresis to the system. The return value includes
-// the current gpio state and the time that the first transition ocurred, which
-// should help glitches from disrupting legitamate pulses. This is called
-void debounce_gpio(unsigned short gpio, unsigned short* gpio_out,
-                   unsigned int* trans_out) {
-    // keep track of number of times this gpio state has been measured since
-    // most recent transistion
-    static int count;
-    static gpio_tran_t deb_gpio;  // current debounced state
-
-    static unsigned int tran_time;
-    static unsigned short target_state;
-    // two states: debouncing and not debouncing
-    static enum state {
-        NOT_DEBOUNCING = 0,
-        DEBOUNCING = 1
-    } state = NOT_DEBOUNCING;
-
-    switch (state) {
-        case NOT_DEBOUNCING: {
-            // if not debouncing, compare current gpio state to previous
-            // debounced gpio state
-            if (gpio != deb_gpio.gpio) {
-                // record start time of this transition
-                tran_time = RFTIMER_REG__COUNTER;
-                // if different, initiate debounce procedure
-                state = DEBOUNCING;
-                target_state = gpio;
-
-                // increment counter for averaging
-                count++;
-            }
-            // otherwise just break without changing curr_state
-            break;
+// states of the photodiode in order to add hysteresis to the system. The
+// return value includes the current gpio state and the time that the first
+// transition ocurred, which should help glitches from disrupting legitamate
+// pulses.
+void debounce_gpio(lh_sensor_t* sensor, unsigned short gpio,
+                   unsigned short* gpio_out, unsigned int* trans_out) {
+    lh_debounce_t* debounce = &sensor->debounce;
+
+    if (!debounce->debouncing) {
+        // if not debouncing, compare current gpio state to previous
+        // debounced gpio state
+        if (gpio != debounce->deb_gpio.gpio) {
+            // record start time of this transition
+            debounce->tran_time = RFTIMER_REG__COUNTER;
+            // if different, initiate debounce procedure
+            debounce->debouncing = true;
+            debounce->target_state = gpio;
+
+            // increment counter for averaging
+            debounce->count++;
+        }
+        // otherwise just return without changing curr_state
+    } else {
+        // if debouncing, compare current gpio state to target transition
+        // state
+        if (gpio == debounce->target_state) {
+            // if same as target transition state, increment counter
+            debounce->count++;
+        } else {
+            // if different from target transition state, decrement counter
+            debounce->count--;
         }
-        case DEBOUNCING: {
-            // if debouncing, compare current gpio state to target transition
-            // state
-            if (gpio == target_state) {
-                // if same as target transition state, increment counter
-                count++;
-            } else {
-                // if different from target transition state, decrement counter
-                count--;
-            }
 
-            // if count is high enough
-            if (count >= DEB_THRESH) {
-                deb_gpio.timestamp_tran = tran_time;
-                deb_gpio.gpio = target_state;
-                state = NOT_DEBOUNCING;
-                count = 0;
+        // if count is high enough
+        if (debounce->count >= DEB_THRESH) {
+            debounce->deb_gpio.timestamp_tran = debounce->tran_time;
+            debounce->deb_gpio.gpio = debounce->target_state;
+            debounce->debouncing = false;
+            debounce->count = 0;
 
-            } else if (count == 0) {
-                count = 0;
-                state = NOT_DEBOUNCING;
-            }
-            break;
+        } else if (debounce->count == 0) {
+            debounce->debouncing = false;
         }
     }
-    *gpio_out = deb_gpio.gpio;
-    *trans_out = deb_gpio.timestamp_tran;
+    *gpio_out = debounce->deb_gpio.gpio;
+    *trans_out = debounce->deb_gpio.timestamp_tran;
 }
 
-// keeps track of the current state and will print out pulse train information
-// when it's done.
-void update_state(pulse_type_t pulse_type, unsigned int timestamp_rise) {
+// keeps track of the current state of the photodiode and will send out the
+// angles when it's done.
+void update_state(lh_sensor_t* sensor, pulse_type_t pulse_type,
+                  unsigned int timestamp_rise) {
     if (pulse_type == INVALID) {
         return;
     }
     // FSM which searches for the four pulse sequence
-    // An output will only be printed if four pulses are found and the sync
+    // An output will only be sent if four pulses are found and the sync
     // pulse widths are within the bounds listed above.
-    update_state_azimuth(pulse_type, timestamp_rise);
-    update_state_elevation(pulse_type, timestamp_rise);
+    update_state_azimuth(sensor, pulse_type, timestamp_rise);
+    update_state_elevation(sensor, pulse_type, timestamp_rise);
 }
 
-void update_state_elevation(pulse_type_t pulse_type,
-                            unsigned int timestamp_rise) {
-    static unsigned int elevation_a_sync;
-    static unsigned int elevation_b_sync;
-
-    static unsigned int elevation_a_laser;
-    static unsigned int elevation_b_laser;
-
-    static int state = 0;
-
+// FSM shared by azimuth and elevation, which only differ in their sync pulse
+// types
+static void update_state_sweep(lh_sensor_t* sensor, lh_sweep_fsm_t* fsm,
+                               angle_type_t angle_type,
+                               pulse_type_t pulse_type,
+                               unsigned int timestamp_rise) {
+    const pulse_type_t sync = angle_type == AZIMUTH ? AZ : EL;
+    const pulse_type_t sync_skip = angle_type == AZIMUTH ? AZ_SKIP : EL_SKIP;
     int nextstate;
 
-    // TODO: keep track of last delta time measurement for filtering
-    static unsigned int last_delta_a;
-    static unsigned int last_delta_b;
-
     if (pulse_type == INVALID) {
         return;
     }
-    switch (state) {
-        // Search for an azimuth sync pulse, assume its A
+    switch (fsm->state) {
+        // Search for a sync pulse, we don't know if it's A or B yet
         case 0: {
-            if (pulse_type == EL || pulse_type == EL_SKIP) {
-                if (pulse_type == EL) {
-                    elevation_a_sync = timestamp_rise;
-                    nextstate = 1;
-
-                } else {
-                    // go to elevation b state
-                    nextstate = 2;
-                    // printf("state transition: %d to %d\n",state,nextstate);
-                }
+            if (pulse_type == sync) {
+                fsm->a_sync = timestamp_rise;
+                nextstate = 1;
+            } else if (pulse_type == sync_skip) {
+                // go to b state
+                nextstate = 2;
             } else {
                 if (DEBUG_STATE) {
-                    printf("el state fail. State %d, Pulse Type: %d \n", state,
-                           pulse_type);
+                    printf("state fail. State %d, Pulse Type: %d \n",
+                           fsm->state, pulse_type);
                 }
                 nextstate = 0;
             }
-
             break;
         }
 
-        // Waiting for another consecutive elevation skip sync from B, this
-        // should be a skip sync pulse
+        // Waiting for another consecutive skip sync from B, this should be a
+        // skip sync pulse
         case 1: {
-            if (pulse_type == EL_SKIP) {
+            if (pulse_type == sync_skip) {
+                // lighthouse A sweep pulse
                 nextstate = 3;
-            } else if (pulse_type == EL) {
-                // return to this state (skip 0)
+            } else if (pulse_type == sync) {
+                // stay in this state (skip 0)
                 nextstate = 1;
-                elevation_a_sync = timestamp_rise;
+                fsm->a_sync = timestamp_rise;
             } else {
                 nextstate = 0;
                 if (DEBUG_STATE) {
-                    printf("el state fail. State %d, Pulse Type: %d \n", state,
-                           pulse_type);
+                    printf("state fail. State %d, Pulse Type: %d \n",
+                           fsm->state, pulse_type);
                 }
             }
             break;
         }
 
-        // Azimuth B sync state
+        // B sync state
         case 2: {
-            if (pulse_type == EL) {
-                // the last pulse was an azimuth sync from lighthouse B
-                elevation_b_sync = timestamp_rise;
-                // go to azimuth b laser detect
+            if (pulse_type == sync) {
+                // the last pulse was a sync from lighthouse B
+                fsm->b_sync = timestamp_rise;
+                // go to b laser detect
                 nextstate = 4;
-                // printf("state transition: %d to %d\n",state,nextstate);
-            } else if (pulse_type == EL_SKIP) {
-                // return to this state (skipping 0)
+            } else if (pulse_type == sync_skip) {
+                // stay in this state (skipping 0)
                 nextstate = 2;
             } else {
                 nextstate = 0;
-                // printf("state fail. State %d, Pulse Type: %d
-                // \n",state,pulse_type);
             }
             break;
         }
 
-        // Elevation A laser sweep
+        // A laser sweep
         case 3: {
             if (pulse_type == LASER) {
                 // lighthouse a laser
-                elevation_a_laser = timestamp_rise;
-
+                fsm->a_laser = timestamp_rise;
                 nextstate = 0;
-                if (last_delta_a > 0 &&
-                    abs(((int)(elevation_a_laser - elevation_a_sync)) -
-                        (int)last_delta_a) < 4630) {
-                    // printf("el A: %d,
-                    // %d\n",elevation_a_sync,elevation_a_laser);
-                    send_lh_packet(elevation_a_sync, elevation_a_laser, A,
-                                   ELEVATION);
+                // filter out pulses that have changed by more than 10 degrees
+                // (4630 ticks)
+                if (fsm->last_delta_a > 0 &&
+                    abs(((int)(fsm->a_laser - fsm->a_sync)) -
+                        (int)fsm->last_delta_a) < 4630) {
+                    lh_record_angle(sensor, fsm->a_sync, fsm->a_laser, A,
+                                    angle_type);
                 }
-                last_delta_a = elevation_a_laser - elevation_a_sync;
-            } else if (pulse_type == EL) {
+                fsm->last_delta_a = fsm->a_laser - fsm->a_sync;
+            } else if (pulse_type == sync) {
                 // skip straight to state 1
                 nextstate = 1;
-                elevation_a_sync = timestamp_rise;
-            } else if (pulse_type == EL_SKIP) {
+                fsm->a_sync = timestamp_rise;
+            } else if (pulse_type == sync_skip) {
                 // skip straight to state 2
                 nextstate = 2;
             } else {
                 nextstate = 0;
                 if (DEBUG_STATE) {
-                    printf("el state fail. State: %d, Pulse Type: %d \n", state,
-                           pulse_type);
+                    printf("state fail. State: %d, Pulse Type: %d \n",
+                           fsm->state, pulse_type);
                 }
             }
             break;
         }
 
-        // elevation B laser sweep
+        // B laser sweep
         case 4: {
             if (pulse_type == LASER) {
                 // lighthouse b laser
-                elevation_b_laser = timestamp_rise;
-                // go to azimuth b laser detect
+                fsm->b_laser = timestamp_rise;
                 nextstate = 0;
-                if (last_delta_b > 0 &&
-                    abs(((int)(elevation_b_laser - elevation_b_sync)) -
-                        (int)last_delta_b) < 4630) {
-                    // printf("el B: %d,
-                    // %d\n",elevation_b_sync,elevation_b_laser);
-                    send_lh_packet(elevation_b_sync, elevation_b_laser, B,
-                                   ELEVATION);
+                // filter out pulses that have changed by more than 10 degrees
+                // (4630 ticks)
+                if (fsm->last_delta_b > 0 &&
+                    abs(((int)(fsm->b_laser - fsm->b_sync)) -
+                        (int)fsm->last_delta_b) < 4630) {
+                    lh_record_angle(sensor, fsm->b_sync, fsm->b_laser, B,
+                                    angle_type);
                 }
-                last_delta_b = elevation_b_laser - elevation_b_sync;
-            } else if (pulse_type == EL) {
+                fsm->last_delta_b = fsm->b_laser - fsm->b_sync;
+            } else if (pulse_type == sync) {
                 // skip straight to state 1
                 nextstate = 1;
-                elevation_a_sync = timestamp_rise;
-            } else if (pulse_type == EL_SKIP) {
+                fsm->a_sync = timestamp_rise;
+            } else if (pulse_type == sync_skip) {
                 // skip straight to state 2
                 nextstate = 2;
             } else {
                 nextstate = 0;
                 if (DEBUG_STATE) {
-                    printf("el state fail. State: %d, Pulse Type: %d \n", state,
-                           pulse_type);
+                    printf("state fail. State: %d, Pulse Type: %d \n",
+                           fsm->state, pulse_type);
                 }
             }
             break;
         }
+
+        default: {
+            nextstate = 0;
+            break;
+        }
     }
 
-    state = nextstate;
+    fsm->state = nextstate;
 }
 
-// keeps track of the current state and will print out pulse train information
-// when it's done.
-void update_state_azimuth(pulse_type_t pulse_type,
-                          unsigned int timestamp_rise) {
-    static unsigned int azimuth_a_sync;
-    static unsigned int azimuth_b_sync;
-
-    static unsigned int azimuth_a_laser;
-    static unsigned int azimuth_b_laser;
+void update_state_elevation(lh_sensor_t* sensor, pulse_type_t pulse_type,
+                            unsigned int timestamp_rise) {
+    update_state_sweep(sensor, &sensor->elevation, ELEVATION, pulse_type,
+                       timestamp_rise);
+}
 
-    static int state = 0;
+void update_state_azimuth(lh_sensor_t* sensor, pulse_type_t pulse_type,
+                          unsigned int timestamp_rise) {
+    update_state_sweep(sensor, &sensor->azimuth, AZIMUTH, pulse_type,
+                       timestamp_rise);
+}
 
-    int nextstate;
+// Pass every decoded angle to the callback instead of sending pose packets,
+// e.g., to fuse the angles with the IMU. NULL restores the pose packets.
+void lh_set_angle_callback(lh_angle_callback_t callback) {
+    angle_callback = callback;
+}
 
-    // TODO: keep track of last delta time measurement for filtering
-    static unsigned int last_delta_a;
-    static unsigned int last_delta_b;
+// Set up the pulse pipelines of the photodiodes on the given GPI bits. The
+// edges of all photodiodes are timestamped into a shared queue, either by
+// lh_int_cb for the first photodiode or by lh_sample_gpio, and are decoded by
+// lh_process_edges.
+void lh_init_sensors(const unsigned short* gpio_masks, uint8_t num) {
+    int i;
 
-    if (pulse_type == INVALID) {
-        return;
+    if (num > LH_MAX_SENSORS) {
+        num = LH_MAX_SENSORS;
     }
-    // FSM which searches for the four pulse sequence
-    // An output will only be printed if four pulses are found and the sync
-    // pulse widths are within the bounds listed above.
-    switch (state) {
-        // Search for an azimuth A sync pulse, we don't know if it's A or B yet
-        case 0: {
-            if (pulse_type == AZ || pulse_type == AZ_SKIP) {
-                if (pulse_type == AZ) {
-                    azimuth_a_sync = timestamp_rise;
-                    nextstate = 1;
-                    // printf("state transition: %d to %d\n",state,nextstate);
-                } else {
-                    // go to azimuth b state
-                    nextstate = 2;
-                    // printf("state transition: %d to %d\n",state,nextstate);
-                }
-            } else
-                nextstate = 0;
-
-            break;
+    memset(sensors, 0, sizeof(sensors));
+    sampled_gpio_mask = 0;
+    for (i = 0; i < num; i++) {
+        sensors[i].gpio_mask = gpio_masks[i];
+        if (i > 0) {
+            sampled_gpio_mask |= gpio_masks[i];
         }
+    }
+    num_sensors = num;
+
+    edge_queue_head = 0;
+    edge_queue_tail = 0;
+    num_dropped_edges = 0;
+    pose_queue_head = 0;
+    pose_queue_tail = 0;
+    num_dropped_poses = 0;
+}
 
-        // Waiting for another consecutive azimuth skip sync from B, this should
-        // be a skip sync pulse
-        case 1: {
-            if (pulse_type == AZ_SKIP) {
-                // lighthouse A sweep pulse
+lh_sensor_t* lh_get_sensor(uint8_t sensor) {
+    return sensor < num_sensors ? &sensors[sensor] : NULL;
+}
 
-                nextstate = 3;
-                // printf("state transition: %d to %d\n",state,nextstate);
-            } else if (pulse_type == AZ) {
-                // staty in this state
-                nextstate = 1;
-                azimuth_a_sync = timestamp_rise;
-            } else {
-                nextstate = 0;
-                // printf("state fail. State %d, Pulse Type: %d
-                // \n",state,pulse_type);
-            }
-            break;
-        }
+// Push a timestamped edge of a photodiode. Return false if the queue is full.
+bool lh_push_edge(uint8_t sensor, uint8_t level, unsigned int timestamp) {
+    const unsigned int next_head =
+        (edge_queue_head + 1) & (LH_EDGE_QUEUE_SIZE - 1);
 
-        // Azimuth B sync state
-        case 2: {
-            if (pulse_type == AZ) {
-                // the last pulse was an azimuth sync from lighthouse B
-                azimuth_b_sync = timestamp_rise;
-                // go to azimuth b laser detect
-                nextstate = 4;
-                // printf("state transition: %d to %d\n",state,nextstate);
-            } else if (pulse_type == AZ_SKIP) {
-                // stay in this state
-                nextstate = 2;
-            } else {
-                nextstate = 0;
-                // printf("state fail. State %d, Pulse Type: %d
-                // \n",state,pulse_type);
-            }
-            break;
-        }
+    if (next_head == edge_queue_tail) {
+        num_dropped_edges++;
+        return false;
+    }
+    edge_queue[edge_queue_head].timestamp = timestamp;
+    edge_queue[edge_queue_head].sensor = sensor;
+    edge_queue[edge_queue_head].level = level;
+    edge_queue_head = next_head;
+    return true;
+}
 
-        // Azimuth A laser sweep
-        case 3: {
-            if (pulse_type == LASER) {
-                // lighthouse a laser
-                azimuth_a_laser = timestamp_rise;
-                // go to azimuth b laser detect
-                nextstate = 0;
-                // filter out pulses that have changed by more than 10 degrees
-                // (4630 ticks)
-                if (last_delta_a > 0 &&
-                    abs(((int)(azimuth_a_laser - azimuth_a_sync)) -
-                        (int)last_delta_a) < 4630) {
-                    // printf("az A: %d, %d\n",azimuth_a_sync,azimuth_a_laser);
-                    send_lh_packet(azimuth_a_sync, azimuth_a_laser, A, AZIMUTH);
-                }
-                last_delta_a = azimuth_a_laser - azimuth_a_sync;
-            } else if (pulse_type == AZ) {
-                // go to first pulse AZ state
-                nextstate = 1;
-                azimuth_a_sync = timestamp_rise;
-            } else if (pulse_type == AZ_SKIP) {
-                // go to az b first pulse state
-                nextstate = 2;
-            } else {
-                nextstate = 0;
-                // printf("state fail. State %d, Pulse Type: %d
-                // \n",state,pulse_type);
-            }
-            break;
+// Sample the GPI bits of all photodiodes except the first at once, debounce
+// each photodiode with debounce_gpio, and push an edge with the time of the
+// first sample of the transition for every photodiode whose debounced level
+// has changed. The laser sweeps last only about 10 us, so call this in a tight
+// loop that does not block, e.g., the decoding loop of lighthouse_app.
+void lh_sample_gpio(void) {
+    const unsigned short gpio = GPIO_REG__INPUT & sampled_gpio_mask;
+    unsigned short previous;
+    unsigned short debounced;
+    unsigned int transition;
+    int i;
+
+    for (i = 1; i < num_sensors; i++) {
+        previous = sensors[i].debounce.deb_gpio.gpio;
+        debounce_gpio(&sensors[i], gpio & sensors[i].gpio_mask, &debounced,
+                      &transition);
+        if (debounced != previous) {
+            lh_push_edge(i, debounced != 0, transition);
         }
+    }
+}
 
-        // Azimuth B laser sweep
-        case 4: {
-            if (pulse_type == LASER) {
-                // lighthouse b laser
-                azimuth_b_laser = timestamp_rise;
-                // go to azimuth b laser detect
-                nextstate = 0;
+// Run an edge through the pulse pipeline of its photodiode. A pulse is
+// classified once the next pulse starts, unless the low time is shorter than
+// LH_GLITCH_TICKS, in which case the pulse continues.
+static void lh_process_edge(lh_sensor_t* sensor, uint8_t level,
+                            unsigned int timestamp) {
+    if (level == sensor->level) {
+        return;
+    }
+    sensor->level = level;
 
-                // filter out pulses that have changed by more than 10 degrees
-                // (4630 ticks)
-                if (last_delta_b > 0 &&
-                    abs(((int)(azimuth_b_laser - azimuth_b_sync)) -
-                        (int)last_delta_b) < 4630) {
-                    // printf("az B: %d, %d,
-                    // %d\n",azimuth_b_sync,azimuth_b_laser,azimuth_b_laser-azimuth_b_sync
-                    // );
-                    send_lh_packet(azimuth_b_sync, azimuth_b_laser, B, AZIMUTH);
-                }
-                last_delta_b = azimuth_b_laser - azimuth_b_sync;
-            } else if (pulse_type == AZ) {
-                // go to first pulse AZ state
-                nextstate = 1;
-                azimuth_a_sync = timestamp_rise;
-            } else if (pulse_type == AZ_SKIP) {
-                // go to az b first pulse state
-                nextstate = 2;
-            } else {
-                nextstate = 0;
-                // printf("state fail. State %d, Pulse Type: %d
-                // \n",state,pulse_type);
-            }
-            break;
+    if (level == 0) {
+        sensor->timestamp_fall = timestamp;
+        sensor->fall_pending = true;
+        return;
+    }
+
+    if (sensor->fall_pending) {
+        sensor->fall_pending = false;
+        if (timestamp - sensor->timestamp_fall < LH_GLITCH_TICKS) {
+            return;
         }
+        update_state(sensor,
+                     classify_pulse(sensor->timestamp_rise,
+                                    sensor->timestamp_fall),
+                     sensor->timestamp_rise);
     }
+    sensor->timestamp_rise = timestamp;
+}
+
+// Decode all queued edges. Call this from the main loop.
+void lh_process_edges(void) {
+    lh_edge_t edge;
 
-    state = nextstate;
+    while (edge_queue_tail != edge_queue_head) {
+        edge = edge_queue[edge_queue_tail];
+        edge_queue_tail = (edge_queue_tail + 1) & (LH_EDGE_QUEUE_SIZE - 1);
+        lh_process_edge(&sensors[edge.sensor], edge.level, edge.timestamp);
+    }
 }
 
+unsigned int lh_get_num_dropped_edges(void) { return num_dropped_edges; }
+
 unsigned int sync_pulse_width_compensate(unsigned int pulse_width) {
     static unsigned int sync_widths[60];
     unsigned int avg;  // average sync pulse width in 10 MHz ticks
@@ -848,35 +993,29 @@ unsigned int sync_pulse_width_compensate(unsigned int pulse_width) {
     return avg;
 }
 
-// callback that is called by gpio ints
+// callback that is called by gpio ints of the first photodiode
 // level parameter is what level the interrupt is at (high or low).
 void lh_int_cb(int level) {
-    // Keep track of static duration level state
-    static int state = 0;
-    static bool debounced = false;
-    static uint8_t debounce_count_high = 0;
-    static uint8_t debounce_count_low = 0;
-    static uint32_t timestamp_rise = 0;
-    static uint32_t timestamp_fall = 0;
+    lh_sensor_t* sensor = &sensors[0];
 
     // detect edge transitions and disable level interrupts to mimic edge
     // behavior
 
     // check for rising edge
-    if (level == 1 && state == 0) {
-        if (debounce_count_high == 0) {
+    if (level == 1 && sensor->int_level == 0) {
+        if (sensor->debounce_count_high == 0) {
             // capture rising edge
-            timestamp_rise = RFTIMER_REG__COUNTER;
+            sensor->int_timestamp = RFTIMER_REG__COUNTER;
         }
 
         // increment debounce count
-        debounce_count_high++;
+        sensor->debounce_count_high++;
 
-        if (debounce_count_high >= DEB_THRESH) {
+        if (sensor->debounce_count_high >= DEB_THRESH) {
             // reset debounce count
-            debounce_count_high = 0;
+            sensor->debounce_count_high = 0;
             // if level high, disable high interrupt and enable low interrupt
-            state = 1;
+            sensor->int_level = 1;
 
             // disable gpio8 active high interrupt
             ICER = GPIO8_HIGH_INT;
@@ -889,26 +1028,27 @@ void lh_int_cb(int level) {
 #if DEBUG_INT == 1
             send_lh_packet(2, 2, A, AZIMUTH);
 #endif
+            lh_push_edge(0, 1, sensor->int_timestamp);
         }
     }
     // if level low with falling edge, disable low interrupt and enable high
     // interrupt
-    else if (level == 0 && state == 1) {
+    else if (level == 0 && sensor->int_level == 1) {
         // capture edge on first edge
-        if (debounce_count_low == 0) {
+        if (sensor->debounce_count_low == 0) {
             // capture falling edge
-            timestamp_fall = RFTIMER_REG__COUNTER;
+            sensor->int_timestamp = RFTIMER_REG__COUNTER;
         }
 
         // increment debounce counter
-        debounce_count_low++;
+        sensor->debounce_count_low++;
 
-        if (debounce_count_low >= DEB_THRESH) {
+        if (sensor->debounce_count_low >= DEB_THRESH) {
             // reset debounce count
-            debounce_count_low = 0;
+            sensor->debounce_count_low = 0;
 
             // if level high, disable high interrupt and enable low interrupt
-            state = 0;
+            sensor->int_level = 0;
 
             // disable gpio9 active low interrupt
             ICER = GPIO9_LOW_INT;
@@ -923,9 +1063,8 @@ void lh_int_cb(int level) {
             send_lh_packet(1, 1, A, AZIMUTH);
 #endif
 
-            update_state(classify_pulse(timestamp_rise, timestamp_fall),
-                         timestamp_rise);
-            // send_lh_packet(timestamp_rise,timestamp_fall,A,AZIMUTH);
+            // the pulse is classified by lh_process_edges
+            lh_push_edge(0, 0, sensor->int_timestamp);
         }
     }
 }
@@ -28,6 +28,32 @@ typedef struct gpio_tran_t {
 #define USE_RADIO 1
 #define DEBUG_INT 0
 #define IMU_CODE 105  // code that tells code that its an imu packet
+#define LH_POSE_CODE 112  // code that tells code that its a pose packet
+// set to 1 to send the raw sync and laser timestamps of every sweep instead of
+// one pose packet per cycle
+#define LH_SEND_RAW 0
+
+// HF_CLOCK ticks in 100 ms used until the pulse classifier is calibrated. This
+// corresponds to scaling the pulse widths by 924 / 1000 to 10 MHz ticks.
+#define LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT 1082251
+// number of pulse width boundaries in the classifier table, must be 16 for the
+// unrolled binary search
+#define LH_NUM_PULSE_BOUNDARIES 16
+// number of angles in a pose packet: azimuth and elevation of lighthouses A
+// and B, indexed by (lighthouse << 1) | angle_type
+#define LH_NUM_ANGLES 4
+#define LH_ALL_ANGLES_VALID 0x0F
+// length of a pose packet: code, sequence number, sensor and valid mask, and
+// the angles
+#define LH_POSE_PACKET_LENGTH (3 + 2 * LH_NUM_ANGLES)
+// maximum number of photodiodes decoded at once
+#define LH_MAX_SENSORS 8
+// number of pose sets waiting to be sent, must be a power of two
+#define LH_POSE_QUEUE_SIZE 8
+// number of edges in the shared edge queue, must be a power of two
+#define LH_EDGE_QUEUE_SIZE 64
+// a low glitch shorter than this number of RF timer ticks continues the pulse
+#define LH_GLITCH_TICKS 20
 
 // defines for lighthouse localization scum configuration
 #define HF_CLOCK_FINE_LH 17
@@ -47,17 +73,98 @@ typedef struct gpio_tran_t {
 #define GPIO9_LOW_INT 0x2000
 #define GPIO10_LOW_INT 0x4000
 
+// debounce state of debounce_gpio
+typedef struct lh_debounce_t {
+    // number of times the target state has been measured since the most recent
+    // transition
+    int count;
+    gpio_tran_t deb_gpio;  // current debounced state
+    unsigned int tran_time;
+    unsigned short target_state;
+    bool debouncing;
+} lh_debounce_t;
+
+// sync and laser state machine of one angle type, which searches for the
+// sync pulse of lighthouse A or B followed by a laser sweep
+typedef struct lh_sweep_fsm_t {
+    int state;
+    unsigned int a_sync;
+    unsigned int b_sync;
+    unsigned int a_laser;
+    unsigned int b_laser;
+    // last delta time measurement for filtering
+    unsigned int last_delta_a;
+    unsigned int last_delta_b;
+} lh_sweep_fsm_t;
+
+// pulse pipeline of one photodiode: edge capture, debounce, classification,
+// and the azimuth and elevation state machines
+typedef struct lh_sensor_t {
+    // GPI bit of the photodiode
+    unsigned short gpio_mask;
+
+    // level interrupt state of lh_int_cb
+    int int_level;
+    uint8_t debounce_count_high;
+    uint8_t debounce_count_low;
+    unsigned int int_timestamp;
+    lh_debounce_t debounce;
+
+    // current level and edges of the pulse being received. A fall is only
+    // classified at the next rise, so that a glitch shorter than
+    // LH_GLITCH_TICKS does not split a pulse.
+    uint8_t level;
+    bool fall_pending;
+    unsigned int timestamp_rise;
+    unsigned int timestamp_fall;
+
+    lh_sweep_fsm_t azimuth;
+    lh_sweep_fsm_t elevation;
+
+    // angles of the current cycle in 0.01 degrees and which of them are valid
+    unsigned short cycle_angles[LH_NUM_ANGLES];
+    uint8_t cycle_valid;
+} lh_sensor_t;
+
+// angles of one cycle of a photodiode waiting to be sent in a pose packet
+typedef struct lh_pose_t {
+    unsigned short angles[LH_NUM_ANGLES];
+    uint8_t sensor;
+    uint8_t valid;
+} lh_pose_t;
+
+// timestamped edge of a photodiode
+typedef struct lh_edge_t {
+    unsigned int timestamp;
+    uint8_t sensor;
+    uint8_t level;
+} lh_edge_t;
+
+// called with every decoded angle in 0.01 degrees, indexed like the pose
+// packet angles, and the timestamp of its laser sweep
+typedef void (*lh_angle_callback_t)(uint8_t sensor, uint8_t index,
+                                    unsigned short angle,
+                                    unsigned int timestamp);
+
 // functions
+void lh_calibrate_pulse_classifier(unsigned int hf_clock_ticks_in_100ms);
 pulse_type_t classify_pulse(unsigned int timestamp_rise,
                             unsigned int timestamp_fall);
-void update_state(pulse_type_t pulse_type, unsigned int timestamp_rise);
-void azimuth_state(pulse_type_t pulse_type, unsigned int timestamp_rise);
-void update_state_azimuth(pulse_type_t pulse_type, unsigned int timestamp_rise);
+void update_state(lh_sensor_t* sensor, pulse_type_t pulse_type,
+                  unsigned int timestamp_rise);
+void update_state_azimuth(lh_sensor_t* sensor, pulse_type_t pulse_type,
+                          unsigned int timestamp_rise);
 unsigned int sync_pulse_width_compensate(unsigned int pulse_width);
-void update_state_elevation(pulse_type_t pulse_type,
+void update_state_elevation(lh_sensor_t* sensor, pulse_type_t pulse_type,
                             unsigned int timestamp_rise);
-void debounce_gpio(unsigned short gpio, unsigned short* deb_gpio,
-                   unsigned int* trans_out);
+void debounce_gpio(lh_sensor_t* sensor, unsigned short gpio,
+                   unsigned short* deb_gpio, unsigned int* trans_out);
+void lh_init_sensors(const unsigned short* gpio_masks, uint8_t num_sensors);
+lh_sensor_t* lh_get_sensor(uint8_t sensor);
+bool lh_push_edge(uint8_t sensor, uint8_t level, unsigned int timestamp);
+void lh_sample_gpio(void);
+void lh_process_edges(void);
+unsigned int lh_get_num_dropped_edges(void);
 void initialize_mote_lighthouse(void);
 void radio_init_tx_lighthouse(uint8_t lo_supply_v, uint8_t lc_supply_c,
                               uint8_t pa_supply_v, bool lo_cortex_ctrl,
@@ -65,6 +172,13 @@ void radio_init_tx_lighthouse(uint8_t lo_supply_v, uint8_t lc_supply_c,
 void radio_init_rx_MF_lighthouse(void);
 void send_lh_packet(unsigned int sync_time, unsigned int laser_time,
                     lh_id_t lighthouse, angle_type_t angle_type);
+unsigned int lh_compute_angle(unsigned int sync_time, unsigned int laser_time);
+void lh_record_angle(lh_sensor_t* sensor, unsigned int sync_time,
+                     unsigned int laser_time, lh_id_t lighthouse,
+                     angle_type_t angle_type);
+bool send_lh_pose_packet(void);
+unsigned int lh_get_num_dropped_poses(void);
+void lh_set_angle_callback(lh_angle_callback_t callback);
 void lh_int_cb(int level);
 void send_imu_packet(imu_data_t imu_measurement);
 // defines for initialization
@@ -0,0 +1,333 @@
+#include "lighthouse_v2.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Mask of the LFSR state.
+#define LIGHTHOUSE_V2_LFSR_MASK ((1 << LIGHTHOUSE_V2_LFSR_LENGTH) - 1)
+
+// LFSR state at offset 0.
+#define LIGHTHOUSE_V2_LFSR_START_STATE 0x00001
+
+// BMC bit rate in bits per 100 ms.
+#define LIGHTHOUSE_V2_BITS_IN_100MS 600000
+
+// Number of rotor period ticks per bit. The rotor periods are given in ticks
+// of 48 MHz.
+#define LIGHTHOUSE_V2_PERIOD_TICKS_PER_BIT 8
+
+// Maximum rotor period in bits.
+#define LIGHTHOUSE_V2_MAX_PERIOD (959000 / LIGHTHOUSE_V2_PERIOD_TICKS_PER_BIT)
+
+// Maximum number of checkpoints per polynomial, including the checkpoint
+// after the end of the period.
+#define LIGHTHOUSE_V2_MAX_NUM_CHECKPOINTS \
+    (LIGHTHOUSE_V2_MAX_PERIOD / LIGHTHOUSE_V2_CHECKPOINT_SPACING + 2)
+
+// Number of bits of the checkpoint index in a checkpoint entry.
+#define LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS 8
+
+#if LIGHTHOUSE_V2_MAX_NUM_CHECKPOINTS > \
+    (1 << LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS)
+#error "LIGHTHOUSE_V2_CHECKPOINT_SPACING is too small."
+#endif
+
+// Polynomials of all channels. The polynomial of channel c with data bit b is
+// at index 2 * (c - 1) + b.
+static const uint32_t
+    g_lighthouse_v2_polynomials[2 * LIGHTHOUSE_V2_NUM_CHANNELS] = {
+        0x0001D258, 0x00017E04, 0x0001FF6B, 0x00013F67, 0x0001B9EE, 0x000198D1,
+        0x000178C7, 0x00018A55, 0x00015777, 0x0001D911, 0x00015769, 0x0001991F,
+        0x00012BD0, 0x0001CF73, 0x0001365D, 0x000197F5, 0x000194A0, 0x0001B279,
+        0x00013A34, 0x0001AE41, 0x000180D4, 0x00017891, 0x00012E64, 0x00017C72,
+        0x00019C6D, 0x00013F32, 0x0001AE14, 0x00014E76, 0x00013C97, 0x000130CB,
+        0x00013750, 0x0001CB8D,
+};
+
+// Rotor periods of all channels in ticks of 48 MHz.
+static const uint32_t g_lighthouse_v2_periods[LIGHTHOUSE_V2_NUM_CHANNELS] = {
+    959000, 957000, 953000, 949000, 947000, 943000, 941000, 939000,
+    937000, 929000, 919000, 911000, 907000, 901000, 893000, 887000,
+};
+
+// Decoder of a configured base station.
+typedef struct {
+    // Channel between 1 and LIGHTHOUSE_V2_NUM_CHANNELS.
+    uint8_t channel;
+
+    // Rotor period in bits.
+    uint32_t period;
+
+    // Rotor angle per bit in 0.01 degrees as a Q16 fixed point number.
+    uint32_t angle_scale;
+
+    // Number of checkpoints per polynomial.
+    uint8_t num_checkpoints;
+
+    // Checkpoints of both polynomials, sorted by state. Each entry holds the
+    // state in the upper bits and the checkpoint index in the lower
+    // LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS bits.
+    uint32_t checkpoints[2][LIGHTHOUSE_V2_MAX_NUM_CHECKPOINTS];
+} lighthouse_v2_base_station_t;
+
+// Configured base stations.
+static lighthouse_v2_base_station_t
+    g_lighthouse_v2_base_stations[LIGHTHOUSE_V2_MAX_BASE_STATIONS];
+
+// Number of configured base stations.
+static uint8_t g_lighthouse_v2_num_base_stations = 0;
+
+// Maximum half and full bit intervals in timer ticks, shifted left by 8 bits.
+static uint32_t g_lighthouse_v2_max_half_bit = 0;
+static uint32_t g_lighthouse_v2_max_full_bit = 0;
+
+// Return the parity of the word.
+static inline uint32_t lighthouse_v2_parity(uint32_t word) {
+    word ^= word >> 16;
+    word ^= word >> 8;
+    word ^= word >> 4;
+    word ^= word >> 2;
+    word ^= word >> 1;
+    return word & 1;
+}
+
+// Return the next LFSR state.
+static inline uint32_t lighthouse_v2_lfsr_next(const uint32_t state,
+                                               const uint32_t polynomial) {
+    return ((state << 1) | lighthouse_v2_parity(state & polynomial)) &
+           LIGHTHOUSE_V2_LFSR_MASK;
+}
+
+// Return the bit at the index, MSB-first.
+static inline uint32_t lighthouse_v2_get_bit(const uint32_t* bits,
+                                             const uint8_t index) {
+    return (bits[index / 32] >> (31 - index % 32)) & 1;
+}
+
+// Build the sorted checkpoint table of the polynomial.
+static void lighthouse_v2_build_checkpoints(uint32_t* checkpoints,
+                                            const uint8_t num_checkpoints,
+                                            const uint32_t polynomial) {
+    uint32_t state = LIGHTHOUSE_V2_LFSR_START_STATE;
+    uint32_t entry = 0;
+    uint32_t step = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    for (i = 0; i < num_checkpoints; ++i) {
+        entry = (state << LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS) | i;
+
+        // Insert the checkpoint in order.
+        for (j = i; j > 0 && checkpoints[j - 1] > entry; --j) {
+            checkpoints[j] = checkpoints[j - 1];
+        }
+        checkpoints[j] = entry;
+
+        for (step = 0; step < LIGHTHOUSE_V2_CHECKPOINT_SPACING; ++step) {
+            state = lighthouse_v2_lfsr_next(state, polynomial);
+        }
+    }
+}
+
+// Return the index of the checkpoint with the state, or -1 if the state is
+// not a checkpoint.
+static int16_t lighthouse_v2_find_checkpoint(const uint32_t* checkpoints,
+                                             const uint8_t num_checkpoints,
+                                             const uint32_t state) {
+    uint8_t low = 0;
+    uint8_t high = num_checkpoints;
+    uint8_t middle = 0;
+    uint32_t checkpoint_state = 0;
+
+    while (low < high) {
+        middle = (low + high) / 2;
+        checkpoint_state =
+            checkpoints[middle] >> LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS;
+        if (checkpoint_state == state) {
+            return checkpoints[middle] &
+                   ((1 << LIGHTHOUSE_V2_CHECKPOINT_INDEX_BITS) - 1);
+        }
+        if (checkpoint_state < state) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return -1;
+}
+
+// Return the offset of the LFSR state, or -1 if no checkpoint is reached
+// within the checkpoint spacing.
+static int32_t lighthouse_v2_find_offset(
+    const lighthouse_v2_base_station_t* base_station, const uint8_t data_bit,
+    uint32_t state) {
+    const uint32_t polynomial =
+        g_lighthouse_v2_polynomials[2 * (base_station->channel - 1) +
+                                    data_bit];
+    int16_t index = 0;
+    uint32_t step = 0;
+
+    for (step = 0; step <= LIGHTHOUSE_V2_CHECKPOINT_SPACING; ++step) {
+        index = lighthouse_v2_find_checkpoint(
+            base_station->checkpoints[data_bit], base_station->num_checkpoints,
+            state);
+        if (index >= 0) {
+            return (int32_t)index * LIGHTHOUSE_V2_CHECKPOINT_SPACING - step;
+        }
+        state = lighthouse_v2_lfsr_next(state, polynomial);
+    }
+    return -1;
+}
+
+bool lighthouse_v2_init(const uint8_t* channels, const uint8_t num_channels,
+                        const uint32_t timer_ticks_in_100ms) {
+    lighthouse_v2_base_station_t* base_station = NULL;
+    uint8_t i = 0;
+
+    g_lighthouse_v2_num_base_stations = 0;
+    if (num_channels > LIGHTHOUSE_V2_MAX_BASE_STATIONS) {
+        return false;
+    }
+    for (i = 0; i < num_channels; ++i) {
+        if (channels[i] == 0 || channels[i] > LIGHTHOUSE_V2_NUM_CHANNELS) {
+            return false;
+        }
+    }
+
+    // A half bit is shorter than 3/4 bits, and a full bit is shorter than
+    // 3/2 bits.
+    g_lighthouse_v2_max_half_bit =
+        ((uint64_t)timer_ticks_in_100ms * 256 * 3) /
+        (4 * LIGHTHOUSE_V2_BITS_IN_100MS);
+    g_lighthouse_v2_max_full_bit =
+        ((uint64_t)timer_ticks_in_100ms * 256 * 3) /
+        (2 * LIGHTHOUSE_V2_BITS_IN_100MS);
+
+    for (i = 0; i < num_channels; ++i) {
+        base_station = &g_lighthouse_v2_base_stations[i];
+        base_station->channel = channels[i];
+        base_station->period = g_lighthouse_v2_periods[channels[i] - 1] /
+                               LIGHTHOUSE_V2_PERIOD_TICKS_PER_BIT;
+        base_station->angle_scale =
+            (((uint32_t)36000 << 16) + base_station->period / 2) /
+            base_station->period;
+        base_station->num_checkpoints =
+            base_station->period / LIGHTHOUSE_V2_CHECKPOINT_SPACING + 2;
+
+        lighthouse_v2_build_checkpoints(
+            base_station->checkpoints[0], base_station->num_checkpoints,
+            g_lighthouse_v2_polynomials[2 * (channels[i] - 1)]);
+        lighthouse_v2_build_checkpoints(
+            base_station->checkpoints[1], base_station->num_checkpoints,
+            g_lighthouse_v2_polynomials[2 * (channels[i] - 1) + 1]);
+    }
+    g_lighthouse_v2_num_base_stations = num_channels;
+    return true;
+}
+
+uint8_t lighthouse_v2_edges_to_bits(const uint32_t* timestamps,
+                                    const uint16_t num_edges, uint32_t* bits) {
+    uint32_t interval = 0;
+    uint8_t num_bits = 0;
+    bool half_bit = false;
+    uint16_t i = 0;
+
+    memset(bits, 0, LIGHTHOUSE_V2_MAX_NUM_BITS / 8);
+    for (i = 1; i < num_edges && num_bits < LIGHTHOUSE_V2_MAX_NUM_BITS; ++i) {
+        // Stop at gaps long enough to overflow the shift.
+        interval = timestamps[i] - timestamps[i - 1];
+        if (interval >= (1 << 24)) {
+            break;
+        }
+        interval <<= 8;
+
+        if (interval < g_lighthouse_v2_max_half_bit) {
+            // The second half bit completes a 1.
+            if (half_bit) {
+                bits[num_bits / 32] |= (uint32_t)1 << (31 - num_bits % 32);
+                ++num_bits;
+            }
+            half_bit = !half_bit;
+        } else if (interval < g_lighthouse_v2_max_full_bit && !half_bit) {
+            // A full bit is a 0.
+            ++num_bits;
+        } else {
+            break;
+        }
+    }
+    return num_bits;
+}
+
+bool lighthouse_v2_decode_bits(const uint32_t* bits, const uint8_t num_bits,
+                               const uint32_t timestamp,
+                               lighthouse_v2_sweep_t* sweep) {
+    const lighthouse_v2_base_station_t* base_station = NULL;
+    uint32_t initial_state = 0;
+    uint32_t state = 0;
+    uint32_t polynomial = 0;
+    int32_t offset = 0;
+    uint8_t num_errors = 0;
+    uint8_t i = 0;
+    uint8_t data_bit = 0;
+    uint8_t j = 0;
+
+    if (num_bits < LIGHTHOUSE_V2_LFSR_LENGTH + LIGHTHOUSE_V2_NUM_CHECK_BITS) {
+        return false;
+    }
+
+    for (j = 0; j < LIGHTHOUSE_V2_LFSR_LENGTH; ++j) {
+        initial_state = (initial_state << 1) | lighthouse_v2_get_bit(bits, j);
+    }
+
+    for (i = 0; i < g_lighthouse_v2_num_base_stations; ++i) {
+        base_station = &g_lighthouse_v2_base_stations[i];
+        for (data_bit = 0; data_bit < 2; ++data_bit) {
+            polynomial =
+                g_lighthouse_v2_polynomials[2 * (base_station->channel - 1) +
+                                            data_bit];
+
+            // Check whether the polynomial predicts the remaining bits.
+            state = initial_state;
+            num_errors = 0;
+            for (j = LIGHTHOUSE_V2_LFSR_LENGTH; j < num_bits && num_errors == 0;
+                 ++j) {
+                num_errors += lighthouse_v2_parity(state & polynomial) ^
+                              lighthouse_v2_get_bit(bits, j);
+                state = lighthouse_v2_lfsr_next(state, polynomial);
+            }
+            if (num_errors > 0) {
+                continue;
+            }
+
+            // The state is at the offset of the last bit of the state.
+            offset = lighthouse_v2_find_offset(base_station, data_bit,
+                                               initial_state);
+            if (offset < LIGHTHOUSE_V2_LFSR_LENGTH - 1) {
+                continue;
+            }
+            offset -= LIGHTHOUSE_V2_LFSR_LENGTH - 1;
+
+            sweep->channel = base_station->channel;
+            sweep->data_bit = data_bit;
+            sweep->offset = offset;
+            sweep->angle = ((uint32_t)offset * base_station->angle_scale) >> 16;
+            sweep->timestamp = timestamp;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lighthouse_v2_decode_edges(const uint32_t* timestamps,
+                                const uint16_t num_edges,
+                                lighthouse_v2_sweep_t* sweep) {
+    uint32_t bits[LIGHTHOUSE_V2_MAX_NUM_BITS / 32];
+    uint8_t num_bits = 0;
+
+    if (num_edges == 0) {
+        return false;
+    }
+    num_bits = lighthouse_v2_edges_to_bits(timestamps, num_edges, bits);
+    return lighthouse_v2_decode_bits(bits, num_bits, timestamps[0], sweep);
+}
@@ -0,0 +1,106 @@
+// The lighthouse V2 module decodes the sweeps of Lighthouse V2 base stations.
+// Unlike V1 base stations, V2 base stations send no sync pulses. Instead, the
+// laser light of each sweep is modulated at 6 Mbps with biphase mark coding
+// (BMC) by the output of a 17-bit Fibonacci LFSR that restarts once per rotor
+// revolution. The base station channel selects a pair of LFSR polynomials, and
+// the polynomial of each sweep carries one bit of the base station's data
+// stream. The LFSR offset of a received bit sequence is the time since the
+// start of the revolution, so it gives the sweep angle without a sync pulse.
+//
+// A sweep is decoded in three steps:
+//  - The BMC edge timestamps captured during the light pulse are converted to
+//    bits. A full bit interval is a 0, and two half bit intervals are a 1.
+//  - The first 17 bits form the LFSR state. The polynomial is identified by
+//    checking which configured polynomial predicts the remaining bits.
+//  - The LFSR is stepped forward from the state until it hits a checkpoint
+//    state with a known offset. The checkpoints are taken every
+//    LIGHTHOUSE_V2_CHECKPOINT_SPACING steps and stored sorted by state, so
+//    each step is a binary search instead of a search over all 2^17 states.
+// The checkpoint tables are built in RAM by lighthouse_v2_init() only for the
+// configured channels. A smaller spacing makes the search faster but the
+// tables larger: each polynomial takes about 4 * 120000 / spacing bytes.
+//
+// The edge timestamps must resolve the 12 MHz BMC transitions, so they should
+// come from a timer of at least 24 MHz. The bits can also be passed directly
+// to lighthouse_v2_decode_bits() if the light is demodulated externally.
+//
+// EXPERIMENTAL: No application uses this module yet, so lighthouse_v2.c is not
+// part of any project and must be added to the project that uses it. SCuM 3C
+// has no capture timer fast enough for the BMC edges, and the lighthouse
+// applications only decode V1 sweeps, so the module needs an external
+// demodulator that passes the bits to lighthouse_v2_decode_bits(). It is not
+// tested on hardware.
+
+#ifndef __LIGHTHOUSE_V2_H
+#define __LIGHTHOUSE_V2_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of base station channels.
+#define LIGHTHOUSE_V2_NUM_CHANNELS 16
+
+// Maximum number of base stations that can be decoded at once.
+#ifndef LIGHTHOUSE_V2_MAX_BASE_STATIONS
+#define LIGHTHOUSE_V2_MAX_BASE_STATIONS 2
+#endif  // LIGHTHOUSE_V2_MAX_BASE_STATIONS
+
+// Number of LFSR steps between checkpoints. Must be at least 512, so that the
+// checkpoint index fits into 8 bits.
+#ifndef LIGHTHOUSE_V2_CHECKPOINT_SPACING
+#define LIGHTHOUSE_V2_CHECKPOINT_SPACING 1024
+#endif  // LIGHTHOUSE_V2_CHECKPOINT_SPACING
+
+// Number of bits of the LFSR state.
+#define LIGHTHOUSE_V2_LFSR_LENGTH 17
+
+// Number of bits after the LFSR state that must match the polynomial.
+#define LIGHTHOUSE_V2_NUM_CHECK_BITS 8
+
+// Maximum number of decoded bits per sweep.
+#define LIGHTHOUSE_V2_MAX_NUM_BITS 64
+
+// Decoded sweep.
+typedef struct {
+    // Base station channel between 1 and LIGHTHOUSE_V2_NUM_CHANNELS.
+    uint8_t channel;
+
+    // Data bit of the base station, i.e., which polynomial of the channel's
+    // pair was used.
+    uint8_t data_bit;
+
+    // LFSR offset of the first decoded bit.
+    uint32_t offset;
+
+    // Rotor angle of the first decoded bit in 0.01 degrees.
+    uint16_t angle;
+
+    // Timestamp of the first edge.
+    uint32_t timestamp;
+} lighthouse_v2_sweep_t;
+
+// Initialize the decoder for the given base station channels and build their
+// checkpoint tables, which takes about 240000 LFSR steps per channel. The
+// edge timestamps are in timer ticks, of which there are timer_ticks_in_100ms
+// in 100 ms. Return false if there are too many or invalid channels.
+bool lighthouse_v2_init(const uint8_t* channels, uint8_t num_channels,
+                        uint32_t timer_ticks_in_100ms);
+
+// Convert the edge timestamps of a light pulse to bits, MSB-first. Decoding
+// stops at the first interval that is neither a half nor a full bit. Return
+// the number of decoded bits.
+uint8_t lighthouse_v2_edges_to_bits(const uint32_t* timestamps,
+                                    uint16_t num_edges, uint32_t* bits);
+
+// Decode the bits of a sweep, MSB-first, received at the timestamp. Return
+// whether a configured polynomial and its offset have been found.
+bool lighthouse_v2_decode_bits(const uint32_t* bits, uint8_t num_bits,
+                               uint32_t timestamp,
+                               lighthouse_v2_sweep_t* sweep);
+
+// Decode the edge timestamps of a light pulse. Return whether a sweep has
+// been decoded.
+bool lighthouse_v2_decode_edges(const uint32_t* timestamps, uint16_t num_edges,
+                                lighthouse_v2_sweep_t* sweep);
+
+#endif  // __LIGHTHOUSE_V2_H
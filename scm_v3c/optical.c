@@ -1,19 +1,121 @@
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "counters.h"
+#include "isr_profiler.h"
+#include "lc_table.h"
 #include "memory_map.h"
+#include "optical_data.h"
 #include "radio.h"
 #include "scm3c_hw_interface.h"
 #include "scum_defs.h"
 
 //=========================== defines =========================================
 
+// The calibration is a closed loop over 100 ms windows between optical SFDs.
+// Each clock jumps close to its target in one window using the known DAC step
+// sizes, and the codes on both sides of the target bracket the search, so an
+// overshoot is corrected by bisection. The calibration finishes once all clocks
+// are within tolerance for OPTICAL_CAL_NUM_SETTLED_WINDOWS consecutive windows.
+
+// Number of initial windows without corrections, since the counts of the first
+// windows do not span a full 100 ms.
+#define OPTICAL_CAL_NUM_SKIPPED_WINDOWS 2
+
+// Number of consecutive windows with all clocks within tolerance to finish.
+#define OPTICAL_CAL_NUM_SETTLED_WINDOWS 2
+
+// Maximum number of windows. The calibration finishes with the current codes
+// if the clocks have not settled by then.
+#define OPTICAL_CAL_MAX_NUM_WINDOWS 50
+
+// HF clock counts in 100 ms. Fine DAC step size is about 6000 counts, and a
+// higher fine code is slower.
+#define OPTICAL_CAL_HF_CLOCK_TARGET 2000000
+#define OPTICAL_CAL_HF_CLOCK_TOLERANCE 3000
+#define OPTICAL_CAL_HF_CLOCK_COUNTS_PER_FINE_CODE -6000
+
+// HF clock fine code after rolling over to the next lower or higher coarse
+// code.
+#define OPTICAL_CAL_HF_CLOCK_FINE_AFTER_COARSE_DECREMENT 10
+#define OPTICAL_CAL_HF_CLOCK_FINE_AFTER_COARSE_INCREMENT 20
+
+// 2 MHz RC counts in 100 ms. Coarse step ~1100 counts, fine ~150 counts,
+// superfine ~25, and higher codes are slower. Each code level is corrected
+// only while the error exceeds the tolerance of that level.
+#define OPTICAL_CAL_RC2M_TARGET 200000
+#define OPTICAL_CAL_RC2M_COARSE_TOLERANCE 600
+#define OPTICAL_CAL_RC2M_FINE_TOLERANCE 80
+#define OPTICAL_CAL_RC2M_SUPERFINE_TOLERANCE 15
+#define OPTICAL_CAL_RC2M_COUNTS_PER_COARSE_CODE -1100
+#define OPTICAL_CAL_RC2M_COUNTS_PER_FINE_CODE -150
+#define OPTICAL_CAL_RC2M_COUNTS_PER_SUPERFINE_CODE -25
+
+// IF clock counts in 100 ms. Fine DAC step size is ~2800 counts, and a higher
+// fine code is slower.
+#define OPTICAL_CAL_IF_TARGET 1600000
+#define OPTICAL_CAL_IF_TOLERANCE 1400
+#define OPTICAL_CAL_IF_COUNTS_PER_FINE_CODE -2800
+
+// LC counts in 100 ms are given by LC_target. The count change per LC code
+// depends on the chip and is estimated from consecutive windows, starting with
+// steps of OPTICAL_CAL_LC_MAX_STEP. LC steps are capped since LC_monotonic()
+// is not linear across the coarse and mid boundaries.
+#define OPTICAL_CAL_LC_TOLERANCE 0
+#define OPTICAL_CAL_LC_MAX_STEP 16
+
+// Maximum value of the 5-bit tuning codes.
+#define OPTICAL_CAL_MAX_CODE 31
+
 //=========================== variables =======================================
 
+// Control loop of a single code.
+typedef struct {
+    // Target count and tolerance.
+    int32_t target;
+    int32_t tolerance;
+
+    // Count change per code increment.
+    int32_t counts_per_code;
+
+    // Whether to estimate counts_per_code from consecutive windows.
+    bool estimate_slope;
+
+    // Range of the code and maximum code change per window.
+    int32_t min_code;
+    int32_t max_code;
+    int32_t max_step;
+
+    // Last codes with a count below and above the target, and their errors.
+    bool has_below;
+    int32_t below_code;
+    int32_t below_error;
+    bool has_above;
+    int32_t above_code;
+    int32_t above_error;
+
+    // Code and count of the previous window.
+    bool has_last;
+    int32_t last_code;
+    uint32_t last_count;
+} optical_cal_loop_t;
+
 typedef struct {
     uint8_t optical_cal_iteration;
     uint8_t optical_cal_finished;
 
+    // Number of consecutive windows with all clocks within tolerance.
+    uint8_t num_settled_windows;
+
+    // Control loops.
+    optical_cal_loop_t HF_CLOCK_loop;
+    optical_cal_loop_t RC2M_coarse_loop;
+    optical_cal_loop_t RC2M_fine_loop;
+    optical_cal_loop_t RC2M_superfine_loop;
+    optical_cal_loop_t IF_loop;
+    optical_cal_loop_t LC_loop;
+
     uint32_t num_32k_ticks_in_100ms;
     uint32_t num_2MRC_ticks_in_100ms;
     uint32_t num_IFclk_ticks_in_100ms;
@@ -23,12 +125,29 @@ typedef struct {
     // reference to calibrate
     uint32_t LC_target;
     uint32_t LC_code;
+
+    // Sweep and number of LC codes of the LC table built after the optical
+    // calibration, or zero LC codes to not build it.
+    tuning_sweep_config_t lc_table_sweep_config;
+    uint16_t lc_table_num_codes;
 } optical_vars_t;
 
 optical_vars_t optical_vars;
 
 //=========================== prototypes ======================================
 
+static void optical_cal_loop_init(optical_cal_loop_t* loop, int32_t target,
+                                  int32_t tolerance, int32_t counts_per_code,
+                                  int32_t min_code, int32_t max_code,
+                                  int32_t max_step);
+static int32_t optical_cal_divide_round(int32_t numerator,
+                                        int32_t denominator);
+static void optical_cal_loop_reset(optical_cal_loop_t* loop);
+static int32_t optical_cal_loop_update(optical_cal_loop_t* loop, int32_t code,
+                                       uint32_t count, bool* settled);
+static void optical_cal_init_loops(void);
+static void optical_build_lc_table(void);
+
 //=========================== public ==========================================
 
 void optical_init(void) {
@@ -45,12 +164,27 @@ uint8_t optical_getCalibrationFinshed(void) {
     return optical_vars.optical_cal_finished;
 }
 
+uint32_t optical_getHFClockTicksIn100ms(void) {
+    return optical_vars.num_HFclock_ticks_in_100ms;
+}
+
+uint32_t optical_getLCCode(void) { return optical_vars.LC_code; }
+
 void optical_enable(void) {
     ISER = 0x1800;  // 1 is for enabling GPIO8 ext interrupt (3WB cal) and 8 is
                     // for enabling optical interrupt
 }
 
+void optical_set_lc_table_sweep(const tuning_sweep_config_t* sweep_config,
+                                uint16_t num_codes) {
+    optical_vars.lc_table_sweep_config = *sweep_config;
+    optical_vars.lc_table_num_codes = num_codes;
+}
+
 void perform_calibration(void) {
+    // Allow the calibration to be repeated, e.g., at another temperature
+    optical_vars.optical_cal_finished = 0;
+
     // For the LO, calibration for RX channel 11, so turn on AUX, IF, and LO
     // LDOs by calling radio rxEnable
     radio_rxEnable();
@@ -62,12 +196,184 @@ void perform_calibration(void) {
     while (optical_getCalibrationFinshed() == 0)
         ;
 
+    // Build the LC table once per chip while the LO is still on, unless it has
+    // been loaded with the calibration data
+    if (optical_vars.lc_table_num_codes > 0 && !lc_table_is_valid()) {
+        optical_build_lc_table();
+    }
+
     // Disable the radio now that it is calibrated
     radio_rfOff();
 
     printf("Calibration complete\r\n");
 }
 
+//=========================== private =========================================
+
+static void optical_cal_loop_init(optical_cal_loop_t* loop, int32_t target,
+                                  int32_t tolerance, int32_t counts_per_code,
+                                  int32_t min_code, int32_t max_code,
+                                  int32_t max_step) {
+    memset(loop, 0, sizeof(optical_cal_loop_t));
+    loop->target = target;
+    loop->tolerance = tolerance;
+    loop->counts_per_code = counts_per_code;
+    loop->min_code = min_code;
+    loop->max_code = max_code;
+    loop->max_step = max_step;
+}
+
+// Divide and round to the nearest integer.
+static int32_t optical_cal_divide_round(int32_t numerator,
+                                        int32_t denominator) {
+    if ((numerator < 0) == (denominator < 0)) {
+        return (numerator + denominator / 2) / denominator;
+    }
+    return (numerator - denominator / 2) / denominator;
+}
+
+// Forget the bracketing codes, e.g., after a coarser code has changed.
+static void optical_cal_loop_reset(optical_cal_loop_t* loop) {
+    loop->has_below = false;
+    loop->has_above = false;
+    loop->has_last = false;
+}
+
+// Return the code for the next window given the count of the current window.
+// settled is set if the count is within tolerance or if the closest code has
+// been found between two adjacent bracketing codes.
+static int32_t optical_cal_loop_update(optical_cal_loop_t* loop, int32_t code,
+                                       uint32_t count, bool* settled) {
+    int32_t error = (int32_t)count - loop->target;
+    int32_t step;
+    int32_t next_code;
+    int32_t slope;
+
+    *settled = false;
+
+    // Estimate the count change per code from the previous window
+    if (loop->estimate_slope && loop->has_last && code != loop->last_code) {
+        slope = ((int32_t)count - (int32_t)loop->last_count) /
+                (code - loop->last_code);
+        if (slope != 0 && (slope > 0) == (loop->counts_per_code > 0)) {
+            loop->counts_per_code = slope;
+        }
+    }
+    loop->has_last = true;
+    loop->last_code = code;
+    loop->last_count = count;
+
+    if (error >= -loop->tolerance && error <= loop->tolerance) {
+        *settled = true;
+        return code;
+    }
+
+    // Remember the last code on each side of the target
+    if (error < 0) {
+        loop->has_below = true;
+        loop->below_code = code;
+        loop->below_error = -error;
+    } else {
+        loop->has_above = true;
+        loop->above_code = code;
+        loop->above_error = error;
+    }
+
+    // Jump by the error divided by the step size, rounded to the nearest code
+    step = optical_cal_divide_round(-error, loop->counts_per_code);
+    if (step == 0) {
+        step = (error < 0) == (loop->counts_per_code > 0) ? 1 : -1;
+    }
+    if (step > loop->max_step) {
+        step = loop->max_step;
+    }
+    if (step < -loop->max_step) {
+        step = -loop->max_step;
+    }
+    next_code = code + step;
+
+    // Bisect if the jump leaves the bracket around the target
+    if (loop->has_below && loop->has_above) {
+        if (loop->below_code - loop->above_code <= 1 &&
+            loop->above_code - loop->below_code <= 1) {
+            *settled = true;
+            return loop->below_error <= loop->above_error ? loop->below_code
+                                                          : loop->above_code;
+        }
+        if ((next_code - loop->below_code) * (next_code - loop->above_code) >=
+            0) {
+            next_code = (loop->below_code + loop->above_code) / 2;
+        }
+    }
+
+    if (next_code < loop->min_code) {
+        next_code = loop->min_code;
+    }
+    if (next_code > loop->max_code) {
+        next_code = loop->max_code;
+    }
+    return next_code;
+}
+
+static void optical_cal_init_loops(void) {
+    // The HF clock fine code rolls over into the coarse code, so its range is
+    // checked by the caller
+    optical_cal_loop_init(&optical_vars.HF_CLOCK_loop,
+                          OPTICAL_CAL_HF_CLOCK_TARGET,
+                          OPTICAL_CAL_HF_CLOCK_TOLERANCE,
+                          OPTICAL_CAL_HF_CLOCK_COUNTS_PER_FINE_CODE, INT32_MIN,
+                          INT32_MAX, OPTICAL_CAL_MAX_CODE);
+    optical_cal_loop_init(&optical_vars.RC2M_coarse_loop,
+                          OPTICAL_CAL_RC2M_TARGET,
+                          OPTICAL_CAL_RC2M_COARSE_TOLERANCE,
+                          OPTICAL_CAL_RC2M_COUNTS_PER_COARSE_CODE, 0,
+                          OPTICAL_CAL_MAX_CODE, OPTICAL_CAL_MAX_CODE);
+    optical_cal_loop_init(&optical_vars.RC2M_fine_loop, OPTICAL_CAL_RC2M_TARGET,
+                          OPTICAL_CAL_RC2M_FINE_TOLERANCE,
+                          OPTICAL_CAL_RC2M_COUNTS_PER_FINE_CODE, 0,
+                          OPTICAL_CAL_MAX_CODE, OPTICAL_CAL_MAX_CODE);
+    optical_cal_loop_init(&optical_vars.RC2M_superfine_loop,
+                          OPTICAL_CAL_RC2M_TARGET,
+                          OPTICAL_CAL_RC2M_SUPERFINE_TOLERANCE,
+                          OPTICAL_CAL_RC2M_COUNTS_PER_SUPERFINE_CODE, 0,
+                          OPTICAL_CAL_MAX_CODE, OPTICAL_CAL_MAX_CODE);
+    optical_cal_loop_init(&optical_vars.IF_loop, OPTICAL_CAL_IF_TARGET,
+                          OPTICAL_CAL_IF_TOLERANCE,
+                          OPTICAL_CAL_IF_COUNTS_PER_FINE_CODE, 0,
+                          OPTICAL_CAL_MAX_CODE, OPTICAL_CAL_MAX_CODE);
+
+    // A higher LC code is faster. The initial count change of one per code
+    // only sets the direction of the first step.
+    optical_cal_loop_init(&optical_vars.LC_loop, optical_vars.LC_target,
+                          OPTICAL_CAL_LC_TOLERANCE, 1, 0, INT32_MAX,
+                          OPTICAL_CAL_LC_MAX_STEP);
+    optical_vars.LC_loop.estimate_slope = true;
+
+    optical_vars.num_settled_windows = 0;
+}
+
+// Build the LC table and convert the calibrated LC code into the LC code of
+// the table with the same LC frequency.
+static void optical_build_lc_table(void) {
+    uint32_t count_LC;
+
+    printf("Building LC table...\r\n");
+    count_LC = lc_table_measure_count();
+    if (!lc_table_build(&optical_vars.lc_table_sweep_config,
+                        optical_vars.lc_table_num_codes)) {
+        printf("LC table failed\r\n");
+        LC_monotonic(optical_vars.LC_code);
+        return;
+    }
+
+    optical_vars.LC_code = lc_table_count_to_lc_code(count_LC);
+    LC_monotonic(optical_vars.LC_code);
+
+    // Print the table to store it with the calibration data
+    lc_table_print();
+    printf("LC_code=%d\r\n", optical_vars.LC_code);
+}
+
 //=========================== interrupt =======================================
 
 // This interrupt goes off every time 32 new bits of data have been shifted into
@@ -75,18 +381,11 @@ void perform_calibration(void) {
 // while trying to receive optical data ex, printf will mess up the received
 // data values
 void optical_32_isr(void) {
-    // printf("Optical 32-bit interrupt triggered\r\n");
-
-    // unsigned int LSBs, MSBs, optical_shiftreg;
-    // int t;
-
     // 32-bit register is analog_rdata[335:304]
-    // LSBs = ANALOG_CFG_REG__19; //16 LSBs
-    // MSBs = ANALOG_CFG_REG__20; //16 MSBs
-    // optical_shiftreg = (MSBs << 16) + LSBs;
+    const uint32_t LSBs = ANALOG_CFG_REG__19;  // 16 LSBs
+    const uint32_t MSBs = ANALOG_CFG_REG__20;  // 16 MSBs
 
-    // Toggle GPIO 0
-    // GPIO_REG__OUTPUT ^= 0x1;
+    optical_data_receive_word((MSBs << 16) + LSBs);
 }
 
 // This interrupt goes off when the optical register holds the value {221, 176,
@@ -100,7 +399,10 @@ void optical_sfd_isr(void) {
     uint32_t dummy = 0;
 
     int32_t t;
-    uint32_t rdata_lsb, rdata_msb;
+    int32_t code;
+    bool settled;
+    bool all_settled;
+    counters_snapshot_t counters;
     uint32_t count_LC, count_32k, count_2M, count_HFclock, count_IF;
 
     uint32_t HF_CLOCK_fine;
@@ -112,6 +414,8 @@ void optical_sfd_isr(void) {
     uint32_t IF_coarse;
     uint32_t IF_fine;
 
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_OPTICAL_SFD);
+
     HF_CLOCK_fine = scm3c_hw_interface_get_HF_CLOCK_fine();
     HF_CLOCK_coarse = scm3c_hw_interface_get_HF_CLOCK_coarse();
     RC2M_coarse = scm3c_hw_interface_get_RC2M_coarse();
@@ -121,65 +425,39 @@ void optical_sfd_isr(void) {
     IF_coarse = scm3c_hw_interface_get_IF_coarse();
     IF_fine = scm3c_hw_interface_get_IF_fine();
 
-    // Disable all counters
-    ANALOG_CFG_REG__0 = 0x007F;
+    // Read all counters and restart them for the next calibration period
+    counters_read(&counters);
+    count_32k = counters.counts[COUNTERS_32K];
+    count_HFclock = counters.counts[COUNTERS_HF_CLOCK];
+    count_2M = counters.counts[COUNTERS_2M];
+    count_LC = counters.counts[COUNTERS_LC];
+    count_IF = counters.counts[COUNTERS_IF];
 
     // Keep track of how many calibration iterations have been completed
     optical_vars.optical_cal_iteration++;
+    if (optical_vars.optical_cal_iteration == 1) {
+        optical_cal_init_loops();
+    }
 
-    // Read 32k counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x000000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x040000);
-    count_32k = rdata_lsb + (rdata_msb << 16);
-
-    // Read HF_CLOCK counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x100000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x140000);
-    count_HFclock = rdata_lsb + (rdata_msb << 16);
-
-    // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    count_2M = rdata_lsb + (rdata_msb << 16);
-
-    // Read LC_div counter (via counter4)
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x280000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x2C0000);
-    count_LC = rdata_lsb + (rdata_msb << 16);
-
-    // Read IF ADC_CLK counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x300000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x340000);
-    count_IF = rdata_lsb + (rdata_msb << 16);
-
-    // Reset all counters
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // Enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
+    // Don't make updates on the first windows
+    if (optical_vars.optical_cal_iteration > OPTICAL_CAL_NUM_SKIPPED_WINDOWS) {
+        // Batch all tuning updates into a single scan chain write
+        asc_begin();
 
-    // Don't make updates on the first two executions of this ISR
-    if (optical_vars.optical_cal_iteration > 2) {
         // Do correction on HF CLOCK
-        // Fine DAC step size is about 6000 counts
-        if (count_HFclock < 1997000) {  // 1997000 original value
-            if (HF_CLOCK_fine == 0) {
-                HF_CLOCK_coarse--;
-                HF_CLOCK_fine = 10;
-                optical_vars.optical_cal_iteration = 3;
-            } else {
-                HF_CLOCK_fine--;
-            }
-        }
-        if (count_HFclock >
-            2003000) {  // new value I picked was 2010000, originally 2003000
-            if (HF_CLOCK_fine == 31) {
-                HF_CLOCK_coarse++;
-                HF_CLOCK_fine = 20;
-                optical_vars.optical_cal_iteration = 3;
-            } else {
-                HF_CLOCK_fine++;
-            }
+        code = optical_cal_loop_update(&optical_vars.HF_CLOCK_loop,
+                                       HF_CLOCK_fine, count_HFclock, &settled);
+        all_settled = settled;
+        if (code < 0) {
+            HF_CLOCK_coarse--;
+            HF_CLOCK_fine = OPTICAL_CAL_HF_CLOCK_FINE_AFTER_COARSE_DECREMENT;
+            optical_cal_loop_reset(&optical_vars.HF_CLOCK_loop);
+        } else if (code > OPTICAL_CAL_MAX_CODE) {
+            HF_CLOCK_coarse++;
+            HF_CLOCK_fine = OPTICAL_CAL_HF_CLOCK_FINE_AFTER_COARSE_INCREMENT;
+            optical_cal_loop_reset(&optical_vars.HF_CLOCK_loop);
+        } else {
+            HF_CLOCK_fine = code;
         }
 
         set_sys_clk_secondary_freq(HF_CLOCK_coarse, HF_CLOCK_fine);
@@ -187,41 +465,37 @@ void optical_sfd_isr(void) {
         scm3c_hw_interface_set_HF_CLOCK_fine(HF_CLOCK_fine);
 
         // Do correction on LC
-        if (count_LC > (optical_vars.LC_target + 0)) {
-            optical_vars.LC_code -= 1;
-        }
-        if (count_LC < (optical_vars.LC_target - 0)) {
-            optical_vars.LC_code += 1;
-        }
+        optical_vars.LC_code = optical_cal_loop_update(
+            &optical_vars.LC_loop, optical_vars.LC_code, count_LC, &settled);
+        all_settled = all_settled && settled;
         LC_monotonic(optical_vars.LC_code);
 
         // Do correction on 2M RC
-        // Coarse step ~1100 counts, fine ~150 counts, superfine ~25
-        // Too fast
-        if (count_2M > (200600)) {
-            RC2M_coarse += 1;
-        } else {
-            if (count_2M > (200080)) {
-                RC2M_fine += 1;
-            } else {
-                if (count_2M > (200015)) {
-                    RC2M_superfine += 1;
-                }
-            }
+        // Only the coarsest code level outside of its tolerance is corrected,
+        // and the finer levels start over after a coarser code changed. A
+        // settled loop may still pick the closer of its bracketing codes, so
+        // its code is always applied
+        code = optical_cal_loop_update(&optical_vars.RC2M_coarse_loop,
+                                       RC2M_coarse, count_2M, &settled);
+        if (code != (int32_t)RC2M_coarse) {
+            optical_cal_loop_reset(&optical_vars.RC2M_fine_loop);
+            optical_cal_loop_reset(&optical_vars.RC2M_superfine_loop);
         }
-
-        // Too slow
-        if (count_2M < (199400)) {
-            RC2M_coarse -= 1;
-        } else {
-            if (count_2M < (199920)) {
-                RC2M_fine -= 1;
-            } else {
-                if (count_2M < (199985)) {
-                    RC2M_superfine -= 1;
-                }
+        RC2M_coarse = code;
+        if (settled) {
+            code = optical_cal_loop_update(&optical_vars.RC2M_fine_loop,
+                                           RC2M_fine, count_2M, &settled);
+            if (code != (int32_t)RC2M_fine) {
+                optical_cal_loop_reset(&optical_vars.RC2M_superfine_loop);
+            }
+            RC2M_fine = code;
+            if (settled) {
+                RC2M_superfine = optical_cal_loop_update(
+                    &optical_vars.RC2M_superfine_loop, RC2M_superfine,
+                    count_2M, &settled);
             }
         }
+        all_settled = all_settled && settled;
 
         set_2M_RC_frequency(31, 31, RC2M_coarse, RC2M_fine, RC2M_superfine);
         scm3c_hw_interface_set_RC2M_coarse(RC2M_coarse);
@@ -229,20 +503,21 @@ void optical_sfd_isr(void) {
         scm3c_hw_interface_set_RC2M_superfine(RC2M_superfine);
 
         // Do correction on IF RC clock
-        // Fine DAC step size is ~2800 counts
-        if (count_IF > (1600000 + 1400)) {
-            IF_fine += 1;
-        }
-        if (count_IF < (1600000 - 1400)) {
-            IF_fine -= 1;
-        }
+        IF_fine = optical_cal_loop_update(&optical_vars.IF_loop, IF_fine,
+                                          count_IF, &settled);
+        all_settled = all_settled && settled;
 
         set_IF_clock_frequency(IF_coarse, IF_fine, 0);
         scm3c_hw_interface_set_IF_coarse(IF_coarse);
         scm3c_hw_interface_set_IF_fine(IF_fine);
 
-        analog_scan_chain_write();
-        analog_scan_chain_load();
+        asc_commit();
+
+        if (all_settled) {
+            optical_vars.num_settled_windows++;
+        } else {
+            optical_vars.num_settled_windows = 0;
+        }
     }
 
     // Debugging output
@@ -256,9 +531,16 @@ void optical_sfd_isr(void) {
            optical_vars.LC_code);
     printf("IF=%d-%d\r\n", count_IF, IF_fine);
 
-    if (optical_vars.optical_cal_iteration == 25) {
+    if (optical_vars.num_settled_windows >= OPTICAL_CAL_NUM_SETTLED_WINDOWS ||
+        optical_vars.optical_cal_iteration >= OPTICAL_CAL_MAX_NUM_WINDOWS) {
         // Disable this ISR
         ICER = 0x1800;
+        printf("Optical calibration %s after %d windows\r\n",
+               optical_vars.num_settled_windows >=
+                       OPTICAL_CAL_NUM_SETTLED_WINDOWS
+                   ? "settled"
+                   : "stopped",
+               optical_vars.optical_cal_iteration);
         optical_vars.optical_cal_iteration = 0;
         optical_vars.optical_cal_finished = 1;
 
@@ -298,4 +580,6 @@ void optical_sfd_isr(void) {
         // Halt all counters
         ANALOG_CFG_REG__0 = 0x0000;
     }
+
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_OPTICAL_SFD);
 }
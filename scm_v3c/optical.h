@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "tuning.h"
+
 //=========================== define ==========================================
 
 //=========================== typedef =========================================
@@ -14,7 +16,11 @@
 //==== admin
 void optical_init(void);
 uint8_t optical_getCalibrationFinshed(void);
+uint32_t optical_getHFClockTicksIn100ms(void);
+uint32_t optical_getLCCode(void);
 void optical_enable(void);
+void optical_set_lc_table_sweep(const tuning_sweep_config_t* sweep_config,
+                                uint16_t num_codes);
 void perform_calibration(void);
 void optical_sfd_isr(void);
 
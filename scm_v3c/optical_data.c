@@ -0,0 +1,316 @@
+#include "optical_data.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "asc_profiles.h"
+#include "crc32.h"
+#include "memory_map.h"
+#include "ring_buffer.h"
+#include "scm3c_hw_interface.h"
+
+// Interrupt enable bit of the optical 32-bit interrupt.
+#define OPTICAL_DATA_INTERRUPT 0x0004
+
+// Length of the frame header and of the CRC in bytes.
+#define OPTICAL_DATA_HEADER_LENGTH 4
+#define OPTICAL_DATA_CRC_LENGTH 4
+
+// Maximum frame length in bytes.
+#define OPTICAL_DATA_MAX_FRAME_LENGTH                            \
+    (OPTICAL_DATA_HEADER_LENGTH + OPTICAL_DATA_MAX_PAYLOAD_LENGTH + \
+     OPTICAL_DATA_CRC_LENGTH)
+
+// Length of the calibration message payload in bytes.
+#define OPTICAL_DATA_CALIBRATION_LENGTH 9
+
+// Length of the ASC profile message payload before the words in bytes.
+#define OPTICAL_DATA_ASC_PROFILE_HEADER_LENGTH 4
+
+// Length of the patch message offset in bytes.
+#define OPTICAL_DATA_PATCH_OFFSET_LENGTH 2
+
+// Maximum value of the 5-bit tuning codes.
+#define OPTICAL_DATA_MAX_CODE 31
+
+// Patch function.
+typedef void (*optical_data_patch_function_t)(void);
+
+// Received bytes, MSB-first from each received word.
+static ring_buffer_t g_optical_data_ring_buffer;
+
+// Frame being assembled.
+static uint8_t g_optical_data_frame[OPTICAL_DATA_MAX_FRAME_LENGTH];
+
+// Number of bytes of the frame received so far.
+static uint16_t g_optical_data_frame_length = 0;
+
+// Total length of the frame in bytes once the header has been received.
+static uint16_t g_optical_data_expected_length = 0;
+
+// RAM patch region.
+static uint32_t g_optical_data_patch[OPTICAL_DATA_PATCH_SIZE / 4];
+
+// Application message callback.
+static optical_data_callback_t g_optical_data_callback = NULL;
+
+// Optical data channel statistics.
+static optical_data_stats_t g_optical_data_stats;
+
+// Read a big-endian 16-bit value.
+static inline uint16_t optical_data_read_16(const uint8_t* bytes) {
+    return ((uint16_t)bytes[0] << 8) | bytes[1];
+}
+
+// Read a big-endian 32-bit value.
+static inline uint32_t optical_data_read_32(const uint8_t* bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+           ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+// Apply the calibration codes.
+static bool optical_data_apply_calibration(const uint8_t* payload,
+                                           const uint16_t length) {
+    uint8_t i = 0;
+
+    if (length != OPTICAL_DATA_CALIBRATION_LENGTH) {
+        return false;
+    }
+    for (i = 0; i < OPTICAL_DATA_CALIBRATION_LENGTH - 2; ++i) {
+        if (payload[i] > OPTICAL_DATA_MAX_CODE) {
+            return false;
+        }
+    }
+
+    // Batch all tuning updates into a single scan chain write
+    asc_begin();
+
+    set_sys_clk_secondary_freq(payload[0], payload[1]);
+    scm3c_hw_interface_set_HF_CLOCK_coarse(payload[0]);
+    scm3c_hw_interface_set_HF_CLOCK_fine(payload[1]);
+
+    set_2M_RC_frequency(31, 31, payload[2], payload[3], payload[4]);
+    scm3c_hw_interface_set_RC2M_coarse(payload[2]);
+    scm3c_hw_interface_set_RC2M_fine(payload[3]);
+    scm3c_hw_interface_set_RC2M_superfine(payload[4]);
+
+    set_IF_clock_frequency(payload[5], payload[6], 0);
+    scm3c_hw_interface_set_IF_coarse(payload[5]);
+    scm3c_hw_interface_set_IF_fine(payload[6]);
+
+    LC_monotonic(optical_data_read_16(&payload[7]));
+
+    asc_commit();
+    return true;
+}
+
+// Overwrite the words of an ASC profile.
+static bool optical_data_apply_asc_profile(const uint8_t* payload,
+                                           const uint16_t length) {
+    uint32_t words[OPTICAL_DATA_MAX_PAYLOAD_LENGTH / 4];
+    asc_profile_e profile = ASC_PROFILE_INVALID;
+    uint16_t num_words = 0;
+    uint16_t i = 0;
+
+    if (length < OPTICAL_DATA_ASC_PROFILE_HEADER_LENGTH ||
+        (length - OPTICAL_DATA_ASC_PROFILE_HEADER_LENGTH) % 4 != 0) {
+        return false;
+    }
+
+    profile = (asc_profile_e)payload[0];
+    num_words = (length - OPTICAL_DATA_ASC_PROFILE_HEADER_LENGTH) / 4;
+    for (i = 0; i < num_words; ++i) {
+        words[i] = optical_data_read_32(
+            &payload[OPTICAL_DATA_ASC_PROFILE_HEADER_LENGTH + 4 * i]);
+    }
+    if (!asc_profiles_write(profile, optical_data_read_16(&payload[2]), words,
+                            num_words)) {
+        return false;
+    }
+
+    // Apply the new words if the profile is currently active
+    if (asc_profiles_get_current() == profile) {
+        asc_profiles_switch(profile);
+    }
+    return true;
+}
+
+// Write bytes into the patch region.
+static bool optical_data_apply_patch_write(const uint8_t* payload,
+                                           const uint16_t length) {
+    uint16_t offset = 0;
+
+    if (length < OPTICAL_DATA_PATCH_OFFSET_LENGTH) {
+        return false;
+    }
+
+    offset = optical_data_read_16(payload);
+    if (offset + length - OPTICAL_DATA_PATCH_OFFSET_LENGTH >
+        OPTICAL_DATA_PATCH_SIZE) {
+        return false;
+    }
+    memcpy(optical_data_get_patch() + offset,
+           &payload[OPTICAL_DATA_PATCH_OFFSET_LENGTH],
+           length - OPTICAL_DATA_PATCH_OFFSET_LENGTH);
+    return true;
+}
+
+// Call a function in the patch region.
+static bool optical_data_apply_patch_call(const uint8_t* payload,
+                                          const uint16_t length) {
+    optical_data_patch_function_t function = NULL;
+    uint16_t offset = 0;
+
+    if (length != OPTICAL_DATA_PATCH_OFFSET_LENGTH) {
+        return false;
+    }
+
+    // Thumb instructions are halfword-aligned.
+    offset = optical_data_read_16(payload);
+    if (offset >= OPTICAL_DATA_PATCH_SIZE || offset % 2 != 0) {
+        return false;
+    }
+
+    // Set the LSB of the address to stay in Thumb state.
+    function = (optical_data_patch_function_t)(
+        ((uint32_t)optical_data_get_patch() + offset) | 1);
+    function();
+    return true;
+}
+
+// Apply the message of a frame with a valid CRC.
+static bool optical_data_apply(const optical_data_message_e type,
+                               const uint8_t* payload, const uint16_t length) {
+    switch (type) {
+        case OPTICAL_DATA_MESSAGE_CALIBRATION:
+            return optical_data_apply_calibration(payload, length);
+        case OPTICAL_DATA_MESSAGE_ASC_PROFILE:
+            return optical_data_apply_asc_profile(payload, length);
+        case OPTICAL_DATA_MESSAGE_PATCH_WRITE:
+            return optical_data_apply_patch_write(payload, length);
+        case OPTICAL_DATA_MESSAGE_PATCH_CALL:
+            return optical_data_apply_patch_call(payload, length);
+        case OPTICAL_DATA_MESSAGE_APPLICATION:
+            if (g_optical_data_callback == NULL) {
+                return false;
+            }
+            g_optical_data_callback(payload, length);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Check the CRC of the complete frame and apply its message. Return whether
+// the message was applied.
+static bool optical_data_handle_frame(void) {
+    const uint16_t crc_offset =
+        g_optical_data_expected_length - OPTICAL_DATA_CRC_LENGTH;
+
+    if (crc32(g_optical_data_frame, crc_offset) !=
+        optical_data_read_32(&g_optical_data_frame[crc_offset])) {
+        ++g_optical_data_stats.num_crc_errors;
+        return false;
+    }
+
+    ++g_optical_data_stats.num_frames;
+    if (!optical_data_apply(
+            (optical_data_message_e)g_optical_data_frame[1],
+            &g_optical_data_frame[OPTICAL_DATA_HEADER_LENGTH],
+            optical_data_read_16(&g_optical_data_frame[2]))) {
+        ++g_optical_data_stats.num_rejected;
+        return false;
+    }
+    return true;
+}
+
+void optical_data_init(void) {
+    ring_buffer_init(&g_optical_data_ring_buffer);
+    g_optical_data_frame_length = 0;
+    g_optical_data_expected_length = 0;
+    memset(&g_optical_data_stats, 0, sizeof(g_optical_data_stats));
+
+    ISER = OPTICAL_DATA_INTERRUPT;
+}
+
+void optical_data_disable(void) { ICER = OPTICAL_DATA_INTERRUPT; }
+
+void optical_data_set_callback(const optical_data_callback_t callback) {
+    g_optical_data_callback = callback;
+}
+
+void optical_data_receive_word(const uint32_t word) {
+    ring_buffer_type_t bytes[4];
+    uint8_t i = 0;
+
+    ++g_optical_data_stats.num_words;
+
+    // Drop the whole word to keep the frames word-aligned.
+    if (ring_buffer_size(&g_optical_data_ring_buffer) + 4 >
+        RING_BUFFER_MAX_SIZE) {
+        ++g_optical_data_stats.num_overflows;
+        return;
+    }
+
+    bytes[0] = word >> 24;
+    bytes[1] = word >> 16;
+    bytes[2] = word >> 8;
+    bytes[3] = word;
+    for (i = 0; i < 4; ++i) {
+        ring_buffer_push(&g_optical_data_ring_buffer, &bytes[i]);
+    }
+}
+
+uint8_t optical_data_process(void) {
+    ring_buffer_type_t byte = 0;
+    uint16_t payload_length = 0;
+    uint8_t num_applied = 0;
+
+    while (ring_buffer_pop(&g_optical_data_ring_buffer, &byte)) {
+        g_optical_data_frame[g_optical_data_frame_length++] = byte;
+        if (g_optical_data_frame_length % 4 != 0) {
+            continue;
+        }
+
+        // Search for the header word
+        if (g_optical_data_frame_length == OPTICAL_DATA_HEADER_LENGTH) {
+            payload_length = optical_data_read_16(&g_optical_data_frame[2]);
+            if (g_optical_data_frame[0] != OPTICAL_DATA_SYNC ||
+                payload_length > OPTICAL_DATA_MAX_PAYLOAD_LENGTH) {
+                g_optical_data_frame_length = 0;
+                continue;
+            }
+            g_optical_data_expected_length = OPTICAL_DATA_HEADER_LENGTH +
+                                             (payload_length + 3) / 4 * 4 +
+                                             OPTICAL_DATA_CRC_LENGTH;
+            continue;
+        }
+
+        if (g_optical_data_frame_length == g_optical_data_expected_length) {
+            if (optical_data_handle_frame()) {
+                ++num_applied;
+            }
+            g_optical_data_frame_length = 0;
+        }
+    }
+    return num_applied;
+}
+
+uint8_t* optical_data_get_patch(void) {
+    return (uint8_t*)g_optical_data_patch;
+}
+
+const optical_data_stats_t* optical_data_get_stats(void) {
+    return &g_optical_data_stats;
+}
+
+void optical_data_print_stats(void) {
+    printf("Optical data: %u words, %u overflows, %u frames, %u CRC errors, "
+           "%u rejected\r\n",
+           g_optical_data_stats.num_words, g_optical_data_stats.num_overflows,
+           g_optical_data_stats.num_frames,
+           g_optical_data_stats.num_crc_errors,
+           g_optical_data_stats.num_rejected);
+}
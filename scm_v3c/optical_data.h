@@ -0,0 +1,103 @@
+// The optical data channel is a framed, CRC-checked downlink over the 32-bit
+// optical shift register. It updates the calibration codes, ASC profiles, or
+// a RAM patch region at runtime without bootloading the whole image again.
+//
+// The optical 32-bit interrupt pushes every received word into a ring buffer,
+// and optical_data_process() assembles the frames from the main loop, so the
+// interrupt stays short enough not to corrupt the following bits. Each frame
+// is word-aligned and consists of:
+//  - A header word with OPTICAL_DATA_SYNC, the message type, and the payload
+//    length in bytes (big-endian).
+//  - The payload, padded with zeros to a multiple of 4 bytes.
+//  - The CRC-32 (big-endian) over the header and the padded payload.
+// The bytes are taken MSB-first from each received word. Words that do not
+// start a frame, e.g., padding between frames, are skipped, and frames with an
+// invalid length or CRC are dropped. scripts/optical_data.py builds the frames
+// and sends them with the Teensy's optical data transfer.
+
+#ifndef __OPTICAL_DATA_H
+#define __OPTICAL_DATA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// First byte of every frame header.
+#define OPTICAL_DATA_SYNC 0xA7
+
+// Maximum payload length in bytes.
+#define OPTICAL_DATA_MAX_PAYLOAD_LENGTH 256
+
+// Size of the RAM patch region in bytes.
+#ifndef OPTICAL_DATA_PATCH_SIZE
+#define OPTICAL_DATA_PATCH_SIZE 1024
+#endif  // OPTICAL_DATA_PATCH_SIZE
+
+// Message type enum.
+typedef enum {
+    // Calibration codes (9 bytes): HF clock coarse and fine, 2 MHz RC coarse,
+    // fine, and superfine, IF clock coarse and fine, and the LC code
+    // (big-endian) as passed to LC_monotonic().
+    OPTICAL_DATA_MESSAGE_CALIBRATION = 1,
+    // ASC profile words: profile, a reserved byte, the word offset
+    // (big-endian), and the big-endian words.
+    OPTICAL_DATA_MESSAGE_ASC_PROFILE = 2,
+    // Patch write: byte offset into the patch region (big-endian) and the
+    // bytes to write.
+    OPTICAL_DATA_MESSAGE_PATCH_WRITE = 3,
+    // Patch call: byte offset of a Thumb function in the patch region
+    // (big-endian) to call.
+    OPTICAL_DATA_MESSAGE_PATCH_CALL = 4,
+    // Application message passed to the application callback.
+    OPTICAL_DATA_MESSAGE_APPLICATION = 5,
+} optical_data_message_e;
+
+// Application message callback.
+typedef void (*optical_data_callback_t)(const uint8_t* payload,
+                                        uint16_t length);
+
+// Optical data channel statistics.
+typedef struct {
+    // Number of received words.
+    uint32_t num_words;
+
+    // Number of words dropped because the ring buffer was full.
+    uint32_t num_overflows;
+
+    // Number of frames with a valid CRC.
+    uint32_t num_frames;
+
+    // Number of frames with an invalid CRC.
+    uint32_t num_crc_errors;
+
+    // Number of valid frames that could not be applied, e.g., because of an
+    // unknown message type or an out-of-range offset.
+    uint32_t num_rejected;
+} optical_data_stats_t;
+
+// Initialize the optical data channel and enable the optical 32-bit
+// interrupt.
+void optical_data_init(void);
+
+// Disable the optical 32-bit interrupt.
+void optical_data_disable(void);
+
+// Set the callback for application messages.
+void optical_data_set_callback(optical_data_callback_t callback);
+
+// Push a received word. Called by the optical 32-bit interrupt.
+void optical_data_receive_word(uint32_t word);
+
+// Decode the received words and apply all complete frames. Return the number
+// of applied frames.
+uint8_t optical_data_process(void);
+
+// Return the patch region.
+uint8_t* optical_data_get_patch(void);
+
+// Return the statistics.
+const optical_data_stats_t* optical_data_get_stats(void);
+
+// Print the statistics.
+void optical_data_print_stats(void);
+
+#endif  // __OPTICAL_DATA_H
@@ -0,0 +1,443 @@
+#include "pose_filter.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Full circle in 0.01 degrees with fractional bits.
+#define POSE_FILTER_FULL_CIRCLE ((int32_t)36000 << POSE_FILTER_FRACTIONAL_BITS)
+
+// Number of fractional bits of the timer tick to seconds scale.
+#define POSE_FILTER_TICK_SCALE_BITS 36
+
+// Number of fractional bits of the gyroscope scale.
+#define POSE_FILTER_GYRO_SCALE_BITS 32
+
+// Orientation axis enum.
+typedef enum {
+    POSE_FILTER_ROLL = 0,
+    POSE_FILTER_PITCH = 1,
+    POSE_FILTER_YAW = 2,
+    POSE_FILTER_NUM_AXES = 3,
+} pose_filter_axis_e;
+
+// Alpha-beta track of a lighthouse angle.
+typedef struct {
+    // Angle in 0.01 degrees with fractional bits between 0 and the full
+    // circle.
+    int32_t angle;
+
+    // Angular rate in 0.01 degrees/s with fractional bits excluding the
+    // gyroscope coupling.
+    int32_t rate;
+
+    // Gains from the rotation rate of each axis to the angular rate with
+    // POSE_FILTER_COUPLING_FRACTIONAL_BITS fractional bits, indexed by
+    // pose_filter_axis_e.
+    int32_t coupling_gains[POSE_FILTER_NUM_AXES];
+
+    // Timestamp of the angle.
+    uint32_t timestamp;
+
+    // Timestamp of the last accepted sweep.
+    uint32_t last_sweep_timestamp;
+
+    // Number of consecutive rejected sweeps.
+    uint8_t num_rejections;
+
+    // Whether the track has been started.
+    bool valid;
+} pose_filter_track_t;
+
+// Filter configuration.
+static pose_filter_config_t g_pose_filter_config;
+
+// Timer ticks per second.
+static uint32_t g_pose_filter_ticks_per_second = 0;
+
+// Timer ticks after which a track is dropped.
+static uint32_t g_pose_filter_track_timeout = 0;
+
+// Seconds per timer tick with POSE_FILTER_TICK_SCALE_BITS fractional bits.
+static uint32_t g_pose_filter_tick_scale = 0;
+
+// Angle with fractional bits per gyroscope LSB and timer tick with
+// POSE_FILTER_GYRO_SCALE_BITS fractional bits.
+static uint32_t g_pose_filter_gyro_scale = 0;
+
+// Orientation with fractional bits, indexed by pose_filter_axis_e.
+static int32_t g_pose_filter_orientation[POSE_FILTER_NUM_AXES];
+
+// Rotation rates of the last IMU sample in 0.01 degrees/s with fractional
+// bits, indexed by pose_filter_axis_e.
+static int32_t g_pose_filter_rotation_rates[POSE_FILTER_NUM_AXES];
+
+// Minimum squared norm of the rotation rates to update the gyroscope coupling
+// gains.
+static int64_t g_pose_filter_min_coupling_norm = 0;
+
+// Whether an IMU sample has been received.
+static bool g_pose_filter_imu_started = false;
+
+// Timestamp of the last IMU sample.
+static uint32_t g_pose_filter_imu_timestamp = 0;
+
+// Lighthouse angle tracks.
+static pose_filter_track_t g_pose_filter_tracks[POSE_FILTER_NUM_ANGLES];
+
+// Wrap the angle with fractional bits to the half-open range of a half circle
+// around zero.
+static inline int32_t pose_filter_wrap(int32_t angle) {
+    while (angle >= POSE_FILTER_FULL_CIRCLE / 2) {
+        angle -= POSE_FILTER_FULL_CIRCLE;
+    }
+    while (angle < -POSE_FILTER_FULL_CIRCLE / 2) {
+        angle += POSE_FILTER_FULL_CIRCLE;
+    }
+    return angle;
+}
+
+// Wrap the angle with fractional bits to the half-open range from zero to the
+// full circle.
+static inline int32_t pose_filter_wrap_positive(int32_t angle) {
+    angle = pose_filter_wrap(angle);
+    return angle < 0 ? angle + POSE_FILTER_FULL_CIRCLE : angle;
+}
+
+// Clamp the value to the symmetric limit.
+static inline int32_t pose_filter_clamp(const int32_t value,
+                                        const int32_t limit) {
+    if (value > limit) {
+        return limit;
+    }
+    if (value < -limit) {
+        return -limit;
+    }
+    return value;
+}
+
+// Return the integer square root.
+static uint32_t pose_filter_sqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Return atan2(y, x) in 0.01 degrees between -18000 and 18000. The arctangent
+// within the first octant is approximated by 45 * z + 15.64 * z * (1 - z)
+// degrees for z = min / max, which is within 0.25 degrees.
+static int32_t pose_filter_atan2(const int32_t y, const int32_t x) {
+    const uint32_t abs_y = y < 0 ? -y : y;
+    const uint32_t abs_x = x < 0 ? -x : x;
+    uint32_t z = 0;
+    int32_t angle = 0;
+
+    if (abs_x == 0 && abs_y == 0) {
+        return 0;
+    }
+
+    // z is the ratio of the smaller to the larger magnitude in Q15.
+    if (abs_x >= abs_y) {
+        z = (abs_y << 15) / abs_x;
+    } else {
+        z = (abs_x << 15) / abs_y;
+    }
+    angle = (z * (4500 + ((1564 * (32768 - z)) >> 15))) >> 15;
+
+    if (abs_x < abs_y) {
+        angle = 9000 - angle;
+    }
+    if (x < 0) {
+        angle = 18000 - angle;
+    }
+    return y < 0 ? -angle : angle;
+}
+
+// Return the angular rate of the track coupled from the rotation rates.
+static int32_t pose_filter_coupled_rate(const pose_filter_track_t* track) {
+    int64_t rate = 0;
+    uint8_t axis = 0;
+
+    for (axis = 0; axis < POSE_FILTER_NUM_AXES; ++axis) {
+        rate += (int64_t)track->coupling_gains[axis] *
+                g_pose_filter_rotation_rates[axis];
+    }
+    return (int32_t)(rate >> POSE_FILTER_COUPLING_FRACTIONAL_BITS);
+}
+
+// Predict the track to the timestamp.
+static void pose_filter_predict_track(pose_filter_track_t* track,
+                                      const uint32_t timestamp) {
+    const int32_t elapsed_ticks = (int32_t)(timestamp - track->timestamp);
+    const int32_t rate = pose_filter_clamp(
+        track->rate + pose_filter_coupled_rate(track),
+        POSE_FILTER_MAX_RATE << POSE_FILTER_FRACTIONAL_BITS);
+
+    track->angle = pose_filter_wrap_positive(
+        track->angle + (int32_t)(((int64_t)rate * elapsed_ticks *
+                                  g_pose_filter_tick_scale) >>
+                                 POSE_FILTER_TICK_SCALE_BITS));
+    track->timestamp = timestamp;
+}
+
+// Update the gyroscope coupling gains of the track with the rate residual in
+// 0.01 degrees/s with fractional bits.
+static void pose_filter_update_coupling(pose_filter_track_t* track,
+                                        const int32_t rate_residual) {
+    int64_t norm = 0;
+    int64_t step = 0;
+    uint8_t axis = 0;
+
+    for (axis = 0; axis < POSE_FILTER_NUM_AXES; ++axis) {
+        norm += (int64_t)g_pose_filter_rotation_rates[axis] *
+                g_pose_filter_rotation_rates[axis];
+    }
+    if (norm < g_pose_filter_min_coupling_norm) {
+        return;
+    }
+
+    for (axis = 0; axis < POSE_FILTER_NUM_AXES; ++axis) {
+        step = (((int64_t)rate_residual * g_pose_filter_rotation_rates[axis]) /
+                (norm >> POSE_FILTER_COUPLING_FRACTIONAL_BITS)) >>
+               g_pose_filter_config.coupling_gain_shift;
+        track->coupling_gains[axis] = pose_filter_clamp(
+            track->coupling_gains[axis] + (int32_t)step,
+            POSE_FILTER_MAX_COUPLING_GAIN
+                << POSE_FILTER_COUPLING_FRACTIONAL_BITS);
+    }
+}
+
+// Restart the track at the angle with fractional bits.
+static void pose_filter_start_track(pose_filter_track_t* track,
+                                    const int32_t angle,
+                                    const uint32_t timestamp) {
+    track->angle = angle;
+    track->rate = 0;
+    memset(track->coupling_gains, 0, sizeof(track->coupling_gains));
+    track->timestamp = timestamp;
+    track->last_sweep_timestamp = timestamp;
+    track->num_rejections = 0;
+    track->valid = true;
+}
+
+// Correct the orientation with the tilt of the gravity vector.
+static void pose_filter_correct_tilt(const imu_data_t* imu_measurement,
+                                     const bool initialize) {
+    const int32_t acc_x = imu_measurement->acc_x.value;
+    const int32_t acc_y = imu_measurement->acc_y.value;
+    const int32_t acc_z = imu_measurement->acc_z.value;
+    const uint32_t lsb_per_g_squared =
+        (uint32_t)g_pose_filter_config.accel_lsb_per_g *
+        g_pose_filter_config.accel_lsb_per_g;
+    const uint32_t norm_squared = (uint32_t)(acc_x * acc_x) +
+                                  (uint32_t)(acc_y * acc_y) +
+                                  (uint32_t)(acc_z * acc_z);
+    int32_t tilt[2];
+    uint8_t axis = 0;
+
+    // Only trust the accelerometer if it mostly measures gravity, i.e., its
+    // magnitude is within 0.75 g and 1.25 g.
+    if (norm_squared < lsb_per_g_squared / 16 * 9 ||
+        norm_squared > lsb_per_g_squared / 16 * 25) {
+        return;
+    }
+
+    tilt[POSE_FILTER_ROLL] = pose_filter_atan2(acc_y, acc_z)
+                             << POSE_FILTER_FRACTIONAL_BITS;
+    tilt[POSE_FILTER_PITCH] =
+        pose_filter_atan2(-acc_x, pose_filter_sqrt((uint32_t)(acc_y * acc_y) +
+                                                   (uint32_t)(acc_z * acc_z)))
+        << POSE_FILTER_FRACTIONAL_BITS;
+
+    for (axis = POSE_FILTER_ROLL; axis <= POSE_FILTER_PITCH; ++axis) {
+        if (initialize) {
+            g_pose_filter_orientation[axis] = tilt[axis];
+        } else {
+            g_pose_filter_orientation[axis] = pose_filter_wrap(
+                g_pose_filter_orientation[axis] +
+                (pose_filter_wrap(tilt[axis] -
+                                  g_pose_filter_orientation[axis]) >>
+                 g_pose_filter_config.tilt_gain_shift));
+        }
+    }
+}
+
+void pose_filter_get_default_config(const uint32_t timer_ticks_in_100ms,
+                                    pose_filter_config_t* config) {
+    config->timer_ticks_in_100ms = timer_ticks_in_100ms;
+    config->gyro_lsb_per_dps = POSE_FILTER_DEFAULT_GYRO_LSB_PER_DPS;
+    config->accel_lsb_per_g = POSE_FILTER_DEFAULT_ACCEL_LSB_PER_G;
+    config->tilt_gain_shift = POSE_FILTER_DEFAULT_TILT_GAIN_SHIFT;
+    config->angle_gain_shift = POSE_FILTER_DEFAULT_ANGLE_GAIN_SHIFT;
+    config->rate_gain_shift = POSE_FILTER_DEFAULT_RATE_GAIN_SHIFT;
+    config->coupling_gain_shift = POSE_FILTER_DEFAULT_COUPLING_GAIN_SHIFT;
+    config->track_timeout_ms = POSE_FILTER_DEFAULT_TRACK_TIMEOUT_MS;
+}
+
+void pose_filter_init(const pose_filter_config_t* config) {
+    g_pose_filter_config = *config;
+    g_pose_filter_ticks_per_second = config->timer_ticks_in_100ms * 10;
+    g_pose_filter_track_timeout =
+        (uint64_t)config->timer_ticks_in_100ms * config->track_timeout_ms / 100;
+    g_pose_filter_tick_scale =
+        ((uint64_t)1 << POSE_FILTER_TICK_SCALE_BITS) /
+        g_pose_filter_ticks_per_second;
+    g_pose_filter_gyro_scale =
+        ((uint64_t)100 << (POSE_FILTER_FRACTIONAL_BITS +
+                           POSE_FILTER_GYRO_SCALE_BITS)) /
+        ((uint64_t)config->gyro_lsb_per_dps * g_pose_filter_ticks_per_second);
+    g_pose_filter_min_coupling_norm =
+        (int64_t)(POSE_FILTER_MIN_COUPLING_RATE_DPS * 100) *
+        (POSE_FILTER_MIN_COUPLING_RATE_DPS * 100) *
+        (1 << (2 * POSE_FILTER_FRACTIONAL_BITS));
+
+    memset(g_pose_filter_orientation, 0, sizeof(g_pose_filter_orientation));
+    memset(g_pose_filter_rotation_rates, 0,
+           sizeof(g_pose_filter_rotation_rates));
+    memset(g_pose_filter_tracks, 0, sizeof(g_pose_filter_tracks));
+    g_pose_filter_imu_started = false;
+    g_pose_filter_imu_timestamp = 0;
+}
+
+void pose_filter_update_imu(const imu_data_t* imu_measurement,
+                            const uint32_t timestamp) {
+    const int16_t gyro[POSE_FILTER_NUM_AXES] = {
+        imu_measurement->gyro_x.value,
+        imu_measurement->gyro_y.value,
+        imu_measurement->gyro_z.value,
+    };
+    pose_filter_track_t* track = NULL;
+    uint32_t elapsed_ticks = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < POSE_FILTER_NUM_AXES; ++i) {
+        g_pose_filter_rotation_rates[i] =
+            ((int32_t)gyro[i] * (100 << POSE_FILTER_FRACTIONAL_BITS)) /
+            g_pose_filter_config.gyro_lsb_per_dps;
+    }
+
+    if (!g_pose_filter_imu_started) {
+        pose_filter_correct_tilt(imu_measurement, true);
+        g_pose_filter_imu_started = true;
+        g_pose_filter_imu_timestamp = timestamp;
+        return;
+    }
+
+    // Integrate the gyroscope rates. Gaps longer than the track timeout are
+    // not integrated, since the rates are unknown during the gap.
+    elapsed_ticks = timestamp - g_pose_filter_imu_timestamp;
+    if (elapsed_ticks > g_pose_filter_track_timeout) {
+        elapsed_ticks = 0;
+    }
+    for (i = 0; i < POSE_FILTER_NUM_AXES; ++i) {
+        g_pose_filter_orientation[i] = pose_filter_wrap(
+            g_pose_filter_orientation[i] +
+            (int32_t)(((int64_t)gyro[i] * elapsed_ticks *
+                       g_pose_filter_gyro_scale) >>
+                      POSE_FILTER_GYRO_SCALE_BITS));
+    }
+    g_pose_filter_imu_timestamp = timestamp;
+
+    pose_filter_correct_tilt(imu_measurement, false);
+
+    // Predict the lighthouse angles to the IMU sample.
+    for (i = 0; i < POSE_FILTER_NUM_ANGLES; ++i) {
+        track = &g_pose_filter_tracks[i];
+        if (!track->valid) {
+            continue;
+        }
+        if (timestamp - track->last_sweep_timestamp >
+            g_pose_filter_track_timeout) {
+            track->valid = false;
+            continue;
+        }
+        pose_filter_predict_track(track, timestamp);
+    }
+}
+
+bool pose_filter_update_angle(const uint8_t index, const uint16_t angle,
+                              const uint32_t timestamp) {
+    const int32_t measured_angle = (int32_t)angle
+                                   << POSE_FILTER_FRACTIONAL_BITS;
+    pose_filter_track_t* track = NULL;
+    uint32_t elapsed_ticks = 0;
+    int32_t residual = 0;
+    int32_t rate_residual = 0;
+
+    if (index >= POSE_FILTER_NUM_ANGLES) {
+        return false;
+    }
+    track = &g_pose_filter_tracks[index];
+
+    if (!track->valid || timestamp - track->last_sweep_timestamp >
+                             g_pose_filter_track_timeout) {
+        pose_filter_start_track(track, measured_angle, timestamp);
+        return true;
+    }
+
+    pose_filter_predict_track(track, timestamp);
+    residual = pose_filter_wrap(measured_angle - track->angle);
+
+    if (residual > (POSE_FILTER_MAX_RESIDUAL << POSE_FILTER_FRACTIONAL_BITS) ||
+        residual <
+            -(POSE_FILTER_MAX_RESIDUAL << POSE_FILTER_FRACTIONAL_BITS)) {
+        ++track->num_rejections;
+        if (track->num_rejections >= POSE_FILTER_MAX_NUM_REJECTIONS) {
+            pose_filter_start_track(track, measured_angle, timestamp);
+            return true;
+        }
+        return false;
+    }
+
+    track->angle = pose_filter_wrap_positive(
+        track->angle + (residual >> g_pose_filter_config.angle_gain_shift));
+
+    elapsed_ticks = timestamp - track->last_sweep_timestamp;
+    if (elapsed_ticks > 0) {
+        rate_residual = pose_filter_clamp(
+            (int32_t)((int64_t)residual * g_pose_filter_ticks_per_second /
+                      elapsed_ticks),
+            POSE_FILTER_MAX_RATE << POSE_FILTER_FRACTIONAL_BITS);
+        track->rate = pose_filter_clamp(
+            track->rate +
+                (rate_residual >> g_pose_filter_config.rate_gain_shift),
+            POSE_FILTER_MAX_RATE << POSE_FILTER_FRACTIONAL_BITS);
+        pose_filter_update_coupling(track, rate_residual);
+    }
+    track->last_sweep_timestamp = timestamp;
+    track->num_rejections = 0;
+    return true;
+}
+
+void pose_filter_get_state(pose_filter_state_t* state) {
+    uint8_t i = 0;
+
+    state->roll = g_pose_filter_orientation[POSE_FILTER_ROLL] >>
+                  POSE_FILTER_FRACTIONAL_BITS;
+    state->pitch = g_pose_filter_orientation[POSE_FILTER_PITCH] >>
+                   POSE_FILTER_FRACTIONAL_BITS;
+    state->yaw = g_pose_filter_orientation[POSE_FILTER_YAW] >>
+                 POSE_FILTER_FRACTIONAL_BITS;
+
+    state->valid = 0;
+    for (i = 0; i < POSE_FILTER_NUM_ANGLES; ++i) {
+        state->angles[i] =
+            g_pose_filter_tracks[i].angle >> POSE_FILTER_FRACTIONAL_BITS;
+        if (g_pose_filter_tracks[i].valid) {
+            state->valid |= 1 << i;
+        }
+    }
+}
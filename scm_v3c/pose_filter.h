@@ -0,0 +1,148 @@
+// The pose filter fuses the IMU samples and the lighthouse angles of one
+// photodiode into a smooth pose estimate, so that only the fused state needs
+// to be transmitted instead of every IMU sample and every sweep.
+//
+// The filter has two parts, both in fixed point:
+//  - The orientation (roll, pitch, and yaw) is predicted at the IMU sample
+//    rate by integrating the gyroscope rates and corrected by the tilt of the
+//    gravity vector measured by the accelerometer, i.e., a complementary
+//    filter. The gyroscope axes are integrated independently, which is only
+//    accurate for small roll and pitch angles. The yaw is not observable from
+//    the accelerometer or from a single photodiode, so it drifts.
+//  - The azimuth and elevation of both lighthouses are each tracked with an
+//    alpha-beta filter of the angle and its rate. The tracks are predicted to
+//    every IMU sample and corrected whenever a sweep arrives, so the angles
+//    are available at the IMU sample rate instead of the 30 Hz sweep rate of
+//    each angle. A track is dropped if no sweep arrives within the timeout,
+//    and it is restarted if several consecutive sweeps disagree with it.
+//  - The rate of each track is the sum of its alpha-beta rate and a linear
+//    coupling of the gyroscope rates, so the angles follow the rotation of
+//    the mote between sweeps. The coupling gains depend on the unknown
+//    position of the photodiode relative to the center of rotation and to the
+//    lighthouse, so they are learned from the rate residual of every sweep
+//    with a normalized least mean squares update while the mote rotates.
+//    The gains are only valid while the geometry changes slowly, and the
+//    tracks do not follow translations between sweeps.
+//
+// All angles are in 0.01 degrees. Internally, they have
+// POSE_FILTER_FRACTIONAL_BITS fractional bits.
+
+#ifndef __POSE_FILTER_H
+#define __POSE_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "spi.h"
+
+// Number of tracked lighthouse angles, indexed by lighthouse << 1 |
+// angle_type as in the lighthouse pose packets.
+#define POSE_FILTER_NUM_ANGLES 4
+
+// Number of fractional bits of the internal angles.
+#define POSE_FILTER_FRACTIONAL_BITS 8
+
+// Default gyroscope sensitivity for the +-250 degrees/s range.
+#define POSE_FILTER_DEFAULT_GYRO_LSB_PER_DPS 131
+
+// Default accelerometer sensitivity for the +-2 g range.
+#define POSE_FILTER_DEFAULT_ACCEL_LSB_PER_G 16384
+
+// Default gain of the accelerometer tilt correction per IMU sample as a power
+// of 2, i.e., 2^-6.
+#define POSE_FILTER_DEFAULT_TILT_GAIN_SHIFT 6
+
+// Default alpha gain of the lighthouse angle tracks as a power of 2.
+#define POSE_FILTER_DEFAULT_ANGLE_GAIN_SHIFT 1
+
+// Default beta gain of the lighthouse angle tracks as a power of 2.
+#define POSE_FILTER_DEFAULT_RATE_GAIN_SHIFT 3
+
+// Default gain of the gyroscope coupling update as a power of 2.
+#define POSE_FILTER_DEFAULT_COUPLING_GAIN_SHIFT 3
+
+// Number of fractional bits of the gyroscope coupling gains.
+#define POSE_FILTER_COUPLING_FRACTIONAL_BITS 12
+
+// Maximum magnitude of a gyroscope coupling gain.
+#define POSE_FILTER_MAX_COUPLING_GAIN 4
+
+// Minimum rotation rate in degrees/s to update the gyroscope coupling gains.
+// Slower rotations are dominated by the gyroscope noise.
+#define POSE_FILTER_MIN_COUPLING_RATE_DPS 10
+
+// Default time without a sweep after which a track is dropped.
+#define POSE_FILTER_DEFAULT_TRACK_TIMEOUT_MS 200
+
+// Maximum difference between a sweep and its track in 0.01 degrees. Sweeps
+// that differ more are rejected as outliers.
+#define POSE_FILTER_MAX_RESIDUAL 1000
+
+// Number of consecutive rejected sweeps after which a track is restarted.
+#define POSE_FILTER_MAX_NUM_REJECTIONS 3
+
+// Maximum angular rate of a track in 0.01 degrees/s.
+#define POSE_FILTER_MAX_RATE 200000
+
+// Filter configuration.
+typedef struct {
+    // Timer ticks of the IMU and sweep timestamps in 100 ms.
+    uint32_t timer_ticks_in_100ms;
+
+    // Gyroscope LSBs per degree/s.
+    uint16_t gyro_lsb_per_dps;
+
+    // Accelerometer LSBs per g.
+    uint16_t accel_lsb_per_g;
+
+    // Gain of the accelerometer tilt correction as a power of 2.
+    uint8_t tilt_gain_shift;
+
+    // Alpha gain of the lighthouse angle tracks as a power of 2.
+    uint8_t angle_gain_shift;
+
+    // Beta gain of the lighthouse angle tracks as a power of 2.
+    uint8_t rate_gain_shift;
+
+    // Gain of the gyroscope coupling update as a power of 2.
+    uint8_t coupling_gain_shift;
+
+    // Time without a sweep after which a track is dropped.
+    uint16_t track_timeout_ms;
+} pose_filter_config_t;
+
+// Fused state.
+typedef struct {
+    // Roll, pitch, and yaw in 0.01 degrees between -18000 and 17999.
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+
+    // Lighthouse angles in 0.01 degrees between 0 and 35999.
+    uint16_t angles[POSE_FILTER_NUM_ANGLES];
+
+    // Bit mask of the valid lighthouse angles.
+    uint8_t valid;
+} pose_filter_state_t;
+
+// Fill in the default configuration for the given timer ticks in 100 ms.
+void pose_filter_get_default_config(uint32_t timer_ticks_in_100ms,
+                                    pose_filter_config_t* config);
+
+// Initialize the filter and reset its state.
+void pose_filter_init(const pose_filter_config_t* config);
+
+// Predict the state to the IMU sample taken at the timestamp with the
+// gyroscope rates and correct the tilt with the accelerometer.
+void pose_filter_update_imu(const imu_data_t* imu_measurement,
+                            uint32_t timestamp);
+
+// Correct the track of a lighthouse angle in 0.01 degrees measured at the
+// timestamp. Return whether the angle was accepted.
+bool pose_filter_update_angle(uint8_t index, uint16_t angle,
+                              uint32_t timestamp);
+
+// Get the fused state.
+void pose_filter_get_state(pose_filter_state_t* state);
+
+#endif  // __POSE_FILTER_H
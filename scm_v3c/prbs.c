@@ -0,0 +1,235 @@
+#include "prbs.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "radio.h"
+#include "tuning.h"
+
+// Initial value of the BER header check byte.
+#define PRBS_BER_HEADER_CHECK_INIT 0xA5
+
+// LFSR polynomial x^degree + x^tap + 1.
+typedef struct {
+    // Degree of the polynomial.
+    uint8_t degree;
+
+    // Lower tap of the polynomial, which is also the maximum number of bits
+    // that can be generated in parallel.
+    uint8_t tap;
+} prbs_polynomial_t;
+
+// Polynomials, indexed by prbs_polynomial_e.
+static const prbs_polynomial_t g_prbs_polynomials[PRBS_NUM_POLYNOMIALS] = {
+    {9, 5},
+    {15, 14},
+    {31, 28},
+};
+
+// Payload polynomial of the BER test.
+static prbs_polynomial_e g_prbs_ber_polynomial = PRBS_PN9;
+
+// BER statistics of the current tuning code.
+static prbs_ber_stats_t g_prbs_ber_stats;
+
+// Number of received packets with an invalid header.
+static uint32_t g_prbs_ber_num_header_errors = 0;
+
+// Return a mask of the lowest num_bits bits.
+static inline uint32_t prbs_mask(const uint8_t num_bits) {
+    return num_bits >= 32 ? 0xFFFFFFFF : ((uint32_t)1 << num_bits) - 1;
+}
+
+// Return the number of set bits. Cortex-M0 has no population count
+// instruction, so the bits are summed in parallel.
+static inline uint32_t prbs_count_ones(uint32_t word) {
+    word = word - ((word >> 1) & 0x55555555);
+    word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F;
+    word = word + (word >> 8);
+    word = word + (word >> 16);
+    return word & 0x3F;
+}
+
+// Return the check byte of the BER header.
+static uint8_t prbs_ber_header_check(const prbs_ber_header_t* header) {
+    return PRBS_BER_HEADER_CHECK_INIT ^ header->tuning_code.coarse ^
+           header->tuning_code.mid ^ header->tuning_code.fine ^
+           header->packet_index ^ header->num_packets;
+}
+
+// Return whether the BER header is valid.
+static bool prbs_ber_header_valid(const prbs_ber_header_t* header) {
+    return header->check == prbs_ber_header_check(header) &&
+           header->tuning_code.coarse <= TUNING_MAX_CODE &&
+           header->tuning_code.mid <= TUNING_MAX_CODE &&
+           header->tuning_code.fine <= TUNING_MAX_CODE &&
+           header->packet_index < header->num_packets;
+}
+
+void prbs_init(prbs_t* prbs, const prbs_polynomial_e polynomial,
+               const uint32_t seed) {
+    const uint32_t mask = prbs_mask(g_prbs_polynomials[polynomial].degree);
+
+    prbs->polynomial = polynomial;
+    prbs->state = seed & mask;
+    if (prbs->state == 0) {
+        prbs->state = mask;
+    }
+}
+
+uint32_t prbs_next_bits(prbs_t* prbs, uint8_t num_bits) {
+    const uint8_t degree = g_prbs_polynomials[prbs->polynomial].degree;
+    const uint8_t tap = g_prbs_polynomials[prbs->polynomial].tap;
+    uint32_t state = prbs->state;
+    uint32_t bits = 0;
+    uint32_t new_bits = 0;
+    uint8_t step = 0;
+
+    while (num_bits > 0) {
+        step = num_bits < tap ? num_bits : tap;
+
+        // The new bit i steps ahead is state[degree - 1 - i] ^
+        // state[tap - 1 - i], which are all already in the state for i < tap.
+        new_bits = ((state >> (degree - step)) ^ (state >> (tap - step))) &
+                   prbs_mask(step);
+        state = ((state << step) | new_bits) & prbs_mask(degree);
+        bits = (bits << step) | new_bits;
+        num_bits -= step;
+    }
+
+    prbs->state = state;
+    return bits;
+}
+
+uint8_t prbs_next_byte(prbs_t* prbs) { return prbs_next_bits(prbs, 8); }
+
+uint32_t prbs_next_word(prbs_t* prbs) { return prbs_next_bits(prbs, 32); }
+
+void prbs_fill(prbs_t* prbs, uint8_t* buffer, const uint16_t length) {
+    uint32_t word = 0;
+    uint16_t i = 0;
+
+    for (i = 0; i + 4 <= length; i += 4) {
+        word = prbs_next_word(prbs);
+        buffer[i] = word >> 24;
+        buffer[i + 1] = word >> 16;
+        buffer[i + 2] = word >> 8;
+        buffer[i + 3] = word;
+    }
+    for (; i < length; ++i) {
+        buffer[i] = prbs_next_byte(prbs);
+    }
+}
+
+uint32_t prbs_check(prbs_t* prbs, const uint8_t* buffer,
+                    const uint16_t length) {
+    uint32_t num_bit_errors = 0;
+    uint32_t word = 0;
+    uint16_t i = 0;
+
+    for (i = 0; i + 4 <= length; i += 4) {
+        word = ((uint32_t)buffer[i] << 24) | ((uint32_t)buffer[i + 1] << 16) |
+               ((uint32_t)buffer[i + 2] << 8) | buffer[i + 3];
+        num_bit_errors += prbs_count_ones(word ^ prbs_next_word(prbs));
+    }
+    for (; i < length; ++i) {
+        num_bit_errors += prbs_count_ones(buffer[i] ^ prbs_next_byte(prbs));
+    }
+    return num_bit_errors;
+}
+
+void prbs_ber_init(const prbs_polynomial_e polynomial) {
+    g_prbs_ber_polynomial = polynomial;
+    memset(&g_prbs_ber_stats, 0, sizeof(g_prbs_ber_stats));
+    g_prbs_ber_num_header_errors = 0;
+}
+
+void prbs_ber_fill_packet(uint8_t* packet, const uint8_t packet_len,
+                          const tuning_code_t* tuning_code,
+                          const uint8_t packet_index,
+                          const uint8_t num_packets) {
+    prbs_ber_header_t header;
+    prbs_t prbs;
+
+    if (packet_len < PRBS_BER_HEADER_LENGTH + LENGTH_CRC) {
+        return;
+    }
+
+    header.tuning_code = *tuning_code;
+    header.packet_index = packet_index;
+    header.num_packets = num_packets;
+    header.check = prbs_ber_header_check(&header);
+    memcpy(packet, &header, PRBS_BER_HEADER_LENGTH);
+
+    prbs_init(&prbs, g_prbs_ber_polynomial, PRBS_BER_SEED);
+    prbs_fill(&prbs, &packet[PRBS_BER_HEADER_LENGTH],
+              packet_len - PRBS_BER_HEADER_LENGTH - LENGTH_CRC);
+}
+
+bool prbs_ber_check_packet(const uint8_t* packet, const uint8_t packet_len,
+                           const bool crc_ok) {
+    prbs_ber_header_t header;
+    prbs_t prbs;
+    uint16_t payload_len = 0;
+    uint32_t num_bit_errors = 0;
+
+    if (packet_len < PRBS_BER_HEADER_LENGTH + LENGTH_CRC) {
+        ++g_prbs_ber_num_header_errors;
+        return false;
+    }
+
+    memcpy(&header, packet, PRBS_BER_HEADER_LENGTH);
+    if (!prbs_ber_header_valid(&header)) {
+        ++g_prbs_ber_num_header_errors;
+        return false;
+    }
+
+    if (memcmp(&header.tuning_code, &g_prbs_ber_stats.tuning_code,
+               sizeof(tuning_code_t)) != 0) {
+        prbs_ber_flush();
+        g_prbs_ber_stats.tuning_code = header.tuning_code;
+    }
+    g_prbs_ber_stats.num_packets_sent = header.num_packets;
+
+    payload_len = packet_len - PRBS_BER_HEADER_LENGTH - LENGTH_CRC;
+    prbs_init(&prbs, g_prbs_ber_polynomial, PRBS_BER_SEED);
+    num_bit_errors =
+        prbs_check(&prbs, &packet[PRBS_BER_HEADER_LENGTH], payload_len);
+
+    ++g_prbs_ber_stats.num_packets_received;
+    if (crc_ok) {
+        ++g_prbs_ber_stats.num_packets_crc_ok;
+    }
+    if (num_bit_errors == 0) {
+        ++g_prbs_ber_stats.num_packets_error_free;
+    }
+    g_prbs_ber_stats.num_bits += (uint32_t)payload_len * 8;
+    g_prbs_ber_stats.num_bit_errors += num_bit_errors;
+    return true;
+}
+
+const prbs_ber_stats_t* prbs_ber_get_stats(void) { return &g_prbs_ber_stats; }
+
+uint32_t prbs_ber_get_num_header_errors(void) {
+    return g_prbs_ber_num_header_errors;
+}
+
+void prbs_ber_flush(void) {
+    if (g_prbs_ber_stats.num_packets_received > 0) {
+        prbs_ber_print(&g_prbs_ber_stats);
+    }
+    memset(&g_prbs_ber_stats, 0, sizeof(g_prbs_ber_stats));
+}
+
+void prbs_ber_print(const prbs_ber_stats_t* stats) {
+    printf("BER %u.%u.%u sent=%u received=%u crc_ok=%u error_free=%u bits=%u "
+           "bit_errors=%u header_errors=%u\n",
+           stats->tuning_code.coarse, stats->tuning_code.mid,
+           stats->tuning_code.fine, stats->num_packets_sent,
+           stats->num_packets_received, stats->num_packets_crc_ok,
+           stats->num_packets_error_free, stats->num_bits,
+           stats->num_bit_errors, g_prbs_ber_num_header_errors);
+}
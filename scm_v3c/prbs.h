@@ -0,0 +1,139 @@
+// The PRBS module generates and checks the PN9, PN15, and PN31 pseudorandom
+// bit sequences for bit error rate (BER) tests.
+//
+// The sequences are generated by Fibonacci LFSRs with the polynomials
+// x^9 + x^5 + 1, x^15 + x^14 + 1, and x^31 + x^28 + 1. The LFSR is shifted
+// left and the new bit is inserted at bit 0, as in update_PN31_byte(). Since
+// the taps of these polynomials are far from bit 0, up to as many bits as the
+// lower tap are computed in parallel with a single shift and XOR, so a 32-bit
+// word takes only a few operations instead of one loop iteration per bit. The
+// first generated bit is the MSB of each byte and word.
+//
+// For BER tests, the transmitter sends packets with a short header followed by
+// a PRBS payload that restarts from the seed in every packet. The header
+// carries the tuning code of the transmitter, the packet index, and the number
+// of packets sent per tuning code. The receiver checks both valid packets and
+// packets with CRC errors, accumulates the bit errors per tuning code, and
+// prints one BER line per tuning code, which is parsed by
+// scripts/ber_report.py.
+
+#ifndef __PRBS_H
+#define __PRBS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tuning.h"
+
+// Seed of the BER packet payloads. A seed of zero selects the all-ones state.
+#define PRBS_BER_SEED 0
+
+// Length of the BER packet header in bytes.
+#define PRBS_BER_HEADER_LENGTH 6
+
+// PRBS polynomial enum.
+typedef enum {
+    PRBS_PN9 = 0,
+    PRBS_PN15 = 1,
+    PRBS_PN31 = 2,
+    PRBS_NUM_POLYNOMIALS = 3,
+} prbs_polynomial_e;
+
+// PRBS generator.
+typedef struct {
+    // Polynomial.
+    prbs_polynomial_e polynomial;
+
+    // LFSR state. Bit 0 holds the most recently generated bit.
+    uint32_t state;
+} prbs_t;
+
+// BER packet header.
+typedef struct __attribute__((packed)) {
+    // Tuning code of the transmitter.
+    tuning_code_t tuning_code;
+
+    // Index of the packet at this tuning code.
+    uint8_t packet_index;
+
+    // Number of packets sent at this tuning code.
+    uint8_t num_packets;
+
+    // Check byte over the preceding header bytes.
+    uint8_t check;
+} prbs_ber_header_t;
+
+// BER statistics of a tuning code.
+typedef struct {
+    // Tuning code of the transmitter.
+    tuning_code_t tuning_code;
+
+    // Number of packets sent at this tuning code.
+    uint8_t num_packets_sent;
+
+    // Number of received packets, including packets with CRC errors.
+    uint32_t num_packets_received;
+
+    // Number of received packets with a valid CRC.
+    uint32_t num_packets_crc_ok;
+
+    // Number of received packets without any bit error in the payload.
+    uint32_t num_packets_error_free;
+
+    // Number of checked payload bits.
+    uint32_t num_bits;
+
+    // Number of payload bit errors.
+    uint32_t num_bit_errors;
+} prbs_ber_stats_t;
+
+// Initialize the generator with the seed. The seed is truncated to the
+// polynomial degree, and a zero seed selects the all-ones state.
+void prbs_init(prbs_t* prbs, prbs_polynomial_e polynomial, uint32_t seed);
+
+// Generate the next bits, where the first generated bit is the MSB of the
+// returned bits. The number of bits must be at most 32.
+uint32_t prbs_next_bits(prbs_t* prbs, uint8_t num_bits);
+
+// Generate the next byte.
+uint8_t prbs_next_byte(prbs_t* prbs);
+
+// Generate the next 32-bit word.
+uint32_t prbs_next_word(prbs_t* prbs);
+
+// Fill the buffer with the next bytes of the sequence.
+void prbs_fill(prbs_t* prbs, uint8_t* buffer, uint16_t length);
+
+// Compare the buffer against the next bytes of the sequence. Return the number
+// of bit errors.
+uint32_t prbs_check(prbs_t* prbs, const uint8_t* buffer, uint16_t length);
+
+// Initialize the BER test with the payload polynomial and reset the
+// statistics.
+void prbs_ber_init(prbs_polynomial_e polynomial);
+
+// Fill a BER packet. The packet length includes the CRC bytes.
+void prbs_ber_fill_packet(uint8_t* packet, uint8_t packet_len,
+                          const tuning_code_t* tuning_code,
+                          uint8_t packet_index, uint8_t num_packets);
+
+// Check a received BER packet and accumulate the statistics of its tuning
+// code. The statistics of the previous tuning code are printed when the tuning
+// code changes. The packet length includes the CRC bytes. Return whether the
+// packet header was valid.
+bool prbs_ber_check_packet(const uint8_t* packet, uint8_t packet_len,
+                           bool crc_ok);
+
+// Return the statistics of the current tuning code.
+const prbs_ber_stats_t* prbs_ber_get_stats(void);
+
+// Return the number of received packets with an invalid header.
+uint32_t prbs_ber_get_num_header_errors(void);
+
+// Print the statistics of the current tuning code and reset them.
+void prbs_ber_flush(void);
+
+// Print the statistics.
+void prbs_ber_print(const prbs_ber_stats_t* stats);
+
+#endif  // __PRBS_H
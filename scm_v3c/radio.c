@@ -6,7 +6,10 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "gpio.h"
+#include "asc_profiles.h"
+#include "counters.h"
+#include "debug_trace.h"
+#include "isr_profiler.h"
 #include "memory_map.h"
 #include "rftimer.h"
 #include "scm3c_hw_interface.h"
@@ -107,6 +110,7 @@ typedef struct {
     uint8_t rxPacket[RX_PKT_ANY_LEN];
     uint8_t rxPacket_len;
     radio_rx_cbt radio_rx_cb;
+    radio_rx_cbt radio_rx_crc_error_cb;
     int8_t rxpk_rssi;
     uint8_t rxpk_lqi;
     volatile bool rxpk_crc;
@@ -201,6 +205,13 @@ void cb_endFrame_rx_radio(uint32_t timestamp) {
         radio_vars.radio_rx_cb(radio_vars.rxPacket, packet_len);
         // printf("IF: %d \r\n", radio_vars.IF_estimate);
     } else {
+        // Packets with CRC errors are only passed on for bit error rate tests
+        if (!radio_getCrcOk() && radio_vars.radio_rx_crc_error_cb != 0 &&
+            (radio_vars.rxPacket_len == RX_PKT_ANY_LEN ||
+             packet_len == radio_vars.rxPacket_len)) {
+            radio_vars.radio_rx_crc_error_cb(radio_vars.rxPacket, packet_len);
+        }
+
         // go back to receiving...
         radio_rxEnable();
         radio_rxNow();
@@ -420,6 +431,10 @@ void radio_setRxCb(radio_rx_cbt radio_rx_cb) {
     radio_vars.radio_rx_cb = radio_rx_cb;
 }
 
+void radio_setRxCrcErrorCb(radio_rx_cbt radio_rx_crc_error_cb) {
+    radio_vars.radio_rx_crc_error_cb = radio_rx_crc_error_cb;
+}
+
 void radio_reset(void) {
     // reset SCuM radio module
     RFCONTROLLER_REG__CONTROL = RF_RESET;
@@ -454,6 +469,9 @@ void radio_loadPacket(void* packet, uint16_t len) {
 // Turn on the radio for transmit
 // This should be done at least ~50 us before txNow()
 void radio_txEnable() {
+    // Switch the analog scan chain to the TX profile
+    asc_profiles_switch(ASC_PROFILE_TX);
+
     // Turn on LO, PA, and AUX LDOs
 
 #ifdef DIV_ON
@@ -477,6 +495,9 @@ void radio_txNow() { RFCONTROLLER_REG__CONTROL = TX_SEND; }
 // Turn on the radio for receive
 // This should be done at least ~50 us before rxNow()
 void radio_rxEnable() {
+    // Switch the analog scan chain to the RX profile
+    asc_profiles_switch(asc_profiles_get_rx());
+
     // Turn on LO, IF, and AUX LDOs via memory mapped register
 
     // Turn on DIV on if need to read LC_div counter
@@ -709,7 +730,6 @@ void setFrequencyTX(uint8_t channel) {
 }
 
 uint32_t build_RX_channel_table(uint32_t channel_11_LC_code) {
-    uint32_t rdata_lsb, rdata_msb;
     int32_t i;
     uint32_t t;
     uint32_t count_LC[16];
@@ -726,23 +746,16 @@ uint32_t build_RX_channel_table(uint32_t channel_11_LC_code) {
         // analog_scan_chain_write_3B_fromFPGA(ASC);
         // analog_scan_chain_load_3B_fromFPGA();
 
-        // Reset all counters
-        ANALOG_CFG_REG__0 = 0x0000;
-
-        // Enable all counters
-        ANALOG_CFG_REG__0 = 0x3FFF;
+        // Reset and enable all counters
+        counters_start();
 
         // Count for some arbitrary amount of time
         for (t = 1; t < 16000; t++) {
         }
 
-        // Disable all counters
-        ANALOG_CFG_REG__0 = 0x007F;
-
-        // Read count result
-        rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x280000);
-        rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x2C0000);
-        count_LC[i] = rdata_lsb + (rdata_msb << 16);
+        // Disable all counters and read count result
+        counters_stop();
+        count_LC[i] = counters_read_counter(COUNTERS_LC);
 
         count_targets[i + 1] = ((961 + (i + 1) * 2) * count_LC[0]) / 961;
 
@@ -777,7 +790,6 @@ uint32_t build_RX_channel_table(uint32_t channel_11_LC_code) {
 
 void build_TX_channel_table(unsigned int channel_11_LC_code,
                             unsigned int count_LC_RX_ch11) {
-    unsigned int rdata_lsb, rdata_msb;
     int t, i = 0;
     unsigned int count_LC[16] = {0};
     unsigned int count_targets[17] = {0};
@@ -796,23 +808,16 @@ void build_TX_channel_table(unsigned int channel_11_LC_code,
         // analog_scan_chain_write_3B_fromFPGA(ASC);
         // analog_scan_chain_load_3B_fromFPGA();
 
-        // Reset all counters
-        ANALOG_CFG_REG__0 = 0x0000;
-
-        // Enable all counters
-        ANALOG_CFG_REG__0 = 0x3FFF;
+        // Reset and enable all counters
+        counters_start();
 
         // Count for some arbitrary amount of time
         for (t = 1; t < 16000; t++) {
         }
 
-        // Disable all counters
-        ANALOG_CFG_REG__0 = 0x007F;
-
-        // Read count result
-        rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x280000);
-        rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x2C0000);
-        count_LC[i] = rdata_lsb + (rdata_msb << 16);
+        // Disable all counters and read count result
+        counters_stop();
+        count_LC[i] = counters_read_counter(COUNTERS_LC);
 
         // Until figure out why modulation spacing is only 800kHz, only set
         // 400khz above RF channel
@@ -869,8 +874,10 @@ void radio_isr(void) {
     unsigned int interrupt = RFCONTROLLER_REG__INT;
     unsigned int error = RFCONTROLLER_REG__ERROR;
 
-    gpio_2_set();
-    gpio_6_set();
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_RADIO);
+
+    DEBUG_TRACE_SET(ISR);
+    DEBUG_TRACE_SET(RADIO);
 
     radio_vars.crc_ok = true;
     if (error != 0) {
@@ -966,8 +973,10 @@ void radio_isr(void) {
 
     //    RFCONTROLLER_REG__INT_CLEAR = interrupt;
 
-    gpio_2_clr();
-    gpio_6_clr();
+    DEBUG_TRACE_CLR(ISR);
+    DEBUG_TRACE_CLR(RADIO);
+
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_RADIO);
 }
 
 // This ISR goes off when the raw chip shift register interrupt goes high
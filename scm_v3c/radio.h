@@ -68,6 +68,7 @@ void cb_endFrame_rx_radio(uint32_t timestamp);
 void default_radio_rx_cb(uint8_t* packet, uint8_t packet_len);
 void cb_timer_radio(void);
 void radio_setRxCb(radio_rx_cbt radio_rx_cb);
+void radio_setRxCrcErrorCb(radio_rx_cbt radio_rx_crc_error_cb);
 void repeat_rx_tx(repeat_rx_tx_params_t repeat_rx_tx_params);
 
 void radio_init(void);
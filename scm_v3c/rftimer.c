@@ -4,7 +4,8 @@
 #include <string.h>
 
 #include "Memory_Map.h"
-#include "gpio.h"
+#include "debug_trace.h"
+#include "isr_profiler.h"
 #include "radio.h"
 #include "scm3c_hw_interface.h"
 
@@ -183,7 +184,9 @@ void rftimer_isr(void) {
     int i = 0;
     int interrupt_id = 1;
 
-    gpio_2_set();
+    ISR_PROFILER_ENTER(ISR_PROFILER_ISR_RFTIMER);
+
+    DEBUG_TRACE_SET(ISR);
 
     interrupt = RFTIMER_REG__INT;
 
@@ -193,6 +196,11 @@ void rftimer_isr(void) {
             printf("COMPARE%d MATCH\r\n", i);
 #endif
 
+            // Record the latency before the callback reprograms the compare
+            // value.
+            ISR_PROFILER_LATENCY(ISR_PROFILER_ISR_RFTIMER,
+                                 *RF_TIMER_REG_ADDRESSES[i]);
+
             handle_interrupt(i);
         }
 
@@ -249,7 +257,9 @@ void rftimer_isr(void) {
 
     RFTIMER_REG__INT_CLEAR = interrupt;
 
-    gpio_2_clr();
+    DEBUG_TRACE_CLR(ISR);
+
+    ISR_PROFILER_EXIT(ISR_PROFILER_ISR_RFTIMER);
 }
 
 void handle_interrupt(uint8_t id) {
@@ -42,3 +42,8 @@ bool ring_buffer_empty(const ring_buffer_t* ring_buffer) {
 bool ring_buffer_full(const ring_buffer_t* ring_buffer) {
     return ring_buffer_next_index(ring_buffer->head) == ring_buffer->tail;
 }
+
+size_t ring_buffer_size(const ring_buffer_t* ring_buffer) {
+    return (ring_buffer->head + RING_BUFFER_MAX_SIZE + 1 - ring_buffer->tail) %
+           (RING_BUFFER_MAX_SIZE + 1);
+}
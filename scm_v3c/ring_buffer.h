@@ -45,4 +45,7 @@ bool ring_buffer_empty(const ring_buffer_t* ring_buffer);
 // Return whether the ring buffer is full.
 bool ring_buffer_full(const ring_buffer_t* ring_buffer);
 
+// Return the number of elements in the ring buffer.
+size_t ring_buffer_size(const ring_buffer_t* ring_buffer);
+
 #endif  // __RING_BUFFER_H
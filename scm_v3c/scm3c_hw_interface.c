@@ -1,8 +1,14 @@
 #include "scm3c_hw_interface.h"
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "asc_map.h"
+#include "asc_profiles.h"
+#include "counters.h"
+#include "crc32.h"
+#include "lc_table.h"
 #include "memory_map.h"
 #include "optical.h"
 #include "radio.h"
@@ -52,6 +58,16 @@ typedef struct {
     uint32_t IF_clk_target;
     uint32_t IF_coarse;
     uint32_t IF_fine;
+
+    // Analog scan chain image last shifted into the chip and last loaded
+    // into the analog configuration
+    uint32_t ASC_shifted[ASC_LEN];
+    uint32_t ASC_loaded[ASC_LEN];
+    bool ASC_shifted_valid;
+    bool ASC_loaded_valid;
+
+    // Nesting depth of asc_begin()/asc_commit()
+    uint8_t asc_transaction_depth;
 } scm3c_hw_interface_vars_t;
 
 scm3c_hw_interface_vars_t scm3c_hw_interface_vars;
@@ -113,6 +129,9 @@ uint32_t scm3c_hw_interface_get_IF_coarse(void) {
 uint32_t scm3c_hw_interface_get_IF_fine(void) {
     return scm3c_hw_interface_vars.IF_fine;
 }
+uint32_t* scm3c_hw_interface_get_asc(void) {
+    return scm3c_hw_interface_vars.ASC;
+}
 
 //===== set function
 
@@ -146,6 +165,47 @@ void scm3c_hw_interface_set_asc(uint32_t* asc_profile) {
            ASC_LEN * sizeof(uint32_t));
 }
 
+//==== analog scan chain transactions
+
+// Start batching ASC updates. Transactions can be nested, and only the
+// outermost asc_commit() writes the scan chain.
+void asc_begin(void) { scm3c_hw_interface_vars.asc_transaction_depth++; }
+
+// The local ASC image is dirty if it differs from the last image loaded into
+// the chip. This compares the image instead of tracking writes, since many
+// functions write scm3c_hw_interface_vars.ASC directly.
+bool asc_is_dirty(void) {
+    return !scm3c_hw_interface_vars.ASC_loaded_valid ||
+           memcmp(scm3c_hw_interface_vars.ASC,
+                  scm3c_hw_interface_vars.ASC_loaded,
+                  sizeof(scm3c_hw_interface_vars.ASC)) != 0;
+}
+
+// Finish a batch of ASC updates. The scan chain is only shifted if the local
+// image differs from the shifted one and only loaded if it differs from the
+// loaded one. Return whether the analog configuration was updated.
+bool asc_commit(void) {
+    if (scm3c_hw_interface_vars.asc_transaction_depth > 0) {
+        scm3c_hw_interface_vars.asc_transaction_depth--;
+    }
+    if (scm3c_hw_interface_vars.asc_transaction_depth > 0) {
+        return false;
+    }
+
+    if (!asc_is_dirty()) {
+        return false;
+    }
+
+    if (!scm3c_hw_interface_vars.ASC_shifted_valid ||
+        memcmp(scm3c_hw_interface_vars.ASC,
+               scm3c_hw_interface_vars.ASC_shifted,
+               sizeof(scm3c_hw_interface_vars.ASC)) != 0) {
+        analog_scan_chain_write();
+    }
+    analog_scan_chain_load();
+    return true;
+}
+
 //==== from scm3c_hardware_interface.h
 
 // Reverses (reflects) bits in a 32-bit word.
@@ -157,44 +217,37 @@ unsigned reverse(unsigned x) {
     return x;
 }
 
-// Computes 32-bit crc from a starting address over 'length' dwords
+// Computes 32-bit crc from a starting address over 'length' bytes
+// The implementation is selected by CRC32_TABLE_BITS in crc32.h
 unsigned int crc32c(unsigned char* message, unsigned int length) {
-    int i, j;
-    unsigned int byte, crc;
-
-    i = 0;
-    crc = 0xFFFFFFFF;
-    while (i < length) {
-        byte = message[i];          // Get next byte.
-        byte = reverse(byte);       // 32-bit reversal.
-        for (j = 0; j <= 7; j++) {  // Do eight times.
-            if ((int)(crc ^ byte) < 0) {
-                crc = (crc << 1) ^ 0x04C11DB7;
-            } else {
-                crc = crc << 1;
-            }
-            byte = byte << 1;  // Ready next msg bit.
-        }
-        i = i + 1;
-    }
-    return reverse(~crc);
+    return crc32(message, length);
 }
 
 void crc_check(void) {
     uint32_t calc_crc;
+    uint32_t start_count;
+    uint32_t duration;
 
     // Check CRC to ensure there were no errors during optical programming
     printf("\r\n-------------------\r\n");
     printf("Validating program integrity...");
 
+    start_count = RFTIMER_REG__COUNTER;
     calc_crc = crc32c(0x0000, CODE_LENGTH);
+    duration = RFTIMER_REG__COUNTER - start_count;
 
     if (calc_crc == CRC_VALUE) {
-        printf("CRC OK\r\n");
+        // Each RF timer tick is 2 us once HF_CLOCK is calibrated
+        printf("CRC OK (%u bytes in %u RF timer ticks)\r\n", CODE_LENGTH,
+               duration);
     } else {
         printf(
             "\r\nProgramming Error - CRC DOES NOT MATCH - Halting "
             "Execution\r\n");
+        // Tell a broken CRC implementation apart from a corrupted program.
+        if (!crc32_self_test()) {
+            printf("CRC self test failed\r\n");
+        }
         while (1)
             ;
     }
@@ -208,75 +261,17 @@ unsigned char flipChar(unsigned char b) {
 }
 
 void GPO_control(uint8_t row1, uint8_t row2, uint8_t row3, uint8_t row4) {
-    int j;
-
-    for (j = 0; j <= 3; j++) {
-        if ((row1 >> j) & 0x1) {
-            set_asc_bit(245 + j);
-        } else {
-            clear_asc_bit(245 + j);
-        }
-    }
-
-    for (j = 0; j <= 3; j++) {
-        if ((row2 >> j) & 0x1) {
-            set_asc_bit(249 + j);
-        } else {
-            clear_asc_bit(249 + j);
-        }
-    }
-
-    for (j = 0; j <= 3; j++) {
-        if ((row3 >> j) & 0x1) {
-            set_asc_bit(253 + j);
-        } else {
-            clear_asc_bit(253 + j);
-        }
-    }
-
-    for (j = 0; j <= 3; j++) {
-        if ((row4 >> j) & 0x1) {
-            set_asc_bit(257 + j);
-        } else {
-            clear_asc_bit(257 + j);
-        }
-    }
+    asc_map_set_gpo_row1_select(scm3c_hw_interface_vars.ASC, row1);
+    asc_map_set_gpo_row2_select(scm3c_hw_interface_vars.ASC, row2);
+    asc_map_set_gpo_row3_select(scm3c_hw_interface_vars.ASC, row3);
+    asc_map_set_gpo_row4_select(scm3c_hw_interface_vars.ASC, row4);
 }
 
 void GPI_control(uint8_t row1, uint8_t row2, uint8_t row3, uint8_t row4) {
-    int j;
-
-    for (j = 0; j <= 1; j++) {
-        if ((row1 >> j) & 0x1) {
-            set_asc_bit(261 + j);
-        } else {
-            clear_asc_bit(261 + j);
-        }
-    }
-
-    for (j = 0; j <= 1; j++) {
-        if ((row2 >> j) & 0x1) {
-            set_asc_bit(263 + j);
-        } else {
-            clear_asc_bit(263 + j);
-        }
-    }
-
-    for (j = 0; j <= 1; j++) {
-        if ((row3 >> j) & 0x1) {
-            set_asc_bit(265 + j);
-        } else {
-            clear_asc_bit(265 + j);
-        }
-    }
-
-    for (j = 0; j <= 1; j++) {
-        if ((row4 >> j) & 0x1) {
-            set_asc_bit(267 + j);
-        } else {
-            clear_asc_bit(267 + j);
-        }
-    }
+    asc_map_set_gpi_row1_select(scm3c_hw_interface_vars.ASC, row1);
+    asc_map_set_gpi_row2_select(scm3c_hw_interface_vars.ASC, row2);
+    asc_map_set_gpi_row3_select(scm3c_hw_interface_vars.ASC, row3);
+    asc_map_set_gpi_row4_select(scm3c_hw_interface_vars.ASC, row4);
 }
 
 // Enable output drivers for GPIO based on 'mask'
@@ -286,18 +281,7 @@ void GPO_enables(unsigned int mask) {
     // out_en<0:15> =
     // ASC<1131>,ASC<1133>,ASC<1135>,ASC<1137>,ASC<1140>,ASC<1142>,ASC<1144>,ASC<1146>,...
     // ASC<1115>,ASC<1117>,ASC<1119>,ASC<1121>,ASC<1124>,ASC<1126>,ASC<1128>,ASC<1130>
-    unsigned short asc_locations[16] = {1131, 1133, 1135, 1137, 1140, 1142,
-                                        1144, 1146, 1115, 1117, 1119, 1121,
-                                        1124, 1126, 1128, 1130};
-    unsigned int j;
-
-    for (j = 0; j <= 15; j++) {
-        if ((mask >> j) & 0x1) {
-            clear_asc_bit(asc_locations[j]);
-        } else {
-            set_asc_bit(asc_locations[j]);
-        }
-    }
+    asc_map_set_gpo_enable(scm3c_hw_interface_vars.ASC, mask);
 }
 
 // Enable input path for GPIO based on 'mask'
@@ -307,18 +291,7 @@ void GPI_enables(unsigned int mask) {
     // in_en<0:15> =
     // ASC<1132>,ASC<1134>,ASC<1136>,ASC<1138>,ASC<1139>,ASC<1141>,ASC<1143>,ASC<1145>,...
     // ASC<1116>,ASC<1118>,ASC<1120>,ASC<1122>,ASC<1123>,ASC<1125>,ASC<1127>,ASC<1129>
-    unsigned short asc_locations[16] = {1132, 1134, 1136, 1138, 1139, 1141,
-                                        1143, 1145, 1116, 1118, 1120, 1122,
-                                        1123, 1125, 1127, 1129};
-    unsigned int j;
-
-    for (j = 0; j <= 15; j++) {
-        if ((mask >> j) & 0x1) {
-            set_asc_bit(asc_locations[j]);
-        } else {
-            clear_asc_bit(asc_locations[j]);
-        }
-    }
+    asc_map_set_gpi_enable(scm3c_hw_interface_vars.ASC, mask);
 }
 
 // Configure how radio and AUX LDOs are turned on and off
@@ -326,22 +299,22 @@ void init_ldo_control(void) {
     // Analog scan chain setup for radio LDOs
     // Memory mapped control signals from the cortex are connected to fsm_pon
     // signals
-    clear_asc_bit(501);  // = scan_pon_if
-    clear_asc_bit(502);  // = scan_pon_lo
-    clear_asc_bit(503);  // = scan_pon_pa
-    clear_asc_bit(504);  // = gpio_pon_en_if
-    set_asc_bit(505);    // = fsm_pon_en_if
-    clear_asc_bit(506);  // = gpio_pon_en_lo
-    set_asc_bit(507);    // = fsm_pon_en_lo
-    clear_asc_bit(508);  // = gpio_pon_en_pa
-    set_asc_bit(509);    // = fsm_pon_en_pa
-    set_asc_bit(510);    // = master_ldo_en_if
-    set_asc_bit(511);    // = master_ldo_en_lo
-    set_asc_bit(512);    // = master_ldo_en_pa
-    clear_asc_bit(513);  // = scan_pon_div
-    clear_asc_bit(514);  // = gpio_pon_en_div
-    set_asc_bit(515);    // = fsm_pon_en_div
-    set_asc_bit(516);    // = master_ldo_en_div
+    asc_map_set_scan_pon_if(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_scan_pon_lo(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_scan_pon_pa(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_gpio_pon_en_if(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_fsm_pon_en_if(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_gpio_pon_en_lo(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_fsm_pon_en_lo(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_gpio_pon_en_pa(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_fsm_pon_en_pa(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_master_ldo_en_if(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_master_ldo_en_lo(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_master_ldo_en_pa(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_scan_pon_div(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_gpio_pon_en_div(scm3c_hw_interface_vars.ASC, 0);
+    asc_map_set_fsm_pon_en_div(scm3c_hw_interface_vars.ASC, 1);
+    asc_map_set_master_ldo_en_div(scm3c_hw_interface_vars.ASC, 1);
 
     // Initialize all radio LDOs off but leave AUX on
     ANALOG_CFG_REG__10 = 0x0000;
@@ -351,7 +324,7 @@ void init_ldo_control(void) {
     // 0 = ASC<916> has control
     // 1 = analog_cfg<167> has control
     // Enable is inverted so 0=on
-    set_asc_bit(914);
+    asc_map_set_aux_ldo_control_select(scm3c_hw_interface_vars.ASC, 1);
     // set_asc_bit(916);
 
     // Initialize all radio LDOs and AUX to off
@@ -493,132 +466,51 @@ unsigned int sram_test(unsigned int* baseAddress, unsigned int num_dwords) {
 // Change the reference voltage for the IF LDO
 // 0 <= code <= 127
 void set_IF_LDO_voltage(int code) {
-    unsigned int j;
-
     // ASC<492:498> = if_ldo_rdac<0:6> (<0:6(MSB)>)
-
-    for (j = 0; j <= 6; j++) {
-        if ((code >> j) & 0x1) {
-            set_asc_bit(492 + j);
-        } else {
-            clear_asc_bit(492 + j);
-        }
-    }
+    asc_map_set_if_ldo_rdac(scm3c_hw_interface_vars.ASC, code);
 }
 
 // Change the reference voltage for the VDDD LDO
 // 0 <= code <= 127
 void set_VDDD_LDO_voltage(int code) {
-    unsigned int j;
-
-    // ASC(791:1:797) (LSB:MSB)
-
-    for (j = 0; j <= 4; j++) {
-        if ((code >> j) & 0x1) {
-            set_asc_bit(797 - j);
-        } else {
-            clear_asc_bit(797 - j);
-        }
-    }
-
-    // Two MSBs are inverted
-    for (j = 5; j <= 6; j++) {
-        if ((code >> j) & 0x1)
-            clear_asc_bit(797 - j);
-        else
-            set_asc_bit(797 - j);
-    }
+    // ASC(791:1:797) (LSB:MSB), two MSBs are inverted
+    asc_map_set_vddd_ldo(scm3c_hw_interface_vars.ASC, code);
 }
 
 // Change the reference voltage for the AUX LDO
 // 0 <= code <= 127
 void set_AUX_LDO_voltage(int code) {
-    unsigned int j;
-
-    // ASC(923:-1:917) (MSB:LSB)
-
-    for (j = 0; j <= 4; j++) {
-        if ((code >> j) & 0x1)
-            set_asc_bit(917 + j);
-        else
-            clear_asc_bit(917 + j);
-    }
-
-    // Two MSBs are inverted
-    for (j = 5; j <= 6; j++) {
-        if ((code >> j) & 0x1)
-            clear_asc_bit(917 + j);
-        else
-            set_asc_bit(917 + j);
-    }
+    // ASC(923:-1:917) (MSB:LSB), two MSBs are inverted
+    asc_map_set_aux_ldo(scm3c_hw_interface_vars.ASC, code);
 }
 
 // Change the reference voltage for the always-on LDO
 // 0 <= code <= 127
 void set_ALWAYSON_LDO_voltage(int code) {
-    unsigned int j;
-
-    // ASC(924:929) (MSB:LSB)
-
-    for (j = 0; j <= 4; j++) {
-        if ((code >> j) & 0x1)
-            set_asc_bit(929 - j);
-        else
-            clear_asc_bit(929 - j);
-    }
-
-    // MSB of normal DAC is inverted
-    if ((code >> 5) & 0x1)
-        clear_asc_bit(924);
-    else
-        set_asc_bit(924);
-
-    // Panic bit was added for 3B (inverted)
-    if ((code >> 6) & 0x1)
-        clear_asc_bit(557);
-    else
-        set_asc_bit(557);
+    // ASC(924:929) (MSB:LSB), MSB of normal DAC is inverted
+    // Panic bit was added for 3B at ASC<557> (inverted)
+    asc_map_set_always_on_ldo(scm3c_hw_interface_vars.ASC, code);
 }
 
 // Must set IF clock frequency AFTER calling this function
 
 void set_zcc_demod_threshold(unsigned int thresh) {
-    int j;
-
     // counter threshold 122:107 MSB:LSB
-    for (j = 0; j <= 15; j++) {
-        if ((thresh >> j) & 0x1)
-            set_asc_bit(107 + j);
-        else
-            clear_asc_bit(107 + j);
-    }
+    asc_map_set_zcc_demod_threshold(scm3c_hw_interface_vars.ASC, thresh);
 }
 
 // Set the divider value for ZCC demod
 // Should be equal to (IF_clock_rate / 2 MHz)
 void set_IF_ZCC_clkdiv(unsigned int div_value) {
-    int j;
-
     // CLK_DIV = ASC<131:124> MSB:LSB
-    for (j = 0; j <= 7; j++) {
-        if ((div_value >> j) & 0x1)
-            set_asc_bit(124 + j);
-        else
-            clear_asc_bit(124 + j);
-    }
+    asc_map_set_zcc_clk_div(scm3c_hw_interface_vars.ASC, div_value);
 }
 
 // Set the early decision value for ZCC demod
 void set_IF_ZCC_early(unsigned int early_value) {
-    int j;
-
     // ASC<224:209> MSB:LSB
-    for (j = 0; j <= 15; j++) {
-        if ((early_value >> j) & 0x1)
-            set_asc_bit(209 + j);
-        else
-            clear_asc_bit(209 + j);
-    }
+    asc_map_set_zcc_early_decision_margin(scm3c_hw_interface_vars.ASC,
+                                          early_value);
 }
 
 // Untested function
@@ -645,49 +537,21 @@ void set_IF_stg3gm_ASC(unsigned int Igm, unsigned int Qgm) {
 // Adjust the comparator offset trim for I channel
 // Valid input range 0-31
 void set_IF_comparator_trim_I(unsigned int ptrim, unsigned int ntrim) {
-    int j;
-
     // I comparator N side = 452:456 LSB:MSB
-    for (j = 0; j <= 4; j++) {
-        if ((ntrim >> j) & 0x1) {
-            set_asc_bit(452 + j);
-        } else {
-            clear_asc_bit(452 + j);
-        }
-    }
+    asc_map_set_if_i_comparator_ntrim(scm3c_hw_interface_vars.ASC, ntrim);
 
     // I comparator P side = 457:461 LSB:MSB
-    for (j = 0; j <= 4; j++) {
-        if ((ptrim >> j) & 0x1) {
-            set_asc_bit(457 + j);
-        } else {
-            clear_asc_bit(457 + j);
-        }
-    }
+    asc_map_set_if_i_comparator_ptrim(scm3c_hw_interface_vars.ASC, ptrim);
 }
 
 // Adjust the comparator offset trim for Q channel
 // Valid input range 0-31
 void set_IF_comparator_trim_Q(unsigned int ptrim, unsigned int ntrim) {
-    int j;
-
-    // I comparator N side = 340:344 MSB:LSB
-    for (j = 0; j <= 4; j++) {
-        if ((ntrim >> j) & 0x1) {
-            set_asc_bit(344 - j);
-        } else {
-            clear_asc_bit(344 - +j);
-        }
-    }
+    // Q comparator N side = 340:344 MSB:LSB
+    asc_map_set_if_q_comparator_ntrim(scm3c_hw_interface_vars.ASC, ntrim);
 
-    // I comparator P side = 335:339 MSB:LSB
-    for (j = 0; j <= 4; j++) {
-        if ((ptrim >> j) & 0x1) {
-            set_asc_bit(339 - j);
-        } else {
-            clear_asc_bit(339 - j);
-        }
-    }
+    // Q comparator P side = 335:339 MSB:LSB
+    asc_map_set_if_q_comparator_ptrim(scm3c_hw_interface_vars.ASC, ptrim);
 }
 
 // Untested function
@@ -713,10 +577,10 @@ void set_IF_gain_ASC(unsigned int Igain, unsigned int Qgain) {
     }
 }
 
-void radio_init_rx_MF() {
-    // int j;
+// Set up the ASC image for matched filter RX without touching the memory
+// mapped registers
+void radio_init_rx_MF_ASC() {
     unsigned int mask1, mask2;
-    unsigned int tau_shift, e_k_shift, correlation_threshold;
 
     // IF uses ASC<271:500>, mask off outside that range
     mask1 = 0xFFFC0000;
@@ -792,38 +656,12 @@ void radio_init_rx_MF() {
     // '0' = control gain of TIA and stage1/2
     set_asc_bit(97);
 
-    // Memory mapped config registers
-    // analog_cfg[239:224]    AGC        {gain_imbalance_select 1, gain_offset
-    // 3, vga_ctrl_Q_analogcfg 6, vga_ctrl_I_analogcfg 6} ANALOG_CFG_REG__14
-    // analog_cfg[255:240]    AGC        {envelope_threshold 4, wait_time 12}
-    // ANALOG_CFG_REG__15
-    // gain_imbalance_select
-    // '0' = subtract 'gain_offset' from Q channel
-    // '1' = subtract 'gain_offset' from I channel
-    // envelope_threshold = the max-min value of signal that will cause gain
-    // reduction wait_time = how long FSM waits for settling before making
-    // another adjustment
-    ANALOG_CFG_REG__14 = 0x0000;
-    ANALOG_CFG_REG__15 = 0xA00F;
-
     // Matched Filter/Clock & Data Recovery
     // Choose output polarity of demod
     // If RX LO is 2.5MHz below the channel, use ASC<103>=1
     // This bit just inverts the output data bits
     set_asc_bit(103);
 
-    // CDR feedback parameters
-    // Determined experimentally - unlikely to need to ever change
-    tau_shift = 11;
-    e_k_shift = 2;
-    ANALOG_CFG_REG__3 = (tau_shift << 11) | (e_k_shift << 7);
-
-    // Threshold used for packet detection
-    // This number corresponds to the Hamming distance threshold for determining
-    // if incoming 15.4 chip stream is a packet
-    correlation_threshold = 5;
-    ANALOG_CFG_REG__9 = correlation_threshold;
-
     // Mux select bits to choose internal demod or external clk/data from gpio
     // '0' = on chip, '1' = external from GPIO
     clear_asc_bit(269);
@@ -859,17 +697,49 @@ void radio_init_rx_MF() {
     set_asc_bit(744);
     set_asc_bit(745);
     set_asc_bit(746);
+}
+
+void radio_init_rx_MF() {
+    unsigned int tau_shift, e_k_shift, correlation_threshold;
+
+    radio_init_rx_MF_ASC();
+    asc_profiles_set_rx(ASC_PROFILE_RX_MF);
+
+    // Memory mapped config registers
+    // analog_cfg[239:224]    AGC        {gain_imbalance_select 1, gain_offset
+    // 3, vga_ctrl_Q_analogcfg 6, vga_ctrl_I_analogcfg 6} ANALOG_CFG_REG__14
+    // analog_cfg[255:240]    AGC        {envelope_threshold 4, wait_time 12}
+    // ANALOG_CFG_REG__15
+    // gain_imbalance_select
+    // '0' = subtract 'gain_offset' from Q channel
+    // '1' = subtract 'gain_offset' from I channel
+    // envelope_threshold = the max-min value of signal that will cause gain
+    // reduction wait_time = how long FSM waits for settling before making
+    // another adjustment
+    ANALOG_CFG_REG__14 = 0x0000;
+    ANALOG_CFG_REG__15 = 0xA00F;
+
+    // CDR feedback parameters
+    // Determined experimentally - unlikely to need to ever change
+    tau_shift = 11;
+    e_k_shift = 2;
+    ANALOG_CFG_REG__3 = (tau_shift << 11) | (e_k_shift << 7);
+
+    // Threshold used for packet detection
+    // This number corresponds to the Hamming distance threshold for determining
+    // if incoming 15.4 chip stream is a packet
+    correlation_threshold = 5;
+    ANALOG_CFG_REG__9 = correlation_threshold;
 
     // Enable both polyphase and mixers via memory mapped IO (...001 = 0x1)
     // To disable both you would invert these values (...110 = 0x6)
     ANALOG_CFG_REG__16 = 0x1;
 }
 
+// Set up the ASC image for ZCC RX without touching the memory mapped registers
 // Must set IF clock frequency AFTER calling this function
-void radio_init_rx_ZCC() {
-    // int j;
+void radio_init_rx_ZCC_ASC() {
     unsigned int mask1, mask2;
-    unsigned int correlation_threshold;
 
     // IF uses ASC<271:500>, mask off outside that range
     mask1 = 0xFFFE0000;
@@ -916,10 +786,6 @@ void radio_init_rx_ZCC() {
     // Enable ZCC demod
     set_asc_bit(132);
 
-    // Threshold used for packet detection
-    correlation_threshold = 5;
-    ANALOG_CFG_REG__9 = correlation_threshold;
-
     // Trim comparator offset
     set_IF_comparator_trim_I(0, 10);
 
@@ -928,6 +794,18 @@ void radio_init_rx_ZCC() {
 
     // Set RST_B to analog_cfg[75]
     set_asc_bit(240);
+}
+
+// Must set IF clock frequency AFTER calling this function
+void radio_init_rx_ZCC() {
+    unsigned int correlation_threshold;
+
+    radio_init_rx_ZCC_ASC();
+    asc_profiles_set_rx(ASC_PROFILE_RX_ZCC);
+
+    // Threshold used for packet detection
+    correlation_threshold = 5;
+    ANALOG_CFG_REG__9 = correlation_threshold;
 
     // Leave baseband held in reset until RX activated
     // RST_B = 0 (it is active low)
@@ -1013,35 +891,13 @@ void radio_init_divider(unsigned int div_value) {
 
 void read_counters_3B(unsigned int* count_2M, unsigned int* count_LC,
                       unsigned int* count_adc) {
-    unsigned int rdata_lsb, rdata_msb;  //, count_LC, count_32k;
+    counters_snapshot_t counters;
 
-    // Disable all counters
-    ANALOG_CFG_REG__0 = 0x007F;
-
-    // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    *count_2M = rdata_lsb + (rdata_msb << 16);
-
-    // Read LC_div counter (via counter4)
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x280000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x2C0000);
-    *count_LC = rdata_lsb + (rdata_msb << 16);
-
-    // Read adc counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x300000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x340000);
-    *count_adc = rdata_lsb + (rdata_msb << 16);
-
-    // Reset all counters
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // Enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
-
-    // printf("LC_count=%X\r\n",*count_LC);
-    // printf("2M_count=%X\r\n",*count_2M);
-    // printf("adc_count=%X\r\n\r\n",*count_adc);
+    // Read all counters, then reset and enable them
+    counters_read(&counters);
+    *count_2M = counters.counts[COUNTERS_2M];
+    *count_LC = counters.counts[COUNTERS_LC];
+    *count_adc = counters.counts[COUNTERS_IF];
 }
 
 // read IF estimate
@@ -1066,33 +922,14 @@ void set_IF_clock_frequency(int coarse, int fine, int high_range) {
     // Coarse and fine frequency tune, binary weighted
     // ASC<427:431> = RC_coarse<4:0> (<4(MSB):0>)
     // ASC<433:437> = RC_fine<4:0>   (<4(MSB):0>)
-
-    unsigned int j;
-
-    for (j = 0; j <= 4; j++) {
-        if ((coarse >> j) & 0x1) {
-            set_asc_bit(431 - j);
-        } else {
-            clear_asc_bit(431 - j);
-        }
-    }
-
-    for (j = 0; j <= 4; j++) {
-        if ((fine >> j) & 0x1) {
-            set_asc_bit(437 - j);
-        } else {
-            clear_asc_bit(437 - j);
-        }
-    }
+    asc_map_set_if_rc_coarse(scm3c_hw_interface_vars.ASC, coarse);
+    asc_map_set_if_rc_fine(scm3c_hw_interface_vars.ASC, fine);
 
     // Switch between high and low speed ranges for IF RC:
     //'1' = high range
     // ASC<726> = RC_high_speed_mode
-    if (high_range == 1) {
-        set_asc_bit(726);
-    } else {
-        clear_asc_bit(726);
-    }
+    asc_map_set_if_rc_high_speed_mode(scm3c_hw_interface_vars.ASC,
+                                      high_range == 1);
 }
 
 // Set frequency for TI 20M oscillator
@@ -1100,40 +937,11 @@ void set_sys_clk_secondary_freq(unsigned int coarse, unsigned int fine) {
     // coarse 0:4 = 860 861 875b 876b 877b
     // fine 0:4 870 871 872 873 874b
 
-    int j;
-
-    for (j = 0; j <= 3; j++) {
-        if ((fine >> j) & 0x1) {
-            set_asc_bit(870 + j);
-        } else {
-            clear_asc_bit(870 + j);
-        }
-    }
-    if ((fine >> 4) & 0x1) {
-        clear_asc_bit(874);
-    } else {
-        set_asc_bit(874);
-    }
-
-    for (j = 0; j <= 1; j++) {
-        if ((coarse >> j) & 0x1) {
-            set_asc_bit(860 + j);
-        } else {
-            clear_asc_bit(860 + j);
-        }
-    }
-    for (j = 2; j <= 4; j++) {
-        if ((coarse >> j) & 0x1) {
-            clear_asc_bit(873 + j);
-        } else {
-            set_asc_bit(873 + j);
-        }
-    }
+    asc_map_set_hf_clock_fine(scm3c_hw_interface_vars.ASC, fine);
+    asc_map_set_hf_clock_coarse(scm3c_hw_interface_vars.ASC, coarse);
 }
 
 void initialize_mote() {
-    int t;
-
     scm3c_hw_interface_init();
     optical_init();
     radio_init();
@@ -1166,7 +974,7 @@ void initialize_mote() {
     GPO_enables(0xFFFF);
 
     // Set HCLK source as HF_CLOCK
-    set_asc_bit(1147);
+    asc_map_set_hclk_source_hf_clock(scm3c_hw_interface_vars.ASC, 1);
 
     // Set initial coarse/fine on HF_CLOCK
     // coarse 0:4 = 860 861 875b 876b 877b
@@ -1175,35 +983,28 @@ void initialize_mote() {
                                scm3c_hw_interface_vars.HF_CLOCK_fine);
 
     // Set RFTimer source as HF_CLOCK
-    set_asc_bit(1151);
+    asc_map_set_rftimer_source_hf_clock(scm3c_hw_interface_vars.ASC, 1);
 
     // Disable LF_CLOCK
-    set_asc_bit(553);
+    asc_map_set_lf_clock_disable(scm3c_hw_interface_vars.ASC, 1);
 
     // HF_CLOCK will be trimmed to 20MHz, so set RFTimer div value to 40 to get
     // 500kHz (inverted, so 1101 0111)
-    set_asc_bit(49);
-    set_asc_bit(48);
-    clear_asc_bit(47);
-    set_asc_bit(46);
-    clear_asc_bit(45);
-    set_asc_bit(44);
-    set_asc_bit(43);
-    set_asc_bit(42);
+    asc_map_set_rftimer_divider(scm3c_hw_interface_vars.ASC, 40);
 
     // Set 2M RC as source for chip CLK
-    set_asc_bit(1156);
+    asc_map_set_chip_clk_source_rc_2m(scm3c_hw_interface_vars.ASC, 1);
 
     // Enable 32k for cal
-    set_asc_bit(623);
+    asc_map_set_osc_32k_enable(scm3c_hw_interface_vars.ASC, 1);
 
     // Enable passthrough on chip CLK divider
-    set_asc_bit(41);
+    asc_map_set_chip_clk_divider_passthrough(scm3c_hw_interface_vars.ASC, 1);
 
     // Init counter setup - set all to analog_cfg control
     // scm3c_hw_interface_vars.ASC[0] is leftmost
     // scm3c_hw_interface_vars.ASC[0] |= 0x6F800000;
-    for (t = 2; t < 9; t++) set_asc_bit(t);
+    asc_map_set_counter_analog_cfg_select(scm3c_hw_interface_vars.ASC, 0x7F);
 
     // Init RX
     radio_init_rx_MF();
@@ -1221,7 +1022,7 @@ void initialize_mote() {
                         scm3c_hw_interface_vars.RC2M_superfine);
 
     // Turn on RC 2M for cal
-    set_asc_bit(1114);
+    asc_map_set_rc_2m_enable(scm3c_hw_interface_vars.ASC, 1);
 
     // Set initial LO frequency
     LC_monotonic(DEFUALT_INIT_LC_CODE);
@@ -1232,36 +1033,27 @@ void initialize_mote() {
     // Program analog scan chain
     analog_scan_chain_write();
     analog_scan_chain_load();
+
+    // Build the ASC profiles for switching between the radio modes
+    asc_profiles_build();
     //--------------------------------------------------------
 }
 
 unsigned int estimate_temperature_2M_32k() {
-    unsigned int rdata_lsb, rdata_msb;
     unsigned int count_2M, count_32k;
     int t;
 
-    // Reset all counters
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // Enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
+    // Reset and enable all counters
+    counters_start();
 
     // Count for some arbitrary amount of time
     for (t = 1; t < 50000; t++)
         ;
 
-    // Disable all counters
-    ANALOG_CFG_REG__0 = 0x007F;
-
-    // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    count_2M = rdata_lsb + (rdata_msb << 16);
-
-    // Read 32k counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x000000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x040000);
-    count_32k = rdata_lsb + (rdata_msb << 16);
+    // Disable all counters and read the 2M and 32k counters
+    counters_stop();
+    count_2M = counters_read_counter(COUNTERS_2M);
+    count_32k = counters_read_counter(COUNTERS_32K);
 
     // printf("%d - %d - %d\r\n",count_2M,count_32k,(count_2M << 13) /
     // count_32k);
@@ -1288,42 +1080,46 @@ unsigned int flip_lsb8(unsigned int in) {
     return out;
 }
 
+// Shift one bit into the analog scan chain. The pattern holds the inverted
+// scan_in bit in bit 0 and analog_cfg<357> in bit 5, which is resetb for the
+// chip shift register, so leave that high. The writes are: set scan_in, lower
+// phi1, toggle phi2 and raise phi1.
+#define ASC_SHIFT_BIT(asc_reg, pattern) \
+    do {                                \
+        *(asc_reg) = (pattern);         \
+        *(asc_reg) = (pattern);         \
+        *(asc_reg) = (pattern) | 0x4;   \
+        *(asc_reg) = (pattern);         \
+        *(asc_reg) = (pattern) | 0x2;   \
+    } while (0)
+
 void analog_scan_chain_write(void) {
+    volatile unsigned int* const asc_reg = &ANALOG_CFG_REG__22;
     int i = 0;
     int j = 0;
-    unsigned int asc_reg;
-
-    // analog_cfg<357> is resetb for chip shift register, so leave that high
+    uint32_t scan_in;
 
     for (i = 37; i >= 0; i--) {
-        // printf("\r\n%d,%lX\r\n",i,scan_bits[i]);
-
-        for (j = 0; j < 32; j++) {
-            // Set scan_in (should be inverted)
-            if ((scm3c_hw_interface_vars.ASC[i] & (0x00000001 << j)) == 0) {
-                asc_reg = 0x21;
-            } else {
-                asc_reg = 0x20;
-            }
-
-            // Write asc_reg to analog_cfg
-            ANALOG_CFG_REG__22 = asc_reg;
-
-            // Lower phi1
-            asc_reg &= ~(0x2);
-            ANALOG_CFG_REG__22 = asc_reg;
-
-            // Toggle phi2
-            asc_reg |= 0x4;
-            ANALOG_CFG_REG__22 = asc_reg;
-            asc_reg &= ~(0x4);
-            ANALOG_CFG_REG__22 = asc_reg;
-
-            // Raise phi1
-            asc_reg |= 0x2;
-            ANALOG_CFG_REG__22 = asc_reg;
+        // Invert the word once, so each bit pattern is a single OR
+        scan_in = ~scm3c_hw_interface_vars.ASC[i];
+
+        // Shift out from the LSB, 8 bits per iteration
+        for (j = 0; j < 32; j += 8) {
+            ASC_SHIFT_BIT(asc_reg, 0x20 | (scan_in & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 1) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 2) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 3) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 4) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 5) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 6) & 0x1));
+            ASC_SHIFT_BIT(asc_reg, 0x20 | ((scan_in >> 7) & 0x1));
+            scan_in >>= 8;
         }
     }
+
+    memcpy(scm3c_hw_interface_vars.ASC_shifted, scm3c_hw_interface_vars.ASC,
+           sizeof(scm3c_hw_interface_vars.ASC));
+    scm3c_hw_interface_vars.ASC_shifted_valid = true;
 }
 
 void analog_scan_chain_load() {
@@ -1332,6 +1128,13 @@ void analog_scan_chain_load() {
 
     // Lower load signal
     ANALOG_CFG_REG__22 = 0x0020;
+
+    if (scm3c_hw_interface_vars.ASC_shifted_valid) {
+        memcpy(scm3c_hw_interface_vars.ASC_loaded,
+               scm3c_hw_interface_vars.ASC_shifted,
+               sizeof(scm3c_hw_interface_vars.ASC));
+        scm3c_hw_interface_vars.ASC_loaded_valid = true;
+    }
 }
 /* sets the 2 MHz RC DAC frequency.
 -updates the local dac settings array
@@ -1341,9 +1144,6 @@ void analog_scan_chain_load() {
 */
 void set_2M_RC_frequency(int coarse1, int coarse2, int coarse3, int fine,
                          int superfine) {
-    unsigned int newval;
-    unsigned int newcoarse1, newcoarse2, newcoarse3, newfine, newsuperfine;
-
     /* update our local dac array */
     scm3c_hw_interface_vars.dac_2M_settings[0] = coarse1;
     scm3c_hw_interface_vars.dac_2M_settings[1] = coarse2;
@@ -1352,27 +1152,14 @@ void set_2M_RC_frequency(int coarse1, int coarse2, int coarse3, int fine,
     scm3c_hw_interface_vars.dac_2M_settings[4] = superfine;
 
     // make sure each argument is between 0-31, inclusive
-
-    // scm3c_hw_interface_vars.ASC[34] covers 1088:1119
-    newval = scm3c_hw_interface_vars.ASC[34] & 0x8000001F;
-
-    // flip endianness of each
-    newcoarse1 = (flip_lsb8(coarse1) >> 3) & 0x1F;
-    newcoarse2 = (flip_lsb8(coarse2) >> 3) & 0x1F;
-    newcoarse3 = (flip_lsb8(coarse3) >> 3) & 0x1F;
-    newfine = (flip_lsb8(fine) >> 3) & 0x1F;
-    newsuperfine = (flip_lsb8(superfine) >> 3) & 0x1F;
-
-    newval |= newcoarse1 << 26;
-    newval |= newcoarse2 << 21;
-    newval |= newcoarse3 << 16;
-    newval |= newfine << 11;
-    newval |= newsuperfine << 6;
+    asc_map_set_rc_2m_coarse1(scm3c_hw_interface_vars.ASC, coarse1);
+    asc_map_set_rc_2m_coarse2(scm3c_hw_interface_vars.ASC, coarse2);
+    asc_map_set_rc_2m_coarse3(scm3c_hw_interface_vars.ASC, coarse3);
+    asc_map_set_rc_2m_fine(scm3c_hw_interface_vars.ASC, fine);
+    asc_map_set_rc_2m_superfine(scm3c_hw_interface_vars.ASC, superfine);
 
     // Enable bit
-    newval |= 0x1 << 5;
-
-    scm3c_hw_interface_vars.ASC[34] = newval;
+    asc_map_set_rc_2m_enable(scm3c_hw_interface_vars.ASC, 1);
 
     // write to analog scanchain and load
     // analog_scan_chain_write();
@@ -1394,44 +1181,20 @@ void initialize_2M_DAC(void) {
 
 void read_counters(unsigned int* count_2M, unsigned int* count_LC,
                    unsigned int* count_32k) {
-    unsigned int rdata_lsb, rdata_msb;  //, count_LC, count_32k;
-
-    // Disable all counters
-    ANALOG_CFG_REG__0 = 0x007F;
+    counters_snapshot_t counters;
 
-    // Read 2M counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x180000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x1C0000);
-    *count_2M = rdata_lsb + (rdata_msb << 16);
-
-    // Read LC_div counter (via counter4)
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x200000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x240000);
-    *count_LC = rdata_lsb + (rdata_msb << 16);
-
-    // Read 32k counter
-    rdata_lsb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x000000);
-    rdata_msb = *(unsigned int*)(APB_ANALOG_CFG_BASE + 0x040000);
-    *count_32k = rdata_lsb + (rdata_msb << 16);
-
-    // Reset all counters
-    ANALOG_CFG_REG__0 = 0x0000;
-
-    // Enable all counters
-    ANALOG_CFG_REG__0 = 0x3FFF;
-
-    // printf("LC_count=%X\r\n",count_LC);
-    // printf("2M_count=%X\r\n",count_2M);
-    // printf("32k_count=%X\r\n\r\n",count_32k);
+    // Read all counters, then reset and enable them
+    counters_read(&counters);
+    *count_2M = counters.counts[COUNTERS_2M];
+    *count_LC = counters.counts[COUNTERS_LC_DIV];
+    *count_32k = counters.counts[COUNTERS_32K];
 }
 
 void update_PN31_byte(unsigned int* current_lfsr) {
-    int i;
-
-    for (i = 0; i < 8; i++) {
-        int newbit = (((*current_lfsr >> 30) ^ (*current_lfsr >> 27)) & 1);
-        *current_lfsr = ((*current_lfsr << 1) | newbit);
-    }
+    // The 8 new bits only depend on bits 20 to 30 of the LFSR, so they are
+    // computed in parallel instead of one bit at a time (see prbs.h).
+    *current_lfsr = (*current_lfsr << 8) |
+                    (((*current_lfsr >> 23) ^ (*current_lfsr >> 20)) & 0xFF);
 }
 
 void set_asc_bit(unsigned int position) {
@@ -1532,6 +1295,12 @@ void LC_FREQCHANGE(int coarse, int mid, int fine) {
     ANALOG_CFG_REG__8 = fcode2;
 }
 void LC_monotonic(int LC_code) {
+    // Use the chip's LC table if it has been built or loaded
+    if (lc_table_is_valid()) {
+        lc_table_tune(LC_code);
+        return;
+    }
+
     // int coarse_divs = 440;
     // int mid_divs = 31; // For full fine code sweeps
 
@@ -1568,18 +1337,15 @@ void LC_monotonic(int LC_code) {
 }
 
 void set_LC_current(unsigned int current) {
-    unsigned int current_msb = (current & 0x000000F0) >> 4;
-    unsigned int current_lsb = (current & 0x0000000F) << 28;
-
-    scm3c_hw_interface_vars.ASC[30] &= 0xFFFFFFF0;
-    scm3c_hw_interface_vars.ASC[30] |= current_msb;
-
-    scm3c_hw_interface_vars.ASC[31] &= 0x0FFFFFFF;
-    scm3c_hw_interface_vars.ASC[31] |= current_lsb;
+    asc_map_set_lo_current(scm3c_hw_interface_vars.ASC, current);
+}
+void disable_polyphase_ASC() {
+    asc_map_set_polyphase_enable(scm3c_hw_interface_vars.ASC, 0);
 }
-void disable_polyphase_ASC() { scm3c_hw_interface_vars.ASC[30] &= 0xFFEFFFFF; }
 
-void enable_polyphase_ASC() { scm3c_hw_interface_vars.ASC[30] |= 0x00100000; }
+void enable_polyphase_ASC() {
+    asc_map_set_polyphase_enable(scm3c_hw_interface_vars.ASC, 1);
+}
 
 void disable_div_power_ASC() { scm3c_hw_interface_vars.ASC[16] &= 0xB7FFFFFF; }
 void enable_div_power_ASC() { scm3c_hw_interface_vars.ASC[16] |= 0x48000000; }
@@ -1593,9 +1359,7 @@ void disable_1mhz_ble_ASC() { scm3c_hw_interface_vars.ASC[32] |= 0x00060000; }
 void set_PA_supply(unsigned int code) {
     // 7-bit setting (between 0 and 127)
     // MSB is a "panic" bit that engages the high-voltage settings
-    unsigned int code_ASC = ((~code) & 0x0000007F) << 13;
-    scm3c_hw_interface_vars.ASC[30] &= 0xFFF01FFF;
-    scm3c_hw_interface_vars.ASC[30] |= code_ASC;
+    asc_map_set_pa_ldo_rdac(scm3c_hw_interface_vars.ASC, code);
 }
 void set_LO_supply(unsigned int code, unsigned char panic) {
     // 7-bit setting (between 0 and 127)
@@ -1,6 +1,7 @@
 #ifndef __SCM3C_HW_INTERFACE_H
 #define __SCM3C_HW_INTERFACE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 //=========================== define ==========================================
@@ -23,6 +24,7 @@ uint32_t scm3c_hw_interface_get_RC2M_superfine(void);
 uint32_t scm3c_hw_interface_get_IF_clk_target(void);
 uint32_t scm3c_hw_interface_get_IF_coarse(void);
 uint32_t scm3c_hw_interface_get_IF_fine(void);
+uint32_t* scm3c_hw_interface_get_asc(void);
 
 //===== set function
 
@@ -37,6 +39,11 @@ void scm3c_hw_interface_set_IF_fine(uint32_t value);
 
 void scm3c_hw_interface_set_asc(uint32_t* asc_profile);
 
+//==== analog scan chain transactions
+void asc_begin(void);
+bool asc_is_dirty(void);
+bool asc_commit(void);
+
 //==== from scm3c_hardware_interface.h
 unsigned reverse(unsigned x);
 unsigned int crc32c(unsigned char* message, unsigned int length);
@@ -44,7 +51,9 @@ void crc_check(void);
 unsigned char flipChar(unsigned char b);
 void init_ldo_control(void);
 unsigned int sram_test(unsigned int* baseAddress, unsigned int num_dwords);
+void radio_init_rx_MF_ASC(void);
 void radio_init_rx_MF(void);
+void radio_init_rx_ZCC_ASC(void);
 void radio_init_rx_ZCC(void);
 void radio_init_tx(void);
 void radio_init_divider(unsigned int div_value);
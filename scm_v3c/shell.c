@@ -0,0 +1,299 @@
+#include "shell.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uart.h"
+
+// Backspace and delete characters, which remove the last character.
+#define SHELL_BACKSPACE 0x08
+#define SHELL_DELETE 0x7F
+
+// Registered parameters.
+static const shell_param_t* g_shell_params[SHELL_MAX_NUM_PARAMS];
+static uint8_t g_shell_num_params = 0;
+
+// Registered actions.
+static const shell_action_t* g_shell_actions[SHELL_MAX_NUM_ACTIONS];
+static uint8_t g_shell_num_actions = 0;
+
+// Status callback.
+static shell_status_cb_t g_shell_status_cb = NULL;
+
+// Command line being received.
+static char g_shell_line[SHELL_MAX_LINE_LENGTH + 1];
+static uint8_t g_shell_line_length = 0;
+
+// Whether the command line being received is too long.
+static bool g_shell_line_overflow = false;
+
+// Return the parameter with the given name or NULL.
+static const shell_param_t* shell_find_param(const char* name) {
+    uint8_t i = 0;
+
+    for (i = 0; i < g_shell_num_params; ++i) {
+        if (strcmp(g_shell_params[i]->name, name) == 0) {
+            return g_shell_params[i];
+        }
+    }
+    return NULL;
+}
+
+// Return the action with the given name or NULL.
+static const shell_action_t* shell_find_action(const char* name) {
+    uint8_t i = 0;
+
+    for (i = 0; i < g_shell_num_actions; ++i) {
+        if (strcmp(g_shell_actions[i]->name, name) == 0) {
+            return g_shell_actions[i];
+        }
+    }
+    return NULL;
+}
+
+// Read the value of the parameter.
+static int32_t shell_read_param(const shell_param_t* param) {
+    switch (param->type) {
+        case SHELL_PARAM_TYPE_BOOL:
+            return *(const bool*)param->value;
+        case SHELL_PARAM_TYPE_UINT8:
+            return *(const uint8_t*)param->value;
+        case SHELL_PARAM_TYPE_UINT16:
+            return *(const uint16_t*)param->value;
+        case SHELL_PARAM_TYPE_UINT32:
+            return (int32_t)(*(const uint32_t*)param->value);
+        case SHELL_PARAM_TYPE_INT32:
+            return *(const int32_t*)param->value;
+        default:
+            return 0;
+    }
+}
+
+// Write the value of the parameter.
+static void shell_write_param(const shell_param_t* param, const int32_t value) {
+    switch (param->type) {
+        case SHELL_PARAM_TYPE_BOOL:
+            *(bool*)param->value = value != 0;
+            break;
+        case SHELL_PARAM_TYPE_UINT8:
+            *(uint8_t*)param->value = value;
+            break;
+        case SHELL_PARAM_TYPE_UINT16:
+            *(uint16_t*)param->value = value;
+            break;
+        case SHELL_PARAM_TYPE_UINT32:
+            *(uint32_t*)param->value = value;
+            break;
+        case SHELL_PARAM_TYPE_INT32:
+            *(int32_t*)param->value = value;
+            break;
+        default:
+            break;
+    }
+}
+
+// Print the parameter as name=value.
+static void shell_print_param(const char* prefix, const shell_param_t* param) {
+    if (param->type == SHELL_PARAM_TYPE_UINT32) {
+        printf("%s%s=%u\n", prefix, param->name,
+               (uint32_t)shell_read_param(param));
+    } else {
+        printf("%s%s=%d\n", prefix, param->name, shell_read_param(param));
+    }
+}
+
+// Parse a decimal or hexadecimal value. Return whether the value is a number
+// within the range of the parameter.
+static bool shell_parse_value(const shell_param_t* param, const char* string,
+                              int32_t* value) {
+    char* end = NULL;
+
+    if (param->type == SHELL_PARAM_TYPE_UINT32) {
+        if (string[0] == '-') {
+            return false;
+        }
+        *value = (int32_t)strtoul(string, &end, 0);
+        if (*end != '\0' || (uint32_t)*value < (uint32_t)param->min ||
+            (uint32_t)*value > (uint32_t)param->max) {
+            return false;
+        }
+        return true;
+    }
+
+    *value = strtol(string, &end, 0);
+    return *end == '\0' && *value >= param->min && *value <= param->max;
+}
+
+// Print the parameters and the actions.
+static void shell_help(void) {
+    uint8_t i = 0;
+
+    for (i = 0; i < g_shell_num_params; ++i) {
+        if (g_shell_params[i]->type == SHELL_PARAM_TYPE_UINT32) {
+            printf("param %s [%u, %u]\n", g_shell_params[i]->name,
+                   (uint32_t)g_shell_params[i]->min,
+                   (uint32_t)g_shell_params[i]->max);
+        } else {
+            printf("param %s [%d, %d]\n", g_shell_params[i]->name,
+                   g_shell_params[i]->min, g_shell_params[i]->max);
+        }
+    }
+    for (i = 0; i < g_shell_num_actions; ++i) {
+        printf("action %s\n", g_shell_actions[i]->usage != NULL
+                                  ? g_shell_actions[i]->usage
+                                  : g_shell_actions[i]->name);
+    }
+    printf("OK\n");
+}
+
+// Print the parameter or all parameters.
+static void shell_get(const uint8_t argc, const char* argv[]) {
+    const shell_param_t* param = NULL;
+    uint8_t i = 0;
+
+    if (argc == 1) {
+        for (i = 0; i < g_shell_num_params; ++i) {
+            shell_print_param("", g_shell_params[i]);
+        }
+        printf("OK\n");
+        return;
+    }
+
+    param = shell_find_param(argv[1]);
+    if (param == NULL) {
+        printf("ERR unknown parameter %s\n", argv[1]);
+        return;
+    }
+    shell_print_param("OK ", param);
+}
+
+// Set the parameter.
+static void shell_set(const uint8_t argc, const char* argv[]) {
+    const shell_param_t* param = NULL;
+    int32_t previous_value = 0;
+    int32_t value = 0;
+
+    if (argc != 3) {
+        printf("ERR usage: set <name> <value>\n");
+        return;
+    }
+
+    param = shell_find_param(argv[1]);
+    if (param == NULL) {
+        printf("ERR unknown parameter %s\n", argv[1]);
+        return;
+    }
+    if (!shell_parse_value(param, argv[2], &value)) {
+        printf("ERR invalid value %s\n", argv[2]);
+        return;
+    }
+
+    previous_value = shell_read_param(param);
+    shell_write_param(param, value);
+    if (param->set_cb != NULL && !param->set_cb()) {
+        shell_write_param(param, previous_value);
+        printf("ERR rejected %s\n", argv[2]);
+        return;
+    }
+    shell_print_param("OK ", param);
+}
+
+void shell_init(void) {
+    g_shell_line_length = 0;
+    g_shell_line_overflow = false;
+    uart_enable_interrupt();
+}
+
+bool shell_register_param(const shell_param_t* param) {
+    if (g_shell_num_params >= SHELL_MAX_NUM_PARAMS) {
+        return false;
+    }
+    g_shell_params[g_shell_num_params++] = param;
+    return true;
+}
+
+bool shell_register_action(const shell_action_t* action) {
+    if (g_shell_num_actions >= SHELL_MAX_NUM_ACTIONS) {
+        return false;
+    }
+    g_shell_actions[g_shell_num_actions++] = action;
+    return true;
+}
+
+void shell_set_status_callback(const shell_status_cb_t status_cb) {
+    g_shell_status_cb = status_cb;
+}
+
+uint8_t shell_process(void) {
+    uint8_t num_lines = 0;
+    uint8_t byte = 0;
+
+    while (uart_read_byte(&byte)) {
+        if (byte == '\r' || byte == '\n') {
+            if (g_shell_line_overflow) {
+                printf("ERR line too long\n");
+            } else if (g_shell_line_length > 0) {
+                g_shell_line[g_shell_line_length] = '\0';
+                shell_execute(g_shell_line);
+                ++num_lines;
+            }
+            g_shell_line_length = 0;
+            g_shell_line_overflow = false;
+        } else if (byte == SHELL_BACKSPACE || byte == SHELL_DELETE) {
+            if (g_shell_line_length > 0) {
+                --g_shell_line_length;
+            }
+        } else if (g_shell_line_length < SHELL_MAX_LINE_LENGTH) {
+            g_shell_line[g_shell_line_length++] = byte;
+        } else {
+            g_shell_line_overflow = true;
+        }
+    }
+    return num_lines;
+}
+
+void shell_execute(char* line) {
+    const char* argv[SHELL_MAX_NUM_ARGS];
+    const shell_action_t* action = NULL;
+    uint8_t argc = 0;
+    char* token = NULL;
+
+    // Split the line into arguments at whitespace.
+    token = strtok(line, " \t");
+    while (token != NULL) {
+        if (argc == SHELL_MAX_NUM_ARGS) {
+            printf("ERR too many arguments\n");
+            return;
+        }
+        argv[argc++] = token;
+        token = strtok(NULL, " \t");
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    if (strcmp(argv[0], "help") == 0) {
+        shell_help();
+    } else if (strcmp(argv[0], "get") == 0) {
+        shell_get(argc, argv);
+    } else if (strcmp(argv[0], "set") == 0) {
+        shell_set(argc, argv);
+    } else if (strcmp(argv[0], "status") == 0) {
+        if (g_shell_status_cb != NULL) {
+            g_shell_status_cb();
+        }
+        printf("OK\n");
+    } else {
+        action = shell_find_action(argv[0]);
+        if (action == NULL) {
+            printf("ERR unknown command %s\n", argv[0]);
+        } else if (action->cb(argc, argv)) {
+            printf("OK\n");
+        } else {
+            printf("ERR %s failed\n", argv[0]);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// The shell accepts commands over the UART at run time, so that experiments
+// can be reconfigured without rebuilding and bootloading the firmware. The
+// UART interrupt buffers the received bytes, and the main loop calls
+// shell_process() to execute the complete lines, so the radio and the timers
+// keep running while the commands are received.
+//
+// The application registers parameters, which point to its variables, and
+// actions, which are called with the rest of the command line. The shell
+// understands the following commands, where values are decimal or
+// hexadecimal with a 0x prefix:
+//
+//     help                 list the parameters and the actions
+//     get [name]           print the parameter or all parameters
+//     set <name> <value>   set the parameter
+//     status               call the status callback
+//     <action> [args]      call the action
+//
+// Every command is answered with a line starting with "OK" or "ERR", so that
+// a host script can wait for the result. Since the UART interrupt consumes
+// all received bytes, the blocking uart_in() and scanf() must not be used
+// while the shell is running.
+
+#ifndef __SHELL_H
+#define __SHELL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Maximum length of a command line without the line terminator. Longer lines
+// are discarded.
+#define SHELL_MAX_LINE_LENGTH 63
+
+// Maximum number of arguments of a command line, including the command.
+#define SHELL_MAX_NUM_ARGS 8
+
+// Maximum number of registered parameters.
+#define SHELL_MAX_NUM_PARAMS 16
+
+// Maximum number of registered actions.
+#define SHELL_MAX_NUM_ACTIONS 8
+
+// Parameter type enum.
+typedef enum {
+    SHELL_PARAM_TYPE_BOOL = 0,
+    SHELL_PARAM_TYPE_UINT8 = 1,
+    SHELL_PARAM_TYPE_UINT16 = 2,
+    SHELL_PARAM_TYPE_UINT32 = 3,
+    SHELL_PARAM_TYPE_INT32 = 4,
+} shell_param_type_e;
+
+// Called after a parameter has been set. Return false to reject the value, in
+// which case the previous value is restored.
+typedef bool (*shell_param_set_cb_t)(void);
+
+// Called with the arguments of the action, including the action name. Return
+// whether the action succeeded.
+typedef bool (*shell_action_cb_t)(uint8_t argc, const char* argv[]);
+
+// Called by the status command to print the status.
+typedef void (*shell_status_cb_t)(void);
+
+// Parameter.
+typedef struct {
+    // Name of the parameter.
+    const char* name;
+
+    // Type of the variable.
+    shell_param_type_e type;
+
+    // Variable of the parameter.
+    void* value;
+
+    // Minimum and maximum value, which are unsigned for
+    // SHELL_PARAM_TYPE_UINT32.
+    int32_t min;
+    int32_t max;
+
+    // Callback after the parameter has been set, or NULL.
+    shell_param_set_cb_t set_cb;
+} shell_param_t;
+
+// Action.
+typedef struct {
+    // Name of the action.
+    const char* name;
+
+    // Usage shown by the help command.
+    const char* usage;
+
+    // Callback of the action.
+    shell_action_cb_t cb;
+} shell_action_t;
+
+// Initialize the shell and enable the UART RX interrupt.
+void shell_init(void);
+
+// Register a parameter. The parameter must stay valid. Return false if there
+// are already SHELL_MAX_NUM_PARAMS parameters.
+bool shell_register_param(const shell_param_t* param);
+
+// Register an action. The action must stay valid. Return false if there are
+// already SHELL_MAX_NUM_ACTIONS actions.
+bool shell_register_action(const shell_action_t* action);
+
+// Set the status callback.
+void shell_set_status_callback(shell_status_cb_t status_cb);
+
+// Execute all complete command lines that have been received. Call this
+// periodically from the main loop. Return the number of executed lines.
+uint8_t shell_process(void);
+
+// Execute a command line.
+void shell_execute(char* line);
+
+#endif  // __SHELL_H
@@ -1,67 +1,49 @@
 #include "spi.h"
 
+#include <stddef.h>
+
 #include "Memory_Map.h"
+#include "bitbang.h"
 
 #define CS_PIN 15
 #define CLK_PIN 14
 #define DIN_PIN 13   // Used when reading data from the IMU thus a SCuM input
 #define DATA_PIN 12  // Used when writing to the IMU thus a SCuM output
 
-void spi_write(unsigned char writeByte) {
-    int j;
-    int t = 0;
-    int clk_pin = CLK_PIN;
-    int data_pin = DATA_PIN;
-
-    for (j = 7; j >= 0; j--) {
-        if ((writeByte & (0x01 << j)) != 0) {
-            GPIO_REG__OUTPUT &= ~(1 << clk_pin);  // clock low
-            GPIO_REG__OUTPUT |= 1 << data_pin;    // write a 1
-            GPIO_REG__OUTPUT |= 1 << clk_pin;     // clock high
-        } else {
-            GPIO_REG__OUTPUT &= ~(1 << clk_pin);   // clock low
-            GPIO_REG__OUTPUT &= ~(1 << data_pin);  // write a 0
-            GPIO_REG__OUTPUT |= (1 << clk_pin);    // clock high
-        }
-    }
+// the IMU samples on the rising edge of the clock, which idles high
+static const bitbang_spi_device_t imu_spi_device = {
+    .cs_pin = CS_PIN,
+    .clk_pin = CLK_PIN,
+    .mosi_pin = DATA_PIN,
+    .miso_pin = DIN_PIN,
+    .mode = BITBANG_SPI_MODE_3,
+    .bit_order = BITBANG_MSB_FIRST,
+    .select_delay = 50,
+    .inter_byte_delay = 0,
+};
 
-    GPIO_REG__OUTPUT &= ~(1 << data_pin);  // set data out to 0
+void spi_transfer(const unsigned char* tx, unsigned char* rx,
+                  unsigned int len) {
+    bitbang_spi_transfer(&imu_spi_device, tx, rx, len);
 }
 
+void spi_write(unsigned char writeByte) { spi_transfer(&writeByte, NULL, 1); }
+
 unsigned char spi_read() {
     unsigned char readByte;
-    int j;
-    int t = 0;
-    int clk_pin = CLK_PIN;
-    int din_pin = DIN_PIN;
-    readByte = 0;
-
-    GPIO_REG__OUTPUT &= ~(1 << clk_pin);  // clock low
-
-    for (j = 7; j >= 0; j--) {
-        GPIO_REG__OUTPUT |= (1 << clk_pin);  // clock high
-        readByte |= ((GPIO_REG__INPUT & (1 << din_pin)) >> din_pin) << j;
-        GPIO_REG__OUTPUT &= ~(1 << clk_pin);  // clock low
-    }
 
+    spi_transfer(NULL, &readByte, 1);
     return readByte;
 }
 
 void spi_chip_select() {
-    int t = 0;
-    int dout_pin = DATA_PIN;
-    int cs_pin = CS_PIN;
     // drop chip select low to select the chip
-    GPIO_REG__OUTPUT &= ~(1 << cs_pin);
-    GPIO_REG__OUTPUT &= ~(1 << dout_pin);
-    for (t = 0; t < 50; t++)
-        ;
+    bitbang_spi_select(&imu_spi_device);
 }
 
 void spi_chip_deselect() {
-    int cs_pin = CS_PIN;
     // hold chip select high to deselect the chip
-    GPIO_REG__OUTPUT |= (1 << cs_pin);
+    bitbang_spi_deselect(&imu_spi_device);
 }
 
 void initialize_imu(void) {
@@ -185,13 +167,30 @@ void write_imu_register(unsigned char reg, unsigned char data) {
     spi_chip_deselect();  // raise chip select
 }
 
+void read_imu_registers(unsigned char reg, unsigned char* data,
+                        unsigned int len) {
+    reg &= 0x7F;
+    reg |= 0x80;  // read, the IMU increments the register after every byte
+
+    spi_chip_select();              // drop chip select
+    spi_transfer(&reg, NULL, 1);    // write the first register to the port
+    spi_transfer(NULL, data, len);  // clock out all registers
+    spi_chip_deselect();            // raise chip select
+}
+
+// reads the accelerometer and gyroscope registers, which are consecutive and
+// MSB first, in a single burst
 void read_all_imu_data(imu_data_t* imu_measurement) {
-    imu_measurement->acc_x.value = read_acc_x();
-    imu_measurement->acc_y.value = read_acc_y();
-    imu_measurement->acc_z.value = read_acc_z();
-    imu_measurement->gyro_x.value = read_gyro_x();
-    imu_measurement->gyro_y.value = read_gyro_y();
-    imu_measurement->gyro_z.value = read_gyro_z();
+    unsigned char data[IMU_DATA_LENGTH];
+
+    read_imu_registers(IMU_ACC_X_REGISTER, data, IMU_DATA_LENGTH);
+
+    imu_measurement->acc_x.value = (data[0] << 8) | data[1];
+    imu_measurement->acc_y.value = (data[2] << 8) | data[3];
+    imu_measurement->acc_z.value = (data[4] << 8) | data[5];
+    imu_measurement->gyro_x.value = (data[6] << 8) | data[7];
+    imu_measurement->gyro_y.value = (data[8] << 8) | data[9];
+    imu_measurement->gyro_z.value = (data[10] << 8) | data[11];
 }
 
 void log_imu_data(imu_data_t* imu_measurement) {
@@ -1,5 +1,13 @@
+#ifndef __SPI_H
+#define __SPI_H
+
 #include <stdint.h>
 
+// first accelerometer register and number of accelerometer and gyroscope
+// data bytes
+#define IMU_ACC_X_REGISTER 0x2D
+#define IMU_DATA_LENGTH 12
+
 typedef union int16_buff_t {
     int16_t value;
     uint8_t bytes[2];
@@ -18,6 +26,11 @@ unsigned int read_gyro_x();
 unsigned int read_gyro_y();
 unsigned int read_gyro_z();
 
+// transfers len bytes MSB-first while chip select is held. tx may be NULL to
+// send zeros and rx may be NULL to discard the received bytes.
+void spi_transfer(const unsigned char* tx, unsigned char* rx,
+                  unsigned int len);
+
 void spi_write(unsigned char writeByte);
 
 unsigned char spi_read();
@@ -28,6 +41,8 @@ void spi_chip_deselect();
 
 void initialize_imu(void);
 
+unsigned int read_acc_x();
+
 unsigned int read_acc_y();
 
 unsigned int read_acc_z();
@@ -38,6 +53,11 @@ unsigned char read_imu_register(unsigned char reg);
 
 void write_imu_register(unsigned char reg, unsigned char data);
 
+void read_imu_registers(unsigned char reg, unsigned char* data,
+                        unsigned int len);
+
 void read_all_imu_data(imu_data_t* imu_measurement);
 
 void log_imu_data(imu_data_t* imu_measurement);
+
+#endif  // __SPI_H
@@ -0,0 +1,362 @@
+#include "sram_march.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+// Initial stack pointer, which is the first entry of the vector table.
+#define SRAM_MARCH_INITIAL_SP (*(const uint32_t*)0x00000000)
+
+// Number of words accessed per iteration of the unrolled loops.
+#define SRAM_MARCH_UNROLL 4
+
+// End of the zero-initialized data, which is the end of all statically
+// allocated data including the stack and the heap.
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit;
+
+// Read the word at the address, record an error if it does not equal the
+// expected value, and write the new value.
+#define SRAM_MARCH_READ_WRITE(address, expected, value)             \
+    do {                                                            \
+        const uint32_t actual = *(address);                         \
+        if (actual != (expected)) {                                 \
+            sram_march_record_error((address), (expected), actual); \
+        }                                                           \
+        *(address) = (value);                                       \
+    } while (0)
+
+// Read the word at the address and record an error if it does not equal the
+// expected value.
+#define SRAM_MARCH_READ(address, expected)                          \
+    do {                                                            \
+        const uint32_t actual = *(address);                         \
+        if (actual != (expected)) {                                 \
+            sram_march_record_error((address), (expected), actual); \
+        }                                                           \
+    } while (0)
+
+// March operation enum.
+typedef enum {
+    // No operation.
+    SRAM_MARCH_OP_NONE = 0,
+    // Read or write the background.
+    SRAM_MARCH_OP_0 = 1,
+    // Read or write the inverted background.
+    SRAM_MARCH_OP_1 = 2,
+} sram_march_op_e;
+
+// March element, which applies the read and then the write operation to each
+// word in ascending or descending address order.
+typedef struct {
+    // If true, the addresses are traversed in descending order.
+    bool descending;
+
+    // Read operation.
+    sram_march_op_e read;
+
+    // Write operation.
+    sram_march_op_e write;
+} sram_march_element_t;
+
+// March algorithm.
+typedef struct {
+    // Algorithm name.
+    const char* name;
+
+    // March elements.
+    const sram_march_element_t* elements;
+
+    // Number of march elements.
+    uint8_t num_elements;
+} sram_march_algorithm_t;
+
+// March C- elements.
+static const sram_march_element_t g_sram_march_c_minus_elements[] = {
+    {false, SRAM_MARCH_OP_NONE, SRAM_MARCH_OP_0},
+    {false, SRAM_MARCH_OP_0, SRAM_MARCH_OP_1},
+    {false, SRAM_MARCH_OP_1, SRAM_MARCH_OP_0},
+    {true, SRAM_MARCH_OP_0, SRAM_MARCH_OP_1},
+    {true, SRAM_MARCH_OP_1, SRAM_MARCH_OP_0},
+    {false, SRAM_MARCH_OP_0, SRAM_MARCH_OP_NONE},
+};
+
+// March X elements.
+static const sram_march_element_t g_sram_march_x_elements[] = {
+    {false, SRAM_MARCH_OP_NONE, SRAM_MARCH_OP_0},
+    {false, SRAM_MARCH_OP_0, SRAM_MARCH_OP_1},
+    {true, SRAM_MARCH_OP_1, SRAM_MARCH_OP_0},
+    {false, SRAM_MARCH_OP_0, SRAM_MARCH_OP_NONE},
+};
+
+// March algorithms, indexed by sram_march_algorithm_e.
+static const sram_march_algorithm_t
+    g_sram_march_algorithms[SRAM_MARCH_NUM_ALGORITHMS] = {
+        {"March C-", g_sram_march_c_minus_elements,
+         sizeof(g_sram_march_c_minus_elements) /
+             sizeof(g_sram_march_c_minus_elements[0])},
+        {"March X", g_sram_march_x_elements,
+         sizeof(g_sram_march_x_elements) / sizeof(g_sram_march_x_elements[0])},
+};
+
+// Data backgrounds.
+static const uint32_t g_sram_march_backgrounds[SRAM_MARCH_NUM_BACKGROUNDS] = {
+    0x00000000, 0x55555555, 0x33333333, 0x0F0F0F0F, 0x00FF00FF, 0x0000FFFF,
+};
+
+// Result of the running test.
+static sram_march_result_t* g_sram_march_result = NULL;
+
+// Record a failed read. This is kept out of line to keep the march loops
+// small.
+static void sram_march_record_error(volatile uint32_t* address,
+                                    const uint32_t expected,
+                                    const uint32_t actual) {
+    sram_march_result_t* result = g_sram_march_result;
+    const uint32_t block =
+        ((uint32_t)address - SRAM_MARCH_DATA_MEMORY_BASE) /
+        SRAM_MARCH_BLOCK_SIZE;
+
+    if (result->num_errors == 0) {
+        result->first_error_address = (uint32_t)address;
+        result->first_error_expected = expected;
+        result->first_error_actual = actual;
+    }
+    ++result->num_errors;
+    result->failed_blocks[block / 32] |= 1UL << (block % 32);
+}
+
+// Write the value to all words in ascending order.
+static void sram_march_write(volatile uint32_t* start,
+                             volatile uint32_t* end, const uint32_t value) {
+    volatile uint32_t* address = start;
+    while (end - address >= SRAM_MARCH_UNROLL) {
+        address[0] = value;
+        address[1] = value;
+        address[2] = value;
+        address[3] = value;
+        address += SRAM_MARCH_UNROLL;
+    }
+    while (address < end) {
+        *address++ = value;
+    }
+}
+
+// Read and verify all words in ascending order.
+static void sram_march_read(volatile uint32_t* start, volatile uint32_t* end,
+                            const uint32_t expected) {
+    volatile uint32_t* address = start;
+    while (end - address >= SRAM_MARCH_UNROLL) {
+        SRAM_MARCH_READ(&address[0], expected);
+        SRAM_MARCH_READ(&address[1], expected);
+        SRAM_MARCH_READ(&address[2], expected);
+        SRAM_MARCH_READ(&address[3], expected);
+        address += SRAM_MARCH_UNROLL;
+    }
+    while (address < end) {
+        SRAM_MARCH_READ(address, expected);
+        ++address;
+    }
+}
+
+// Read, verify, and write all words in ascending order.
+static void sram_march_read_write_up(volatile uint32_t* start,
+                                     volatile uint32_t* end,
+                                     const uint32_t expected,
+                                     const uint32_t value) {
+    volatile uint32_t* address = start;
+    while (end - address >= SRAM_MARCH_UNROLL) {
+        SRAM_MARCH_READ_WRITE(&address[0], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[1], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[2], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[3], expected, value);
+        address += SRAM_MARCH_UNROLL;
+    }
+    while (address < end) {
+        SRAM_MARCH_READ_WRITE(address, expected, value);
+        ++address;
+    }
+}
+
+// Read, verify, and write all words in descending order.
+static void sram_march_read_write_down(volatile uint32_t* start,
+                                       volatile uint32_t* end,
+                                       const uint32_t expected,
+                                       const uint32_t value) {
+    volatile uint32_t* address = end;
+    while (address - start >= SRAM_MARCH_UNROLL) {
+        address -= SRAM_MARCH_UNROLL;
+        SRAM_MARCH_READ_WRITE(&address[3], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[2], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[1], expected, value);
+        SRAM_MARCH_READ_WRITE(&address[0], expected, value);
+    }
+    while (address > start) {
+        --address;
+        SRAM_MARCH_READ_WRITE(address, expected, value);
+    }
+}
+
+// Apply the march element to the range.
+static void sram_march_apply_element(const sram_march_element_t* element,
+                                     const sram_march_range_t* range,
+                                     const uint32_t background) {
+    const uint32_t expected =
+        element->read == SRAM_MARCH_OP_1 ? ~background : background;
+    const uint32_t value =
+        element->write == SRAM_MARCH_OP_1 ? ~background : background;
+
+    if (element->read == SRAM_MARCH_OP_NONE) {
+        sram_march_write(range->start, range->end, value);
+    } else if (element->write == SRAM_MARCH_OP_NONE) {
+        sram_march_read(range->start, range->end, expected);
+    } else if (element->descending) {
+        sram_march_read_write_down(range->start, range->end, expected, value);
+    } else {
+        sram_march_read_write_up(range->start, range->end, expected, value);
+    }
+}
+
+// Clip the ranges to the data memory and split them around the stack. Return
+// the number of clipped ranges.
+static uint8_t sram_march_clip_ranges(const sram_march_range_t* ranges,
+                                      const uint8_t num_ranges,
+                                      sram_march_range_t* clipped_ranges) {
+    uint32_t* const memory_start = (uint32_t*)SRAM_MARCH_DATA_MEMORY_BASE;
+    uint32_t* const memory_end =
+        memory_start + SRAM_MARCH_DATA_MEMORY_SIZE / sizeof(uint32_t);
+    uint32_t* const stack_end = (uint32_t*)SRAM_MARCH_INITIAL_SP;
+    uint32_t* const stack_start =
+        stack_end - SRAM_MARCH_STACK_SIZE / sizeof(uint32_t);
+    uint8_t num_clipped_ranges = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < num_ranges && i < SRAM_MARCH_MAX_RANGES; ++i) {
+        uint32_t* start =
+            ranges[i].start > memory_start ? ranges[i].start : memory_start;
+        uint32_t* end = ranges[i].end < memory_end ? ranges[i].end : memory_end;
+
+        // Range below the stack.
+        if (start < stack_start) {
+            clipped_ranges[num_clipped_ranges].start = start;
+            clipped_ranges[num_clipped_ranges].end =
+                end < stack_start ? end : stack_start;
+            ++num_clipped_ranges;
+        }
+
+        // Range above the stack.
+        if (end > stack_end) {
+            clipped_ranges[num_clipped_ranges].start =
+                start > stack_end ? start : stack_end;
+            clipped_ranges[num_clipped_ranges].end = end;
+            ++num_clipped_ranges;
+        }
+    }
+
+    // Drop any empty ranges.
+    for (i = 0; i < num_clipped_ranges;) {
+        if (clipped_ranges[i].start >= clipped_ranges[i].end) {
+            --num_clipped_ranges;
+            memmove(&clipped_ranges[i], &clipped_ranges[i + 1],
+                    (num_clipped_ranges - i) * sizeof(sram_march_range_t));
+        } else {
+            ++i;
+        }
+    }
+    return num_clipped_ranges;
+}
+
+void sram_march_get_free_range(sram_march_range_t* range) {
+    range->start = &Image$$RW_IRAM1$$ZI$$Limit;
+    range->end = (uint32_t*)(SRAM_MARCH_DATA_MEMORY_BASE +
+                             SRAM_MARCH_DATA_MEMORY_SIZE);
+}
+
+bool sram_march_run(const sram_march_algorithm_e algorithm,
+                    const sram_march_range_t* ranges, const uint8_t num_ranges,
+                    uint8_t num_backgrounds, sram_march_result_t* result) {
+    sram_march_range_t clipped_ranges[2 * SRAM_MARCH_MAX_RANGES];
+    const sram_march_algorithm_t* march = NULL;
+    const sram_march_element_t* element = NULL;
+    uint8_t num_clipped_ranges = 0;
+    uint32_t start_count = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+    int8_t k = 0;
+
+    memset(result, 0, sizeof(sram_march_result_t));
+    if (algorithm < 0 || algorithm >= SRAM_MARCH_NUM_ALGORITHMS) {
+        return false;
+    }
+    march = &g_sram_march_algorithms[algorithm];
+    if (num_backgrounds > SRAM_MARCH_NUM_BACKGROUNDS) {
+        num_backgrounds = SRAM_MARCH_NUM_BACKGROUNDS;
+    }
+
+    num_clipped_ranges =
+        sram_march_clip_ranges(ranges, num_ranges, clipped_ranges);
+    g_sram_march_result = result;
+    start_count = RFTIMER_REG__COUNTER;
+
+    for (i = 0; i < num_backgrounds; ++i) {
+        for (j = 0; j < march->num_elements; ++j) {
+            element = &march->elements[j];
+
+            // A descending element also traverses the ranges in descending
+            // order.
+            if (element->descending) {
+                for (k = num_clipped_ranges - 1; k >= 0; --k) {
+                    sram_march_apply_element(element, &clipped_ranges[k],
+                                             g_sram_march_backgrounds[i]);
+                }
+            } else {
+                for (k = 0; k < num_clipped_ranges; ++k) {
+                    sram_march_apply_element(element, &clipped_ranges[k],
+                                             g_sram_march_backgrounds[i]);
+                }
+            }
+        }
+        for (k = 0; k < num_clipped_ranges; ++k) {
+            result->num_words +=
+                clipped_ranges[k].end - clipped_ranges[k].start;
+        }
+    }
+
+    // Wrap-around safe like in isr_profiler_exit().
+    result->duration = RFTIMER_REG__COUNTER - start_count;
+    g_sram_march_result = NULL;
+    return result->num_errors == 0;
+}
+
+bool sram_march_block_failed(const sram_march_result_t* result,
+                             const uint8_t block) {
+    return (result->failed_blocks[block / 32] >> (block % 32)) & 0x1;
+}
+
+void sram_march_print_result(const sram_march_algorithm_e algorithm,
+                             const sram_march_result_t* result) {
+    uint8_t i = 0;
+
+    // Each RF timer tick is 2 us.
+    printf("SRAM %s: %u words, %u errors, %u us\n",
+           algorithm >= 0 && algorithm < SRAM_MARCH_NUM_ALGORITHMS
+               ? g_sram_march_algorithms[algorithm].name
+               : "invalid",
+           result->num_words, result->num_errors, 2 * result->duration);
+    if (result->num_errors == 0) {
+        return;
+    }
+
+    printf("First error @ 0x%08X: expected 0x%08X, read 0x%08X\n",
+           result->first_error_address, result->first_error_expected,
+           result->first_error_actual);
+    printf("Failed 1 kB blocks:");
+    for (i = 0; i < SRAM_MARCH_NUM_BLOCKS; ++i) {
+        if (sram_march_block_failed(result, i)) {
+            printf(" %u", i);
+        }
+    }
+    printf("\n");
+}
@@ -0,0 +1,109 @@
+// The SRAM march test engine runs word-wide March C- and March X tests over
+// ranges of the data memory. Each march element processes one 32-bit word per
+// access with unrolled loops, and the test is repeated for several data
+// backgrounds to detect coupling faults between bits within the same word.
+//
+// The test is destructive, so the tested ranges must not contain any data that
+// is still in use. The stack is always excluded from the tested ranges, and
+// sram_march_get_free_range() returns the data memory above all statically
+// allocated data, which includes the stack and the heap.
+//
+// Failures are recorded in a bitmap with one bit per 1 kB block of the data
+// memory, and the test duration is measured with the RF timer.
+
+#ifndef __SRAM_MARCH_H
+#define __SRAM_MARCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Base address of the data memory.
+#define SRAM_MARCH_DATA_MEMORY_BASE 0x20000000
+
+// Size of the data memory in bytes.
+#define SRAM_MARCH_DATA_MEMORY_SIZE 0x10000
+
+// Stack size in bytes. This must match Stack_Size in cm0dsasm.s.
+#define SRAM_MARCH_STACK_SIZE 0x0800
+
+// Size of a block in the failure bitmap in bytes.
+#define SRAM_MARCH_BLOCK_SIZE 1024
+
+// Number of blocks in the data memory.
+#define SRAM_MARCH_NUM_BLOCKS \
+    (SRAM_MARCH_DATA_MEMORY_SIZE / SRAM_MARCH_BLOCK_SIZE)
+
+// Number of data backgrounds. The backgrounds are 0x00000000, 0x55555555,
+// 0x33333333, 0x0F0F0F0F, 0x00FF00FF, and 0x0000FFFF, so that every pair of
+// bits within a word is written with both equal and different values.
+#define SRAM_MARCH_NUM_BACKGROUNDS 6
+
+// Maximum number of ranges per test.
+#define SRAM_MARCH_MAX_RANGES 4
+
+// March algorithm enum.
+typedef enum {
+    // March C-: {(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); (r0)}.
+    // Detects stuck-at, transition, address decoder, and coupling faults.
+    SRAM_MARCH_C_MINUS = 0,
+    // March X: {(w0); up(r0,w1); down(r1,w0); (r0)}. Detects stuck-at,
+    // transition, address decoder, and inversion coupling faults.
+    SRAM_MARCH_X = 1,
+    SRAM_MARCH_NUM_ALGORITHMS = 2,
+} sram_march_algorithm_e;
+
+// Memory range [start, end) to test.
+typedef struct {
+    // First word of the range.
+    uint32_t* start;
+
+    // Word after the last word of the range.
+    uint32_t* end;
+} sram_march_range_t;
+
+// Test result.
+typedef struct {
+    // Number of words that were tested, including all backgrounds.
+    uint32_t num_words;
+
+    // Number of failed reads.
+    uint32_t num_errors;
+
+    // Address of the first failed read.
+    uint32_t first_error_address;
+
+    // Expected value of the first failed read.
+    uint32_t first_error_expected;
+
+    // Actual value of the first failed read.
+    uint32_t first_error_actual;
+
+    // Bitmap of the failed blocks. Bit i % 32 of word i / 32 is set if block i
+    // had a failed read.
+    uint32_t failed_blocks[(SRAM_MARCH_NUM_BLOCKS + 31) / 32];
+
+    // Test duration in RF timer ticks.
+    uint32_t duration;
+} sram_march_result_t;
+
+// Get the data memory range above all statically allocated data.
+void sram_march_get_free_range(sram_march_range_t* range);
+
+// Run the march test over the given ranges with the first num_backgrounds
+// data backgrounds. The ranges should be in ascending address order. They are
+// clipped to the data memory, and the stack is skipped. The result must not be
+// located within the tested ranges, and the RF timer must be running for the
+// duration to be measured. Return whether the test passed.
+bool sram_march_run(sram_march_algorithm_e algorithm,
+                    const sram_march_range_t* ranges, uint8_t num_ranges,
+                    uint8_t num_backgrounds, sram_march_result_t* result);
+
+// Return whether the given block failed.
+bool sram_march_block_failed(const sram_march_result_t* result,
+                             uint8_t block);
+
+// Print the test result.
+void sram_march_print_result(sram_march_algorithm_e algorithm,
+                             const sram_march_result_t* result);
+
+#endif  // __SRAM_MARCH_H
@@ -0,0 +1,338 @@
+#include "temp_comp.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "scm3c_hw_interface.h"
+
+// Minimum code values, indexed by temp_comp_code_e.
+static const int32_t g_temp_comp_min_codes[TEMP_COMP_NUM_CODES] = {0, 0, 0};
+
+// Maximum code values, indexed by temp_comp_code_e.
+static const int32_t g_temp_comp_max_codes[TEMP_COMP_NUM_CODES] = {
+    INT16_MAX, 31, 31};
+
+// Compensation table.
+static temp_comp_table_t g_temp_comp_table;
+
+// Whether the table has been initialized or loaded.
+static bool g_temp_comp_initialized = false;
+
+// Whether the codes should be applied on the next update regardless of the
+// hysteresis.
+static bool g_temp_comp_force_update = false;
+
+// Currently applied codes.
+static temp_comp_codes_t g_temp_comp_applied;
+
+// Temperature estimate when the codes were last applied.
+static uint32_t g_temp_comp_applied_temperature = 0;
+
+// Shift of the temperature estimate caused by the applied 2 MHz RC code.
+static int32_t g_temp_comp_rc2m_shift = 0;
+
+// Temperature source or NULL for estimate_temperature_2M_32k().
+static temp_comp_temperature_source_t g_temp_comp_temperature_source = NULL;
+
+// Return the absolute difference between two temperature estimates.
+static inline uint32_t temp_comp_distance(const uint32_t a, const uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Convert an offset with fractional bits into a code offset, rounding to the
+// nearest code.
+static inline int32_t temp_comp_round_offset(const int32_t offset) {
+    const int32_t half = 1 << (TEMP_COMP_OFFSET_FRACTIONAL_BITS - 1);
+    return (offset >= 0 ? offset + half : offset - half) /
+           (1 << TEMP_COMP_OFFSET_FRACTIONAL_BITS);
+}
+
+// Return the index of the point closest to the temperature estimate.
+static uint8_t temp_comp_closest_point(const uint32_t temperature) {
+    uint8_t closest = 0;
+    uint8_t i = 0;
+
+    for (i = 1; i < g_temp_comp_table.num_points; ++i) {
+        if (temp_comp_distance(g_temp_comp_table.points[i].temperature,
+                               temperature) <
+            temp_comp_distance(g_temp_comp_table.points[closest].temperature,
+                               temperature)) {
+            closest = i;
+        }
+    }
+    return closest;
+}
+
+// Insert a new point at the temperature estimate, keeping the points in
+// ascending temperature order.
+static void temp_comp_insert_point(const uint32_t temperature,
+                                   const int32_t* offsets) {
+    temp_comp_point_t* point = NULL;
+    uint8_t index = 0;
+    uint8_t i = 0;
+
+    while (index < g_temp_comp_table.num_points &&
+           g_temp_comp_table.points[index].temperature < temperature) {
+        ++index;
+    }
+    memmove(&g_temp_comp_table.points[index + 1],
+            &g_temp_comp_table.points[index],
+            (g_temp_comp_table.num_points - index) * sizeof(temp_comp_point_t));
+    ++g_temp_comp_table.num_points;
+
+    point = &g_temp_comp_table.points[index];
+    point->temperature = temperature;
+    for (i = 0; i < TEMP_COMP_NUM_CODES; ++i) {
+        point->offsets[i] = offsets[i];
+    }
+    point->weight = 1;
+}
+
+// Average the observed offsets into the point.
+static void temp_comp_merge_point(temp_comp_point_t* point,
+                                  const uint32_t temperature,
+                                  const int32_t* offsets) {
+    const int32_t weight = point->weight;
+    uint8_t i = 0;
+
+    // The point moves towards the observed temperature, which is closer to
+    // this point than to its neighbors, so the points stay sorted.
+    point->temperature += ((int32_t)(temperature - point->temperature)) /
+                          (weight + 1);
+    for (i = 0; i < TEMP_COMP_NUM_CODES; ++i) {
+        point->offsets[i] =
+            (point->offsets[i] * weight + offsets[i]) / (weight + 1);
+    }
+    if (point->weight < TEMP_COMP_MAX_WEIGHT) {
+        ++point->weight;
+    }
+}
+
+// Apply the codes that differ from the currently applied codes. Return whether
+// the 2 MHz RC code was changed.
+static bool temp_comp_apply_codes(const temp_comp_codes_t* codes) {
+    const int32_t* applied = g_temp_comp_applied.codes;
+    bool rc2m_changed = false;
+
+    // Batch all tuning updates into a single scan chain write
+    asc_begin();
+
+    if (codes->codes[TEMP_COMP_CODE_LC] != applied[TEMP_COMP_CODE_LC]) {
+        LC_monotonic(codes->codes[TEMP_COMP_CODE_LC]);
+    }
+
+    if (codes->codes[TEMP_COMP_CODE_RC2M_FINE] !=
+        applied[TEMP_COMP_CODE_RC2M_FINE]) {
+        set_2M_RC_frequency(31, 31, scm3c_hw_interface_get_RC2M_coarse(),
+                            codes->codes[TEMP_COMP_CODE_RC2M_FINE],
+                            scm3c_hw_interface_get_RC2M_superfine());
+        scm3c_hw_interface_set_RC2M_fine(
+            codes->codes[TEMP_COMP_CODE_RC2M_FINE]);
+        rc2m_changed = true;
+    }
+
+    if (codes->codes[TEMP_COMP_CODE_IF_FINE] !=
+        applied[TEMP_COMP_CODE_IF_FINE]) {
+        set_IF_clock_frequency(scm3c_hw_interface_get_IF_coarse(),
+                               codes->codes[TEMP_COMP_CODE_IF_FINE], 0);
+        scm3c_hw_interface_set_IF_fine(codes->codes[TEMP_COMP_CODE_IF_FINE]);
+    }
+
+    asc_commit();
+
+    g_temp_comp_applied = *codes;
+    return rc2m_changed;
+}
+
+void temp_comp_init(const temp_comp_codes_t* reference) {
+    const int32_t offsets[TEMP_COMP_NUM_CODES] = {0};
+
+    memset(&g_temp_comp_table, 0, sizeof(g_temp_comp_table));
+    g_temp_comp_table.reference = *reference;
+    g_temp_comp_applied = *reference;
+    g_temp_comp_rc2m_shift = 0;
+    g_temp_comp_applied_temperature = temp_comp_measure_temperature();
+
+    // The reference point is trusted as much as a fully averaged point.
+    temp_comp_insert_point(g_temp_comp_applied_temperature, offsets);
+    g_temp_comp_table.points[0].weight = TEMP_COMP_MAX_WEIGHT;
+
+    g_temp_comp_initialized = true;
+    g_temp_comp_force_update = false;
+}
+
+bool temp_comp_load_table(const temp_comp_table_t* table) {
+    uint8_t i = 0;
+
+    if (table->num_points > TEMP_COMP_MAX_NUM_POINTS) {
+        return false;
+    }
+
+    // Interpolating between points with equal temperatures would divide by
+    // zero.
+    for (i = 1; i < table->num_points; ++i) {
+        if (table->points[i].temperature <= table->points[i - 1].temperature) {
+            return false;
+        }
+    }
+
+    g_temp_comp_table = *table;
+    g_temp_comp_applied = table->reference;
+    g_temp_comp_rc2m_shift = 0;
+    g_temp_comp_initialized = true;
+    g_temp_comp_force_update = true;
+    return true;
+}
+
+const temp_comp_table_t* temp_comp_get_table(void) {
+    return &g_temp_comp_table;
+}
+
+const temp_comp_codes_t* temp_comp_get_applied_codes(void) {
+    return &g_temp_comp_applied;
+}
+
+void temp_comp_set_temperature_source(
+    const temp_comp_temperature_source_t source) {
+    g_temp_comp_temperature_source = source;
+    g_temp_comp_rc2m_shift = 0;
+}
+
+uint32_t temp_comp_measure_temperature(void) {
+    if (g_temp_comp_temperature_source != NULL) {
+        return g_temp_comp_temperature_source();
+    }
+    return estimate_temperature_2M_32k() - g_temp_comp_rc2m_shift;
+}
+
+void temp_comp_learn(const uint32_t temperature,
+                     const temp_comp_codes_t* codes) {
+    int32_t offsets[TEMP_COMP_NUM_CODES];
+    uint8_t closest = 0;
+    bool rc2m_changed = false;
+    uint8_t i = 0;
+
+    if (!g_temp_comp_initialized) {
+        return;
+    }
+
+    for (i = 0; i < TEMP_COMP_NUM_CODES; ++i) {
+        offsets[i] = (codes->codes[i] - g_temp_comp_table.reference.codes[i])
+                     << TEMP_COMP_OFFSET_FRACTIONAL_BITS;
+    }
+
+    closest = temp_comp_closest_point(temperature);
+    if (g_temp_comp_table.num_points == 0 ||
+        (g_temp_comp_table.num_points < TEMP_COMP_MAX_NUM_POINTS &&
+         temp_comp_distance(g_temp_comp_table.points[closest].temperature,
+                            temperature) >= TEMP_COMP_MIN_POINT_SPACING)) {
+        temp_comp_insert_point(temperature, offsets);
+    } else {
+        temp_comp_merge_point(&g_temp_comp_table.points[closest], temperature,
+                              offsets);
+    }
+
+    // The learned codes have been applied by the application, so measure
+    // the new temperature estimate shift if the 2 MHz RC code changed.
+    rc2m_changed = codes->codes[TEMP_COMP_CODE_RC2M_FINE] !=
+                   g_temp_comp_applied.codes[TEMP_COMP_CODE_RC2M_FINE];
+    g_temp_comp_applied = *codes;
+    g_temp_comp_applied_temperature = temperature;
+    if (rc2m_changed && g_temp_comp_temperature_source == NULL) {
+        g_temp_comp_rc2m_shift = estimate_temperature_2M_32k() - temperature;
+    }
+}
+
+void temp_comp_get_codes(const uint32_t temperature,
+                         temp_comp_codes_t* codes) {
+    const temp_comp_point_t* points = g_temp_comp_table.points;
+    const uint8_t num_points = g_temp_comp_table.num_points;
+    int32_t offset = 0;
+    uint8_t segment = 0;
+    uint8_t i = 0;
+
+    // Find the segment containing the temperature, or the outermost segment
+    // for extrapolation.
+    while (segment + 2 < num_points &&
+           points[segment + 1].temperature <= temperature) {
+        ++segment;
+    }
+
+    for (i = 0; i < TEMP_COMP_NUM_CODES; ++i) {
+        if (num_points == 0) {
+            offset = 0;
+        } else if (num_points == 1) {
+            offset = points[0].offsets[i];
+        } else {
+            offset = points[segment].offsets[i] +
+                     (int32_t)((int64_t)(points[segment + 1].offsets[i] -
+                                         points[segment].offsets[i]) *
+                               ((int32_t)(temperature -
+                                          points[segment].temperature)) /
+                               (int32_t)(points[segment + 1].temperature -
+                                         points[segment].temperature));
+        }
+
+        codes->codes[i] = g_temp_comp_table.reference.codes[i] +
+                          temp_comp_round_offset(offset);
+        if (codes->codes[i] < g_temp_comp_min_codes[i]) {
+            codes->codes[i] = g_temp_comp_min_codes[i];
+        }
+        if (codes->codes[i] > g_temp_comp_max_codes[i]) {
+            codes->codes[i] = g_temp_comp_max_codes[i];
+        }
+    }
+}
+
+bool temp_comp_update(void) {
+    temp_comp_codes_t codes;
+    uint32_t temperature = 0;
+
+    if (!g_temp_comp_initialized) {
+        return false;
+    }
+
+    temperature = temp_comp_measure_temperature();
+    if (!g_temp_comp_force_update &&
+        temp_comp_distance(temperature, g_temp_comp_applied_temperature) <
+            TEMP_COMP_HYSTERESIS) {
+        return false;
+    }
+    g_temp_comp_force_update = false;
+    g_temp_comp_applied_temperature = temperature;
+
+    temp_comp_get_codes(temperature, &codes);
+    if (memcmp(&codes, &g_temp_comp_applied, sizeof(codes)) == 0) {
+        return false;
+    }
+
+    // The temperature does not change while applying the codes, so the
+    // difference to the new estimate is the shift caused by the 2 MHz RC code.
+    if (temp_comp_apply_codes(&codes) &&
+        g_temp_comp_temperature_source == NULL) {
+        g_temp_comp_rc2m_shift = estimate_temperature_2M_32k() - temperature;
+    }
+    return true;
+}
+
+void temp_comp_print_table(void) {
+    const temp_comp_point_t* point = NULL;
+    uint8_t i = 0;
+
+    printf("TEMPCOMP ref LC=%d RC2M=%d IF=%d shift=%d\n",
+           g_temp_comp_table.reference.codes[TEMP_COMP_CODE_LC],
+           g_temp_comp_table.reference.codes[TEMP_COMP_CODE_RC2M_FINE],
+           g_temp_comp_table.reference.codes[TEMP_COMP_CODE_IF_FINE],
+           g_temp_comp_rc2m_shift);
+    for (i = 0; i < g_temp_comp_table.num_points; ++i) {
+        point = &g_temp_comp_table.points[i];
+
+        // The offsets are printed in 1/16 codes.
+        printf("TEMPCOMP T=%u w=%u LC=%d RC2M=%d IF=%d\n", point->temperature,
+               point->weight, point->offsets[TEMP_COMP_CODE_LC],
+               point->offsets[TEMP_COMP_CODE_RC2M_FINE],
+               point->offsets[TEMP_COMP_CODE_IF_FINE]);
+    }
+}
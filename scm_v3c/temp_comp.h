@@ -0,0 +1,128 @@
+// The temperature compensation learns how the LC, 2 MHz RC, and IF clock
+// codes shift with the temperature estimate from estimate_temperature_2M_32k()
+// and pre-corrects the codes whenever the temperature estimate moves.
+//
+// The table stores the code offsets from the reference codes, i.e., the codes
+// at the calibration temperature, at up to TEMP_COMP_MAX_NUM_POINTS
+// temperature points. The offsets between the points are linearly
+// interpolated, and the offsets outside of the learned temperature range are
+// linearly extrapolated from the outermost segment. The application teaches
+// the table by passing codes that are known to be good at the current
+// temperature, e.g., after correcting the frequency with packets.
+//
+// Since the temperature estimate is the ratio of the 2 MHz RC and the 32 kHz
+// counts, changing the 2 MHz RC code also shifts the temperature estimate.
+// The shift is measured whenever the 2 MHz RC code is changed and removed from
+// all subsequent temperature estimates.
+//
+// Alternatively, the application can set another temperature source, e.g.,
+// health_monitor_get_temperature_millikelvin(), which is not affected by the
+// 2 MHz RC code. The table must be learned with the same source, and the
+// point spacing and hysteresis then apply in the units of that source.
+
+#ifndef __TEMP_COMP_H
+#define __TEMP_COMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Maximum number of temperature points in the table.
+#define TEMP_COMP_MAX_NUM_POINTS 16
+
+// Minimum temperature estimate difference between two points. Codes learned
+// closer than this to an existing point are merged into that point.
+#define TEMP_COMP_MIN_POINT_SPACING 1000
+
+// Minimum temperature estimate change to recompute and apply the codes.
+#define TEMP_COMP_HYSTERESIS 250
+
+// Number of fractional bits of the code offsets.
+#define TEMP_COMP_OFFSET_FRACTIONAL_BITS 4
+
+// Maximum weight of a point. Limiting the weight keeps the points adapting to
+// new observations.
+#define TEMP_COMP_MAX_WEIGHT 8
+
+// Compensated code enum.
+typedef enum {
+    // LC code as passed to LC_monotonic().
+    TEMP_COMP_CODE_LC = 0,
+    // 2 MHz RC fine code.
+    TEMP_COMP_CODE_RC2M_FINE = 1,
+    // IF clock fine code.
+    TEMP_COMP_CODE_IF_FINE = 2,
+    TEMP_COMP_NUM_CODES = 3,
+} temp_comp_code_e;
+
+// Compensated codes, indexed by temp_comp_code_e.
+typedef struct {
+    int32_t codes[TEMP_COMP_NUM_CODES];
+} temp_comp_codes_t;
+
+// Temperature source, which returns the current temperature estimate.
+typedef uint32_t (*temp_comp_temperature_source_t)(void);
+
+// Temperature point.
+typedef struct {
+    // Temperature estimate.
+    uint32_t temperature;
+
+    // Code offsets from the reference codes with
+    // TEMP_COMP_OFFSET_FRACTIONAL_BITS fractional bits.
+    int16_t offsets[TEMP_COMP_NUM_CODES];
+
+    // Number of observations averaged into the point, saturating at
+    // TEMP_COMP_MAX_WEIGHT.
+    uint8_t weight;
+} temp_comp_point_t;
+
+// Compensation table, which can be stored and loaded with the calibration
+// data.
+typedef struct {
+    // Reference codes at the calibration temperature.
+    temp_comp_codes_t reference;
+
+    // Number of valid points.
+    uint8_t num_points;
+
+    // Points in ascending temperature order.
+    temp_comp_point_t points[TEMP_COMP_MAX_NUM_POINTS];
+} temp_comp_table_t;
+
+// Initialize the table with the reference codes at the current temperature.
+// The reference codes should be the calibrated and applied codes.
+void temp_comp_init(const temp_comp_codes_t* reference);
+
+// Load a previously learned table. The codes are applied on the next update.
+// Return false if the table has too many points or the point temperatures are
+// not strictly ascending, in which case the current table is kept.
+bool temp_comp_load_table(const temp_comp_table_t* table);
+
+// Return the table.
+const temp_comp_table_t* temp_comp_get_table(void);
+
+// Return the currently applied codes.
+const temp_comp_codes_t* temp_comp_get_applied_codes(void);
+
+// Set the temperature source. NULL restores the 2 MHz RC and 32 kHz counter
+// ratio from estimate_temperature_2M_32k().
+void temp_comp_set_temperature_source(temp_comp_temperature_source_t source);
+
+// Measure the temperature estimate with the 2 MHz RC shift removed.
+uint32_t temp_comp_measure_temperature(void);
+
+// Learn that the codes are good at the given temperature estimate.
+void temp_comp_learn(uint32_t temperature, const temp_comp_codes_t* codes);
+
+// Get the compensated codes at the given temperature estimate.
+void temp_comp_get_codes(uint32_t temperature, temp_comp_codes_t* codes);
+
+// Measure the temperature and apply the compensated codes if the temperature
+// estimate moved by more than TEMP_COMP_HYSTERESIS since the codes were last
+// applied. Return whether any code was changed.
+bool temp_comp_update(void);
+
+// Print the table.
+void temp_comp_print_table(void);
+
+#endif  // __TEMP_COMP_H
@@ -1,2 +1,42 @@
+#include "uart.h"
 
-void uart_rx_isr() { printf("uart rx interrupt triggered\r\n"); }
\ No newline at end of file
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memory_map.h"
+#include "ring_buffer.h"
+
+// UART interrupt.
+#define UART_INTERRUPT 0x1
+
+// Ring buffer of received bytes. The UART interrupt pushes the bytes, and the
+// main loop pops them.
+static ring_buffer_t g_uart_rx_buffer;
+
+// Number of dropped received bytes.
+static volatile uint32_t g_uart_num_rx_dropped = 0;
+
+void uart_enable_interrupt(void) {
+    ring_buffer_init(&g_uart_rx_buffer);
+    g_uart_num_rx_dropped = 0;
+    ISER = UART_INTERRUPT;
+}
+
+void uart_disable_interrupt(void) { ICER = UART_INTERRUPT; }
+
+bool uart_read_byte(uint8_t* byte) {
+    return ring_buffer_pop(&g_uart_rx_buffer, byte);
+}
+
+size_t uart_num_rx_bytes(void) { return ring_buffer_size(&g_uart_rx_buffer); }
+
+uint32_t uart_get_num_rx_dropped(void) { return g_uart_num_rx_dropped; }
+
+void uart_rx_isr(void) {
+    const uint8_t byte = UART_REG__RX_DATA;
+
+    if (!ring_buffer_push(&g_uart_rx_buffer, &byte)) {
+        ++g_uart_num_rx_dropped;
+    }
+}
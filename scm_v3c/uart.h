@@ -1,6 +1,10 @@
 #ifndef __UART_H
 #define __UART_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 //=========================== define ==========================================
 
 //=========================== typedef =========================================
@@ -9,4 +13,24 @@
 
 //=========================== prototypes ======================================
 
-#endif
\ No newline at end of file
+// Enable the UART RX interrupt. The received bytes are buffered in a ring
+// buffer instead of being read with the blocking uart_in().
+void uart_enable_interrupt(void);
+
+// Disable the UART RX interrupt.
+void uart_disable_interrupt(void);
+
+// Pop the oldest received byte. Return whether a byte was popped.
+bool uart_read_byte(uint8_t* byte);
+
+// Return the number of buffered received bytes.
+size_t uart_num_rx_bytes(void);
+
+// Return the number of received bytes that were dropped because the ring
+// buffer was full.
+uint32_t uart_get_num_rx_dropped(void);
+
+// Push the received byte into the ring buffer.
+void uart_rx_isr(void);
+
+#endif
@@ -0,0 +1,59 @@
+"""Analog scan chain field map for scm4.
+
+Generated by scripts/gen_asc_map.py from asc_map_scm4.json. Do not edit.
+
+The helpers work on a list of bits indexed by ASC position before
+any scan chain inversion is applied.
+"""
+
+ASC_LENGTH = 72
+
+# Field name: (positions from MSB to LSB, inverted bits mask).
+FIELDS = {
+    'radio_en_tx': ([71], 0x0),
+    'radio_lo_ftune': ([68, 69, 70, 65, 66, 67], 0x0),
+    'radio_lo_itune': ([62, 64, 63], 0x0),
+    'radio_en_lo': ([61], 0x0),
+    'radio_lo_fine': ([59, 60], 0x0),
+    'radio_en_debug_degen': ([58], 0x0),
+    'radio_en_debug_driver': ([57], 0x0),
+    'radio_en_output_degen': ([56], 0x0),
+    'radio_en_output_drive': ([55], 0x0),
+    'cam_gain': ([36, 37], 0x0),
+    'cam_en_pga': ([35], 0x0),
+    'cam_en_pixel_out': ([34], 0x0),
+    'cam_row': ([33, 32, 31, 30], 0x0),
+    'cam_read': ([29, 28, 27, 26, 25, 24, 23, 22, 21, 20], 0x0),
+    'cam_exposure': (
+        [10, 9, 8, 7, 19, 18, 17, 16, 15, 14, 13, 12, 11, 6],
+        0x0),
+    'cam_en_dig': ([5], 0x0),
+    'cam_col': ([4, 3, 2, 1, 0], 0x0),
+}
+
+
+def set_field(asc, name, value):
+    """Write the value into the field of the ASC bit list."""
+    bits, inverted = FIELDS[name]
+    if value >> len(bits):
+        raise ValueError('{} does not fit into {}'.format(value, name))
+    value ^= inverted
+    for index, position in enumerate(bits):
+        asc[position] = (value >> (len(bits) - 1 - index)) & 0x1
+
+
+def get_field(asc, name):
+    """Read the field from the ASC bit list."""
+    bits, inverted = FIELDS[name]
+    value = 0
+    for position in bits:
+        value = (value << 1) | (asc[position] & 0x1)
+    return value ^ inverted
+
+
+def build(**values):
+    """Return an ASC bit list with the given fields set."""
+    asc = [0] * ASC_LENGTH
+    for name, value in values.items():
+        set_field(asc, name, value)
+    return asc
@@ -10,6 +10,8 @@ import difflib
 import visa
 from subprocess import Popen, PIPE
 
+import asc_map_scm4
+
 ####################################################
 ####################################################
 ################## Scan Functions ################## 
@@ -98,36 +100,21 @@ def construct_ASC(radio_en_tx=[0], radio_lo_ftune = [0,0,0,0,0,0],
 		out of the box and not worry about inverting/reversing.
 	"""
 
-	# Reversing for breaking into chunks and for ease of indexing.
-	cam_exposure_rev = cam_exposure[::-1]
-	radio_lo_ftune_rev = radio_lo_ftune[::-1]
-	radio_lo_itune_rev = radio_lo_itune[::-1]
-	radio_lo_fine_rev = radio_lo_fine[::-1]
-
-	ASC = radio_en_tx + \
-			radio_lo_ftune_rev[3:6] + \
-			radio_lo_ftune_rev[0:3] + \
-			[radio_lo_itune_rev[1]] + \
-			[radio_lo_itune_rev[0]] + \
-			[radio_lo_itune_rev[2]] + \
-			radio_en_lo + \
-			radio_lo_fine_rev + \
-			radio_en_debug_degen + \
-			radio_en_debug_driver + \
-			radio_en_output_degen + \
-			radio_en_output_drive + \
-			[0]*17 + \
-			cam_gain[::-1] + \
-			cam_en_pga + \
-			cam_en_pixel_out + \
-			cam_row + \
-			cam_read + \
-			cam_exposure_rev[9:0:-1] + \
-			cam_exposure_rev[13:9:-1] + \
-			[cam_exposure_rev[0]] + \
-			cam_en_dig + \
-			cam_col
-	ASC = ASC[::-1]
+	# The field positions are defined in asc_map_scm4.json. Each argument is
+	# a list of bits from the MSB to the LSB.
+	fields = dict(radio_en_tx=radio_en_tx, radio_lo_ftune=radio_lo_ftune,
+					radio_lo_itune=radio_lo_itune, radio_en_lo=radio_en_lo,
+					radio_lo_fine=radio_lo_fine,
+					radio_en_debug_degen=radio_en_debug_degen,
+					radio_en_debug_driver=radio_en_debug_driver,
+					radio_en_output_degen=radio_en_output_degen,
+					radio_en_output_drive=radio_en_output_drive,
+					cam_row=cam_row, cam_col=cam_col, cam_read=cam_read,
+					cam_exposure=cam_exposure, cam_en_dig=cam_en_dig,
+					cam_gain=cam_gain, cam_en_pga=cam_en_pga,
+					cam_en_pixel_out=cam_en_pixel_out)
+	ASC = asc_map_scm4.build(**{name: int(''.join(map(str, bits)), 2)
+		for name, bits in fields.items()})
 	ASC[:] = [int(1-x) for x in ASC] # invert the scan chain :)
 
 	return ASC
@@ -0,0 +1,216 @@
+"""Report the bit error rate (BER) and packet error rate (PER) per tuning code.
+
+The BER lines are printed by the receiving SCuM with prbs_ber_flush() whenever
+the tuning code of the transmitter changes, e.g.,
+
+    BER 22.28.5 sent=10 received=9 crc_ok=7 error_free=7 bits=1920 ...
+
+The lines are read either from a log file or from a serial port and are summed
+per tuning code over all sweeps. The PRBS generator below is bit-exact with
+prbs.c, so the same packets can also be generated and checked on the host,
+e.g., to transmit BER packets from an OpenMote or to check captured payloads.
+"""
+
+import argparse
+import csv
+import re
+import sys
+
+# Polynomials x^degree + x^tap + 1, as in prbs.c.
+POLYNOMIALS = {
+    "pn9": (9, 5),
+    "pn15": (15, 14),
+    "pn31": (31, 28),
+}
+
+# Length of the CRC in bytes.
+LENGTH_CRC = 2
+
+# Length of the BER packet header in bytes.
+HEADER_LENGTH = 6
+
+# Initial value of the BER header check byte.
+HEADER_CHECK_INIT = 0xA5
+
+BER_LINE = re.compile(
+    r"BER (?P<setting>\d+\.\d+\.\d+) sent=(?P<sent>\d+) "
+    r"received=(?P<received>\d+) crc_ok=(?P<crc_ok>\d+) "
+    r"error_free=(?P<error_free>\d+) bits=(?P<bits>\d+) "
+    r"bit_errors=(?P<bit_errors>\d+) header_errors=(?P<header_errors>\d+)")
+
+
+class Prbs:
+    """Fibonacci LFSR shifting left with the new bit inserted at bit 0."""
+
+    def __init__(self, polynomial, seed=0):
+        self.degree, self.tap = POLYNOMIALS[polynomial]
+        self.mask = (1 << self.degree) - 1
+        self.state = (seed & self.mask) or self.mask
+
+    def next_bits(self, num_bits):
+        """Return the next bits with the first generated bit as the MSB."""
+        bits = 0
+        for _ in range(num_bits):
+            new_bit = ((self.state >> (self.degree - 1)) ^
+                       (self.state >> (self.tap - 1))) & 1
+            self.state = ((self.state << 1) | new_bit) & self.mask
+            bits = (bits << 1) | new_bit
+        return bits
+
+    def fill(self, length):
+        """Return the next bytes of the sequence."""
+        return bytes(self.next_bits(8) for _ in range(length))
+
+    def check(self, payload):
+        """Return the number of bit errors of the payload."""
+        return sum(bin(byte ^ self.next_bits(8)).count("1")
+                   for byte in payload)
+
+
+def header_check(header):
+    """Return the check byte over the first five header bytes."""
+    check = HEADER_CHECK_INIT
+    for byte in header[:HEADER_LENGTH - 1]:
+        check ^= byte
+    return check
+
+
+def build_packet(polynomial, setting, packet_index, num_packets, packet_len):
+    """Return a BER packet without the CRC bytes, as prbs_ber_fill_packet()."""
+    header = bytearray(setting + (packet_index, num_packets))
+    header.append(header_check(header))
+    payload_len = packet_len - HEADER_LENGTH - LENGTH_CRC
+    return bytes(header) + Prbs(polynomial).fill(payload_len)
+
+
+def check_packet(polynomial, packet):
+    """Return the setting and the number of bit errors of a BER packet without
+    the CRC bytes, or None if the header is invalid."""
+    header = packet[:HEADER_LENGTH]
+    if (len(header) < HEADER_LENGTH or header[-1] != header_check(header) or
+            max(header[:3]) > 31 or header[3] >= header[4]):
+        return None
+    setting = "{}.{}.{}".format(*header[:3])
+    return setting, Prbs(polynomial).check(packet[HEADER_LENGTH:])
+
+
+def read_lines(args):
+    """Yield the lines from the log file or from the serial port."""
+    if args.file:
+        with open(args.file) as log:
+            for line in log:
+                yield line
+        return
+
+    import serial
+    port = serial.Serial(args.port, args.baudrate, timeout=args.timeout)
+    while True:
+        line = port.readline()
+        if not line:
+            return
+        yield line.decode("ascii", errors="ignore")
+
+
+def parse_setting(setting):
+    """Return the setting as a tuple for sorting."""
+    return tuple(int(code) for code in setting.split("."))
+
+
+def report(args):
+    """Sum the BER lines per setting and print the report."""
+    totals = {}
+    header_errors = 0
+    for line in read_lines(args):
+        match = BER_LINE.search(line)
+        if match is None:
+            continue
+        stats = {key: int(value) for key, value in match.groupdict().items()
+                 if key != "setting"}
+        header_errors = stats.pop("header_errors")
+        total = totals.setdefault(match.group("setting"),
+                                  dict.fromkeys(stats, 0))
+        for key, value in stats.items():
+            total[key] += value
+
+    if not totals:
+        print("No BER lines found.")
+        return 1
+
+    rows = []
+    for setting in sorted(totals, key=parse_setting):
+        total = totals[setting]
+        ber = total["bit_errors"] / total["bits"] if total["bits"] else 1.0
+        per = 1 - total["crc_ok"] / total["sent"] if total["sent"] else 1.0
+        rows.append([setting, total["sent"], total["received"],
+                     total["crc_ok"], total["bits"], total["bit_errors"], ber,
+                     per])
+
+    print("{:<10} {:>7} {:>9} {:>7} {:>10} {:>10} {:>10} {:>6}".format(
+        "setting", "sent", "received", "crc_ok", "bits", "bit_errors", "BER",
+        "PER"))
+    for row in rows:
+        print("{:<10} {:>7} {:>9} {:>7} {:>10} {:>10} {:>10.2e} {:>6.3f}"
+              .format(*row))
+    print("Packets with an invalid header: {}".format(header_errors))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as output:
+            writer = csv.writer(output)
+            writer.writerow(["setting", "sent", "received", "crc_ok", "bits",
+                             "bit_errors", "BER", "PER"])
+            writer.writerows(rows)
+    return 0
+
+
+def packet(args):
+    """Print a BER packet as hex, or check a captured packet."""
+    if args.check:
+        result = check_packet(args.polynomial, bytes.fromhex(args.check))
+        if result is None:
+            print("Invalid header.")
+            return 1
+        print("setting={} bit_errors={}".format(*result))
+        return 0
+
+    setting = parse_setting(args.setting)
+    print(build_packet(args.polynomial, setting, args.index, args.num_packets,
+                       args.length).hex())
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    report_parser = subparsers.add_parser(
+        "report", help="report the BER lines of the receiving SCuM")
+    source = report_parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("-f", "--file", help="log file containing BER lines")
+    source.add_argument("-p", "--port", help="serial port of SCuM")
+    report_parser.add_argument("-b", "--baudrate", type=int, default=19200)
+    report_parser.add_argument(
+        "-t", "--timeout", type=float, default=30,
+        help="serial timeout in seconds ending the capture")
+    report_parser.add_argument("--csv", help="write the report to a CSV file")
+    report_parser.set_defaults(handler=report)
+
+    packet_parser = subparsers.add_parser(
+        "packet", help="generate or check a BER packet")
+    packet_parser.add_argument("--polynomial", choices=POLYNOMIALS,
+                               default="pn9")
+    packet_parser.add_argument("--setting", default="0.0.0",
+                               help="tuning code as coarse.mid.fine")
+    packet_parser.add_argument("--index", type=int, default=0)
+    packet_parser.add_argument("--num-packets", type=int, default=1)
+    packet_parser.add_argument("--length", type=int, default=127,
+                               help="packet length including the CRC")
+    packet_parser.add_argument("--check",
+                               help="hex packet without the CRC to check")
+    packet_parser.set_defaults(handler=packet)
+
+    args = parser.parse_args()
+    return args.handler(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
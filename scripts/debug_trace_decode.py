@@ -0,0 +1,248 @@
+"""Decode debug trace pins from a logic analyzer CSV export.
+
+SCuM outputs the debug traces from debug_trace.h on its GPIO pins: single
+trace points, e.g., the ISR pin, and a 4-pin state bus carrying the state
+code of a state machine. This script reads a CSV export of the captured
+channels, e.g., from Saleae Logic or PulseView, in which the first column is
+the time in seconds and the other columns are the channel levels, e.g.,
+
+    Time [s],Channel 0,Channel 1,Channel 2,Channel 3
+    0.000000000,0,0,0,0
+    0.001234500,1,0,0,0
+
+Exports without a time column are supported with --samplerate. The state bus
+is decoded into a timeline of states, and the trace points into pulses, and
+the durations are summarized per state and per trace point.
+"""
+
+import argparse
+import csv
+import sys
+
+# Number of pins of the state bus.
+STATE_NUM_PINS = 4
+
+
+def parse_mapping(values, what):
+    """Parse KEY=VALUE arguments into a dictionary."""
+    mapping = {}
+    for value in values or []:
+        key, separator, name = value.partition("=")
+        if not separator:
+            raise ValueError("{} must be KEY=VALUE: {}".format(what, value))
+        mapping[key.strip()] = name.strip()
+    return mapping
+
+
+def find_column(header, column):
+    """Return the index of the column given by its name or channel index."""
+    if column in header:
+        return header.index(column)
+    try:
+        index = int(column)
+    except ValueError:
+        raise ValueError("Unknown column: {}".format(column))
+    if not 0 <= index < len(header):
+        raise ValueError("Column index out of range: {}".format(column))
+    return index
+
+
+def read_samples(path, samplerate):
+    """Read the CSV export and return the channel names and the samples.
+
+    Each sample is a (time, levels) tuple with the levels of all channels.
+    """
+    with open(path, newline="") as export:
+        rows = [row for row in csv.reader(export)
+                if row and not row[0].lstrip().startswith(";")]
+    if not rows:
+        raise ValueError("Empty CSV export.")
+
+    header = [name.strip() for name in rows[0]]
+    has_time = samplerate is None
+    channels = header[1:] if has_time else header
+    samples = []
+    for index, row in enumerate(rows[1:]):
+        values = [value.strip() for value in row]
+        if has_time:
+            time = float(values[0])
+            levels = values[1:]
+        else:
+            time = index / samplerate
+            levels = values
+        samples.append((time, [int(level) for level in levels]))
+    return channels, samples
+
+
+def decode_state(levels, state_columns):
+    """Return the state code of the state bus, LSB first."""
+    code = 0
+    for bit, column in enumerate(state_columns):
+        code |= (levels[column] & 0x1) << bit
+    return code
+
+
+def decode_states(samples, state_columns, min_duration):
+    """Decode the state bus into a list of (start, end, code) intervals.
+
+    States shorter than min_duration, e.g., from the skew between the state
+    pins, are merged into the following state.
+    """
+    intervals = []
+    for time, levels in samples:
+        code = decode_state(levels, state_columns)
+        if intervals and intervals[-1][2] == code:
+            continue
+        if intervals:
+            intervals[-1][1] = time
+            if intervals[-1][1] - intervals[-1][0] < min_duration:
+                start = intervals.pop()[0]
+                if intervals and intervals[-1][2] == code:
+                    continue
+                intervals.append([start, None, code])
+                continue
+        intervals.append([time, None, code])
+
+    if intervals:
+        intervals[-1][1] = samples[-1][0]
+    return [tuple(interval) for interval in intervals]
+
+
+def decode_pulses(samples, column):
+    """Decode the high pulses of a trace point into (start, end) tuples."""
+    pulses = []
+    start = None
+    for time, levels in samples:
+        level = levels[column] & 0x1
+        if level and start is None:
+            start = time
+        elif not level and start is not None:
+            pulses.append((start, time))
+            start = None
+    return pulses
+
+
+def format_us(seconds):
+    """Format a duration in seconds as microseconds."""
+    return "{:.3f}".format(seconds * 1e6)
+
+
+def summarize(durations):
+    """Return the count, total, mean, minimum, and maximum of the durations."""
+    if not durations:
+        return 0, 0, 0, 0, 0
+    total = sum(durations)
+    return (len(durations), total, total / len(durations), min(durations),
+            max(durations))
+
+
+def print_summary_header(label):
+    print("{:<16} {:>8} {:>12} {:>12} {:>12} {:>12}".format(
+        label, "n", "total_us", "mean_us", "min_us", "max_us"))
+
+
+def print_summary_row(name, durations):
+    n, total, mean, minimum, maximum = summarize(durations)
+    print("{:<16} {:>8} {:>12} {:>12} {:>12} {:>12}".format(
+        name, n, format_us(total), format_us(mean), format_us(minimum),
+        format_us(maximum)))
+
+
+def report_states(intervals, state_names, timeline):
+    """Print the state timeline and the summary per state."""
+    def name(code):
+        return state_names.get(str(code), str(code))
+
+    if timeline:
+        print("{:>14} {:>12} state".format("start_us", "duration_us"))
+        for start, end, code in intervals:
+            print("{:>14} {:>12} {}".format(format_us(start),
+                                            format_us(end - start),
+                                            name(code)))
+        print("")
+
+    # The last state is still ongoing at the end of the capture.
+    durations = {}
+    for start, end, code in intervals[:-1]:
+        durations.setdefault(code, []).append(end - start)
+    print_summary_header("state")
+    for code in sorted(durations):
+        print_summary_row(name(code), durations[code])
+
+    transitions = {}
+    for previous, current in zip(intervals, intervals[1:]):
+        key = (previous[2], current[2])
+        transitions[key] = transitions.get(key, 0) + 1
+    print("")
+    print("transitions:")
+    for (previous, current), count in sorted(transitions.items()):
+        print("  {} -> {}: {}".format(name(previous), name(current), count))
+
+
+def report_points(points):
+    """Print the pulse summary per trace point."""
+    print_summary_header("point")
+    for name, pulses in points:
+        print_summary_row(name, [end - start for start, end in pulses])
+    for name, pulses in points:
+        periods = [b[0] - a[0] for a, b in zip(pulses, pulses[1:])]
+        if periods:
+            n, _, mean, minimum, maximum = summarize(periods)
+            print("{} period: mean {} us, min {} us, max {} us".format(
+                name, format_us(mean), format_us(minimum),
+                format_us(maximum)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("file", help="CSV export of the logic analyzer")
+    parser.add_argument("-s", "--state", nargs=STATE_NUM_PINS,
+                        metavar="COLUMN",
+                        help="columns of the state bus, LSB first, as "
+                        "channel names or channel indices")
+    parser.add_argument("-n", "--state-name", action="append",
+                        metavar="CODE=NAME", help="name of a state code")
+    parser.add_argument("-p", "--point", action="append",
+                        metavar="NAME=COLUMN", help="column of a trace point")
+    parser.add_argument("--samplerate", type=float, default=None,
+                        help="sample rate in Hz if there is no time column")
+    parser.add_argument("--min-duration-us", type=float, default=0,
+                        help="merge shorter states into the next state")
+    parser.add_argument("--timeline", action="store_true",
+                        help="print every state interval")
+    args = parser.parse_args()
+
+    if not args.state and not args.point:
+        parser.error("Specify the state bus, a trace point, or both.")
+
+    try:
+        channels, samples = read_samples(args.file, args.samplerate)
+        state_names = parse_mapping(args.state_name, "State name")
+        point_columns = parse_mapping(args.point, "Trace point")
+        state_columns = [find_column(channels, column)
+                         for column in args.state or []]
+        points = [(name, decode_pulses(samples, find_column(channels,
+                                                            column)))
+                  for name, column in point_columns.items()]
+    except ValueError as error:
+        print(error)
+        return 1
+
+    if not samples:
+        print("No samples found.")
+        return 1
+
+    if state_columns:
+        report_states(
+            decode_states(samples, state_columns,
+                          args.min_duration_us * 1e-6),
+            state_names, args.timeline)
+    if points:
+        if state_columns:
+            print("")
+        report_points(points)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,346 @@
+"""Generate analog scan chain (ASC) field accessors from an ASC field map.
+
+The ASC field map is a JSON file describing the named fields of a chip's
+analog scan chain:
+
+    {
+        "chip": "scm3c",
+        "length": 1216,
+        "fields": [
+            {
+                "name": "if_rc_coarse",
+                "msb": 427,
+                "lsb": 431,
+                "description": "IF RC oscillator coarse tuning"
+            },
+            {
+                "name": "hf_clock_fine",
+                "bits": [874, 873, 872, 871, 870],
+                "invert_bits": [874],
+                "description": "HF_CLOCK fine tuning"
+            },
+            {
+                "name": "polyphase_enable",
+                "bit": 971,
+                "description": "Polyphase filter enable"
+            }
+        ]
+    }
+
+A field is given by its MSB and LSB position, which covers all positions in
+between, by an explicit list of positions from the MSB to the LSB, or by a
+single bit position. Positions in invert_bits store the complement of the
+field bit.
+
+The C header contains a constant-folded setter and getter per field, which
+only touch the ASC words covered by the field. Field bits that keep the same
+offset within a word are moved with a single shift and mask. The Python
+module contains the same field table and helpers working on a list of bits
+indexed by ASC position, as used by the scan scripts.
+
+Usage:
+    python scripts/gen_asc_map.py scm_v3c/asc_map_scm3c.json \\
+        --c-header scm_v3c/asc_map.h --python scm_v3a/asc_map_scm3c.py
+"""
+
+import argparse
+import json
+import os
+import sys
+import textwrap
+
+WORD_BITS = 32
+
+
+def field_bits(field):
+    """Return the ASC positions of the field from its MSB to its LSB."""
+    if "bits" in field:
+        return list(field["bits"])
+    if "bit" in field:
+        return [field["bit"]]
+    step = 1 if field["lsb"] >= field["msb"] else -1
+    return list(range(field["msb"], field["lsb"] + step, step))
+
+
+def load_map(path):
+    """Load and validate the ASC field map."""
+    with open(path) as map_file:
+        asc_map = json.load(map_file)
+
+    names = set()
+    for field in asc_map["fields"]:
+        name = field["name"]
+        if name in names:
+            raise ValueError("Duplicate field {}".format(name))
+        names.add(name)
+
+        bits = field_bits(field)
+        if not 0 < len(bits) <= WORD_BITS:
+            raise ValueError("Field {} has {} bits".format(name, len(bits)))
+        if len(set(bits)) != len(bits):
+            raise ValueError("Field {} repeats a position".format(name))
+        for position in bits + field.get("invert_bits", []):
+            if not 0 <= position < asc_map["length"]:
+                raise ValueError("Field {} position {} out of range".format(
+                    name, position))
+        for position in field.get("invert_bits", []):
+            if position not in bits:
+                raise ValueError("Field {} inverts unused position {}".format(
+                    name, position))
+    return asc_map
+
+
+def invert_mask(field):
+    """Return the mask of the field bits that are stored inverted."""
+    bits = field_bits(field)
+    mask = 0
+    for position in field.get("invert_bits", []):
+        mask |= 1 << (len(bits) - 1 - bits.index(position))
+    return mask
+
+
+def word_terms(field):
+    """Group the field bits per ASC word into (shift, field mask) terms.
+
+    Returns a dictionary from the word index to a list of (shift, mask)
+    tuples, where the word bits are ((value << shift) & (mask << shift)) for
+    a positive shift.
+    """
+    bits = field_bits(field)
+    words = {}
+    for index, position in enumerate(bits):
+        field_bit = len(bits) - 1 - index
+        word_bit = WORD_BITS - 1 - position % WORD_BITS
+        shift = word_bit - field_bit
+        terms = words.setdefault(position // WORD_BITS, {})
+        terms[shift] = terms.get(shift, 0) | (1 << field_bit)
+    return {word: sorted(terms.items()) for word, terms in words.items()}
+
+
+def shifted(mask, shift):
+    """Shift the mask into its word position."""
+    return (mask << shift if shift >= 0 else mask >> -shift) & 0xFFFFFFFF
+
+
+def c_set_term(shift, mask):
+    """Return the C expression moving the field bits into the word."""
+    if shift > 0:
+        return "((v & 0x{:X}u) << {})".format(mask, shift)
+    if shift < 0:
+        return "((v & 0x{:X}u) >> {})".format(mask, -shift)
+    return "(v & 0x{:X}u)".format(mask)
+
+
+def c_get_term(word, shift, mask):
+    """Return the C expression moving the word bits into the field."""
+    word_mask = shifted(mask, shift)
+    if shift > 0:
+        return "((asc[{}] & 0x{:X}u) >> {})".format(word, word_mask, shift)
+    if shift < 0:
+        return "((asc[{}] & 0x{:X}u) << {})".format(word, word_mask, -shift)
+    return "(asc[{}] & 0x{:X}u)".format(word, word_mask)
+
+
+def c_bits_comment(field):
+    """Return the comment lines listing the ASC positions of the field."""
+    bits = field_bits(field)
+    if "bits" in field:
+        positions = ", ".join(str(position) for position in bits)
+    elif len(bits) == 1:
+        positions = str(bits[0])
+    else:
+        positions = "{}:{}".format(bits[0], bits[-1])
+    comment = "ASC<{}> (MSB first)".format(positions)
+
+    invert_bits = field.get("invert_bits", [])
+    if len(invert_bits) == len(bits):
+        comment += ", inverted"
+    elif invert_bits:
+        comment += ", inverted ASC<{}>".format(", ".join(
+            str(position) for position in invert_bits))
+    return ["// " + line for line in textwrap.wrap(comment + ".", 77)]
+
+
+def c_join(prefix, terms, suffix):
+    """Join the terms with |, one term per line if they exceed 80 columns."""
+    line = prefix + " | ".join(terms) + suffix
+    if len(line) <= 80:
+        return [line]
+    indent = " " * len(prefix)
+    lines = [prefix + terms[0] + " |"]
+    lines += [indent + term + " |" for term in terms[1:-1]]
+    lines.append(indent + terms[-1] + suffix)
+    return lines
+
+
+def c_signature(signature):
+    """Break the function signature after the parenthesis if too long."""
+    if len(signature) <= 80:
+        return [signature]
+    head, arguments = signature.split("(", 1)
+    return [head + "(", "    " + arguments]
+
+
+def generate_c_header(asc_map, map_path):
+    """Return the C header with the field accessors."""
+    guard = "__ASC_MAP_H"
+    lines = [
+        "// Analog scan chain field map for {}.".format(asc_map["chip"]),
+        "//",
+        "// Generated by scripts/gen_asc_map.py from {}. Do not edit.".format(
+            os.path.basename(map_path)),
+        "//",
+        "// Each field has a setter and a getter operating on the ASC image,",
+        "// e.g., asc_map_set_if_rc_coarse(asc, 22). Bits that are stored",
+        "// inverted on-chip are inverted by the accessors.",
+        "",
+        "#ifndef {}".format(guard),
+        "#define {}".format(guard),
+        "",
+        "#include <stdint.h>",
+        "",
+        "// Number of bits in the analog scan chain.",
+        "#define ASC_MAP_LENGTH {}".format(asc_map["length"]),
+        "",
+    ]
+
+    for field in asc_map["fields"]:
+        name = field["name"]
+        upper = name.upper()
+        bits = field_bits(field)
+        width = len(bits)
+        inverted = invert_mask(field)
+        words = word_terms(field)
+
+        if "description" in field:
+            lines.append("// {}.".format(field["description"].rstrip(".")))
+        lines += c_bits_comment(field)
+        lines.append("#define ASC_MAP_{}_WIDTH {}".format(upper, width))
+        lines.append("")
+
+        lines += c_signature(
+            "static inline void asc_map_set_{}(uint32_t* asc, "
+            "const uint32_t value) {{".format(name))
+        if inverted:
+            lines.append("    const uint32_t v = value ^ 0x{:X}u;".format(
+                inverted))
+        else:
+            lines.append("    const uint32_t v = value;")
+        for word in sorted(words):
+            terms = words[word]
+            word_mask = 0
+            for shift, mask in terms:
+                word_mask |= shifted(mask, shift)
+            lines += c_join(
+                "    asc[{0}] = ".format(word),
+                ["(asc[{}] & ~0x{:08X}u)".format(word, word_mask)] +
+                [c_set_term(s, m) for s, m in terms], ";")
+        lines.append("}")
+        lines.append("")
+
+        lines += c_signature(
+            "static inline uint32_t asc_map_get_{}(const uint32_t* asc) {{".
+            format(name))
+        terms = [c_get_term(word, shift, mask) for word in sorted(words)
+                 for shift, mask in words[word]]
+        if inverted:
+            lines += c_join("    return (", terms,
+                            ") ^ 0x{:X}u;".format(inverted))
+        else:
+            lines += c_join("    return ", terms, ";")
+        lines.append("}")
+        lines.append("")
+
+    lines.append("#endif  // {}".format(guard))
+    return "\n".join(lines) + "\n"
+
+
+def generate_python(asc_map, map_path):
+    """Return the Python module with the field table and helpers."""
+    lines = [
+        '"""Analog scan chain field map for {}.'.format(asc_map["chip"]),
+        "",
+        "Generated by scripts/gen_asc_map.py from {}. Do not edit.".format(
+            os.path.basename(map_path)),
+        "",
+        "The helpers work on a list of bits indexed by ASC position before",
+        "any scan chain inversion is applied.",
+        '"""',
+        "",
+        "ASC_LENGTH = {}".format(asc_map["length"]),
+        "",
+        "# Field name: (positions from MSB to LSB, inverted bits mask).",
+        "FIELDS = {",
+    ]
+    for field in asc_map["fields"]:
+        line = "    {!r}: ({!r}, 0x{:X}),".format(
+            field["name"], field_bits(field), invert_mask(field))
+        if len(line) <= 79:
+            lines.append(line)
+            continue
+        lines.append("    {!r}: (".format(field["name"]))
+        lines += textwrap.wrap(
+            repr(field_bits(field)) + ",", 79,
+            initial_indent=" " * 8, subsequent_indent=" " * 9)
+        lines.append("        0x{:X}),".format(invert_mask(field)))
+    lines += [
+        "}",
+        "",
+        "",
+        "def set_field(asc, name, value):",
+        '    """Write the value into the field of the ASC bit list."""',
+        "    bits, inverted = FIELDS[name]",
+        "    if value >> len(bits):",
+        "        raise ValueError('{} does not fit into {}'.format(value, "
+        "name))",
+        "    value ^= inverted",
+        "    for index, position in enumerate(bits):",
+        "        asc[position] = (value >> (len(bits) - 1 - index)) & 0x1",
+        "",
+        "",
+        "def get_field(asc, name):",
+        '    """Read the field from the ASC bit list."""',
+        "    bits, inverted = FIELDS[name]",
+        "    value = 0",
+        "    for position in bits:",
+        "        value = (value << 1) | (asc[position] & 0x1)",
+        "    return value ^ inverted",
+        "",
+        "",
+        "def build(**values):",
+        '    """Return an ASC bit list with the given fields set."""',
+        "    asc = [0] * ASC_LENGTH",
+        "    for name, value in values.items():",
+        "        set_field(asc, name, value)",
+        "    return asc",
+    ]
+    return "\n".join(lines) + "\n"
+
+
+def write_if_changed(path, content):
+    """Write the file only if its content changed."""
+    if os.path.exists(path):
+        with open(path) as existing:
+            if existing.read() == content:
+                return
+    with open(path, "w", newline="\n") as output:
+        output.write(content)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("map", help="ASC field map JSON file")
+    parser.add_argument("--c-header", help="C header to generate")
+    parser.add_argument("--python", help="Python module to generate")
+    args = parser.parse_args()
+
+    asc_map = load_map(args.map)
+    if args.c_header:
+        write_if_changed(args.c_header, generate_c_header(asc_map, args.map))
+    if args.python:
+        write_if_changed(args.python, generate_python(asc_map, args.map))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,142 @@
+"""Report the ISR profiler statistics dumped by isr_profiler_print().
+
+The statistics are read either from a log file or from a serial port. Each
+profiled ISR is printed by SCuM as a single line, e.g.,
+
+    ISRPROF rftimer n=120 min=3 max=41 sum=780 dur=0,0,4,... nlat=120 ...
+
+All times on SCuM are in RF timer ticks of 2 us.
+"""
+
+import argparse
+import re
+import sys
+
+# RF timer tick in microseconds (500 kHz).
+TICK_US = 2
+
+ISRPROF_LINE = re.compile(
+    r"ISRPROF (?P<name>\w+) n=(?P<n>\d+) min=(?P<min>\d+) max=(?P<max>\d+) "
+    r"sum=(?P<sum>\d+) dur=(?P<dur>[\d,]+) nlat=(?P<nlat>\d+) "
+    r"maxlat=(?P<maxlat>\d+) lat=(?P<lat>[\d,]+)")
+
+
+def parse_line(line):
+    """Parse a single ISRPROF line into a dictionary or return None."""
+    match = ISRPROF_LINE.search(line)
+    if match is None:
+        return None
+    stats = {key: int(value) for key, value in match.groupdict().items()
+             if key not in ("name", "dur", "lat")}
+    stats["name"] = match.group("name")
+    stats["dur"] = [int(count) for count in match.group("dur").split(",")]
+    stats["lat"] = [int(count) for count in match.group("lat").split(",")]
+    return stats
+
+
+def bucket_upper_bound_us(bucket):
+    """Return the exclusive upper bound of the log2 bucket in microseconds."""
+    return (1 << bucket) * TICK_US
+
+
+def percentile_upper_bound_us(histogram, percentile):
+    """Return the upper bound of the bucket containing the percentile."""
+    total = sum(histogram)
+    if total == 0:
+        return 0
+    threshold = total * percentile / 100.0
+    cumulative = 0
+    for bucket, count in enumerate(histogram):
+        cumulative += count
+        if cumulative >= threshold:
+            return bucket_upper_bound_us(bucket)
+    return bucket_upper_bound_us(len(histogram) - 1)
+
+
+def format_histogram(histogram):
+    """Format the non-empty buckets of the histogram."""
+    buckets = []
+    for bucket, count in enumerate(histogram):
+        if count == 0:
+            continue
+        if bucket == 0:
+            buckets.append("0us:{}".format(count))
+        else:
+            buckets.append("<{}us:{}".format(bucket_upper_bound_us(bucket),
+                                             count))
+    return " ".join(buckets)
+
+
+def report(all_stats, budget_us):
+    """Print the report and return the ISRs exceeding the budget."""
+    over_budget = []
+    print("{:<12} {:>8} {:>9} {:>9} {:>9} {:>9} {:>10}".format(
+        "isr", "n", "mean_us", "max_us", "p99_us", "maxlat_us", "budget"))
+    for stats in sorted(all_stats.values(), key=lambda s: -s["max"]):
+        mean_us = TICK_US * stats["sum"] / max(stats["n"], 1)
+        max_us = TICK_US * stats["max"]
+        maxlat_us = TICK_US * stats["maxlat"]
+        exceeds = budget_us is not None and max_us > budget_us
+        if exceeds:
+            over_budget.append(stats["name"])
+        print("{:<12} {:>8} {:>9.1f} {:>9} {:>9} {:>9} {:>10}".format(
+            stats["name"], stats["n"], mean_us, max_us,
+            percentile_upper_bound_us(stats["dur"], 99),
+            maxlat_us if stats["nlat"] else "-",
+            "EXCEEDED" if exceeds else ""))
+    print("")
+    for stats in all_stats.values():
+        print("{} duration: {}".format(stats["name"],
+                                       format_histogram(stats["dur"])))
+        if stats["nlat"]:
+            print("{} latency:  {}".format(stats["name"],
+                                           format_histogram(stats["lat"])))
+    return over_budget
+
+
+def read_lines(args):
+    """Yield the lines from the log file or from the serial port."""
+    if args.file:
+        with open(args.file) as log:
+            for line in log:
+                yield line
+        return
+
+    import serial
+    port = serial.Serial(args.port, args.baudrate, timeout=args.timeout)
+    while True:
+        line = port.readline()
+        if not line:
+            return
+        yield line.decode("ascii", errors="ignore")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("-f", "--file", help="log file containing the dump")
+    source.add_argument("-p", "--port", help="serial port of SCuM")
+    parser.add_argument("-b", "--baudrate", type=int, default=19200)
+    parser.add_argument("-t", "--timeout", type=float, default=5,
+                        help="serial timeout in seconds ending the capture")
+    parser.add_argument("--budget-us", type=int, default=None,
+                        help="flag ISRs whose maximum duration exceeds this")
+    args = parser.parse_args()
+
+    # Only keep the last dump of each ISR.
+    all_stats = {}
+    for line in read_lines(args):
+        stats = parse_line(line)
+        if stats is not None:
+            all_stats[stats["name"]] = stats
+
+    if not all_stats:
+        print("No ISRPROF lines found.")
+        return 1
+
+    over_budget = report(all_stats, args.budget_us)
+    return 1 if over_budget else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,248 @@
+"""Replay lighthouse edge traces through the on-chip decoder on the host.
+
+The harness in lighthouse_replay/ is compiled on Linux with the unmodified
+scm_v3c/lighthouse.c against stub headers. It replays an edge trace through the
+decoding pipeline and prints the transmitted pose packets and the CPU time per
+edge.
+
+The synth command generates a synthetic Lighthouse V1 trace of two base
+stations in A/B mode seen by one or more photodiodes, optionally with glitches,
+missed sync pulses, and timestamp jitter, replays it, and reports the decoded
+angle error and the fraction of decoded sweeps. The replay command replays a
+recorded trace and prints the harness output.
+"""
+
+import argparse
+import os
+import random
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+SCRIPTS_DIR = os.path.dirname(os.path.abspath(__file__))
+HARNESS_DIR = os.path.join(SCRIPTS_DIR, "lighthouse_replay")
+SCM_V3C_DIR = os.path.join(SCRIPTS_DIR, os.pardir, "scm_v3c")
+
+# RF timer ticks in 100 ms, as LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT.
+DEFAULT_TICKS_IN_100MS = 1082251
+
+# Duration of a sweep slot in seconds. The rotor turns at 60 Hz and each turn
+# is split into two sweep slots.
+SLOT_DURATION = 1 / 120
+
+# Sync pulse width in 10 MHz ticks is SYNC_BASE_WIDTH + SYNC_STEP_WIDTH * n with
+# n = skip << 2 | data << 1 | axis.
+SYNC_BASE_WIDTH = 625
+SYNC_STEP_WIDTH = 104
+
+# Delay between the sync pulses of lighthouses A and B in seconds.
+SYNC_SPACING = 400e-6
+
+# Laser pulse width in 10 MHz ticks.
+LASER_WIDTH = 200
+
+# Width of a glitch in 10 MHz ticks.
+GLITCH_WIDTH = 8
+
+# Sweep slots of a cycle as (lighthouse, axis), in the order of the A/B mode.
+SLOTS = [(0, 0), (0, 1), (1, 0), (1, 1)]
+
+POSE_LINE = re.compile(r"POSE (\d+) (\d+) (\d+) (\d+) (\d+) (\d+) (\d+)")
+STATS_LINE = re.compile(r"STATS .*")
+
+
+def build_harness(output_dir):
+    """Compile the harness and return the path to the executable."""
+    executable = os.path.join(output_dir, "lighthouse_replay")
+    subprocess.run([
+        "gcc", "-std=gnu99", "-O2", "-w",
+        "-I", os.path.join(HARNESS_DIR, "stubs"), "-I", SCM_V3C_DIR,
+        os.path.join(HARNESS_DIR, "lighthouse_replay.c"),
+        os.path.join(SCM_V3C_DIR, "lighthouse.c"), "-o", executable
+    ], check=True)
+    return executable
+
+
+def run_harness(executable, trace_path, args, num_sensors):
+    """Replay the trace and return the harness output lines."""
+    command = [executable, "-t", str(args.ticks), "-n", str(num_sensors),
+               "-r", str(args.repetitions)]
+    if args.compensate:
+        command.append("-c")
+    command.append(trace_path)
+    result = subprocess.run(command, check=True, capture_output=True,
+                            text=True)
+    return result.stdout.splitlines()
+
+
+class TraceGenerator:
+    """Generates the edges of a synthetic Lighthouse V1 trace."""
+
+    def __init__(self, args):
+        self.args = args
+        self.ticks_per_second = args.ticks * 10
+        self.ticks_per_10mhz_tick = args.ticks / 1e6
+        self.edges = []
+        self.random = random.Random(args.seed)
+
+        # Angles in degrees of every photodiode, indexed by
+        # lighthouse << 1 | axis as in the pose packets.
+        self.angles = [[self.random.uniform(60, 120) for _ in range(4)]
+                       for _ in range(args.sensors)]
+
+    def jitter(self):
+        """Return a random timestamp jitter in ticks."""
+        return self.random.randint(-self.args.jitter, self.args.jitter)
+
+    def pulse(self, sensor, start, width):
+        """Add a pulse of the width in 10 MHz ticks starting at the tick."""
+        rise = int(start) + self.jitter()
+        fall = rise + int(width * self.ticks_per_10mhz_tick) + self.jitter()
+        if self.random.random() < self.args.glitch_rate:
+            # Split the pulse with a short low glitch.
+            middle = (rise + fall) // 2
+            self.edges += [(sensor, 1, rise), (sensor, 0, middle),
+                           (sensor, 1, middle + GLITCH_WIDTH), (sensor, 0, fall)]
+        else:
+            self.edges += [(sensor, 1, rise), (sensor, 0, fall)]
+        if self.random.random() < self.args.glitch_rate:
+            # Add a short spurious pulse after the pulse.
+            spurious = fall + int(50 * self.ticks_per_10mhz_tick)
+            self.edges += [(sensor, 1, spurious),
+                           (sensor, 0, spurious + GLITCH_WIDTH)]
+
+    def sync_width(self, skip, axis):
+        """Return the width of a sync pulse with a random data bit."""
+        data = self.random.randint(0, 1)
+        return SYNC_BASE_WIDTH + SYNC_STEP_WIDTH * (skip << 2 | data << 1 |
+                                                    axis)
+
+    def generate(self):
+        """Generate all cycles and return the edges sorted by time."""
+        slot_ticks = SLOT_DURATION * self.ticks_per_second
+        rotor_ticks = 2 * slot_ticks
+        start = 1000
+        for _ in range(self.args.cycles):
+            for lighthouse, axis in SLOTS:
+                sync_starts = [start, start + SYNC_SPACING *
+                               self.ticks_per_second]
+                for sensor in range(self.args.sensors):
+                    if self.random.random() < self.args.miss_rate:
+                        # The photodiode misses this sweep slot.
+                        continue
+                    for sync in range(2):
+                        self.pulse(sensor, sync_starts[sync],
+                                   self.sync_width(int(sync != lighthouse),
+                                                   axis))
+                    angle = self.angles[sensor][lighthouse << 1 | axis]
+                    self.pulse(sensor,
+                               sync_starts[lighthouse] +
+                               angle / 360 * rotor_ticks, LASER_WIDTH)
+                start += slot_ticks
+        # Wrap around like the 32-bit RF timer.
+        self.edges = [(sensor, level, timestamp % (1 << 32))
+                      for sensor, level, timestamp in sorted(
+                          self.edges, key=lambda edge: (edge[2], edge[0]))]
+        return self.edges
+
+
+def report(lines, generator=None, args=None):
+    """Print the statistics and, for synthetic traces, the angle errors."""
+    poses = [tuple(int(value) for value in match.groups())
+             for match in map(POSE_LINE.match, lines) if match]
+    last_avg = None
+    for line in lines:
+        if STATS_LINE.match(line):
+            print(line)
+        elif line.startswith("avg:"):
+            last_avg = line.split(":")[1].strip()
+    if args is not None and args.compensate:
+        print("Last sync pulse width average: {}".format(last_avg))
+
+    if generator is None:
+        for pose in poses:
+            print("POSE sequence={} sensor={} mask={:x} angles={}".format(
+                pose[0], pose[1], pose[2], pose[3:]))
+        return 0
+
+    errors = []
+    for _, sensor, mask, *angles in poses:
+        for index, angle in enumerate(angles):
+            if mask & (1 << index):
+                errors.append(angle / 100 - generator.angles[sensor][index])
+    num_sweeps = args.cycles * len(SLOTS) * args.sensors
+    print("Pose packets: {}".format(len(poses)))
+    print("Decoded sweeps: {} of {} ({:.1%})".format(
+        len(errors), num_sweeps, len(errors) / num_sweeps))
+    if errors:
+        print("Angle error: mean {:+.3f} deg, stdev {:.3f} deg, max {:.3f} deg"
+              .format(statistics.mean(errors),
+                      statistics.pstdev(errors),
+                      max(abs(error) for error in errors)))
+    return 0
+
+
+def synth(args):
+    """Generate a synthetic trace, replay it, and report the accuracy."""
+    generator = TraceGenerator(args)
+    edges = generator.generate()
+    with tempfile.TemporaryDirectory() as output_dir:
+        trace_path = args.output or os.path.join(output_dir, "trace.txt")
+        with open(trace_path, "w") as trace:
+            trace.write("# sensor level timestamp\n")
+            for edge in edges:
+                trace.write("{} {} {}\n".format(*edge))
+        executable = build_harness(output_dir)
+        lines = run_harness(executable, trace_path, args, args.sensors)
+    return report(lines, generator, args)
+
+
+def replay(args):
+    """Replay a recorded trace and print the pose packets."""
+    with tempfile.TemporaryDirectory() as output_dir:
+        executable = build_harness(output_dir)
+        lines = run_harness(executable, args.trace, args, args.sensors)
+    return report(lines, args=args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("-t", "--ticks", type=int,
+                        default=DEFAULT_TICKS_IN_100MS,
+                        help="RF timer ticks in 100 ms")
+    parser.add_argument("-r", "--repetitions", type=int, default=100,
+                        help="number of timed replays")
+    parser.add_argument("-c", "--compensate", action="store_true",
+                        help="feed the pulse widths of the first photodiode "
+                        "to sync_pulse_width_compensate()")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    synth_parser = subparsers.add_parser("synth",
+                                         help="replay a synthetic trace")
+    synth_parser.add_argument("--sensors", type=int, default=1)
+    synth_parser.add_argument("--cycles", type=int, default=100)
+    synth_parser.add_argument("--glitch-rate", type=float, default=0,
+                              help="probability of a glitch per pulse")
+    synth_parser.add_argument("--miss-rate", type=float, default=0,
+                              help="probability of missing a sweep slot")
+    synth_parser.add_argument("--jitter", type=int, default=2,
+                              help="maximum timestamp jitter in ticks")
+    synth_parser.add_argument("--seed", type=int, default=0)
+    synth_parser.add_argument("-o", "--output",
+                              help="also write the trace to this file")
+    synth_parser.set_defaults(handler=synth)
+
+    replay_parser = subparsers.add_parser("replay",
+                                          help="replay a recorded trace")
+    replay_parser.add_argument("trace")
+    replay_parser.add_argument("--sensors", type=int, default=1)
+    replay_parser.set_defaults(handler=replay)
+
+    args = parser.parse_args()
+    return args.handler(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,276 @@
+// Host replay harness for the lighthouse decoding pipeline. It compiles
+// scm_v3c/lighthouse.c unmodified against the stub headers in stubs/, replays
+// an edge trace through lh_push_edge() and lh_process_edges(), prints every
+// pose packet that lighthouse.c transmits, and measures the CPU time per edge.
+//
+// Each trace line holds one edge as "<sensor> <level> <timestamp>", where the
+// timestamp is in RF timer ticks. Empty lines and lines starting with '#' are
+// skipped. The output lines are:
+//  - POSE <sequence> <sensor> <valid mask> <angle 0> ... <angle 3>
+//  - avg: <width> (with -c, printed by sync_pulse_width_compensate())
+//  - STATS edges=<n> repetitions=<n> ns_per_edge=<mean> max_ns=<max>
+//    dropped=<n>
+// The CPU time is measured on the host, so it is only a relative baseline to
+// compare decoder changes, not the time on the Cortex-M0.
+//
+// scripts/lighthouse_replay.py builds this harness, generates synthetic
+// traces, and checks the decoded angles.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lighthouse.h"
+
+// Maximum number of edges in a trace.
+#define LIGHTHOUSE_REPLAY_MAX_NUM_EDGES 1000000
+
+// GPI bit of the first photodiode. The other photodiodes use the next bits.
+#define LIGHTHOUSE_REPLAY_FIRST_GPIO_MASK 0x0100
+
+// Registers used by lighthouse.c.
+unsigned int ANALOG_CFG_REG__3;
+unsigned int ANALOG_CFG_REG__9;
+unsigned int ANALOG_CFG_REG__11;
+unsigned int ANALOG_CFG_REG__14;
+unsigned int ANALOG_CFG_REG__15;
+unsigned int ANALOG_CFG_REG__16;
+unsigned int GPIO_REG__INPUT;
+unsigned int ICER;
+unsigned int ICPR;
+unsigned int ISER;
+unsigned int RFTIMER_REG__CONTROL;
+unsigned int RFTIMER_REG__COUNTER;
+unsigned int RFTIMER_REG__MAX_COUNT;
+
+// Globals used by lighthouse.c.
+unsigned int ASC[38];
+char send_packet[127];
+
+// Whether to print the transmitted pose packets.
+static bool g_lighthouse_replay_print_packets = true;
+
+// Edge trace.
+static lh_edge_t g_lighthouse_replay_edges[LIGHTHOUSE_REPLAY_MAX_NUM_EDGES];
+
+// Hardware interface functions, which do nothing.
+void analog_scan_chain_load(void) {}
+void analog_scan_chain_write(unsigned int* scan_bits) {}
+void clear_asc_bit(unsigned int position) {}
+void GPI_control(char row1, char row2, char row3, char row4) {}
+void GPI_enables(unsigned int mask) {}
+void GPO_control(char row1, char row2, char row3, char row4) {}
+void GPO_enables(unsigned int mask) {}
+void init_ldo_control(void) {}
+void LC_FREQCHANGE(int coarse, int mid, int fine) {}
+void LC_monotonic(int LC_code) {}
+void radio_disable_interrupts(void) {}
+void radio_txEnable(void) {}
+void radio_txNow(void) {}
+void rftimer_disable_interrupts(void) {}
+void set_2M_RC_frequency(int coarse1, int fine1, int coarse2, int fine2,
+                         int superfine) {}
+void set_ALWAYSON_LDO_voltage(int code) {}
+void set_asc_bit(unsigned int position) {}
+void set_IF_clock_frequency(int coarse, int fine, int high_range) {}
+void set_IF_comparator_trim_I(unsigned int ptrim, unsigned int ntrim) {}
+void set_IF_comparator_trim_Q(unsigned int ptrim, unsigned int ntrim) {}
+void set_IF_gain_ASC(unsigned int Igain, unsigned int Qgain) {}
+void set_IF_LDO_voltage(int code) {}
+void set_IF_stg3gm_ASC(unsigned int Igm, unsigned int Qgm) {}
+void set_LC_current(unsigned int current) {}
+void set_LO_supply(unsigned int code, unsigned char panic) {}
+void set_PA_supply(unsigned int code) {}
+void set_sys_clk_secondary_freq(unsigned int coarse, unsigned int fine) {}
+void set_VDDD_LDO_voltage(int code) {}
+
+// Capture the transmitted packet.
+void radio_loadPacket(unsigned int len) {
+    const uint8_t* packet = (const uint8_t*)send_packet;
+    int i;
+
+    if (!g_lighthouse_replay_print_packets || len != LH_POSE_PACKET_LENGTH ||
+        packet[0] != LH_POSE_CODE) {
+        return;
+    }
+    printf("POSE %u %u %u", packet[1], packet[2] >> 4, packet[2] & 0x0F);
+    for (i = 0; i < LH_NUM_ANGLES; i++) {
+        printf(" %u", packet[3 + 2 * i] | (packet[4 + 2 * i] << 8));
+    }
+    printf("\n");
+}
+
+// Return the monotonic time in nanoseconds.
+static uint64_t lighthouse_replay_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Read the trace. Return the number of edges or -1 on error.
+static long lighthouse_replay_read_trace(FILE* trace,
+                                         const uint8_t num_sensors) {
+    char line[128];
+    unsigned int sensor = 0;
+    unsigned int level = 0;
+    unsigned int timestamp = 0;
+    long num_edges = 0;
+
+    while (fgets(line, sizeof(line), trace) != NULL) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%u %u %u", &sensor, &level, &timestamp) != 3 ||
+            sensor >= num_sensors || level > 1) {
+            fprintf(stderr, "Invalid edge: %s", line);
+            return -1;
+        }
+        if (num_edges == LIGHTHOUSE_REPLAY_MAX_NUM_EDGES) {
+            fprintf(stderr, "Too many edges.\n");
+            return -1;
+        }
+        g_lighthouse_replay_edges[num_edges].sensor = sensor;
+        g_lighthouse_replay_edges[num_edges].level = level;
+        g_lighthouse_replay_edges[num_edges].timestamp = timestamp;
+        ++num_edges;
+    }
+    return num_edges;
+}
+
+// Replay the trace once. Return the maximum time of a single edge in
+// nanoseconds if measure_edges is set.
+static uint64_t lighthouse_replay_run(const long num_edges,
+                                      const bool measure_edges,
+                                      const bool compensate,
+                                      const uint32_t ticks_in_100ms) {
+    const lh_edge_t* edge = NULL;
+    uint32_t timestamp_rise = 0;
+    uint64_t start = 0;
+    uint64_t duration = 0;
+    uint64_t max_duration = 0;
+    long i = 0;
+
+    for (i = 0; i < num_edges; i++) {
+        edge = &g_lighthouse_replay_edges[i];
+        RFTIMER_REG__COUNTER = edge->timestamp;
+
+        if (measure_edges) {
+            start = lighthouse_replay_now();
+        }
+        lh_push_edge(edge->sensor, edge->level, edge->timestamp);
+        lh_process_edges();
+        if (measure_edges) {
+            duration = lighthouse_replay_now() - start;
+            if (duration > max_duration) {
+                max_duration = duration;
+            }
+        }
+
+        // Average the pulse widths of the first photodiode in 10 MHz ticks.
+        if (compensate && edge->sensor == 0) {
+            if (edge->level == 1) {
+                timestamp_rise = edge->timestamp;
+            } else {
+                sync_pulse_width_compensate(
+                    (uint64_t)(edge->timestamp - timestamp_rise) * 1000000 /
+                    ticks_in_100ms);
+            }
+        }
+    }
+    return max_duration;
+}
+
+static void lighthouse_replay_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [-t ticks_in_100ms] [-n num_sensors] [-r repetitions] "
+            "[-c] [trace]\n",
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short gpio_masks[LH_MAX_SENSORS];
+    uint32_t ticks_in_100ms = LH_HF_CLOCK_TICKS_IN_100MS_DEFAULT;
+    uint8_t num_sensors = 1;
+    long num_repetitions = 100;
+    bool compensate = false;
+    FILE* trace = stdin;
+    long num_edges = 0;
+    uint64_t start = 0;
+    uint64_t duration = 0;
+    uint64_t max_duration = 0;
+    long i = 0;
+    int option = 0;
+
+    while ((option = getopt(argc, argv, "t:n:r:c")) != -1) {
+        switch (option) {
+            case 't':
+                ticks_in_100ms = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                num_sensors = atoi(optarg);
+                break;
+            case 'r':
+                num_repetitions = atol(optarg);
+                break;
+            case 'c':
+                compensate = true;
+                break;
+            default:
+                lighthouse_replay_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (num_sensors == 0 || num_sensors > LH_MAX_SENSORS ||
+        num_repetitions < 1) {
+        lighthouse_replay_usage(argv[0]);
+        return 1;
+    }
+    if (optind < argc) {
+        trace = fopen(argv[optind], "r");
+        if (trace == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    num_edges = lighthouse_replay_read_trace(trace, num_sensors);
+    if (trace != stdin) {
+        fclose(trace);
+    }
+    if (num_edges < 0) {
+        return 1;
+    }
+
+    for (i = 0; i < num_sensors; i++) {
+        gpio_masks[i] = LIGHTHOUSE_REPLAY_FIRST_GPIO_MASK << i;
+    }
+    lh_calibrate_pulse_classifier(ticks_in_100ms);
+
+    // The first replay prints the packets and measures every edge.
+    lh_init_sensors(gpio_masks, num_sensors);
+    max_duration =
+        lighthouse_replay_run(num_edges, true, compensate, ticks_in_100ms);
+
+    // The other replays measure the mean time per edge.
+    g_lighthouse_replay_print_packets = false;
+    for (i = 0; i < num_repetitions; i++) {
+        lh_init_sensors(gpio_masks, num_sensors);
+        start = lighthouse_replay_now();
+        lighthouse_replay_run(num_edges, false, false, ticks_in_100ms);
+        duration += lighthouse_replay_now() - start;
+    }
+
+    printf("STATS edges=%ld repetitions=%ld ns_per_edge=%.1f max_ns=%llu "
+           "dropped=%u\n",
+           num_edges, num_repetitions,
+           num_edges > 0 ? (double)duration / num_repetitions / num_edges : 0,
+           (unsigned long long)max_duration, lh_get_num_dropped_edges());
+    return 0;
+}
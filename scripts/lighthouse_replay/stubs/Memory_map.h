@@ -0,0 +1,21 @@
+// Host stand-ins for the memory-mapped registers used by lighthouse.c. The
+// registers are plain variables defined by lighthouse_replay.c.
+
+#ifndef __MEMORY_MAP_STUB_H
+#define __MEMORY_MAP_STUB_H
+
+extern unsigned int ANALOG_CFG_REG__3;
+extern unsigned int ANALOG_CFG_REG__9;
+extern unsigned int ANALOG_CFG_REG__11;
+extern unsigned int ANALOG_CFG_REG__14;
+extern unsigned int ANALOG_CFG_REG__15;
+extern unsigned int ANALOG_CFG_REG__16;
+extern unsigned int GPIO_REG__INPUT;
+extern unsigned int ICER;
+extern unsigned int ICPR;
+extern unsigned int ISER;
+extern unsigned int RFTIMER_REG__CONTROL;
+extern unsigned int RFTIMER_REG__COUNTER;
+extern unsigned int RFTIMER_REG__MAX_COUNT;
+
+#endif  // __MEMORY_MAP_STUB_H
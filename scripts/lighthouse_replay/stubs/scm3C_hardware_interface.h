@@ -0,0 +1,41 @@
+// Host stand-ins for the hardware interface functions used by lighthouse.c.
+// The functions are defined by lighthouse_replay.c and do nothing except for
+// capturing the transmitted packets.
+
+#ifndef __SCM3C_HARDWARE_INTERFACE_STUB_H
+#define __SCM3C_HARDWARE_INTERFACE_STUB_H
+
+#include <stdbool.h>
+
+void analog_scan_chain_load(void);
+void analog_scan_chain_write(unsigned int* scan_bits);
+void clear_asc_bit(unsigned int position);
+void GPI_control(char row1, char row2, char row3, char row4);
+void GPI_enables(unsigned int mask);
+void GPO_control(char row1, char row2, char row3, char row4);
+void GPO_enables(unsigned int mask);
+void init_ldo_control(void);
+void LC_FREQCHANGE(int coarse, int mid, int fine);
+void LC_monotonic(int LC_code);
+void radio_disable_interrupts(void);
+void radio_loadPacket(unsigned int len);
+void radio_txEnable(void);
+void radio_txNow(void);
+void rftimer_disable_interrupts(void);
+void set_2M_RC_frequency(int coarse1, int fine1, int coarse2, int fine2,
+                         int superfine);
+void set_ALWAYSON_LDO_voltage(int code);
+void set_asc_bit(unsigned int position);
+void set_IF_clock_frequency(int coarse, int fine, int high_range);
+void set_IF_comparator_trim_I(unsigned int ptrim, unsigned int ntrim);
+void set_IF_comparator_trim_Q(unsigned int ptrim, unsigned int ntrim);
+void set_IF_gain_ASC(unsigned int Igain, unsigned int Qgain);
+void set_IF_LDO_voltage(int code);
+void set_IF_stg3gm_ASC(unsigned int Igm, unsigned int Qgm);
+void set_LC_current(unsigned int current);
+void set_LO_supply(unsigned int code, unsigned char panic);
+void set_PA_supply(unsigned int code);
+void set_sys_clk_secondary_freq(unsigned int coarse, unsigned int fine);
+void set_VDDD_LDO_voltage(int code);
+
+#endif  // __SCM3C_HARDWARE_INTERFACE_STUB_H
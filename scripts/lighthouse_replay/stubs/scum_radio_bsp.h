@@ -0,0 +1 @@
+// Empty host stand-in for a header included by lighthouse.c.
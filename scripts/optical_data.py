@@ -0,0 +1,189 @@
+"""Send configuration and patch messages to SCuM over the optical data channel.
+
+The messages are framed as expected by optical_data.c: a header word with the
+sync byte, the message type, and the payload length, the payload padded to a
+multiple of 4 bytes, and the CRC-32 over the header and the padded payload.
+The frames are sent with the Teensy's optical data transfer ("optdata"), which
+transmits a fixed-size buffer after the optical SFD, so the frames are padded
+with zero words that SCuM skips.
+
+The Teensy transmits each byte LSB-first, while SCuM takes the bytes MSB-first
+from each received word, so the bits of each byte are reversed before sending.
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+
+# First byte of every frame header.
+SYNC = 0xA7
+
+# Maximum payload length in bytes.
+MAX_PAYLOAD_LENGTH = 256
+
+# Message types, as in optical_data_message_e.
+MESSAGE_CALIBRATION = 1
+MESSAGE_ASC_PROFILE = 2
+MESSAGE_PATCH_WRITE = 3
+MESSAGE_PATCH_CALL = 4
+MESSAGE_APPLICATION = 5
+
+# ASC profiles, as in asc_profile_e.
+ASC_PROFILES = {"tx": 0, "rx_mf": 1, "rx_zcc": 2, "sleep": 3, "lighthouse": 4}
+
+# Number of bytes sent by the Teensy per optical data transfer.
+TEENSY_DIG_DATA_BYTES = 1500
+
+
+def build_frame(message_type, payload):
+    """Return the frame of the message."""
+    if len(payload) > MAX_PAYLOAD_LENGTH:
+        raise ValueError("Payload of {} bytes is too long.".format(
+            len(payload)))
+    frame = struct.pack(">BBH", SYNC, message_type, len(payload)) + payload
+    frame += bytes(-len(frame) % 4)
+    return frame + struct.pack(">I", binascii.crc32(frame) & 0xFFFFFFFF)
+
+
+def calibration_payload(args):
+    """Return the calibration message payload."""
+    return struct.pack(">7BH", args.hf_coarse, args.hf_fine, args.rc2m_coarse,
+                       args.rc2m_fine, args.rc2m_superfine, args.if_coarse,
+                       args.if_fine, args.lc_code)
+
+
+def asc_profile_frames(args):
+    """Return the frames writing the words of an ASC profile."""
+    words = [int(word, 16) for word in args.words]
+    max_words = (MAX_PAYLOAD_LENGTH - 4) // 4
+    frames = []
+    for start in range(0, len(words), max_words):
+        chunk = words[start:start + max_words]
+        payload = struct.pack(">BBH", ASC_PROFILES[args.profile], 0,
+                              args.offset + start)
+        payload += struct.pack(">{}I".format(len(chunk)), *chunk)
+        frames.append(build_frame(MESSAGE_ASC_PROFILE, payload))
+    return frames
+
+
+def patch_frames(args):
+    """Return the frames writing the patch and optionally calling it."""
+    with open(args.binary, "rb") as binary:
+        patch = binary.read()
+    max_bytes = MAX_PAYLOAD_LENGTH - 2
+    frames = []
+    for start in range(0, len(patch), max_bytes):
+        payload = struct.pack(">H", args.offset + start)
+        payload += patch[start:start + max_bytes]
+        frames.append(build_frame(MESSAGE_PATCH_WRITE, payload))
+    if args.call is not None:
+        frames.append(build_frame(MESSAGE_PATCH_CALL,
+                                  struct.pack(">H", args.call)))
+    return frames
+
+
+def reverse_bits(byte):
+    """Return the byte with its bits reversed."""
+    return int("{:08b}".format(byte)[::-1], 2)
+
+
+def build_transfer(frames):
+    """Return the bit-reversed and padded Teensy transfer buffer."""
+    data = b"".join(frames)
+    if len(data) > TEENSY_DIG_DATA_BYTES:
+        raise ValueError("Frames of {} bytes exceed one transfer.".format(
+            len(data)))
+    data += bytes(TEENSY_DIG_DATA_BYTES - len(data))
+    return bytes(reverse_bits(byte) for byte in data)
+
+
+def send(args, frames):
+    """Send the frames in as few optical data transfers as possible."""
+    transfers = []
+    current = []
+    for frame in frames:
+        if sum(len(f) for f in current) + len(frame) > TEENSY_DIG_DATA_BYTES:
+            transfers.append(current)
+            current = []
+        current.append(frame)
+    transfers.append(current)
+
+    if args.output:
+        with open(args.output, "wb") as output:
+            for transfer in transfers:
+                output.write(build_transfer(transfer))
+        return
+
+    import serial
+    teensy = serial.Serial(args.teensy_port, 19200)
+
+    # Configure the optical pulse widths as for bootloading.
+    teensy.write(b"configopt\n")
+    for value in args.optical_config:
+        teensy.write("{}\n".format(value).encode())
+
+    for transfer in transfers:
+        teensy.write(b"transfersdigdata\n")
+        teensy.write(build_transfer(transfer))
+        teensy.write(b"optdata\n")
+    teensy.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("-tp", "--teensy_port", default="COM15")
+    parser.add_argument("--optical-config", type=int, nargs=4,
+                        default=[80, 80, 3, 80],
+                        help="long high, long low, short high, and short low "
+                        "optical pulse delays")
+    parser.add_argument("-o", "--output",
+                        help="write the Teensy transfer buffers to this file "
+                        "instead of sending them")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    calibration = subparsers.add_parser("calibration",
+                                        help="set the calibration codes")
+    calibration.add_argument("hf_coarse", type=int)
+    calibration.add_argument("hf_fine", type=int)
+    calibration.add_argument("rc2m_coarse", type=int)
+    calibration.add_argument("rc2m_fine", type=int)
+    calibration.add_argument("rc2m_superfine", type=int)
+    calibration.add_argument("if_coarse", type=int)
+    calibration.add_argument("if_fine", type=int)
+    calibration.add_argument("lc_code", type=int)
+
+    asc_profile = subparsers.add_parser("asc-profile",
+                                        help="overwrite ASC profile words")
+    asc_profile.add_argument("profile", choices=ASC_PROFILES)
+    asc_profile.add_argument("offset", type=int, help="word offset")
+    asc_profile.add_argument("words", nargs="+", help="hex words")
+
+    patch = subparsers.add_parser("patch", help="write a RAM patch")
+    patch.add_argument("binary", help="position-independent Thumb code")
+    patch.add_argument("--offset", type=int, default=0,
+                       help="byte offset into the patch region")
+    patch.add_argument("--call", type=int, default=None,
+                       help="byte offset of the function to call afterwards")
+
+    application = subparsers.add_parser("application",
+                                        help="send an application message")
+    application.add_argument("payload", help="hex payload")
+
+    args = parser.parse_args()
+    if args.command == "calibration":
+        frames = [build_frame(MESSAGE_CALIBRATION, calibration_payload(args))]
+    elif args.command == "asc-profile":
+        frames = asc_profile_frames(args)
+    elif args.command == "patch":
+        frames = patch_frames(args)
+    else:
+        frames = [build_frame(MESSAGE_APPLICATION,
+                              bytes.fromhex(args.payload))]
+
+    send(args, frames)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())